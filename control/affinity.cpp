@@ -13,6 +13,10 @@
 #include "affinity.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 
 affinity_set::affinity_set()
 {
@@ -74,4 +78,257 @@ void affinity_set::print_set(int id, const char* s)
 #endif
 }
 
+// Reads an integer from /sys/devices/system/cpu/cpu<cpu_nr>/<file>,
+// returning defval if it can't be read.
+static int read_cpu_int(int cpu_nr, const char* file, int defval)
+{
+    char path[128];
+    int val = defval;
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/%s", cpu_nr, file);
+    FILE* f = fopen(path, "r");
+    if (f != NULL) {
+        if (fscanf(f, "%d", &val) != 1 || val < 0)
+            val = defval;
+        fclose(f);
+    }
+    return val;
+}
+
+// Returns the socket (physical package id) of cpu_nr, or 0 if unknown.
+int affinity_set::get_socket(int cpu_nr)
+{
+    return read_cpu_int(cpu_nr, "topology/physical_package_id", 0);
+}
+
+// Returns the number of sockets with configured CPUs, at least 1.
+int affinity_set::get_num_sockets()
+{
+    static int num_sockets = 0;
+    if (num_sockets == 0) {
+        bool seen[CPU_SETSIZE] = { false };
+        int ncpu = sysconf(_SC_NPROCESSORS_CONF);
+        int cnt = 0;
+        for(int icpu=0; icpu<ncpu && icpu<CPU_SETSIZE; ++icpu){
+            int socket = get_socket(icpu);
+            if(socket < CPU_SETSIZE && ! seen[socket]){
+                seen[socket] = true;
+                ++cnt;
+            }
+        }
+        num_sockets = (cnt > 0 ? cnt : 1);
+    }
+    return num_sockets;
+}
+
+// Prints, for each socket, the CPUs in this set on that socket.
+void affinity_set::print_topology(const char* s)
+{
+    int socket_of[CPU_SETSIZE];
+    int nsockets = get_num_sockets();
+    int maxsocket = -1;
+    for(int icpu=0; icpu<CPU_SETSIZE; ++icpu){
+        socket_of[icpu] = -1;
+        if(CPU_ISSET(icpu,&set)){
+            socket_of[icpu] = get_socket(icpu);
+            maxsocket = (socket_of[icpu] > maxsocket ? socket_of[icpu] : maxsocket);
+        }
+    }
+    printf("%s: %d socket%s\n", s, nsockets, (nsockets > 1 ? "s" : ""));
+    for(int socket=0; socket<=maxsocket; ++socket){
+        int nrcpu=0;
+        for(int icpu=0; icpu<CPU_SETSIZE; ++icpu){
+            if(socket_of[icpu] == socket){
+                if(nrcpu == 0)
+                    printf("  socket %d: CPUS %d", socket, icpu);
+                else
+                    printf(",%d", icpu);
+                ++nrcpu;
+            }
+        }
+        if(nrcpu > 0)
+            printf("\n");
+    }
+    fflush(stdout);
+}
+
+// ---------------------------------------------
+// Topology of the CPUs this process may use, discovered once.
+struct cpu_info {
+    int cpu;
+    int socket;
+    int core;       // core id within socket, from sysfs
+    int core_rank;  // rank of core among this process's cores on its socket
+    int smt;        // rank of cpu among this process's CPUs on its core
+};
+
+static cpu_info*      g_cpus  = NULL;
+static int            g_ncpus = 0;
+static pthread_once_t g_topology_once = PTHREAD_ONCE_INIT;
+
+// Lexicographic comparison of two CPUs on the keys listed.
+#define CMP_KEY(key) if (a->key != b->key) return (a->key < b->key ? -1 : 1);
+
+static int cmp_physical(const void* pa, const void* pb)
+{
+    const cpu_info* a = (const cpu_info*) pa;
+    const cpu_info* b = (const cpu_info*) pb;
+    CMP_KEY(smt); CMP_KEY(socket); CMP_KEY(core_rank); CMP_KEY(cpu);
+    return 0;
+}
+
+static int cmp_compact(const void* pa, const void* pb)
+{
+    const cpu_info* a = (const cpu_info*) pa;
+    const cpu_info* b = (const cpu_info*) pb;
+    CMP_KEY(socket); CMP_KEY(core_rank); CMP_KEY(smt); CMP_KEY(cpu);
+    return 0;
+}
+
+static int cmp_scatter(const void* pa, const void* pb)
+{
+    const cpu_info* a = (const cpu_info*) pa;
+    const cpu_info* b = (const cpu_info*) pb;
+    CMP_KEY(smt); CMP_KEY(core_rank); CMP_KEY(socket); CMP_KEY(cpu);
+    return 0;
+}
+
+static int cmp_linear(const void* pa, const void* pb)
+{
+    const cpu_info* a = (const cpu_info*) pa;
+    const cpu_info* b = (const cpu_info*) pb;
+    CMP_KEY(cpu);
+    return 0;
+}
+
+// Parses a CPU list such as "0-3,8,10-11" into set.
+static int parse_cpu_list(const char* str, cpu_set_t* set)
+{
+    CPU_ZERO(set);
+    int cnt = 0;
+    while (*str != '\0' && *str != '\n') {
+        char* end;
+        long first = strtol(str, &end, 10);
+        if (end == str)
+            break;
+        long last = first;
+        str = end;
+        if (*str == '-') {
+            last = strtol(str+1, &end, 10);
+            str = end;
+        }
+        for (long icpu = first; icpu <= last && icpu < CPU_SETSIZE; ++icpu) {
+            CPU_SET(icpu, set);
+            ++cnt;
+        }
+        if (*str == ',')
+            ++str;
+    }
+    return cnt;
+}
+
+// Finds the CPUs this process may use: the online CPUs in
+// /sys/devices/system/cpu/online that are also in the process's affinity
+// mask (which the kernel restricts to its cgroup cpuset, e.g., from a batch
+// scheduler). Then finds each one's socket and core, and sorts them
+// by the placement policy in $MAGMA_AFFINITY.
+static void topology_init()
+{
+    cpu_set_t online, allowed;
+    char buf[4096];
+    int nonline = 0;
+    FILE* f = fopen("/sys/devices/system/cpu/online", "r");
+    if (f != NULL) {
+        if (fgets(buf, sizeof(buf), f) != NULL)
+            nonline = parse_cpu_list(buf, &online);
+        fclose(f);
+    }
+    if (nonline == 0) {
+        CPU_ZERO(&online);
+        int ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        for (int icpu = 0; icpu < ncpu && icpu < CPU_SETSIZE; ++icpu)
+            CPU_SET(icpu, &online);
+    }
+    // the process's mask, i.e., its main thread's, not the calling thread's,
+    // which may already be pinned
+    if (sched_getaffinity(getpid(), sizeof(allowed), &allowed) != 0)
+        allowed = online;
+
+    g_cpus  = (cpu_info*) malloc(CPU_SETSIZE * sizeof(cpu_info));
+    g_ncpus = 0;
+    if (g_cpus == NULL) {
+        // no placement; get_cpu returns -1, so threads are not pinned
+        return;
+    }
+    for (int icpu = 0; icpu < CPU_SETSIZE; ++icpu) {
+        if (CPU_ISSET(icpu, &online) && CPU_ISSET(icpu, &allowed)) {
+            cpu_info* c  = &g_cpus[g_ncpus++];
+            c->cpu       = icpu;
+            c->socket    = read_cpu_int(icpu, "topology/physical_package_id", 0);
+            c->core      = read_cpu_int(icpu, "topology/core_id", icpu);
+            c->core_rank = 0;
+            c->smt       = 0;
+        }
+    }
+    if (g_ncpus == 0) {
+        // nothing usable found; don't pin anywhere unexpected
+        g_cpus[0].cpu = 0;
+        g_cpus[0].socket = g_cpus[0].core = g_cpus[0].core_rank = g_cpus[0].smt = 0;
+        g_ncpus = 1;
+    }
+
+    // rank siblings within each core, then cores within each socket,
+    // counting each core once by its first sibling (smt == 0)
+    for (int i = 0; i < g_ncpus; ++i) {
+        for (int j = 0; j < i; ++j) {
+            if (g_cpus[j].socket == g_cpus[i].socket && g_cpus[j].core == g_cpus[i].core)
+                g_cpus[i].smt += 1;
+        }
+    }
+    for (int i = 0; i < g_ncpus; ++i) {
+        for (int j = 0; j < g_ncpus; ++j) {
+            if (g_cpus[j].socket == g_cpus[i].socket && g_cpus[j].core < g_cpus[i].core && g_cpus[j].smt == 0)
+                g_cpus[i].core_rank += 1;
+        }
+    }
+
+    int (*cmp)(const void*, const void*) = cmp_physical;
+    const char* policy = getenv("MAGMA_AFFINITY");
+    if (policy == NULL || strcmp(policy, "physical") == 0)
+        cmp = cmp_physical;
+    else if (strcmp(policy, "compact") == 0)
+        cmp = cmp_compact;
+    else if (strcmp(policy, "scatter") == 0)
+        cmp = cmp_scatter;
+    else if (strcmp(policy, "linear") == 0)
+        cmp = cmp_linear;
+    else
+        fprintf(stderr, "$MAGMA_AFFINITY='%s' is invalid; using physical.\n", policy);
+    qsort(g_cpus, g_ncpus, sizeof(cpu_info), cmp);
+}
+
+// Returns the CPU for thread thread_nr, wrapping around if there are more
+// threads than CPUs. See the policies in affinity.h.
+// Returns -1 if the topology couldn't be allocated; then don't pin.
+int affinity_set::get_cpu(int thread_nr)
+{
+    pthread_once(&g_topology_once, topology_init);
+    if (g_ncpus == 0)
+        return -1;
+    return g_cpus[ thread_nr % g_ncpus ].cpu;
+}
+
+// Returns the number of CPUs this process may use, or 0 if unknown.
+int affinity_set::get_num_cpus()
+{
+    pthread_once(&g_topology_once, topology_init);
+    return g_ncpus;
+}
+
+// C interface to affinity_set::get_cpu, e.g., for QUARK.
+extern "C"
+int magma_affinity_get_cpu(int thread_nr)
+{
+    return affinity_set::get_cpu(thread_nr);
+}
+
 #endif  // MAGMA_SETAFFINITY
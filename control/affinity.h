@@ -38,11 +38,35 @@ public:
 
     void print_set(int id, const char* s);
 
+    // socket (physical package) topology, from /sys/devices/system/cpu
+
+    static int get_socket(int cpu_nr);
+
+    static int get_num_sockets();
+
+    void print_topology(const char* s);
+
+    // placement of threads on the CPUs this process may use (its cpuset),
+    // according to the policy in $MAGMA_AFFINITY:
+    //   physical  one thread per physical core, socket by socket;
+    //             SMT siblings only once every core has a thread (default)
+    //   compact   fill all hardware threads of a core, then the next core,
+    //             then the next socket
+    //   scatter   round-robin over sockets, then over cores within a socket
+    //   linear    i-th allowed CPU in numeric order (the previous behavior)
+    // get_cpu returns -1 if the placement is unknown; then don't pin.
+
+    static int get_cpu(int thread_nr);
+
+    static int get_num_cpus();
+
 private:
 
     cpu_set_t set;
 };
 
+extern "C" int magma_affinity_get_cpu(int thread_nr);
+
 #else
 #error "Affinity requires Linux glibc version >= 2.3.3, which isn't available. Remove -DMAGMA_SETAFFINITY from CFLAGS in make.inc."
 #endif
@@ -13,6 +13,14 @@
 #include "common_magma.h"
 #include "magma_bulge.h"
 
+#ifdef MAGMA_SETAFFINITY
+#include "affinity.h"
+#endif
+
+#ifdef MAGMA_WITH_NUMA
+#include <numa.h>
+#endif
+
 #define applyQver 113
 
 
@@ -213,6 +221,168 @@ extern "C" {
         return blkcnt;
     }
 
+    /////////////////////////////////////////
+    // Returns the scheduling of the bulge chasing tasks in hb2st/sb2st,
+    // from $MAGMA_BULGE_SCHED = static (default) or dynamic.
+    magma_bulge_sched_t magma_bulge_get_sched()
+    {
+        const char* sched_str = getenv("MAGMA_BULGE_SCHED");
+        if ( sched_str == NULL || strcmp( sched_str, "static" ) == 0 ) {
+            return MagmaBulgeStatic;
+        }
+        else if ( strcmp( sched_str, "dynamic" ) == 0 ) {
+            return MagmaBulgeDynamic;
+        }
+        fprintf( stderr, "$MAGMA_BULGE_SCHED='%s' is invalid; using static.\n", sched_str );
+        return MagmaBulgeStatic;
+    }
+
+    /////////////////////////////////////////
+    // Returns the number of consecutive tasks of a sweep that the dynamic
+    // bulge chasing scheduler hands to a thread at once.
+    // Each task updates an nb-by-2nb block of the band and writes nb
+    // Householder elements; neighbouring tasks share half of that block,
+    // so a group is sized to fit in half the L2 cache, while leaving at
+    // least two groups per thread in the first sweep.
+    // The group size is 1 or even (see magma_ztile_bulge_parallel).
+    // $MAGMA_BULGE_GRSIZ overrides it.
+    magma_int_t magma_bulge_get_grsiz(magma_int_t n, magma_int_t nb, magma_int_t threads, magma_int_t elemsize)
+    {
+        magma_int_t grsiz;
+        const char* grsiz_str = getenv("MAGMA_BULGE_GRSIZ");
+        if ( grsiz_str != NULL ) {
+            grsiz = atoi( grsiz_str );
+        }
+        else {
+            long l2 = 0;
+            #if defined(_SC_LEVEL2_CACHE_SIZE)
+            l2 = sysconf( _SC_LEVEL2_CACHE_SIZE );
+            #endif
+            if ( l2 <= 0 )
+                l2 = 256*1024;
+
+            magma_int_t tilesize = 3*nb*nb*elemsize;
+            magma_int_t ntasks   = 2*magma_ceildiv(n, nb);
+            grsiz = (l2/2) / max(1, tilesize);
+            grsiz = min( grsiz, ntasks / (2*max(1, threads)) );
+        }
+        if ( grsiz < 2 )
+            return 1;
+        return grsiz - grsiz%2;
+    }
+
+    /////////////////////////////////////////
+    // Returns the placement of the band matrix and V, TAU, T workspaces in
+    // hb2st/sb2st, from $MAGMA_BULGE_NUMA = none, firsttouch, or interleave.
+    // The default is firsttouch on machines with several sockets, otherwise none.
+    // Interleave requires MAGMA built with -DMAGMA_WITH_NUMA; otherwise,
+    // and if the kernel has no NUMA support, it falls back to firsttouch.
+    magma_bulge_numa_t magma_bulge_get_numa()
+    {
+        const char* numa_str = getenv("MAGMA_BULGE_NUMA");
+        if ( numa_str == NULL ) {
+            #ifdef MAGMA_SETAFFINITY
+            if ( affinity_set::get_num_sockets() > 1 )
+                return MagmaBulgeNumaFirstTouch;
+            #endif
+            return MagmaBulgeNumaNone;
+        }
+        else if ( strcmp( numa_str, "none" ) == 0 ) {
+            return MagmaBulgeNumaNone;
+        }
+        else if ( strcmp( numa_str, "firsttouch" ) == 0 ) {
+            return MagmaBulgeNumaFirstTouch;
+        }
+        else if ( strcmp( numa_str, "interleave" ) == 0 ) {
+            #ifdef MAGMA_WITH_NUMA
+            if ( numa_available() >= 0 )
+                return MagmaBulgeNumaInterleave;
+            #endif
+            return MagmaBulgeNumaFirstTouch;
+        }
+        fprintf( stderr, "$MAGMA_BULGE_NUMA='%s' is invalid; using none.\n", numa_str );
+        return MagmaBulgeNumaNone;
+    }
+
+    /////////////////////////////////////////
+    // Sets the pages inside [ptr, ptr+size) to be interleaved over all NUMA
+    // nodes when first touched. Pages already touched are not moved.
+    // The policy stays with the pages, so use it only on memory that MAGMA
+    // allocates and frees itself. Does nothing without MAGMA_WITH_NUMA.
+    void magma_bulge_numa_interleave(void *ptr, size_t size)
+    {
+        #ifdef MAGMA_WITH_NUMA
+        size_t page  = sysconf( _SC_PAGESIZE );
+        size_t begin = ((size_t) ptr + page - 1) / page * page;
+        size_t end   = ((size_t) ptr + size) / page * page;
+        if ( end > begin )
+            numa_interleave_memory( (void*) begin, end - begin, numa_all_nodes_ptr );
+        #endif
+    }
+
+    /////////////////////////////////////////
+    // Thread my_core_id owns the tile columns that the static bulge chasing
+    // schedule assigns it, i.e., column j is owned by
+    // (j/colpercore) % mycoresnb, as in magma_ztile_bulge_parallel.
+    static magma_int_t bulge_numa_owner(magma_int_t j, magma_int_t cores_num, magma_int_t n, magma_int_t nb, magma_int_t grsiz)
+    {
+        magma_int_t colblktile = (grsiz == 1 ? 1 : grsiz/2);
+        magma_int_t maxrequiredcores = max( 1, magma_ceildiv(n, nb)/colblktile );
+        magma_int_t mycoresnb = min( cores_num, maxrequiredcores );
+        return (j/(colblktile*nb)) % mycoresnb;
+    }
+
+    /////////////////////////////////////////
+    // Copies the columns of the band matrix Asrc, stored in lda-by-n
+    // elements of elemsize bytes, that thread my_core_id owns into Adst.
+    // Called by all threads, before the bulge chasing into a fresh Adst so
+    // its pages are first touched by their owners, and after it back to Asrc.
+    void magma_bulge_numa_copy_band(magma_int_t my_core_id, magma_int_t cores_num, magma_int_t n, magma_int_t nb, magma_int_t grsiz,
+                                    magma_int_t elemsize, const void *Asrc, void *Adst, magma_int_t lda)
+    {
+        size_t colsize = lda*elemsize;
+        for (magma_int_t j = 0; j < n; j++) {
+            if ( bulge_numa_owner(j+1, cores_num, n, nb, grsiz) == my_core_id )
+                memcpy( (char*) Adst + j*colsize, (const char*) Asrc + j*colsize, colsize );
+        }
+    }
+
+    /////////////////////////////////////////
+    // Zeros the blocks of V, TAU, and T that thread my_core_id writes in the
+    // static bulge chasing schedule, so their pages are first touched by
+    // the owner. A block of Vblksiz sweeps starting at row st belongs to
+    // the owner of column st. Called by all threads instead of the memsets.
+    // Blocks are stored as in magma_bulge_findpos113: block columns from
+    // last to first, then blocks within a block column from top to bottom.
+    void magma_bulge_numa_zero_VT(magma_int_t my_core_id, magma_int_t cores_num, magma_int_t n, magma_int_t nb, magma_int_t grsiz,
+                                  magma_int_t Vblksiz, magma_int_t elemsize,
+                                  void *V, magma_int_t ldv, void *TAU, void *T, magma_int_t ldt)
+    {
+        magma_int_t colblk, blk, myblknb, mastersweep;
+        magma_int_t nbcolblk = magma_ceildiv((n-1),Vblksiz);
+        size_t Vsize   = Vblksiz*ldv*elemsize;
+        size_t TAUsize = Vblksiz*elemsize;
+        size_t Tsize   = Vblksiz*ldt*elemsize;
+
+        magma_int_t blkid = 0;
+        for (colblk = nbcolblk-1; colblk >= 0; colblk--)
+        {
+            mastersweep = colblk * Vblksiz;
+            if(colblk == (nbcolblk-1))
+                myblknb = magma_ceildiv((n-(mastersweep+1)),nb);
+            else
+                myblknb = magma_ceildiv((n-(mastersweep+2)),nb);
+            for (blk = 0; blk < myblknb; blk++, blkid++)
+            {
+                if ( bulge_numa_owner(mastersweep + blk*nb + 2, cores_num, n, nb, grsiz) == my_core_id ) {
+                    memset( (char*) V   + blkid*Vsize,   0, Vsize   );
+                    memset( (char*) TAU + blkid*TAUsize, 0, TAUsize );
+                    memset( (char*) T   + blkid*Tsize,   0, Tsize   );
+                }
+            }
+        }
+    }
+
     ///////////////////
     // Old functions //
     ///////////////////
@@ -314,7 +314,38 @@ const char *magma2lapack_constants[] =
     "", "", "", "", "", "", "", "",          // 393-400
     "Columnwise",                            // 401: MagmaColumnwise
     "Rowwise",                               // 402: MagmaRowwise
-    "", "", "", "", "", "", "", ""           // 403-410
+    "", "", "", "", "", "", "", "",          // 403-410
+    "CSR",                                   // 411: Magma_CSR
+    "ELLPACK",                               // 412: Magma_ELLPACK
+    "ELL",                                   // 413: Magma_ELL
+    "DENSE",                                 // 414: Magma_DENSE
+    "BCSR",                                  // 415: Magma_BCSR
+    "CSC",                                   // 416: Magma_CSC
+    "HYB",                                   // 417: Magma_HYB
+    "COO",                                   // 418: Magma_COO
+    "ELLRT",                                 // 419: Magma_ELLRT
+    "SELLC",                                 // 420: Magma_SELLC
+    "SELLP",                                 // 421: Magma_SELLP
+    "ELLD",                                  // 422: Magma_ELLD
+    "ELLDD",                                 // 423: Magma_ELLDD
+    "CSRD",                                  // 424: Magma_CSRD
+    "", "",                                  // 425-426
+    "CSRL",                                  // 427: Magma_CSRL
+    "CSRU",                                  // 428: Magma_CSRU
+    "CSRCOO",                                // 429: Magma_CSRCOO
+    "STENCIL",                               // 430: Magma_STENCIL
+    "", "", "", "", "", "", "", "", "", "",  // 431-440
+    "", "", "", "", "", "", "", "", "", "",  // 441-450
+    "", "", "", "", "", "", "", "", "", "",  // 451-460
+    "", "", "", "", "", "", "", "", "", "",  // 461-470
+    "", "", "", "", "", "", "", "", "", "",  // 471-480
+    "", "", "", "", "", "", "", "", "", "",  // 481-490
+    "", "", "", "", "", "", "", "", "", "",  // 491-500
+    "", "", "", "", "", "", "", "", "", "",  // 501-510
+    "", "", "", "", "", "", "", "", "", "",  // 511-520
+    "NOREORDER",                             // 521: Magma_NOREORDER
+    "RCM",                                   // 522: Magma_RCM
+    "ND"                                     // 523: Magma_ND
     // Remember to add a comma!
 };
 
@@ -446,6 +477,22 @@ const char* lapack_storev_const( magma_storev_t magma_const )
     return magma2lapack_constants[ magma_const ];
 }
 
+extern "C"
+const char* lapack_storage_const( magma_storage_t magma_const )
+{
+    assert( magma_const >= Magma_CSR     );
+    assert( magma_const <= Magma_STENCIL );
+    return magma2lapack_constants[ magma_const ];
+}
+
+extern "C"
+const char* lapack_reorder_const( magma_reorder_t magma_const )
+{
+    assert( magma_const >= Magma_NOREORDER );
+    assert( magma_const <= Magma_ND        );
+    return magma2lapack_constants[ magma_const ];
+}
+
 
 // ----------------------------------------
 // Convert magma constants to clAmdBlas constants.
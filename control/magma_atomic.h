@@ -0,0 +1,82 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+*/
+
+#ifndef MAGMA_ATOMIC_H
+#define MAGMA_ATOMIC_H
+
+// Minimal atomic operations on long and void*, used by the lock-free parts of
+// the CPU runtime (thread_queue, bulge chasing progress table).
+//
+// With gcc >= 4.7, icc, and clang, these map onto the __atomic builtins, so they
+// don't require compiling with -std=c++11 or -std=c11, and can be used from
+// both C and C++.
+// With Microsoft compilers, these map onto the Interlocked functions.
+//
+// Loads have acquire semantics, stores have release semantics, and
+// read-modify-write operations (fetch_add, cas) are sequentially consistent.
+
+#if defined( _WIN32 ) || defined( _WIN64 )
+    #include <windows.h>
+    #include <intrin.h>
+#else
+    #include <sched.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined( _MSC_VER )
+
+// MSVC volatile accesses have acquire/release semantics on x86 and x64.
+static __inline long  magma_atomic_load( volatile long* p )                   { long v = *p; _ReadWriteBarrier(); return v; }
+static __inline void  magma_atomic_store( volatile long* p, long v )          { _ReadWriteBarrier(); *p = v; }
+static __inline long  magma_atomic_fetch_add( volatile long* p, long v )      { return InterlockedExchangeAdd( p, v ); }
+static __inline int   magma_atomic_cas( volatile long* p, long old, long v )  { return InterlockedCompareExchange( p, v, old ) == old; }
+
+static __inline void* magma_atomic_load_ptr( void* volatile* p )              { void* v = *p; _ReadWriteBarrier(); return v; }
+static __inline void  magma_atomic_store_ptr( void* volatile* p, void* v )    { _ReadWriteBarrier(); *p = v; }
+
+static __inline void  magma_atomic_fence()  { MemoryBarrier(); }
+static __inline void  magma_cpu_relax()     { YieldProcessor(); }
+static __inline void  magma_yield()         { SwitchToThread(); }
+
+#else
+
+static inline long  magma_atomic_load( volatile long* p )                   { return __atomic_load_n( p, __ATOMIC_ACQUIRE ); }
+static inline void  magma_atomic_store( volatile long* p, long v )          { __atomic_store_n( p, v, __ATOMIC_RELEASE ); }
+static inline long  magma_atomic_fetch_add( volatile long* p, long v )      { return __atomic_fetch_add( p, v, __ATOMIC_SEQ_CST ); }
+static inline int   magma_atomic_cas( volatile long* p, long old, long v )
+{
+    return __atomic_compare_exchange_n( p, &old, v, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+}
+
+static inline void* magma_atomic_load_ptr( void* volatile* p )              { return __atomic_load_n( p, __ATOMIC_ACQUIRE ); }
+static inline void  magma_atomic_store_ptr( void* volatile* p, void* v )    { __atomic_store_n( p, v, __ATOMIC_RELEASE ); }
+
+static inline void  magma_atomic_fence()  { __atomic_thread_fence( __ATOMIC_SEQ_CST ); }
+
+// pause instruction tells a hyperthreaded core that we are spinning
+static inline void  magma_cpu_relax()
+{
+    #if defined( __i386__ ) || defined( __x86_64__ )
+    __asm__ __volatile__( "pause" ::: "memory" );
+    #else
+    __asm__ __volatile__( "" ::: "memory" );
+    #endif
+}
+
+static inline void  magma_yield()         { sched_yield(); }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif        //  #ifndef MAGMA_ATOMIC_H
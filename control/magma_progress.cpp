@@ -0,0 +1,165 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#if defined( __linux__ )
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    #include <linux/futex.h>
+    #define MAGMA_HAVE_FUTEX
+#endif
+
+#include "magma_progress.h"
+
+// number of polls with exponential backoff, from 1 up to max_pause
+// pause instructions each; then number of polls with yield; then sleep.
+static const int max_pause   = 64;
+static const int spin_count  = 64;
+static const int yield_count = 16;
+
+
+#ifdef MAGMA_HAVE_FUTEX
+// ---------------------------------------------
+static void futex_wait( volatile int* addr, int value )
+{
+    syscall( SYS_futex, (int*) addr, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0 );
+}
+
+static void futex_wake_all( volatile int* addr )
+{
+    syscall( SYS_futex, (int*) addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0 );
+}
+#endif
+
+
+// ---------------------------------------------
+/// Allocates and zeros size progress counters.
+/// @return MAGMA_SUCCESS, or MAGMA_ERR_HOST_ALLOC if allocation fails.
+extern "C"
+magma_int_t magma_progress_init( magma_progress_t* prog, magma_int_t size )
+{
+    // allocate extra line to align counters to 64 bytes
+    size_t bytes = (size + 1) * MAGMA_PROGRESS_STRIDE * sizeof(long);
+    prog->alloc = malloc( bytes );
+    if ( prog->alloc == NULL ) {
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    size_t line = MAGMA_PROGRESS_STRIDE * sizeof(long);
+    prog->counters = (volatile long*)
+        (((size_t) prog->alloc + line - 1) / line * line);
+    prog->size   = size;
+    prog->nsleep = 0;
+    prog->epoch  = 0;
+    pthread_mutex_init( &prog->mutex, NULL );
+    pthread_cond_init(  &prog->cond,  NULL );
+    magma_progress_reset( prog );
+    return MAGMA_SUCCESS;
+}
+
+
+/// Frees progress counters. No threads may be waiting.
+extern "C"
+void magma_progress_destroy( magma_progress_t* prog )
+{
+    pthread_mutex_destroy( &prog->mutex );
+    pthread_cond_destroy(  &prog->cond  );
+    free( prog->alloc );
+    prog->alloc    = NULL;
+    prog->counters = NULL;
+    prog->size     = 0;
+}
+
+
+/// Sets all counters to zero. No threads may be waiting.
+extern "C"
+void magma_progress_reset( magma_progress_t* prog )
+{
+    memset( (void*) prog->counters, 0, prog->size * MAGMA_PROGRESS_STRIDE * sizeof(long) );
+    magma_atomic_fence();
+}
+
+
+/// Sets counter i to value, with release semantics, and wakes any sleeping
+/// threads so they can re-check their counters.
+/// Counters must be monotonically increasing.
+extern "C"
+void magma_progress_set( magma_progress_t* prog, magma_int_t i, long value )
+{
+    magma_atomic_store( &prog->counters[ i*MAGMA_PROGRESS_STRIDE ], value );
+
+    // pairs with the fence in wait_slow: either we see the sleeper,
+    // or the sleeper sees the new value before going to sleep.
+    magma_atomic_fence();
+    if ( magma_atomic_load( &prog->nsleep ) > 0 ) {
+        #ifdef MAGMA_HAVE_FUTEX
+        __atomic_fetch_add( &prog->epoch, 1, __ATOMIC_SEQ_CST );
+        futex_wake_all( &prog->epoch );
+        #else
+        pthread_mutex_lock( &prog->mutex );
+        pthread_cond_broadcast( &prog->cond );
+        pthread_mutex_unlock( &prog->mutex );
+        #endif
+    }
+}
+
+
+/// Waits until counter i >= value: spins with exponential backoff,
+/// then yields, then sleeps until some counter is set.
+/// Use magma_progress_wait, which checks the counter once before calling this.
+extern "C"
+void magma_progress_wait_slow( magma_progress_t* prog, magma_int_t i, long value )
+{
+    volatile long* counter = &prog->counters[ i*MAGMA_PROGRESS_STRIDE ];
+
+    // spin, doubling the number of pauses between polls
+    int npause = 1;
+    for( int spin=0; spin < spin_count; ++spin ) {
+        if ( magma_atomic_load( counter ) >= value ) {
+            return;
+        }
+        for( int k=0; k < npause; ++k ) {
+            magma_cpu_relax();
+        }
+        if ( npause < max_pause ) {
+            npause *= 2;
+        }
+    }
+
+    // give up time slice, in case the thread we're waiting on is descheduled
+    for( int spin=0; spin < yield_count; ++spin ) {
+        if ( magma_atomic_load( counter ) >= value ) {
+            return;
+        }
+        magma_yield();
+    }
+
+    // sleep until a setter wakes us
+    while( magma_atomic_load( counter ) < value ) {
+        #ifdef MAGMA_HAVE_FUTEX
+        int epoch = __atomic_load_n( &prog->epoch, __ATOMIC_SEQ_CST );
+        magma_atomic_fetch_add( &prog->nsleep, 1 );
+        magma_atomic_fence();
+        if ( magma_atomic_load( counter ) < value ) {
+            // returns immediately if epoch changed since we read it
+            futex_wait( &prog->epoch, epoch );
+        }
+        magma_atomic_fetch_add( &prog->nsleep, -1 );
+        #else
+        pthread_mutex_lock( &prog->mutex );
+        magma_atomic_fetch_add( &prog->nsleep, 1 );
+        magma_atomic_fence();
+        if ( magma_atomic_load( counter ) < value ) {
+            pthread_cond_wait( &prog->cond, &prog->mutex );
+        }
+        magma_atomic_fetch_add( &prog->nsleep, -1 );
+        pthread_mutex_unlock( &prog->mutex );
+        #endif
+    }
+}
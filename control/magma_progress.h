@@ -0,0 +1,72 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+*/
+
+#ifndef MAGMA_PROGRESS_H
+#define MAGMA_PROGRESS_H
+
+#if defined( _WIN32 ) || defined( _WIN64 )
+    #include "magmawinthread.h"
+#else
+    #include <pthread.h>
+#endif
+
+#include "magma_types.h"
+#include "magma_atomic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Table of monotonically increasing progress counters, as used by the bulge
+// chasing kernels (hb2st, sb2st) to signal that task myid of a sweep is done.
+//
+// magma_progress_set publishes a counter with release semantics;
+// magma_progress_wait waits, with acquire semantics, until a counter reaches
+// at least a given value. Waiting first spins with exponential backoff
+// (pause instruction), then yields, then sleeps (futex on Linux, otherwise a
+// condition variable), so oversubscribed threads don't burn whole cores.
+// Setters only make a system call if some thread is actually sleeping.
+//
+// Each counter is padded to its own cache line.
+typedef struct magma_progress_s {
+    volatile long*  counters;   // size * MAGMA_PROGRESS_STRIDE longs
+    void*           alloc;      // unaligned allocation for counters
+    magma_int_t     size;
+    volatile long   nsleep;     // number of threads sleeping (or about to) in wait
+    volatile int    epoch;      // futex word; incremented to wake sleepers
+    pthread_mutex_t mutex;      // used when futex is not available
+    pthread_cond_t  cond;
+} magma_progress_t;
+
+#define MAGMA_PROGRESS_STRIDE 8   // 64 bytes per counter
+
+magma_int_t magma_progress_init( magma_progress_t* prog, magma_int_t size );
+void        magma_progress_destroy( magma_progress_t* prog );
+void        magma_progress_reset( magma_progress_t* prog );
+
+void        magma_progress_set( magma_progress_t* prog, magma_int_t i, long value );
+void        magma_progress_wait_slow( magma_progress_t* prog, magma_int_t i, long value );
+
+static inline long magma_progress_get( magma_progress_t* prog, magma_int_t i )
+{
+    return magma_atomic_load( &prog->counters[ i*MAGMA_PROGRESS_STRIDE ] );
+}
+
+// Waits until counter i >= value. Inlined fast path; see magma_progress_wait_slow.
+static inline void magma_progress_wait( magma_progress_t* prog, magma_int_t i, long value )
+{
+    if ( magma_progress_get( prog, i ) < value ) {
+        magma_progress_wait_slow( prog, i, value );
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif        //  #ifndef MAGMA_PROGRESS_H
@@ -0,0 +1,382 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+*/
+#include "common_magma.h"
+#include "magma_thread_team.h"
+#include "magma_progress.h"
+#include "magma_atomic.h"
+
+#ifdef MAGMA_SETAFFINITY
+#include "affinity.h"
+#endif
+
+
+// ---------------------------------------------
+// The team. Workers sleep on start until the generation is incremented,
+// run their part of the job, then set done[i] to that generation.
+// Job parameters are written by the thread that set g_team_busy before it
+// increments start, and not changed until all workers have set done.
+static struct {
+    magma_int_t              nworker;
+    pthread_t*               threads;
+    magma_progress_t         start;     // counter 0 is the current generation
+    magma_progress_t         done;      // counter i is the last generation worker i finished
+    long                     gen;
+    volatile long            quit;
+    magma_thread_team_func_t func;
+    char*                    args;
+    size_t                   argsize;
+    magma_int_t              njob;
+} g_team;
+
+// 1 from magma_thread_team_start to magma_thread_team_wait of a job on the team.
+// A flag set with magma_atomic_cas instead of a mutex, because Windows mutexes
+// (magmawinthread) are recursive, so a nested job would also get the team.
+static volatile long g_team_busy = 0;
+
+
+// ---------------------------------------------
+// Pins the calling thread to the index-th CPU in the $MAGMA_AFFINITY
+// placement (see affinity.h), wrapping around if there are more threads
+// than CPUs. Pinning is only an optimization, so errors are ignored.
+static void pin_thread( magma_int_t index )
+{
+#ifdef MAGMA_SETAFFINITY
+    int cpu = affinity_set::get_cpu( index );
+    if ( cpu >= 0 ) {
+        affinity_set set( cpu );
+        set.set_affinity();
+    }
+#endif
+}
+
+
+// ---------------------------------------------
+extern "C"
+void* magma_thread_team_main( void* arg )
+{
+    magma_int_t index = (magma_int_t) (size_t) arg;
+    pin_thread( index + 1 );
+
+    // with MKL and when using omp_set_num_threads instead of mkl_set_num_threads
+    // it need that all threads setting it to 1.
+    magma_set_lapack_numthreads(1);
+
+    long gen = 0;
+    while( true ) {
+        gen += 1;
+        magma_progress_wait( &g_team.start, 0, gen );
+        if ( magma_atomic_load( &g_team.quit )) {
+            break;
+        }
+        if ( index < g_team.njob ) {
+            g_team.func( g_team.args + index*g_team.argsize );
+        }
+        magma_progress_set( &g_team.done, index, gen );
+    }
+    return NULL;
+}
+
+
+// ---------------------------------------------
+// Thread created for one job when the team is busy; pinned like the team.
+// It waits until all threads of the job were created (go = 1), so that if
+// one could not be, the others are cancelled (go = -1) before they run func
+// and block in a barrier waiting for the missing one.
+struct adhoc_arg {
+    magma_thread_team_func_t func;
+    void*                    arg;
+    magma_int_t              index;
+    volatile long            go;
+};
+
+extern "C"
+void* magma_thread_team_adhoc_main( void* arg )
+{
+    adhoc_arg* a = (adhoc_arg*) arg;
+    long go;
+    while( (go = magma_atomic_load( &a->go )) == 0 ) {
+        magma_yield();
+    }
+    if ( go < 0 ) {
+        return NULL;
+    }
+    pin_thread( a->index + 1 );
+    return a->func( a->arg );
+}
+
+
+// ---------------------------------------------
+// Creates nworker workers. Called with g_team_busy set.
+// If a thread cannot be created, the team keeps the workers already started,
+// and g_team.nworker is their number; if none were started, or memory could
+// not be allocated, there is no team and g_team.nworker is 0.
+static void team_create( magma_int_t nworker )
+{
+    g_team.gen     = 0;
+    g_team.quit    = 0;
+    g_team.njob    = 0;
+    g_team.nworker = 0;
+    if ( magma_progress_init( &g_team.start, 1 ) != MAGMA_SUCCESS ) {
+        return;
+    }
+    if ( magma_progress_init( &g_team.done, nworker ) != MAGMA_SUCCESS ) {
+        magma_progress_destroy( &g_team.start );
+        return;
+    }
+    g_team.threads = (pthread_t*) malloc( nworker * sizeof(pthread_t) );
+    if ( g_team.threads == NULL ) {
+        magma_progress_destroy( &g_team.start );
+        magma_progress_destroy( &g_team.done  );
+        return;
+    }
+    magma_int_t i;
+    for( i=0; i < nworker; ++i ) {
+        if ( pthread_create( &g_team.threads[i], NULL, magma_thread_team_main, (void*) (size_t) i ) != 0 ) {
+            break;
+        }
+    }
+    g_team.nworker = i;
+    if ( i == 0 ) {
+        free( g_team.threads );
+        g_team.threads = NULL;
+        magma_progress_destroy( &g_team.start );
+        magma_progress_destroy( &g_team.done  );
+    }
+}
+
+
+// ---------------------------------------------
+// Exits and joins workers. Called with g_team_busy set.
+static void team_destroy()
+{
+    if ( g_team.nworker == 0 ) {
+        return;
+    }
+    magma_atomic_store( &g_team.quit, 1 );
+    g_team.gen += 1;
+    magma_progress_set( &g_team.start, 0, g_team.gen );
+    for( magma_int_t i=0; i < g_team.nworker; ++i ) {
+        pthread_join( g_team.threads[i], NULL );
+    }
+    free( g_team.threads );
+    g_team.threads = NULL;
+    magma_progress_destroy( &g_team.start );
+    magma_progress_destroy( &g_team.done  );
+    g_team.nworker = 0;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Starts func( args + i*argsize ), for i = 0, ..., nthread-1, each on its own
+    thread, and returns without waiting for them.
+    Uses the persistent team if it is free, creating it on first use with
+    max( nthread, magma_get_parallel_numthreads() ) workers;
+    otherwise, or if the team could not start nthread workers,
+    creates threads for this job.
+    If the threads cannot be created, nothing is started and an error is
+    returned; magma_thread_team_wait may still be called.
+    Every job must be finished with magma_thread_team_wait.
+
+    @param[out]
+    job     Handle to pass to magma_thread_team_wait.
+
+    @param[in]
+    nthread Number of threads. If nthread <= 0, nothing is started.
+
+    @param[in]
+    func    Function to run on each thread.
+
+    @param[in]
+    args    Array of nthread arguments, each argsize bytes.
+
+    @param[in]
+    argsize Size in bytes of each argument.
+
+    @return MAGMA_SUCCESS, MAGMA_ERR_HOST_ALLOC, or MAGMA_ERR_UNKNOWN if a
+            thread could not be created.
+
+    @ingroup magma_util
+    ********************************************************************/
+extern "C"
+magma_int_t magma_thread_team_start(
+    magma_thread_team_job_t* job, magma_int_t nthread,
+    magma_thread_team_func_t func, void* args, size_t argsize )
+{
+    job->nthread = nthread;
+    job->on_team = 0;
+    job->threads = NULL;
+    job->adhoc   = NULL;
+    if ( nthread <= 0 ) {
+        return MAGMA_SUCCESS;
+    }
+
+    if ( magma_atomic_cas( &g_team_busy, 0, 1 )) {
+        if ( g_team.nworker < nthread ) {
+            team_destroy();
+            team_create( max( nthread, magma_get_parallel_numthreads() ));
+        }
+        if ( g_team.nworker >= nthread ) {
+            g_team.func    = func;
+            g_team.args    = (char*) args;
+            g_team.argsize = argsize;
+            g_team.njob    = nthread;
+            g_team.gen    += 1;
+            magma_progress_set( &g_team.start, 0, g_team.gen );
+            job->on_team = 1;
+            return MAGMA_SUCCESS;
+        }
+        // the team has too few workers; a later job tries to create it again
+        magma_atomic_store( &g_team_busy, 0 );
+    }
+
+    adhoc_arg* adhoc   = (adhoc_arg*) malloc( nthread * sizeof(adhoc_arg) );
+    pthread_t* threads = (pthread_t*) malloc( nthread * sizeof(pthread_t) );
+    if ( adhoc == NULL || threads == NULL ) {
+        free( adhoc );
+        free( threads );
+        return MAGMA_ERR_HOST_ALLOC;
+    }
+    magma_int_t i, j;
+    for( i=0; i < nthread; ++i ) {
+        adhoc[i].func  = func;
+        adhoc[i].arg   = (char*) args + i*argsize;
+        adhoc[i].index = i;
+        adhoc[i].go    = 0;
+        if ( pthread_create( &threads[i], NULL, magma_thread_team_adhoc_main, &adhoc[i] ) != 0 ) {
+            break;
+        }
+    }
+    long go = ( i == nthread ? 1 : -1 );
+    for( j=0; j < i; ++j ) {
+        magma_atomic_store( &adhoc[j].go, go );
+    }
+    if ( go < 0 ) {
+        for( j=0; j < i; ++j ) {
+            pthread_join( threads[j], NULL );
+        }
+        free( adhoc );
+        free( threads );
+        return MAGMA_ERR_UNKNOWN;
+    }
+    job->threads = threads;
+    job->adhoc   = adhoc;
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Waits for a job started with magma_thread_team_start to finish.
+
+    @param[in,out]
+    job     Handle from magma_thread_team_start.
+
+    @ingroup magma_util
+    ********************************************************************/
+extern "C"
+void magma_thread_team_wait( magma_thread_team_job_t* job )
+{
+    if ( job->on_team ) {
+        for( magma_int_t i=0; i < g_team.nworker; ++i ) {
+            magma_progress_wait( &g_team.done, i, g_team.gen );
+        }
+        job->on_team = 0;
+        magma_atomic_store( &g_team_busy, 0 );
+    }
+    else if ( job->threads != NULL ) {
+        for( magma_int_t i=0; i < job->nthread; ++i ) {
+            pthread_join( job->threads[i], NULL );
+        }
+        free( job->threads );
+        free( job->adhoc );
+        job->threads = NULL;
+        job->adhoc   = NULL;
+    }
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Runs func( args + i*argsize ), for i = 0, ..., nthread-1, in parallel and
+    waits for all to finish. The calling thread runs i = 0, pinned to the
+    first CPU of the placement; the others run on the team
+    (see magma_thread_team_start).
+    This replaces the usual pthread_create / pthread_join loop in parallel
+    sections that synchronize with a barrier among all nthread threads.
+    If the other threads cannot be started, func is not run at all and an
+    error is returned.
+
+    @param[in]
+    nthread Number of threads, including the calling thread.
+
+    @param[in]
+    func    Function to run on each thread.
+
+    @param[in]
+    args    Array of nthread arguments, each argsize bytes.
+
+    @param[in]
+    argsize Size in bytes of each argument.
+
+    @return MAGMA_SUCCESS, or the error of magma_thread_team_start.
+
+    @ingroup magma_util
+    ********************************************************************/
+extern "C"
+magma_int_t magma_thread_team_run(
+    magma_int_t nthread,
+    magma_thread_team_func_t func, void* args, size_t argsize )
+{
+    magma_thread_team_job_t job;
+    magma_int_t info = magma_thread_team_start( &job, nthread-1, func, (char*) args + argsize, argsize );
+    if ( info != MAGMA_SUCCESS ) {
+        return info;
+    }
+
+#ifdef MAGMA_SETAFFINITY
+    affinity_set original_set;
+    int check = original_set.get_affinity();
+    if ( check == 0 ) {
+        pin_thread( 0 );
+    }
+#endif
+
+    func( args );
+
+#ifdef MAGMA_SETAFFINITY
+    if ( check == 0 ) {
+        original_set.set_affinity();
+    }
+#endif
+
+    magma_thread_team_wait( &job );
+    return MAGMA_SUCCESS;
+}
+
+
+/***************************************************************************//**
+    Purpose
+    -------
+    Exits and joins the team's worker threads. Called by magma_finalize.
+    A later job creates the team again.
+
+    @ingroup magma_util
+    ********************************************************************/
+extern "C"
+void magma_thread_team_finalize()
+{
+    while( ! magma_atomic_cas( &g_team_busy, 0, 1 )) {
+        magma_yield();
+    }
+    team_destroy();
+    magma_atomic_store( &g_team_busy, 0 );
+}
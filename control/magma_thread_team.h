@@ -0,0 +1,63 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+*/
+
+#ifndef MAGMA_THREAD_TEAM_H
+#define MAGMA_THREAD_TEAM_H
+
+#if defined( _WIN32 ) || defined( _WIN64 )
+    #include "magmawinthread.h"
+#else
+    #include <pthread.h>
+#endif
+
+#include <stddef.h>
+
+#include "magma_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Persistent team of worker threads, created on first use and kept until
+// magma_finalize, so routines called many times (hb2st, bulge_back,
+// trevc3_mt) don't pay for pthread_create, pinning, and pthread_join
+// on every call. With MAGMA_SETAFFINITY, worker i is pinned to CPU i+1 of
+// the $MAGMA_AFFINITY placement (see affinity.h), leaving the first CPU
+// for the calling thread.
+//
+// One job at a time runs on the team. If the team is busy, e.g., a job
+// itself starts another job, or several application threads call MAGMA,
+// the job instead runs on threads created just for it, as before.
+
+typedef void* (*magma_thread_team_func_t)( void* arg );
+
+// Handle for a job started with magma_thread_team_start.
+typedef struct magma_thread_team_job_s {
+    magma_int_t nthread;
+    int         on_team;    // 1 if running on the team, 0 if on threads created for this job
+    pthread_t*  threads;    // threads created for this job, if not on the team
+    void*       adhoc;      // arguments for those threads
+} magma_thread_team_job_t;
+
+magma_int_t magma_thread_team_start(
+    magma_thread_team_job_t* job, magma_int_t nthread,
+    magma_thread_team_func_t func, void* args, size_t argsize );
+
+void magma_thread_team_wait( magma_thread_team_job_t* job );
+
+magma_int_t magma_thread_team_run(
+    magma_int_t nthread,
+    magma_thread_team_func_t func, void* args, size_t argsize );
+
+void magma_thread_team_finalize();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif        //  #ifndef MAGMA_THREAD_TEAM_H
@@ -9,6 +9,7 @@
 */
 
 #include "thread_queue.hpp"
+#include "magma_atomic.h"
 #include "common_magma.h"  // after thread_queue.hpp
 
 // If err, prints error and throws exception.
@@ -31,13 +32,20 @@ static void check( int err )
     Typical use:
     A main thread creates the queue and tells it to launch worker threads. Then
     the main thread inserts (pushes) tasks into the queue. Threads will execute
-    the tasks. No dependencies are tracked. The main thread can sync the queue,
+    the tasks. The main thread can sync the queue,
     waiting for all current tasks to finish, and then insert more tasks into the
     queue. When finished, the main thread calls quit or simply destructs the
     queue, which will exit all worker threads.
     
     Tasks are sub-classes of magma_task. They must implement the run() function.
     
+    By default, no dependencies are tracked. Instead of a sync between phases,
+    a task can declare, before it is pushed, data regions that it reads or
+    writes (magma_task::reads, magma_task::writes), or explicit predecessor
+    tasks (magma_task::depends_on). The queue orders tasks that access the same
+    region as read-after-write, write-after-read, and write-after-write, and
+    releases each task as soon as its predecessors finish.
+    
     Example
     -------
     @code
@@ -75,6 +83,26 @@ static void check( int err )
         }
         queue.quit();  // [optional] explicitly exit worker threads
     }
+    
+    // same, but each task2( i, j ) waits only for task1( i ),
+    // which writes x[i], instead of for all task1.
+    void master_dep( int n, double* x ) {
+        magma_thread_queue queue;
+        queue.launch( 12 );  // 12 worker threads
+        for( int i=0; i < n; ++i ) {
+            magma_task* t = new task1( i );
+            t->writes( &x[i] );
+            queue.push_task( t );
+        }
+        for( int i=0; i < n; ++i ) {
+            for( int j=0; j < i; ++j ) {
+                magma_task* t = new task2( i, j );
+                t->reads( &x[i] );
+                queue.push_task( t );
+            }
+        }
+        queue.quit();
+    }
     @endcode
     
     This is similar to python's queue class, but also implements worker threads
@@ -84,25 +112,127 @@ static void check( int err )
 
 
 // ---------------------------------------------
-/// Thread's main routine, executed by pthread_create.
-/// Executes tasks from queue (given as arg), until a NULL task is returned.
+/// Bounded, lock-free, multi-producer, multi-consumer ring of tasks,
+/// after Dmitry Vyukov's bounded MPMC queue. Each slot holds a sequence number
+/// that says whether it is ready to be written (seq == pos) or
+/// read (seq == pos+1) at position pos, so push and pop each need only
+/// one compare-and-swap on their own index.
+/// Indices are padded to separate cache lines to avoid false sharing
+/// between the pushing master and the popping workers.
+class magma_task_ring
+{
+public:
+    enum { capacity = 1024 };  // must be power of 2
+    
+    magma_task_ring():
+        head( 0 ),
+        tail( 0 )
+    {
+        for( long i=0; i < capacity; ++i ) {
+            cells[i].seq  = i;
+            cells[i].task = NULL;
+        }
+    }
+    
+    /// @return true if task was inserted, false if ring is full.
+    bool push( magma_task* task )
+    {
+        long pos = magma_atomic_load( &head );
+        while( true ) {
+            cell* c = &cells[ pos & (capacity-1) ];
+            long diff = magma_atomic_load( &c->seq ) - pos;
+            if ( diff == 0 ) {
+                if ( magma_atomic_cas( &head, pos, pos+1 )) {
+                    c->task = task;
+                    magma_atomic_store( &c->seq, pos+1 );
+                    return true;
+                }
+            }
+            else if ( diff < 0 ) {
+                return false;  // full
+            }
+            pos = magma_atomic_load( &head );
+        }
+    }
+    
+    /// @return oldest task, or NULL if ring is empty.
+    magma_task* pop()
+    {
+        long pos = magma_atomic_load( &tail );
+        while( true ) {
+            cell* c = &cells[ pos & (capacity-1) ];
+            long diff = magma_atomic_load( &c->seq ) - (pos+1);
+            if ( diff == 0 ) {
+                if ( magma_atomic_cas( &tail, pos, pos+1 )) {
+                    magma_task* task = c->task;
+                    magma_atomic_store( &c->seq, pos + capacity );
+                    return task;
+                }
+            }
+            else if ( diff < 0 ) {
+                return NULL;  // empty
+            }
+            pos = magma_atomic_load( &tail );
+        }
+    }
+    
+private:
+    struct cell {
+        volatile long seq;
+        magma_task*   task;
+    };
+    
+    char          pad0[64];
+    volatile long head;        ///<  next position to push
+    char          pad1[64];
+    volatile long tail;        ///<  next position to pop
+    char          pad2[64];
+    cell          cells[ capacity ];
+};
+
+
+// ---------------------------------------------
+/// Per-worker state: the worker's ring of tasks, and a flag, mutex, and
+/// condition variable for sleeping when there is no work anywhere.
+/// parked is set by the worker before sleeping, and cleared (with cas)
+/// by whichever thread wakes it; only that thread decrements nparked.
+struct magma_thread_worker
+{
+    magma_thread_queue* queue;
+    magma_int_t         index;
+    pthread_t           thread;
+    magma_task_ring     ring;
+    volatile long       parked;
+    pthread_mutex_t     mutex;
+    pthread_cond_t      cond;
+};
+
+// number of times an idle worker re-scans the rings before going to sleep
+static const int spin_count = 32;
+
+
+// ---------------------------------------------
+/// Thread's main routine, executed by the thread team.
+/// Executes tasks from queue, until a NULL task is returned.
 /// Deletes each task when it is done.
-/// @param[in,out] arg    magma_thread_queue to get tasks from.
+/// @param[in,out] arg    magma_thread_worker, which points to the
+///                       magma_thread_queue to get tasks from.
 extern "C"
 void* magma_thread_main( void* arg )
 {
-    magma_thread_queue* queue = (magma_thread_queue*) arg;
+    magma_thread_worker* worker = (magma_thread_worker*) arg;
+    magma_thread_queue*  queue  = worker->queue;
     magma_task* task;
     
+    worker->thread = pthread_self();
     while( true ) {
-        task = queue->pop_task();
+        task = queue->pop_task( worker->index );
         if ( task == NULL ) {
             break;
         }
         
         task->run();
-        queue->task_done();
-        delete task;
+        queue->task_done( task, worker->index );  // may delete task
         task = NULL;
     }
     
@@ -110,17 +240,106 @@ void* magma_thread_main( void* arg )
 }
 
 
+// ---------------------------------------------
+// Spin lock protecting a task's done flag and successors list.
+// It is held only for a push_back or swap, so it is never contended for long.
+static void task_lock( volatile long* lock )
+{
+    while( ! magma_atomic_cas( lock, 0, 1 )) {
+        magma_cpu_relax();
+    }
+}
+
+static void task_unlock( volatile long* lock )
+{
+    magma_atomic_store( lock, 0 );
+}
+
+
+// ---------------------------------------------
+/// Creates task with no dependencies.
+magma_task::magma_task():
+    npred( 1 ),  // released when pushed
+    nref ( 1 ),  // released after run
+    lock ( 0 ),
+    done ( false ),
+    successors(),
+    regions()
+{}
+
+
+/// Declares that this task must wait for pred to finish.
+/// Must be called before pred is pushed, since afterwards pred may finish
+/// and be deleted at any time; for tasks already pushed, use data regions.
+/// @param[in,out] pred    Predecessor task.
+void magma_task::depends_on( magma_task* pred )
+{
+    assert( pred != this );
+    task_lock( &pred->lock );
+    if ( ! pred->done ) {
+        pred->successors.push_back( this );
+        magma_atomic_fetch_add( &npred, 1 );
+    }
+    task_unlock( &pred->lock );
+}
+
+
+/// Declares that this task reads region; it will run after the previous
+/// task that writes region, and before the next task that writes region.
+/// Must be called before this task is pushed.
+/// @param[in] region    Address identifying data region.
+void magma_task::reads( const void* region )
+{
+    regions.push_back( std::make_pair( region, false ));
+}
+
+
+/// Declares that this task writes (or reads and writes) region; it will run
+/// after all previous tasks that read or write region.
+/// Must be called before this task is pushed.
+/// @param[in] region    Address identifying data region.
+void magma_task::writes( const void* region )
+{
+    regions.push_back( std::make_pair( region, true ));
+}
+
+
+/// Adds a reference to task.
+/// A task holds one reference for its execution, and one for each time it is
+/// recorded in the queue's region table; it is deleted when all are released.
+void magma_task::retain()
+{
+    magma_atomic_fetch_add( &nref, 1 );
+}
+
+
+/// Releases one reference to task, deleting it if that was the last one.
+void magma_task::release()
+{
+    if ( magma_atomic_fetch_add( &nref, -1 ) == 1 ) {
+        delete this;
+    }
+}
+
+
 // ---------------------------------------------
 /// Creates queue with NO threads. Use \ref launch to create threads.
 magma_thread_queue::magma_thread_queue():
-    q        (),
+    workers  ( NULL  ),
+    overflow (),
+    regions  (),
+    noverflow( 0     ),
     quit_flag( false ),
     ntask    ( 0     ),
-    threads  ( NULL  ),
+    nparked  ( 0     ),
+    next     ( 0     ),
     nthread  ( 0     )
 {
+    job.nthread = 0;
+    job.on_team = 0;
+    job.threads = NULL;
+    job.adhoc   = NULL;
     check( pthread_mutex_init( &mutex,      NULL ));
-    check( pthread_cond_init(  &cond,       NULL ));
     check( pthread_cond_init(  &cond_ntask, NULL ));
 }
 
@@ -130,130 +349,340 @@ magma_thread_queue::~magma_thread_queue()
 {
     quit();
     check( pthread_mutex_destroy( &mutex ));
-    check( pthread_cond_destroy( &cond ));
     check( pthread_cond_destroy( &cond_ntask ));
 }
 
 
-/// Creates threads.
+/// Starts worker threads, on the persistent thread team if it is free.
 /// @param[in] in_nthread    Number of threads to launch.
 void magma_thread_queue::launch( magma_int_t in_nthread )
 {
-    assert( threads == NULL );  // else launch was called previously
+    assert( workers == NULL );  // else launch was called previously
     nthread = in_nthread;
     if ( nthread < 1 ) {
         nthread = 1;
     }
-    threads = new pthread_t[ nthread ];
+    workers = new magma_thread_worker[ nthread ];
     for( magma_int_t i=0; i < nthread; ++i ) {
-        check( pthread_create( &threads[i], NULL, magma_thread_main, this ));
-        //printf( "launch %d (%lx)\n", i, (long) threads[i] );
+        workers[i].queue  = this;
+        workers[i].index  = i;
+        workers[i].parked = 0;
+        check( pthread_mutex_init( &workers[i].mutex, NULL ));
+        check( pthread_cond_init(  &workers[i].cond,  NULL ));
+    }
+    magma_int_t info = magma_thread_team_start( &job, nthread, magma_thread_main,
+                                                workers, sizeof(magma_thread_worker) );
+    if ( info != MAGMA_SUCCESS ) {
+        fprintf( stderr, "Error: cannot start %d threads (%d)\n", (int) nthread, (int) info );
+        throw std::exception();
     }
 }
 
 
 /// Add task to queue. Task must be allocated with C++ new.
 /// Increments number of outstanding tasks.
-/// Signals threads that are waiting in pop_task.
+/// If task declared data regions, adds edges from the previous tasks that
+/// accessed those regions. If task has no unfinished predecessors,
+/// it is enqueued immediately; otherwise the worker that finishes its
+/// last predecessor enqueues it.
 /// @param[in] task    Task to queue.
 void magma_thread_queue::push_task( magma_task* task )
 {
-    check( pthread_mutex_lock( &mutex ));
-    if ( quit_flag ) {
+    if ( magma_atomic_load( &quit_flag )) {
         fprintf( stderr, "Error: push_task() called after quit()\n" );
         throw std::exception();
     }
-    q.push( task );
-    ntask += 1;
-    //printf( "push; ntask %d\n", ntask );
-    check( pthread_cond_broadcast( &cond ));
-    check( pthread_mutex_unlock( &mutex ));
+    assert( workers != NULL );  // else launch was not called
+    
+    // increment ntask before task is visible, so sync can't miss it
+    magma_atomic_fetch_add( &ntask, 1 );
+    
+    if ( ! task->regions.empty() ) {
+        check( pthread_mutex_lock( &mutex ));
+        for( size_t i=0; i < task->regions.size(); ++i ) {
+            region_state& r = regions[ task->regions[i].first ];
+            if ( r.writer != NULL && r.writer != task ) {
+                task->depends_on( r.writer );
+            }
+            if ( task->regions[i].second ) {
+                // write: wait for last writer and all readers since then
+                for( size_t j=0; j < r.readers.size(); ++j ) {
+                    if ( r.readers[j] != task ) {
+                        task->depends_on( r.readers[j] );
+                    }
+                    r.readers[j]->release();
+                }
+                r.readers.clear();
+                if ( r.writer != NULL ) {
+                    r.writer->release();
+                }
+                r.writer = task;
+            }
+            else {
+                // read: wait for last writer only
+                r.readers.push_back( task );
+            }
+            task->retain();
+        }
+        task->regions.clear();
+        check( pthread_mutex_unlock( &mutex ));
+    }
+    
+    // remove the +1 that held task back until it was pushed
+    if ( magma_atomic_fetch_add( &task->npred, -1 ) == 1 ) {
+        magma_int_t index = magma_atomic_fetch_add( &next, 1 ) % nthread;
+        enqueue( task, index );
+    }
+}
+
+
+/// Inserts a ready task into worker index's ring, without locking;
+/// if that ring is full, tries the other rings, and if all rings are full,
+/// inserts into the (locked) overflow queue.
+/// Wakes at most one sleeping worker, preferring the ring's owner.
+/// @param[in] task     Task with no unfinished predecessors.
+/// @param[in] index    Preferred worker.
+void magma_thread_queue::enqueue( magma_task* task, magma_int_t index )
+{
+    bool pushed = false;
+    for( magma_int_t i=0; i < nthread && ! pushed; ++i ) {
+        magma_int_t j = (index + i) % nthread;
+        if ( workers[j].ring.push( task )) {
+            index  = j;
+            pushed = true;
+        }
+    }
+    if ( ! pushed ) {
+        check( pthread_mutex_lock( &mutex ));
+        overflow.push( task );
+        magma_atomic_fetch_add( &noverflow, 1 );
+        check( pthread_mutex_unlock( &mutex ));
+    }
+    //printf( "push; ntask %ld\n", ntask );
+    
+    // pairs with the fence in pop_task: either we see a parked worker,
+    // or that worker sees our task when it re-scans the rings.
+    magma_atomic_fence();
+    if ( magma_atomic_load( &nparked ) > 0 ) {
+        wake_one( index );
+    }
+}
+
+
+/// Wakes one sleeping worker, if any, trying worker index first.
+/// @param[in] index    Preferred worker to wake.
+void magma_thread_queue::wake_one( magma_int_t index )
+{
+    for( magma_int_t i=0; i < nthread; ++i ) {
+        magma_thread_worker* w = &workers[ (index + i) % nthread ];
+        if ( magma_atomic_load( &w->parked ) && magma_atomic_cas( &w->parked, 1, 0 )) {
+            magma_atomic_fetch_add( &nparked, -1 );
+            // lock so the signal can't get in between the worker's
+            // check of parked and its cond_wait
+            check( pthread_mutex_lock( &w->mutex ));
+            check( pthread_cond_signal( &w->cond ));
+            check( pthread_mutex_unlock( &w->mutex ));
+            return;
+        }
+    }
+}
+
+
+/// Finds a task without blocking: first from worker's own ring,
+/// then from the overflow queue, then by stealing from other workers' rings.
+/// @param[in] index    Worker index.
+/// @return task, or NULL if no tasks were found.
+magma_task* magma_thread_queue::find_task( magma_int_t index )
+{
+    magma_task* task = workers[index].ring.pop();
+    if ( task != NULL ) {
+        return task;
+    }
+    
+    if ( magma_atomic_load( &noverflow ) > 0 ) {
+        check( pthread_mutex_lock( &mutex ));
+        if ( ! overflow.empty()) {
+            task = overflow.front();
+            overflow.pop();
+            magma_atomic_fetch_add( &noverflow, -1 );
+        }
+        check( pthread_mutex_unlock( &mutex ));
+        if ( task != NULL ) {
+            return task;
+        }
+    }
+    
+    for( magma_int_t i=1; i < nthread; ++i ) {
+        task = workers[ (index + i) % nthread ].ring.pop();
+        if ( task != NULL ) {
+            return task;
+        }
+    }
+    return NULL;
 }
 
 
 /// Get next task from queue.
+/// @param[in] index    Index of calling worker.
 /// @return next task, blocking until a task is inserted if necesary.
 /// @return NULL if queue is empty *and* \ref quit has been called.
 ///
+/// Spins briefly re-scanning the rings (first with pause, then yielding
+/// the cpu), then parks the worker
+/// on its own condition variable until \ref push_task or \ref quit wakes it.
+///
 /// This does *not* decrement number of outstanding tasks;
 /// thread should call \ref task_done when task is completed.
-magma_task* magma_thread_queue::pop_task()
+magma_task* magma_thread_queue::pop_task( magma_int_t index )
 {
-    magma_task* task = NULL;
-    check( pthread_mutex_lock( &mutex ));
-    while( q.empty() && ! quit_flag ) {
-        check( pthread_cond_wait( &cond, &mutex ));
-    }
-    // q has item or quit is set (or both)
-    if ( ! q.empty()) {
-        task = q.front();
-        q.pop();
+    magma_thread_worker* w = &workers[index];
+    magma_task* task;
+    while( true ) {
+        for( int spin=0; spin < spin_count; ++spin ) {
+            task = find_task( index );
+            if ( task != NULL ) {
+                return task;
+            }
+            if ( magma_atomic_load( &quit_flag )) {
+                return NULL;
+            }
+            if ( spin < spin_count/2 ) {
+                magma_cpu_relax();
+            }
+            else {
+                magma_yield();
+            }
+        }
+        
+        // announce we are going to sleep, then re-scan once more,
+        // in case a task was pushed before push_task could see us parked.
+        magma_atomic_store( &w->parked, 1 );
+        magma_atomic_fetch_add( &nparked, 1 );
+        magma_atomic_fence();
+        
+        task = find_task( index );
+        if ( task != NULL || magma_atomic_load( &quit_flag )) {
+            // un-park, unless someone else already woke us
+            if ( magma_atomic_cas( &w->parked, 1, 0 )) {
+                magma_atomic_fetch_add( &nparked, -1 );
+            }
+            if ( task != NULL ) {
+                return task;
+            }
+            // quit is set; loop around to drain anything left, then return NULL
+            continue;
+        }
+        
+        check( pthread_mutex_lock( &w->mutex ));
+        while( magma_atomic_load( &w->parked )) {
+            check( pthread_cond_wait( &w->cond, &w->mutex ));
+        }
+        check( pthread_mutex_unlock( &w->mutex ));
     }
-    //printf( "pop;  ntask %d\n", ntask );
-    check( pthread_mutex_unlock( &mutex ));
-    return task;
 }
 
 
-/// Marks task as finished, decrementing number of outstanding tasks.
-/// Signals threads that are waiting in \ref sync.
-void magma_thread_queue::task_done()
+/// Marks task as finished: enqueues successors that are now ready onto
+/// this worker's ring, then decrements number of outstanding tasks.
+/// Signals threads that are waiting in \ref sync, when ntask reaches zero.
+/// Releases the task's execution reference, which may delete it.
+/// @param[in,out] task     Task that finished.
+/// @param[in]     index    Index of calling worker.
+void magma_thread_queue::task_done( magma_task* task, magma_int_t index )
 {
-    check( pthread_mutex_lock( &mutex ));
-    ntask -= 1;
-    //printf( "fini; ntask %d\n", ntask );
-    check( pthread_cond_broadcast( &cond_ntask ));
-    check( pthread_mutex_unlock( &mutex ));
+    std::vector< magma_task* > successors;
+    task_lock( &task->lock );
+    task->done = true;
+    successors.swap( task->successors );
+    task_unlock( &task->lock );
+    
+    for( size_t i=0; i < successors.size(); ++i ) {
+        if ( magma_atomic_fetch_add( &successors[i]->npred, -1 ) == 1 ) {
+            enqueue( successors[i], index );
+        }
+    }
+    
+    if ( magma_atomic_fetch_add( &ntask, -1 ) == 1 ) {
+        //printf( "fini; ntask %ld\n", ntask );
+        check( pthread_mutex_lock( &mutex ));
+        check( pthread_cond_broadcast( &cond_ntask ));
+        check( pthread_mutex_unlock( &mutex ));
+    }
+    task->release();
 }
 
 
 /// Block until all outstanding tasks have been finished.
 /// Threads continue to be alive; more tasks can be pushed after sync.
+/// Since all tasks are finished, this also forgets all data regions,
+/// so tasks pushed after sync have no dependencies on tasks before it.
 void magma_thread_queue::sync()
 {
     check( pthread_mutex_lock( &mutex ));
-    //printf( "sync; ntask %d [start]\n", ntask );
-    while( ntask > 0 ) {
+    //printf( "sync; ntask %ld [start]\n", ntask );
+    while( magma_atomic_load( &ntask ) > 0 ) {
         check( pthread_cond_wait( &cond_ntask, &mutex ));
-        //printf( "sync; ntask %d\n", ntask );
+        //printf( "sync; ntask %ld\n", ntask );
     }
-    //printf( "sync; ntask %d [done]\n", ntask );
+    //printf( "sync; ntask %ld [done]\n", ntask );
+    clear_regions();
     check( pthread_mutex_unlock( &mutex ));
 }
 
 
-/// Sets quit_flag, so \ref pop_task will return NULL once queue is empty,
+/// Releases the region table's references to tasks. Called with mutex locked.
+void magma_thread_queue::clear_regions()
+{
+    std::map< const void*, region_state >::iterator iter;
+    for( iter = regions.begin(); iter != regions.end(); ++iter ) {
+        region_state& r = iter->second;
+        for( size_t j=0; j < r.readers.size(); ++j ) {
+            r.readers[j]->release();
+        }
+        if ( r.writer != NULL ) {
+            r.writer->release();
+        }
+    }
+    regions.clear();
+}
+
+
+/// Waits for outstanding tasks, including any held back by dependencies,
+/// then sets quit_flag, so \ref pop_task will return NULL,
 /// telling threads to exit.
-/// Signals all threads that are waiting in pop_task.
-/// Waits for all threads to exit (i.e., joins them).
+/// Wakes all threads that are sleeping in pop_task.
+/// Waits for all threads to exit (i.e., joins them, or returns them to the team).
 /// It is safe to call quit multiple times -- the first time all the threads are
 /// joined; subsequent times it does nothing.
 /// (Destructor also calls quit, but you may prefer to call it explicitly.)
 void magma_thread_queue::quit()
 {
-    // first, set quit_flag and signal waiting threads
-    bool join = true;
-    check( pthread_mutex_lock( &mutex ));
-    //printf( "quit %d\n", quit_flag );
-    if ( quit_flag ) {
-        join = false;  // quit previously called; don't join again.
+    if ( magma_atomic_load( &quit_flag )) {
+        return;  // quit previously called; don't join again.
     }
-    else {
-        quit_flag = true;
-        check( pthread_cond_broadcast( &cond ));
+    if ( workers != NULL ) {
+        sync();
     }
-    check( pthread_mutex_unlock( &mutex ));
     
-    // next, join all threads
-    if ( join ) {
-        assert( threads != NULL );
-        for( magma_int_t i=0; i < nthread; ++i ) {
-            check( pthread_join( threads[i], NULL ));
-            //printf( "joined %d (%lx)\n", i, (long) threads[i] );
-        }
-        delete[] threads;
-        threads = NULL;
+    // first, set quit_flag and wake sleeping threads
+    //printf( "quit %ld\n", quit_flag );
+    if ( ! magma_atomic_cas( &quit_flag, 0, 1 )) {
+        return;  // quit previously called; don't join again.
+    }
+    magma_atomic_fence();
+    for( magma_int_t i=0; i < nthread; ++i ) {
+        wake_one( i );
+    }
+    
+    // next, wait for all threads to exit
+    magma_thread_team_wait( &job );
+    
+    for( magma_int_t i=0; i < nthread; ++i ) {
+        check( pthread_mutex_destroy( &workers[i].mutex ));
+        check( pthread_cond_destroy( &workers[i].cond ));
     }
+    delete[] workers;
+    workers = NULL;
 }
 
 
@@ -261,7 +690,7 @@ void magma_thread_queue::quit()
 magma_int_t magma_thread_queue::get_thread_index( pthread_t thread ) const
 {
     for( magma_int_t i=0; i < nthread; ++i ) {
-        if ( pthread_equal( thread, threads[i] )) {
+        if ( pthread_equal( thread, workers[i].thread )) {
             return i;
         }
     }
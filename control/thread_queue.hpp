@@ -13,8 +13,12 @@
 
 #include <pthread.h>
 #include <queue>
+#include <vector>
+#include <map>
+#include <utility>
 
 #include "magma.h"
+#include "magma_thread_team.h"
 
 
 // ---------------------------------------------
@@ -23,22 +27,64 @@ void* magma_thread_main( void* arg );
 
 
 // ---------------------------------------------
+class magma_thread_queue;
+
+// ---------------------------------------------
+// Task to execute in a magma_thread_queue.
+//
+// Optionally, before it is pushed, a task can declare dependencies, either
+// explicitly on predecessor tasks (depends_on), or implicitly on data regions
+// it reads or writes. A region is identified by its address, e.g., a pointer
+// to the first element of a column or tile; regions are not checked for
+// overlap, so the same address must be used by all tasks touching that data.
+// A task is released to the worker threads as soon as all its
+// predecessors finish.
 class magma_task
 {
 public:
-    magma_task() {}
+    magma_task();
     virtual ~magma_task() {}
     
     virtual void run() = 0;  // pure virtual function to execute task
+    
+    void depends_on( magma_task* pred );
+    void reads ( const void* region );
+    void writes( const void* region );
+    
+private:
+    friend class magma_thread_queue;
+    
+    void retain();
+    void release();
+    
+    volatile long npred;         ///<  number of unfinished predecessors, plus one until pushed
+    volatile long nref;          ///<  number of references held by queue; deleted when 0
+    volatile long lock;          ///<  spin lock for done and successors
+    bool          done;          ///<  set when task finishes, after which no edges can be added
+    std::vector< magma_task* > successors;                 ///<  tasks waiting on this task
+    std::vector< std::pair< const void*, bool > > regions;  ///<  (region, is_write) declared before push
 };
 
 
+// ---------------------------------------------
+// per-worker state, defined in thread_queue.cpp
+struct magma_thread_worker;
+
+
 // ---------------------------------------------
 // Thread pool with multi-producer, multi-consumer queue.
 //
 // This is similar to python's queue class, but also implements worker threads
 // and adds quit mechanism.
 // sync is like python's join. Threads do not exit, so I find join to be a misleading name.
+//
+// Internally, each worker has its own lock-free ring of tasks; tasks are pushed
+// round-robin onto the rings, and idle workers steal from other workers' rings.
+// Idle workers sleep, and each push wakes at most one of them.
+// Tasks with unfinished predecessors are held back, then put onto the ring of
+// the worker that finished their last predecessor.
+// Workers run on the persistent thread team (see magma_thread_team.h) when it
+// is free, so repeated launch and quit don't create and join threads.
 class magma_thread_queue
 {
 public:
@@ -52,19 +98,35 @@ public:
     
 protected:
     friend void* magma_thread_main( void* arg );
-    magma_task* pop_task();
-    void task_done();
+    magma_task* pop_task( magma_int_t index );
+    void task_done( magma_task* task, magma_int_t index );
     
     magma_int_t get_thread_index( pthread_t thread ) const;
     
 private:
-    std::queue< magma_task* > q;  ///<  queue of tasks
-    bool            quit_flag;    ///<  quit() sets this to true; after this, pop returns NULL
-    magma_int_t     ntask;        ///<  number of unfinished tasks (in queue or currently executing)
-    pthread_mutex_t mutex;        ///<  mutex lock for queue, quit, ntask
-    pthread_cond_t  cond;         ///<  condition variable for changes to queue and quit (see push, pop, quit)
+    magma_task* find_task( magma_int_t index );
+    void enqueue( magma_task* task, magma_int_t index );
+    void wake_one( magma_int_t index );
+    void clear_regions();
+    
+    // last writer and subsequent readers of each data region
+    struct region_state {
+        region_state(): writer( NULL ) {}
+        magma_task* writer;
+        std::vector< magma_task* > readers;
+    };
+    
+    magma_thread_worker* workers;     ///<  array of per-worker rings and wakeup state
+    std::queue< magma_task* > overflow;  ///<  tasks that didn't fit into any ring
+    std::map< const void*, region_state > regions;  ///<  data regions of tasks pushed since last sync
+    volatile long   noverflow;    ///<  number of tasks in overflow
+    volatile long   quit_flag;    ///<  quit() sets this to true; after this, pop returns NULL
+    volatile long   ntask;        ///<  number of unfinished tasks (in queue or currently executing)
+    volatile long   nparked;      ///<  number of workers sleeping in pop_task
+    volatile long   next;         ///<  next worker to push to, round-robin
+    pthread_mutex_t mutex;        ///<  mutex lock for overflow, regions, and sync
     pthread_cond_t  cond_ntask;   ///<  condition variable for changes to ntask (see sync, task_done)
-    pthread_t*      threads;      ///<  array of threads
+    magma_thread_team_job_t job;  ///<  worker threads, on the thread team or created by launch
     magma_int_t     nthread;      ///<  number of threads
 };
 
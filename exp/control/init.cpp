@@ -115,9 +115,12 @@ magma_init( void *params, void* (*func)(void *a), magma_int_t nthread, magma_int
       }
     
     context->nb = -1;
+    context->lookahead = 1;
     for(i = 1; i<argc; i++)
       if (strcmp("-b", argv[i])==0)
     context->nb = atoi(argv[++i]);
+      else if (strcmp("-l", argv[i])==0)
+    context->lookahead = atoi(argv[++i]);
     
     return context;
 }
@@ -157,3 +160,46 @@ magma_finalize( magma_context *cntxt)
 
   free(cntxt);
 }
+
+
+extern "C" magma_int_t
+magma_task_priority( magma_context *cntxt, magma_int_t dist)
+{
+/*  -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+    Purpose
+    =======
+    This function returns the QUARK priority of a task of the multicore
+    factorizations. DIST is the number of block columns between the
+    panel the task uses and the block column it updates; the panel
+    factorization itself has DIST = 0. The tasks on the critical path
+    are those with small DIST: with the lookahead depth L of the
+    context, the tasks with DIST <= L get priorities decreasing with
+    DIST, all higher than that of the other tasks, which is 0. QUARK
+    keeps the ready tasks in one list per power of two of the priority,
+    so the priorities are powers of two.
+
+    Arguments
+    =========
+    CNTXT  (input) MAGMA_CONTEXT
+           Pointer to the MAGMA hardware context
+    DIST   (input) INTEGER
+           Distance of the task from the panel, DIST >= 0
+    ===================================================================== */
+
+  /* the priorities must fit in the 32 lists of QUARK */
+  magma_int_t lookahead = cntxt->lookahead;
+  if (lookahead < 0)
+    lookahead = 0;
+  if (lookahead > 29)
+    lookahead = 29;
+
+  if (dist < 0 || dist > lookahead)
+    return 0;
+
+  return 1 << (lookahead + 1 - dist);
+}
@@ -39,6 +39,10 @@ typedef struct context
   /* Block size, internally used for some algorithms */
   magma_int_t nb;
 
+  /* Lookahead depth of the multicore factorizations: the number of
+     block columns after the panel whose updates are prioritized */
+  magma_int_t lookahead;
+
   /* Pointer to other global algorithm-dependent parameters */
   void *params;
 
@@ -215,6 +219,7 @@ void magma_xerbla( const char *name, magma_int_t info );
 magma_context *magma_init(void *, void* (*func)(void *a), magma_int_t nthread, magma_int_t ncpu, 
                           magma_int_t ngpu, magma_int_t argc, char **argv);
 void magma_finalize(magma_context *cntxt);
+magma_int_t magma_task_priority(magma_context *cntxt, magma_int_t dist);
 void auto_tune(char algorithm, char precision, magma_int_t ncores, magma_int_t ncorespsocket,
                magma_int_t m, magma_int_t n, magma_int_t *nb, magma_int_t *ob, magma_int_t *ib,
                magma_int_t *nthreads, magma_int_t *nquarkthreads);
@@ -54,6 +54,27 @@ magma_int_t magma_zgeqrf_mc(magma_context *cntxt, magma_int_t *m, magma_int_t *n
                           cuDoubleComplex *A, magma_int_t *lda,
                           cuDoubleComplex *tau, cuDoubleComplex *work,
                           magma_int_t *lwork, magma_int_t *info);
+magma_int_t magma_zpotrf_tile_mc( magma_context *cntxt, char *uplo, magma_int_t *n, cuDoubleComplex *A,
+                          magma_int_t *lda, magma_int_t *info);
+magma_int_t magma_zgetrf_tile_mc( magma_context *cntxt, magma_int_t *m, magma_int_t *n, cuDoubleComplex *A,
+                          magma_int_t *lda, magma_int_t *ipiv, magma_int_t *info);
+magma_int_t magma_zgeqrf_tile_mc(magma_context *cntxt, magma_int_t *m, magma_int_t *n,
+                          cuDoubleComplex *A, magma_int_t *lda,
+                          cuDoubleComplex *tau, cuDoubleComplex *work,
+                          magma_int_t *lwork, magma_int_t *info);
+magma_int_t magma_zlapack_to_tile_mc(magma_context *cntxt, magma_int_t *m, magma_int_t *n,
+                          cuDoubleComplex *A, magma_int_t *lda,
+                          cuDoubleComplex *At, magma_int_t *ldt, magma_int_t *info);
+magma_int_t magma_ztile_to_lapack_mc(magma_context *cntxt, magma_int_t *m, magma_int_t *n,
+                          cuDoubleComplex *At, magma_int_t *ldt,
+                          cuDoubleComplex *A, magma_int_t *lda, magma_int_t *info);
+void        magma_ztile_laswp( magma_int_t n, cuDoubleComplex *A, magma_int_t lda,
+                          magma_int_t stride, magma_int_t nb,
+                          magma_int_t k2, magma_int_t *ipiv);
+void        magma_ztile_copy( magma_int_t get, magma_int_t m, magma_int_t n,
+                          cuDoubleComplex *A, magma_int_t lda,
+                          magma_int_t stride, magma_int_t nb,
+                          cuDoubleComplex *B, magma_int_t ldb);
 magma_int_t magma_zgetrf2(magma_int_t m, magma_int_t n, cuDoubleComplex *a, 
                           magma_int_t lda, magma_int_t *ipiv, magma_int_t *info);
 magma_int_t magma_zlatrd( char uplo, magma_int_t n, magma_int_t nb, cuDoubleComplex *a, 
@@ -57,6 +57,36 @@ static int string_compare(void* a, void* b)
 }
 
 
+/**
+ * Get an entry for the hash table, from the entries of deleted items
+ * if there are any, since tables that see many inserts and deletes
+ * would otherwise call malloc and free for every item.
+ */
+
+static icl_entry_t *
+icl_entry_get(icl_hash_t *ht)
+{
+    icl_entry_t *curr = ht->free_entries;
+
+    if(curr != NULL)
+        ht->free_entries = curr->next;
+    else
+        curr = (icl_entry_t*)malloc(sizeof(icl_entry_t));
+
+    return curr;
+}
+
+/**
+ * Keep the entry of a deleted item for reuse by the next insert.
+ */
+
+static void
+icl_entry_put(icl_hash_t *ht, icl_entry_t *curr)
+{
+    curr->next = ht->free_entries;
+    ht->free_entries = curr;
+}
+
 /**
  * Create a new hash table.
  *
@@ -77,6 +107,7 @@ icl_hash_create( int nbuckets, unsigned int (*hash_function)(void*), int (*hash_
     if(!ht) return NULL;
 
     ht->nentries = 0;
+    ht->free_entries = NULL;
     ht->buckets = (icl_entry_t**)malloc(nbuckets * sizeof(icl_entry_t*));
     assert(ht->buckets!=NULL);
     if(!ht->buckets) return NULL;
@@ -143,7 +174,7 @@ icl_hash_insert(icl_hash_t *ht, void* key, void *data)
             return(NULL); /* key already exists */
 
     /* if key was not found */
-    curr = (icl_entry_t*)malloc(sizeof(icl_entry_t));
+    curr = icl_entry_get(ht);
     assert(curr != NULL);
     if(!curr) return NULL;
 
@@ -194,7 +225,7 @@ icl_hash_update_insert(icl_hash_t *ht, void* key, void *data, void **olddata)
         }
 
     /* Since key was either not found, or found-and-removed, create and prepend new node */
-    curr = (icl_entry_t*)malloc(sizeof(icl_entry_t));
+    curr = icl_entry_get(ht);
     assert(curr!=NULL);
     if(curr == NULL) return NULL; /* out of memory */
 
@@ -240,7 +271,7 @@ int icl_hash_delete(icl_hash_t *ht, void* key, void (*free_key)(void*), void (*f
             if (*free_key && curr->key) (*free_key)(curr->key);
             if (*free_data && curr->data) (*free_data)(curr->data);
             ht->nentries++;
-            free(curr);
+            icl_entry_put(ht, curr);
             return 0;
         }
         prev = curr;
@@ -277,6 +308,12 @@ icl_hash_destroy(icl_hash_t *ht, void (*free_key)(void*), void (*free_data)(void
         }
     }
 
+    for (curr=ht->free_entries; curr!=NULL; ) {
+        next=curr->next;
+        free(curr);
+        curr=next;
+    }
+
     if(ht->buckets) free(ht->buckets);
     if(ht) free(ht);
 
@@ -34,6 +34,28 @@ icl_list_new()
   return(node);
 }
 
+/**
+ * Initialize a list head provided by the caller, e.g., embedded in
+ * another structure.  Such a list must not be destroyed with
+ * icl_list_destroy.
+ *
+ * @param head -- the list head to be initialized
+ *
+ * @returns pointer to the list head.
+ */
+
+icl_list_t *
+icl_list_init(icl_list_t *head)
+{
+  if(!head) return NULL;
+
+  head->flink = NULL;
+  head->blink = head;
+  head->data = NULL;
+
+  return(head);
+}
+
 /**
  * Insert a new node after the specified node.
  *
@@ -56,6 +78,27 @@ icl_list_insert(icl_list_t *head, icl_list_t *pos, void *data)
 
   if(!node) return NULL;
 
+  return(icl_list_insert_node(head, pos, node, data));
+}
+
+/**
+ * Insert a node provided by the caller after the specified node.  The
+ * node must be removed with icl_list_unlink, not icl_list_delete.
+ *
+ * @param head -- the linked list
+ * @param pos -- points to the position of the new node (it will
+ *   be inserted after this node)
+ * @param node -- the node to be inserted
+ * @param data -- pointer to the data that is to be inserted
+ *
+ * @returns pointer to the node.  returns NULL on error.
+ */
+
+icl_list_t *
+icl_list_insert_node(icl_list_t *head, icl_list_t *pos, icl_list_t *node, void *data)
+{
+  if(!head || !pos || !node) return NULL;
+
   node->blink = pos;
   node->flink = pos->flink;
   node->data = data;
@@ -89,6 +132,28 @@ icl_list_delete(icl_list_t *head, icl_list_t *pos, void (*free_function)(void *)
   if(free_function && pos->data)
     (*free_function)(pos->data);
 
+  icl_list_unlink(head, pos);
+
+  free(pos);
+
+  return 0;
+}
+
+/**
+ * Remove the specified node from the list without freeing it.
+ *
+ * @param head -- the linked list containing the node to be removed
+ * @param pos -- the node to be removed
+ *
+ * @returns 0 on success, -1 on failure.
+ */
+
+int
+icl_list_unlink(icl_list_t *head, icl_list_t *pos)
+{
+  if (!pos || !head) return -1;
+  if (pos == head) return -1;
+
   pos->blink->flink = pos->flink;
 
   if(pos->flink)
@@ -96,8 +161,6 @@ icl_list_delete(icl_list_t *head, icl_list_t *pos, void (*free_function)(void *)
   else
     head->blink = pos->blink; /* pos at end of list */
 
-  free(pos);
-
   return 0;
 }
 
@@ -305,3 +368,19 @@ icl_list_append(icl_list_t *head, void *data)
 {
   return(icl_list_insert(head, head->blink, data));
 }
+
+/**
+ * Insert a node provided by the caller at the end of this list.
+ *
+ * @param head -- the linked list
+ * @param node -- the node to be inserted
+ * @param data -- the data to be inserted
+ *
+ * @returns pointer to the node.  returns NULL on error.
+ */
+
+icl_list_t *
+icl_list_append_node(icl_list_t *head, icl_list_t *node, void *data)
+{
+  return(icl_list_insert_node(head, head->blink, node, data));
+}
@@ -24,6 +24,7 @@ typedef struct icl_hash_s {
     int nbuckets;
     int nentries;
     icl_entry_t **buckets;
+    icl_entry_t *free_entries;
     unsigned int (*hash_function)(void*);
     int (*hash_key_compare)(void*, void*);
 } icl_hash_t;
@@ -24,7 +24,9 @@ typedef struct icl_list_s icl_list_t;
 
 icl_list_t
   * icl_list_new(),
+  * icl_list_init(icl_list_t *),
   * icl_list_insert(icl_list_t *, icl_list_t *, void *),
+  * icl_list_insert_node(icl_list_t *, icl_list_t *, icl_list_t *, void *),
   * icl_list_search(icl_list_t *, void *, int (*)(void*, void*)),
   * icl_list_first(icl_list_t *),
   * icl_list_last(icl_list_t *),
@@ -32,10 +34,12 @@ icl_list_t
   * icl_list_prev(icl_list_t *, icl_list_t *),
   * icl_list_concat(icl_list_t *, icl_list_t *),
   * icl_list_prepend(icl_list_t *, void *),
-  * icl_list_append(icl_list_t *, void *);
+  * icl_list_append(icl_list_t *, void *),
+  * icl_list_append_node(icl_list_t *, icl_list_t *, void *);
 
 int
   icl_list_delete(icl_list_t *, icl_list_t *, void (*)(void *)) ,
+  icl_list_unlink(icl_list_t *, icl_list_t *),
   icl_list_destroy(icl_list_t *, void (*)(void*)),
   icl_list_size(icl_list_t *);
 
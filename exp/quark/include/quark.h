@@ -152,6 +152,9 @@ void *QUARK_Args_Pop( void *args_list, void **last_arg);
 /* Utility function returning rank of the current thread */
 int QUARK_Thread_Rank(Quark *quark);
 
+/* Utility function returning the time a worker spent executing tasks */
+double QUARK_Worker_Busy_Time(Quark *quark, int rank);
+
 /* Packed task interface */
 /* Create a task data structure to hold arguments */
 Quark_Task *QUARK_Task_Init(Quark * quark, void (*function) (Quark *), Quark_Task_Flags *task_flags );
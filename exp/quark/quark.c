@@ -47,6 +47,7 @@ export QUARK_DOT_DAG_ENABLE=1
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <assert.h>
 #include <stdarg.h>
 #include <string.h>
@@ -77,7 +78,6 @@ export QUARK_DOT_DAG_ENABLE=1
 #include "icl_list.h"
 #include "icl_hash.h"
 #include "bsd_queue.h"
-#include "bsd_tree.h"
 #include "quark.h"
 #include "quark_unpack_args.h"
 
@@ -110,7 +110,9 @@ struct quark_s {
     pthread_attr_t thread_attr;   /* threads' attributes */
     int (*rank)();
     volatile int num_queued_tasks;
-    pthread_cond_t num_queued_tasks_cond;
+    volatile long long ready_epoch; /* incremented by every insertion into a ready list */
+    volatile long long num_parked; /* number of workers blocked in worker_park */
+    int idle_spin_max;            /* scans of all ready lists before a worker parks */
     int war_dependencies_enable;
 #define tasklevel_width_max_level 5000
     int dot_dag_enable;
@@ -119,6 +121,10 @@ struct quark_s {
     pthread_mutex_t dot_dag_mutex;
     pthread_mutex_t completed_tasks_mutex;
     struct completed_tasks_head_s *completed_tasks;
+    struct quark_task_s * volatile task_free_list; /* recycled tasks, pushed by any thread */
+    struct task_slab_s * volatile task_slabs; /* all task memory, freed in QUARK_Free */
+    struct address_set_node_s *address_set_node_free_list; /* protected by the address_set_mutex */
+    struct address_set_node_slab_s *address_set_node_slabs; /* protected by the address_set_mutex */
 };
 
 struct Quark_sequence_s {
@@ -127,17 +133,81 @@ struct Quark_sequence_s {
     struct ll_list_head_s *tasks_in_sequence;
 };
 
+/* Ring buffer of a ready list; grown by doubling, the smaller rings
+ * are kept in the retired list until the worker is deleted since
+ * other threads may still be reading them */
+typedef struct ready_ring_s {
+    long long size;               /* power of two */
+    void * volatile *slot;
+    struct ready_ring_s *retired;
+} ready_ring_t;
+
+/* Ready list for one priority bucket of a worker.  Only one thread
+ * inserts at a time (the one holding the address_set_mutex), at the
+ * tail; any thread takes from the head with a compare-and-swap, so
+ * neither the owner nor the thieves take a lock */
+typedef struct ready_list_s {
+    volatile long long head;      /* next entry to take */
+    volatile long long tail;      /* next entry to fill */
+    ready_ring_t * volatile ring;
+} ready_list_t;
+
+/* Priorities are grouped in buckets by their number of bits, so
+ * bucket 0 holds priority 0 and bucket 31 the priorities from 2^30 to
+ * INT_MAX.  Within a bucket, tasks are run in insertion order */
+#define QUARK_PRIORITY_BUCKETS 32
+#define QUARK_READY_RING_MIN_SIZE 64
+
+/* Scratch buffers kept by each worker for the next tasks that need
+ * scratch space, instead of a malloc and free for every task */
+#define QUARK_SCRATCH_CACHE_SIZE 8
+
+typedef struct scratch_buffer_s {
+    void *ptr;
+    int size;
+} scratch_buffer_t;
+
 typedef struct worker_s {
     pthread_t thread_id;
-    pthread_mutex_t ready_list_mutex;
-    struct task_priority_tree_head_s *ready_list;
-    volatile int ready_list_size;
+    ready_list_t ready_list[QUARK_PRIORITY_BUCKETS];
+    ready_list_t locked_list[QUARK_PRIORITY_BUCKETS]; /* tasks locked to this thread, never stolen */
+    volatile long long ready_list_size; /* tasks in both ready_list and locked_list */
+    pthread_mutex_t park_mutex;
+    pthread_cond_t park_cond;
+    volatile long long parked;    /* TRUE while blocked in worker_park */
+    int idle_spin;                /* current spin limit, adapted between 1 and quark->idle_spin_max */
+    Quark_Task *task_cache;       /* free tasks owned by this thread, for quark_task_new */
+    scratch_buffer_t scratch_cache[QUARK_SCRATCH_CACHE_SIZE];
+    int num_scratch_cached;
     Quark_Task *current_task_ptr;
     Quark *quark_ptr;
     volatile bool finalize;       /* termination flag */
     volatile bool executing_task;
+    double busy_time;             /* seconds spent executing tasks */
 } Worker;
 
+/* Tasks are allocated in slabs and recycled through free lists.  The
+ * arguments, dependencies and scratch records of a task, and the
+ * nodes of its lists, are carved from the arena at the end of the
+ * task; what does not fit goes to overflow chunks that are freed when
+ * the task is recycled.  So inserting a task usually needs no malloc
+ * at all. */
+#define QUARK_TASK_SLAB_SIZE 32
+#define QUARK_TASK_ARENA_SIZE 1024
+
+typedef struct task_arena_chunk_s {
+    struct task_arena_chunk_s *next;
+    double data[1];
+} task_arena_chunk_t;
+
+typedef struct completed_tasks_node_s {
+    struct quark_task_s *task;
+    int workerid;
+    TAILQ_ENTRY( completed_tasks_node_s ) entries;
+} completed_tasks_node_t;
+TAILQ_HEAD( completed_tasks_head_s, completed_tasks_node_s );
+typedef struct completed_tasks_head_s completed_tasks_head_t;
+
 typedef struct quark_task_s {
     pthread_mutex_t task_mutex;
     void (*function) (Quark *);    /* task function pointer */
@@ -157,8 +227,23 @@ typedef struct quark_task_s {
     Quark_Sequence *sequence;
     struct ll_list_node_s *ptr_to_task_in_sequence; /* convenience pointer to this task in the sequence */
     int task_thread_count;                /* Num of threads required by task */
+    icl_list_t args_list_head;    /* storage for the list heads */
+    icl_list_t dependency_list_head;
+    icl_list_t scratch_list_head;
+    completed_tasks_node_t completed_node; /* entry in quark->completed_tasks */
+    struct quark_task_s *next_free; /* next task in a free list */
+    char *arena_next;             /* next free byte in the arena */
+    size_t arena_left;            /* bytes left after arena_next */
+    task_arena_chunk_t *arena_chunks; /* overflow chunks of the arena */
+    double arena[QUARK_TASK_ARENA_SIZE/sizeof(double)];
 } Task;
 
+typedef struct task_slab_s {
+    struct task_slab_s *next;
+    int num_tasks;
+    Task task[1];
+} task_slab_t;
+
 typedef struct dependency_s {
     struct quark_task_s *task; /* pointer to parent task containing this dependency */
     void *address;              /* address of data */
@@ -172,12 +257,16 @@ typedef struct dependency_s {
     icl_list_t *task_args_list_node_ptr; /* convenience ptr to the task->args_list [node] to use for WAR address updates */
     icl_list_t *task_dependency_list_node_ptr; /* convenience ptr to the task->dependency_list [node] */
     volatile bool ready;        /* Data dependency is ready */
+    icl_list_t address_set_waiting_deps_node; /* storage for the list nodes */
+    icl_list_t task_dependency_list_node;
 } Dependency;
 
 typedef struct scratch_s {
     void *ptr;                  /* address of scratch space */
     int size;                   /* Size of scratch data */
+    int buffer_size;            /* Size of the buffer allocated for it */
     icl_list_t *task_args_list_node_ptr; /* convenience ptr to the task->args_list [node] */
+    icl_list_t task_scratch_list_node; /* storage for the task->scratch_list node */
 } Scratch;
 
 typedef struct address_set_node_s {
@@ -193,8 +282,17 @@ typedef struct address_set_node_s {
     unsigned long long last_writer_tasklevel; /* used for tracking critical depth */
     unsigned long long last_reader_or_writer_taskid; /* used for generating DOT DAGs */
     unsigned long long last_reader_or_writer_tasklevel; /* used for tracking critical depth */
+    icl_list_t waiting_deps_head; /* storage for the waiting_deps list head */
+    struct address_set_node_s *next_free; /* next node in quark->address_set_node_free_list */
 } Address_Set_Node;
 
+#define QUARK_ADDRESS_SET_NODE_SLAB_SIZE 64
+
+typedef struct address_set_node_slab_s {
+    struct address_set_node_slab_s *next;
+    Address_Set_Node node[QUARK_ADDRESS_SET_NODE_SLAB_SIZE];
+} address_set_node_slab_t;
+
 /* Data structure for a list containing long long int values.  Used to
  * track task ids in sequences of tasks, so that the tasks in a
  * sequence can be controlled */
@@ -205,37 +303,13 @@ typedef struct ll_list_node_s {
 LIST_HEAD(ll_list_head_s, ll_list_node_s);
 typedef struct ll_list_head_s ll_list_head_t;
 
-typedef struct completed_tasks_node_s {
-    Task *task;
-    int workerid;
-    TAILQ_ENTRY( completed_tasks_node_s ) entries;
-} completed_tasks_node_t;
-TAILQ_HEAD( completed_tasks_head_s, completed_tasks_node_s );
-typedef struct completed_tasks_head_s completed_tasks_head_t;
-
-/* Tree (red-black) structure for keeping a priority list of
- * executable tasks */
-typedef struct task_priority_tree_node_s {
-    int priority;
-    Task *task;
-    RB_ENTRY( task_priority_tree_node_s ) n_entry;
-} task_priority_tree_node_t;
-RB_HEAD( task_priority_tree_head_s, task_priority_tree_node_s );
-typedef struct task_priority_tree_head_s task_priority_tree_head_t;
-static int compare_task_priority_tree_nodes( task_priority_tree_node_t *n1, task_priority_tree_node_t *n2 )
-{
-    return n2->priority - n1->priority;
-}
-/* Generate red-black tree functions */
-RB_GENERATE( task_priority_tree_head_s, task_priority_tree_node_s, n_entry, compare_task_priority_tree_nodes );
-
-
 /* **************************************************************************** */
 /**
  * Local function prototypes, declared static so they are not
  * available outside the scope of this file.
  */
-static Task *quark_task_new();
+static Task *quark_task_new( Quark *quark );
+static void quark_task_recycle( Quark *quark, Task *task );
 static void task_delete( Quark *quark, Task *task);
 static Worker *worker_new(Quark *quark, int rank);
 static void worker_delete(Worker *worker);
@@ -244,9 +318,13 @@ static void quark_insert_task_dependencies(Quark * quark, Task * task);
 static void quark_check_and_queue_ready_task( Quark *quark, Task *task );
 static void work_set_affinity_and_call_main_loop(Worker *worker);
 static void work_main_loop(Worker *worker);
-static Scratch *scratch_new( void *arg_ptr, int arg_size, icl_list_t *task_args_list_node_ptr);
-static void scratch_allocate( Task *task );
-static void scratch_deallocate( Task *task );
+static Task *worker_take_task(Quark *quark, int worker_rank, int victim_rank);
+static bool worker_park(Quark *quark, Worker *worker, long long epoch);
+static void worker_wake(Worker *worker);
+static void worker_wake_thief(Quark *quark, int rank);
+static Scratch *scratch_new( Task *task, void *arg_ptr, int arg_size, icl_list_t *task_args_list_node_ptr);
+static void scratch_allocate( Worker *worker, Task *task );
+static void scratch_deallocate( Worker *worker, Task *task );
 static void address_set_node_delete( Quark *quark, Address_Set_Node *address_set_node );
 
 /* static void worker_remove_completed_task_and_check_for_ready(Quark *quark, Task *task, int exe_thread_idx); */
@@ -260,6 +338,7 @@ void quark_topology_finalize();
 int  quark_get_numthreads();
 int  *quark_get_affthreads();
 int  quark_yield();
+double quark_get_time();
 
 /* **************************************************************************** */
 /**
@@ -270,10 +349,6 @@ inline static int pthread_mutex_lock_asn(pthread_mutex_t *mtx) { return pthread_
 inline static int pthread_mutex_trylock_asn(pthread_mutex_t *mtx) { return pthread_mutex_trylock( mtx ); }
 inline static int pthread_mutex_unlock_asn(pthread_mutex_t *mtx) { return pthread_mutex_unlock( mtx ); }
 
-inline static int pthread_mutex_lock_ready_list(pthread_mutex_t *mtx) { return pthread_mutex_lock( mtx ); }
-inline static int pthread_mutex_trylock_ready_list(pthread_mutex_t *mtx) { return pthread_mutex_trylock( mtx ); }
-inline static int pthread_mutex_unlock_ready_list(pthread_mutex_t *mtx) { return pthread_mutex_unlock( mtx ); }
-
 inline static int pthread_mutex_lock_wrap(pthread_mutex_t *mtx) { return pthread_mutex_lock( mtx ); }
 inline static int pthread_mutex_unlock_wrap(pthread_mutex_t *mtx) { return pthread_mutex_unlock( mtx ); }
 
@@ -283,6 +358,113 @@ inline static int pthread_mutex_unlock_completed_tasks(pthread_mutex_t *mtx) { r
 
 inline static int pthread_cond_wait_ready_list( pthread_cond_t *cond, pthread_mutex_t *mtx ) { return pthread_cond_wait( cond, mtx ); }
 
+/* **************************************************************************** */
+/**
+ * Atomic operations for the ready lists and idle workers.  All are
+ * sequentially consistent, which worker_park relies on.
+ */
+#if defined( _WIN32 ) || defined( _WIN64 )
+inline static long long quark_atomic_load( volatile long long *p ) { return InterlockedCompareExchange64( p, 0, 0 ); }
+inline static void quark_atomic_store( volatile long long *p, long long v ) { InterlockedExchange64( p, v ); }
+inline static long long quark_atomic_fetch_add( volatile long long *p, long long v ) { return InterlockedExchangeAdd64( p, v ); }
+inline static int quark_atomic_cas( volatile long long *p, long long old, long long v ) { return InterlockedCompareExchange64( p, v, old ) == old; }
+inline static void *quark_atomic_load_ptr( void * volatile *p ) { return InterlockedCompareExchangePointer( p, NULL, NULL ); }
+inline static void quark_atomic_store_ptr( void * volatile *p, void *v ) { InterlockedExchangePointer( p, v ); }
+inline static void *quark_atomic_exchange_ptr( void * volatile *p, void *v ) { return InterlockedExchangePointer( p, v ); }
+inline static int quark_atomic_cas_ptr( void * volatile *p, void *old, void *v ) { return InterlockedCompareExchangePointer( p, v, old ) == old; }
+inline static void quark_cpu_relax() { YieldProcessor(); }
+#else
+inline static long long quark_atomic_load( volatile long long *p ) { return __atomic_load_n( p, __ATOMIC_SEQ_CST ); }
+inline static void quark_atomic_store( volatile long long *p, long long v ) { __atomic_store_n( p, v, __ATOMIC_SEQ_CST ); }
+inline static long long quark_atomic_fetch_add( volatile long long *p, long long v ) { return __atomic_fetch_add( p, v, __ATOMIC_SEQ_CST ); }
+inline static int quark_atomic_cas( volatile long long *p, long long old, long long v ) { return __atomic_compare_exchange_n( p, &old, v, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ); }
+inline static void *quark_atomic_load_ptr( void * volatile *p ) { return __atomic_load_n( p, __ATOMIC_ACQUIRE ); }
+inline static void quark_atomic_store_ptr( void * volatile *p, void *v ) { __atomic_store_n( p, v, __ATOMIC_RELEASE ); }
+inline static void *quark_atomic_exchange_ptr( void * volatile *p, void *v ) { return __atomic_exchange_n( p, v, __ATOMIC_ACQ_REL ); }
+inline static int quark_atomic_cas_ptr( void * volatile *p, void *old, void *v ) { return __atomic_compare_exchange_n( p, &old, v, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ); }
+#if defined( __i386__ ) || defined( __x86_64__ )
+inline static void quark_cpu_relax() { __builtin_ia32_pause(); }
+#else
+inline static void quark_cpu_relax() { }
+#endif
+#endif
+
+/* **************************************************************************** */
+/**
+ * Ready lists.  Entries are task pointers.  Tasks locked to a thread
+ * go to separate lists of that thread, so a locked task never sits at
+ * the head of a list that thieves take from.
+ */
+
+inline static int ready_list_bucket( int priority )
+{
+    int bucket = 0;
+    while ( priority > 0 && bucket < QUARK_PRIORITY_BUCKETS-1 ) {
+        priority >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/* Append a task; the caller holds the address_set_mutex, so there is
+ * a single inserting thread. The ring is allocated on first use and
+ * doubled when full; the new ring is published before the tail, so a
+ * thread that sees the new tail also sees the new ring. */
+static void ready_list_insert( ready_list_t *list, Task *task )
+{
+    long long tail = list->tail;
+    long long head = quark_atomic_load( &list->head );
+    ready_ring_t *ring = list->ring;
+    long long i;
+
+    if ( ring == NULL || tail - head >= ring->size ) {
+        ready_ring_t *bigger = (ready_ring_t *) malloc(sizeof(ready_ring_t));
+        assert( bigger != NULL );
+        bigger->size = ( ring == NULL ? QUARK_READY_RING_MIN_SIZE : 2*ring->size );
+        bigger->slot = (void * volatile *) malloc( bigger->size * sizeof(void *) );
+        assert( bigger->slot != NULL );
+        if ( ring != NULL )
+            for ( i = head; i < tail; i++ )
+                bigger->slot[i & (bigger->size-1)] = ring->slot[i & (ring->size-1)];
+        bigger->retired = ring;
+        quark_atomic_store_ptr( (void * volatile *)&list->ring, bigger );
+        ring = bigger;
+    }
+    quark_atomic_store_ptr( &ring->slot[tail & (ring->size-1)], (void *)task );
+    quark_atomic_store( &list->tail, tail+1 );
+}
+
+/* Take the oldest task, or return NULL if the list is empty.  An
+ * entry is only overwritten after the head has moved past it, so if
+ * the compare-and-swap succeeds the entry read before it was current. */
+static Task *ready_list_take( ready_list_t *list )
+{
+    long long head, tail;
+    ready_ring_t *ring;
+    void *entry;
+
+    do {
+        head = quark_atomic_load( &list->head );
+        tail = quark_atomic_load( &list->tail );
+        if ( head >= tail ) return NULL;
+        ring = (ready_ring_t *) quark_atomic_load_ptr( (void * volatile *)&list->ring );
+        entry = quark_atomic_load_ptr( &ring->slot[head & (ring->size-1)] );
+    } while ( !quark_atomic_cas( &list->head, head, head+1 ) );
+    return (Task *)entry;
+}
+
+static void ready_list_free( ready_list_t *list )
+{
+    ready_ring_t *ring = list->ring, *retired;
+    while ( ring != NULL ) {
+        retired = ring->retired;
+        free( (void *)ring->slot );
+        free( ring );
+        ring = retired;
+    }
+    list->ring = NULL;
+}
+
 /* **************************************************************************** */
 
 /* If dags are to be generated, setup file name and pointer and
@@ -307,30 +489,97 @@ FILE *dot_dag_file;
         pthread_mutex_unlock_wrap( &quark->dot_dag_mutex );                 \
     }
 
+/* **************************************************************************** */
+/**
+ * Allocate a slab of num_tasks tasks, record it in quark->task_slabs
+ * and return its tasks linked through next_free.  The task mutexes
+ * live as long as the slab.
+ */
+static Task *task_slab_new( Quark *quark, int num_tasks )
+{
+    task_slab_t *slab = (task_slab_t *)malloc( offsetof(task_slab_t, task) + num_tasks*sizeof(Task) );
+    int i;
+    assert( slab != NULL );
+    slab->num_tasks = num_tasks;
+    for ( i = 0; i < num_tasks; i++ ) {
+        pthread_mutex_init( &slab->task[i].task_mutex, NULL );
+        slab->task[i].next_free = ( i+1 < num_tasks ? &slab->task[i+1] : NULL );
+    }
+    do {
+        slab->next = quark_atomic_load_ptr( (void * volatile *)&quark->task_slabs );
+    } while ( !quark_atomic_cas_ptr( (void * volatile *)&quark->task_slabs, slab->next, slab ) );
+    return &slab->task[0];
+}
+
+/* **************************************************************************** */
+/**
+ * Get a free task.  Each thread takes tasks from its own cache, which
+ * is refilled by taking the whole list of recycled tasks at once, or
+ * a new slab when there are none.  Taking the whole list rather than
+ * popping one task keeps the compare-and-swap pushes in
+ * quark_task_recycle free of ABA problems.  A thread that is not one
+ * of the workers gets a slab of its own for one task.
+ */
+static Task *task_pool_get( Quark *quark )
+{
+    int rank = QUARK_Thread_Rank( quark );
+    Worker *worker;
+    Task *task;
+    if ( rank < 0 )
+        return task_slab_new( quark, 1 );
+    worker = quark->worker[rank];
+    if ( worker->task_cache == NULL )
+        worker->task_cache = quark_atomic_exchange_ptr( (void * volatile *)&quark->task_free_list, NULL );
+    if ( worker->task_cache == NULL )
+        worker->task_cache = task_slab_new( quark, QUARK_TASK_SLAB_SIZE );
+    task = worker->task_cache;
+    worker->task_cache = task->next_free;
+    return task;
+}
+
+/* **************************************************************************** */
+/**
+ * Allocate size bytes, rounded up to keep 8 byte alignment, from the
+ * task arena.  The memory is released when the task is recycled.
+ */
+static void *task_arena_alloc( Task *task, size_t size )
+{
+    void *ptr;
+    size = (size + sizeof(double) - 1) & ~(sizeof(double) - 1);
+    if ( size > task->arena_left ) {
+        size_t chunk_size = ( size > QUARK_TASK_ARENA_SIZE ? size : QUARK_TASK_ARENA_SIZE );
+        task_arena_chunk_t *chunk = (task_arena_chunk_t *)malloc( offsetof(task_arena_chunk_t, data) + chunk_size );
+        assert( chunk != NULL );
+        chunk->next = task->arena_chunks;
+        task->arena_chunks = chunk;
+        task->arena_next = (char *)chunk->data;
+        task->arena_left = chunk_size;
+    }
+    ptr = task->arena_next;
+    task->arena_next += size;
+    task->arena_left -= size;
+    return ptr;
+}
+
 /* **************************************************************************** */
 /**
  * Initialize the task data structure
  */
-static Task *quark_task_new()
+static Task *quark_task_new( Quark *quark )
 {
     static unsigned long long taskid = 1;
-    Task *task = (Task *)malloc(sizeof(Task));
-    assert(task != NULL);
+    Task *task = task_pool_get( quark );
     task->function = NULL;
     task->num_dependencies = 0;
     task->num_dependencies_remaining = 0;
-    task->args_list = icl_list_new();
-    assert(task->args_list != NULL);
-    task->dependency_list = icl_list_new();
-    assert(task->dependency_list != NULL);
+    task->args_list = icl_list_init( &task->args_list_head );
+    task->dependency_list = icl_list_init( &task->dependency_list_head );
     task->locality_preserving_dep = NULL;
     task->status = NOTREADY;
-    task->scratch_list = icl_list_new();
-    assert( task->scratch_list != NULL);
+    task->scratch_list = icl_list_init( &task->scratch_list_head );
     assert( taskid < ULLONG_MAX );
     task->taskid = taskid++;
     task->tasklevel = 0;
-    pthread_mutex_init(&task->task_mutex, NULL);
     task->ptr_to_task_in_sequence = NULL;
     task->sequence = NULL;
     task->priority = QUARK_TASK_MIN_PRIORITY;
@@ -338,9 +587,31 @@ static Task *quark_task_new()
     task->task_color = quark_task_default_color;
     task->lock_to_thread = -1;
     task->task_thread_count = 1;
+    task->next_free = NULL;
+    task->arena_next = (char *)task->arena;
+    task->arena_left = sizeof(task->arena);
+    task->arena_chunks = NULL;
     return task;
 }
 
+/* **************************************************************************** */
+/**
+ * Release the task arena and put the task on the free list.  Any
+ * thread can recycle a task.
+ */
+static void quark_task_recycle( Quark *quark, Task *task )
+{
+    task_arena_chunk_t *chunk, *next;
+    for ( chunk = task->arena_chunks; chunk != NULL; chunk = next ) {
+        next = chunk->next;
+        free( chunk );
+    }
+    task->arena_chunks = NULL;
+    do {
+        task->next_free = quark_atomic_load_ptr( (void * volatile *)&quark->task_free_list );
+    } while ( !quark_atomic_cas_ptr( (void * volatile *)&quark->task_free_list, task->next_free, task ) );
+}
+
 /* **************************************************************************** */
 /**
  * Free the task data structure
@@ -351,20 +622,14 @@ static void task_delete(Quark *quark, Task *task)
     icl_hash_delete( quark->task_set, &task->taskid, NULL, NULL );
     pthread_mutex_lock_wrap( &task->task_mutex );
     pthread_mutex_unlock_wrap( &quark->task_set_mutex );
-    icl_list_destroy(task->args_list, free);
-    icl_list_destroy(task->dependency_list, free);
-    icl_list_destroy(task->scratch_list, free);
     if ( task->ptr_to_task_in_sequence != NULL ) {
         pthread_mutex_lock_wrap( &task->sequence->sequence_mutex );
         LIST_REMOVE( task->ptr_to_task_in_sequence, entries );
         pthread_mutex_unlock_wrap( &task->sequence->sequence_mutex );
         free( task->ptr_to_task_in_sequence );
     }
-    if (task->task_color!=NULL && task->task_color!=quark_task_default_color) free(task->task_color);
-    if (task->task_label!=NULL && task->task_label!=quark_task_default_label) free(task->task_label);
     pthread_mutex_unlock_wrap( &task->task_mutex );
-    pthread_mutex_destroy( &task->task_mutex );
-    free( task );
+    quark_task_recycle( quark, task );
     // TODO pthread_mutex_lock_asn( &quark->address_set_mutex );
     quark->num_tasks--;
     // TODO pthread_mutex_unlock_asn( &quark->address_set_mutex );
@@ -384,6 +649,27 @@ int QUARK_Thread_Rank(Quark *quark)
     return -1;
 }
 
+/* **************************************************************************** */
+/**
+ * Return the time a worker has spent executing tasks since the
+ * scheduler was created.  The difference between the elapsed time of
+ * a computation and the increase of this time is the time the worker
+ * was idle, or inserting tasks for the master.
+ *
+ * @param[in] quark
+ *         The scheduler's main data structure.
+ * @param[in] rank
+ *         The rank of the worker, 0 ... number of threads - 1
+ * @return
+ *          The time in seconds, or -1 if there is no such worker
+ * @ingroup QUARK
+ */
+double QUARK_Worker_Busy_Time(Quark *quark, int rank)
+{
+    if ( rank < 0 || rank >= quark->num_threads ) return -1.0;
+    return quark->worker[rank]->busy_time;
+}
+
 /* **************************************************************************** */
 /**
  * Return a pointer to the argument list being processed by the
@@ -504,24 +790,32 @@ static inline int quark_revolve_robin(Quark * quark)
 
 /* **************************************************************************** */
 /**
- * Duplicate the argument, allocating a memory buffer for it
+ * Duplicate the argument, in a buffer from the task arena
  */
-static inline char *arg_dup(char *arg, int size)
+static inline char *arg_dup(Task *task, char *arg, int size)
 {
-    char *argbuf = (char *) malloc(size);
-    assert( argbuf != NULL );
+    char *argbuf = (char *) task_arena_alloc(task, size);
     memcpy(argbuf, arg, size);
     return argbuf;
 }
 
+/* **************************************************************************** */
+/**
+ * Append a copy of the argument to the task argument list
+ */
+static inline icl_list_t *task_args_list_append(Task *task, char *arg, int size)
+{
+    icl_list_t *node = (icl_list_t *) task_arena_alloc(task, sizeof(icl_list_t));
+    return icl_list_append_node(task->args_list, node, arg_dup(task, arg, size));
+}
+
 /* **************************************************************************** */
 /**
  * Allocate and initialize a dependency structure
  */
 static inline Dependency *dependency_new(void *addr, long long size, quark_direction_t dir, bool loc, Task *task, bool accumulator, bool gatherv, icl_list_t *task_args_list_node_ptr)
 {
-    Dependency *dep = (Dependency *) malloc(sizeof(Dependency));
-    assert(dep != NULL);
+    Dependency *dep = (Dependency *) task_arena_alloc(task, sizeof(Dependency));
     dep->task = task;
     dep->address = addr;
     dep->size = size;
@@ -532,7 +826,7 @@ static inline Dependency *dependency_new(void *addr, long long size, quark_direc
     dep->address_set_node_ptr = NULL; /* convenience ptr, filled later */
     dep->address_set_waiting_deps_node_ptr = NULL; /* convenience ptr, filled later */
     dep->task_args_list_node_ptr = task_args_list_node_ptr; /* convenience ptr for WAR address updating */
-    dep->task_dependency_list_node_ptr = NULL; /* convenience ptr */
+    dep->task_dependency_list_node_ptr = &dep->task_dependency_list_node; /* convenience ptr */
     dep->ready = FALSE;
     /* For the task, track the dependency to be use to do locality
      * preservation; by default, use first output dependency.  */
@@ -550,18 +844,30 @@ static inline Dependency *dependency_new(void *addr, long long size, quark_direc
 static Worker *worker_new(Quark *quark, int rank)
 {
     Worker *worker = (Worker *) malloc(sizeof(Worker));
+    int i;
     assert(worker != NULL);
     worker->thread_id = pthread_self();
-    worker->ready_list = malloc(sizeof(task_priority_tree_head_t));
-    assert(worker->ready_list != NULL);
-    RB_INIT( worker->ready_list );
+    for ( i = 0; i < QUARK_PRIORITY_BUCKETS; i++ ) {
+        worker->ready_list[i].head = 0;
+        worker->ready_list[i].tail = 0;
+        worker->ready_list[i].ring = NULL;
+        worker->locked_list[i].head = 0;
+        worker->locked_list[i].tail = 0;
+        worker->locked_list[i].ring = NULL;
+    }
     worker->ready_list_size = 0;
-    pthread_mutex_init(&worker->ready_list_mutex, NULL);
+    pthread_mutex_init(&worker->park_mutex, NULL);
+    pthread_cond_init(&worker->park_cond, NULL);
+    worker->parked = FALSE;
+    worker->idle_spin = quark->idle_spin_max;
+    worker->task_cache = NULL;
+    worker->num_scratch_cached = 0;
     /* convenience pointer to the real args for the task  */
     worker->current_task_ptr = NULL;
     worker->quark_ptr = quark;
     worker->finalize = FALSE;
     worker->executing_task = FALSE;
+    worker->busy_time = 0.0;
     return worker;
 }
 
@@ -571,15 +877,17 @@ static Worker *worker_new(Quark *quark, int rank)
  */
 static void worker_delete(Worker * worker)
 {
-    task_priority_tree_node_t *node, *nxt;
-    /* Destroy the workers priority queue, if there is still anything there */
-    for ( node = RB_MIN( task_priority_tree_head_s, worker->ready_list ); node != NULL; node = nxt) {
-        nxt = RB_NEXT( task_priority_tree_head_s, worker->ready_list, node );
-        RB_REMOVE( task_priority_tree_head_s, worker->ready_list, node );
-        free(node);
+    int i;
+    /* Destroy the workers ready lists, the tasks are owned by the task_set */
+    for ( i = 0; i < QUARK_PRIORITY_BUCKETS; i++ ) {
+        ready_list_free( &worker->ready_list[i] );
+        ready_list_free( &worker->locked_list[i] );
     }
-    free( worker->ready_list );
-    pthread_mutex_destroy(&worker->ready_list_mutex);
+    /* The cached tasks belong to the slabs freed in QUARK_Free */
+    for ( i = 0; i < worker->num_scratch_cached; i++ )
+        free( worker->scratch_cache[i].ptr );
+    pthread_mutex_destroy(&worker->park_mutex);
+    pthread_cond_destroy(&worker->park_cond);
     free(worker);
 }
 
@@ -588,21 +896,23 @@ static void worker_delete(Worker * worker)
  * The task requires scratch workspace, which will be allocated if
  * needed.  This records the scratch requirements.
  */
-static Scratch *scratch_new( void *arg_ptr, int arg_size, icl_list_t *task_args_list_node_ptr )
+static Scratch *scratch_new( Task *task, void *arg_ptr, int arg_size, icl_list_t *task_args_list_node_ptr )
 {
-    Scratch *scratch = (Scratch *)malloc(sizeof(Scratch));
-    assert(scratch != NULL);
+    Scratch *scratch = (Scratch *)task_arena_alloc(task, sizeof(Scratch));
     scratch->ptr = arg_ptr;
     scratch->size = arg_size;
+    scratch->buffer_size = 0;
     scratch->task_args_list_node_ptr = task_args_list_node_ptr;
     return(scratch);
 }
 
 /* **************************************************************************** */
 /**
- * Allocate any needed scratch space;
+ * Allocate any needed scratch space; the smallest buffer cached by
+ * the worker that is large enough is used, else a new one is
+ * allocated.
  */
-static void scratch_allocate( Task *task )
+static void scratch_allocate( Worker *worker, Task *task )
 {
     icl_list_t *scr_node;
     for (scr_node = icl_list_first( task->scratch_list );
@@ -611,8 +921,21 @@ static void scratch_allocate( Task *task )
         Scratch *scratch = (Scratch *)scr_node->data;
         if ( scratch->ptr == NULL ) {
             /* Since ptr is null, space is to be allocted and attached */
+            void *scratchspace = NULL;
+            int i, best = -1;
             assert( scratch->size > 0 );
-            void *scratchspace = malloc( scratch->size );
+            for ( i = 0; i < worker->num_scratch_cached; i++ )
+                if ( worker->scratch_cache[i].size >= scratch->size &&
+                     ( best < 0 || worker->scratch_cache[i].size < worker->scratch_cache[best].size ) )
+                    best = i;
+            if ( best >= 0 ) {
+                scratchspace = worker->scratch_cache[best].ptr;
+                scratch->buffer_size = worker->scratch_cache[best].size;
+                worker->scratch_cache[best] = worker->scratch_cache[--worker->num_scratch_cached];
+            } else {
+                scratchspace = malloc( scratch->size );
+                scratch->buffer_size = scratch->size;
+            }
             assert( scratchspace != NULL );
             *(void **)scratch->task_args_list_node_ptr->data = scratchspace;
         }
@@ -621,9 +944,10 @@ static void scratch_allocate( Task *task )
 
 /* **************************************************************************** */
 /**
- * Deallocate any scratch space.
+ * Return any allocated scratch space to the worker cache.  When the
+ * cache is full, the smallest buffer is freed.
  */
-static void scratch_deallocate( Task *task )
+static void scratch_deallocate( Worker *worker, Task *task )
 {
     icl_list_t *scr_node;
     for (scr_node = icl_list_first( task->scratch_list );
@@ -631,8 +955,24 @@ static void scratch_deallocate( Task *task )
          scr_node = icl_list_next(task->scratch_list, scr_node)) {
         Scratch *scratch = (Scratch *)scr_node->data;
         if ( scratch->ptr == NULL ) {
-            /* If scratch had to be allocated, free it */
-            free(*(void **)scratch->task_args_list_node_ptr->data);
+            /* If scratch had to be allocated, cache or free it */
+            scratch_buffer_t buffer;
+            int i, smallest = 0;
+            buffer.ptr = *(void **)scratch->task_args_list_node_ptr->data;
+            buffer.size = scratch->buffer_size;
+            if ( worker->num_scratch_cached < QUARK_SCRATCH_CACHE_SIZE ) {
+                worker->scratch_cache[worker->num_scratch_cached++] = buffer;
+                continue;
+            }
+            for ( i = 1; i < QUARK_SCRATCH_CACHE_SIZE; i++ )
+                if ( worker->scratch_cache[i].size < worker->scratch_cache[smallest].size )
+                    smallest = i;
+            if ( worker->scratch_cache[smallest].size < buffer.size ) {
+                free( worker->scratch_cache[smallest].ptr );
+                worker->scratch_cache[smallest] = buffer;
+            } else {
+                free( buffer.ptr );
+            }
         }
     }
 }
@@ -670,7 +1010,11 @@ Quark *QUARK_Setup(int num_threads)
         quark->high_water_mark = (int)(quark->low_water_mark + quark->low_water_mark*0.25);
     }
     quark->num_queued_tasks = 0;
-    pthread_cond_init( &quark->num_queued_tasks_cond, NULL );
+    quark->ready_epoch = 0;
+    quark->num_parked = 0;
+    /* Idle workers scan all ready lists up to this many times before blocking */
+    quark->idle_spin_max = quark_getenv_int("QUARK_IDLE_SPIN", 1000);
+    if ( quark->idle_spin_max < 1 ) quark->idle_spin_max = 1;
     quark->num_threads = num_threads;
     quark->list_robin = 0;
     quark->start = FALSE;
@@ -688,6 +1032,11 @@ Quark *QUARK_Setup(int num_threads)
     assert ( quark->completed_tasks != NULL );
     TAILQ_INIT( quark->completed_tasks );
     pthread_mutex_init(&quark->completed_tasks_mutex, NULL);
+    /* Pools of tasks and address set nodes */
+    quark->task_free_list = NULL;
+    quark->task_slabs = NULL;
+    quark->address_set_node_free_list = NULL;
+    quark->address_set_node_slabs = NULL;
     /* Setup workers */
     quark->worker = (Worker **) malloc(num_threads * sizeof(Worker *));
     assert(quark->worker != NULL);
@@ -791,9 +1140,12 @@ void QUARK_Waitall(Quark * quark)
 {
     int i;
     QUARK_Barrier( quark );
-    /* Tell each worker to exit the work_loop; master handles himself */
-    for (i=1; i<quark->num_threads; i++)
+    /* Tell each worker to exit the work_loop, waking the parked ones;
+     * master handles himself */
+    for (i=1; i<quark->num_threads; i++) {
         quark->worker[i]->finalize = TRUE;
+        worker_wake( quark->worker[i] );
+    }
 }
 
 /* **************************************************************************** */
@@ -809,6 +1161,8 @@ void QUARK_Waitall(Quark * quark)
 void QUARK_Free(Quark * quark)
 {
     int i;
+    task_slab_t *task_slab;
+    address_set_node_slab_t *asn_slab;
     QUARK_Waitall(quark);
     /* Write the level matching/forcing information */
     if ( quark->dot_dag_enable ) {
@@ -826,6 +1180,17 @@ void QUARK_Free(Quark * quark)
     if (quark->completed_tasks) free(quark->completed_tasks);
     icl_hash_destroy(quark->address_set, NULL, NULL);
     icl_hash_destroy(quark->task_set, NULL, NULL);
+    /* Free the pools; this also frees the address set nodes kept for DAG generation */
+    while ( (task_slab = quark->task_slabs) != NULL ) {
+        quark->task_slabs = task_slab->next;
+        for (i = 0; i < task_slab->num_tasks; i++)
+            pthread_mutex_destroy( &task_slab->task[i].task_mutex );
+        free( task_slab );
+    }
+    while ( (asn_slab = quark->address_set_node_slabs) != NULL ) {
+        quark->address_set_node_slabs = asn_slab->next;
+        free( asn_slab );
+    }
     if ( quark->dot_dag_enable ) {
         pthread_mutex_destroy(&quark->dot_dag_mutex);
         fclose(dot_dag_file);
@@ -870,8 +1235,8 @@ Task *quark_set_task_flags_in_task_structure( Quark *quark, Task *task, Quark_Ta
     if ( task_flags ) {
         if ( task_flags->task_priority ) task->priority = task_flags->task_priority;
         if ( task_flags->task_lock_to_thread >= 0 ) task->lock_to_thread = task_flags->task_lock_to_thread;
-        if ( task_flags->task_color && quark->dot_dag_enable ) task->task_color = strdup(task_flags->task_color);
-        if ( task_flags->task_label && quark->dot_dag_enable ) task->task_label = strdup(task_flags->task_label);
+        if ( task_flags->task_color && quark->dot_dag_enable ) task->task_color = arg_dup(task, task_flags->task_color, strlen(task_flags->task_color)+1);
+        if ( task_flags->task_label && quark->dot_dag_enable ) task->task_label = arg_dup(task, task_flags->task_label, strlen(task_flags->task_label)+1);
         if ( task_flags->task_sequence ) task->sequence = task_flags->task_sequence;
         if ( task_flags->task_thread_count > 1 ) task->task_thread_count = task_flags->task_thread_count;
     }
@@ -894,7 +1259,7 @@ Task *quark_set_task_flags_in_task_structure( Quark *quark, Task *task, Quark_Ta
  */
 Task *QUARK_Task_Init(Quark * quark, void (*function) (Quark *), Quark_Task_Flags *task_flags )
 {
-    Task *task = quark_task_new();
+    Task *task = quark_task_new( quark );
     task->function = function;
     quark_set_task_flags_in_task_structure( quark, task, task_flags );
     return task;
@@ -942,30 +1307,23 @@ void QUARK_Task_Pack_Arg( Quark *quark, Task *task, int arg_size, void *arg_ptr,
         else if ( task_lock_to_thread ) task->lock_to_thread = *((int *)arg_ptr);
         else if ( task_thread_count ) task->task_thread_count = *((int *)arg_ptr);
         else if ( task_sequence ) task->sequence = *((Quark_Sequence **)arg_ptr);
-        else if ( task_color && quark->dot_dag_enable ) {
-            if ( task->task_color && task->task_color!=quark_task_default_color) free(task->task_color);
-            task->task_color = arg_dup(arg_ptr, arg_size);
-        }
-        else if ( task_label && quark->dot_dag_enable ) {
-            if ( task->task_label && task->task_label!=quark_task_default_label) free(task->task_label);
-            task->task_label = arg_dup(arg_ptr, arg_size) ;
-        }
-        else task_args_list_node_ptr = icl_list_append(task->args_list, arg_dup(arg_ptr, arg_size));
+        else if ( task_color && quark->dot_dag_enable ) task->task_color = arg_dup(task, arg_ptr, arg_size);
+        else if ( task_label && quark->dot_dag_enable ) task->task_label = arg_dup(task, arg_ptr, arg_size);
+        else task_args_list_node_ptr = task_args_list_append(task, arg_ptr, arg_size);
     } else {
         /* Else - argument is a pointer; Copy the pointer to the argument buffer - pass by reference */
-        task_args_list_node_ptr = icl_list_append(task->args_list, arg_dup((char *) &arg_ptr, sizeof(char *)));
+        task_args_list_node_ptr = task_args_list_append(task, (char *) &arg_ptr, sizeof(char *));
     }
     if ((arg_ptr != NULL) && ( arg_direction==INPUT || arg_direction==INOUT || arg_direction==OUTPUT )) {
         /* If argument is a dependency/slice, add dependency to task dependency list */
         Dependency *dep = dependency_new(arg_ptr, arg_size, arg_direction, arg_locality, task, accumulator, gatherv, task_args_list_node_ptr);
-        icl_list_t *task_dependency_list_node_ptr = icl_list_append( task->dependency_list, dep );
-        dep->task_dependency_list_node_ptr = task_dependency_list_node_ptr;
+        icl_list_append_node( task->dependency_list, dep->task_dependency_list_node_ptr, dep );
         task->num_dependencies++;
         task->num_dependencies_remaining++;
     }
     else if( arg_direction==SCRATCH ) {
-        Scratch *scratch = scratch_new( arg_ptr, arg_size, task_args_list_node_ptr);
-        icl_list_append( task->scratch_list, scratch );
+        Scratch *scratch = scratch_new( task, arg_ptr, arg_size, task_args_list_node_ptr);
+        icl_list_append_node( task->scratch_list, &scratch->task_scratch_list_node, scratch );
     }
 }
 
@@ -1144,19 +1502,17 @@ unsigned long long QUARK_Execute_Task(Quark * quark, void (*function) (Quark *),
         /* Call the task */
         task->status = RUNNING;
         worker->current_task_ptr = task;
-        scratch_allocate( task );
+        scratch_allocate( worker, task );
+        double start = quark_get_time();
         task->function( quark );
-        scratch_deallocate( task );
+        worker->busy_time += quark_get_time() - start;
+        scratch_deallocate( worker, task );
         worker->current_task_ptr = NULL;
         task->status = DONE;
     }
 
-    /* Delete the task data structures */
-    icl_list_destroy(task->args_list, free);
-    icl_list_destroy(task->dependency_list, free);
-    icl_list_destroy(task->scratch_list, free);
-    pthread_mutex_destroy(&task->task_mutex);
-    free(task);
+    /* Recycle the task data structures */
+    quark_task_recycle( quark, task );
 
     /* There is no real taskid to be returned, since the task has been deleted */
     return( -1 );
@@ -1201,17 +1557,27 @@ int QUARK_Cancel_Task(Quark *quark, unsigned long long taskid)
 /* **************************************************************************** */
 /**
  * Allocate and initialize address_set_node structure.  These are
- * inserted into the hash table.
+ * inserted into the hash table.  The nodes come from slabs and are
+ * recycled through a free list; the address_set_mutex must be locked.
  */
-static Address_Set_Node *address_set_node_new( void* address, int size )
+static Address_Set_Node *address_set_node_new( Quark *quark, void* address, int size )
 {
-    Address_Set_Node *address_set_node = (Address_Set_Node *)malloc(sizeof(Address_Set_Node));
-    assert( address_set_node != NULL );
+    Address_Set_Node *address_set_node = quark->address_set_node_free_list;
+    if ( address_set_node == NULL ) {
+        address_set_node_slab_t *slab = (address_set_node_slab_t *)malloc(sizeof(address_set_node_slab_t));
+        int i;
+        assert( slab != NULL );
+        slab->next = quark->address_set_node_slabs;
+        quark->address_set_node_slabs = slab;
+        for ( i = 0; i < QUARK_ADDRESS_SET_NODE_SLAB_SIZE; i++ )
+            slab->node[i].next_free = ( i+1 < QUARK_ADDRESS_SET_NODE_SLAB_SIZE ? &slab->node[i+1] : NULL );
+        address_set_node = &slab->node[0];
+    }
+    quark->address_set_node_free_list = address_set_node->next_free;
     address_set_node->address = address;
     address_set_node->size = size;
     address_set_node->last_thread = -1;
-    address_set_node->waiting_deps = icl_list_new();
-    assert( address_set_node->waiting_deps != NULL );
+    address_set_node->waiting_deps = icl_list_init( &address_set_node->waiting_deps_head );
     address_set_node->num_waiting_input = 0;
     address_set_node->num_waiting_output = 0;
     address_set_node->num_waiting_inout = 0;
@@ -1239,13 +1605,12 @@ static void address_set_node_delete( Quark *quark, Address_Set_Node *address_set
     if ( quark->dot_dag_enable )
         return;
 
-    /* Remove any data structures in the waiting_deps list */
-    if ( address_set_node->waiting_deps != NULL )
-        icl_list_destroy( address_set_node->waiting_deps, NULL );
     /* Delete and free the hash table entry if this was NOT a WAR create entry */
     icl_hash_delete( quark->address_set, address_set_node->address, NULL, NULL );
-    /* Remove the data structure */
-    free( address_set_node );
+    /* Return the data structure to the pool; the waiting_deps list
+     * is empty and its nodes belong to the dependencies */
+    address_set_node->next_free = quark->address_set_node_free_list;
+    quark->address_set_node_free_list = address_set_node;
 }
 
 /* **************************************************************************** */
@@ -1279,18 +1644,24 @@ static void quark_check_and_queue_ready_task( Quark *quark, Task *task )
     while ( assigned_thread_count < task->task_thread_count) {
 
         worker = quark->worker[worker_thread_id];
-        /* Create a new entry for the ready list */
-        task_priority_tree_node_t *new_task_tree_node = malloc(sizeof(task_priority_tree_node_t));
-        assert( new_task_tree_node != NULL );
-        new_task_tree_node->priority = task->priority;
-        new_task_tree_node->task = task;
-        /* Insert new entry into the ready list */
-        pthread_mutex_lock_ready_list(&worker->ready_list_mutex);
-        RB_INSERT( task_priority_tree_head_s, worker->ready_list, new_task_tree_node );
-        worker->ready_list_size++;
-        pthread_mutex_unlock_ready_list(&worker->ready_list_mutex);
-        pthread_cond_broadcast( &quark->num_queued_tasks_cond );
+        /* Insert into the ready list of the task's priority bucket */
+        if ( task->lock_to_thread >= 0 )
+            ready_list_insert( &worker->locked_list[ready_list_bucket(task->priority)], task );
+        else
+            ready_list_insert( &worker->ready_list[ready_list_bucket(task->priority)], task );
+        quark_atomic_fetch_add( &worker->ready_list_size, 1 );
         quark->num_queued_tasks++;
+        /* Wake the worker if it is parked; if it is busy, wake a
+         * parked worker that can steal the task instead.  The epoch
+         * is incremented before the parked flags are read, and
+         * worker_park sets them before it reads the epoch, so a
+         * worker cannot park while missing this task. */
+        quark_atomic_fetch_add( &quark->ready_epoch, 1 );
+        if ( quark_atomic_load( &worker->parked ) ) {
+            worker_wake( worker );
+        } else if ( worker->executing_task && task->lock_to_thread < 0 ) {
+            worker_wake_thief( quark, worker_thread_id );
+        }
 
         assigned_thread_count++;
         /* TODO Abort when too many threads requested */
@@ -1365,25 +1736,24 @@ void quark_avoid_war_dependencies( Quark *quark, Address_Set_Node *asn_old, Task
         /* quark->mem_allocated_to_war_dependency_data += asn_old->size; */
         memcpy( datacopy, asn_old->address, asn_old->size );
         /* Create address set node, attach to hash, and set it to clean up when done */
-        asn_new = address_set_node_new( datacopy, asn_old->size );
+        asn_new = address_set_node_new( quark, datacopy, asn_old->size );
         asn_new->delete_data_at_address_when_node_is_deleted = TRUE;
         icl_hash_insert( quark->address_set, asn_new->address, asn_new );
         /* Update task dependences to point to this new data */
-        /* Grab input deps from the old list, copy to new list, delete, then repeat */
+        /* Grab input deps from the old list, move their nodes to the new list, then repeat */
         for ( dep_node_asn_old=icl_list_first(asn_old->waiting_deps);
               dep_node_asn_old!=NULL;  ) {
-            icl_list_t *dep_node_asn_old_to_be_deleted = NULL;
+            icl_list_t *dep_node_asn_old_next = icl_list_next(asn_old->waiting_deps, dep_node_asn_old);
             Dependency *dep = (Dependency *)dep_node_asn_old->data;
             Task *task = dep->task;
             if ( dep->direction==INPUT && task->status==NOTREADY ) {
-                dep_node_asn_old_to_be_deleted = dep_node_asn_old;
-                icl_list_t *dep_node_new = icl_list_append( asn_new->waiting_deps, dep );
+                icl_list_unlink( asn_old->waiting_deps, dep_node_asn_old );
+                icl_list_append_node( asn_new->waiting_deps, dep_node_asn_old, dep );
                 asn_new->num_waiting_input++;
                 /* In the args list, set the arg pointer to the new datacopy address */
                 *(void **)dep->task_args_list_node_ptr->data = datacopy;
                 dep->address = asn_new->address;
                 dep->address_set_node_ptr = asn_new;
-                dep->address_set_waiting_deps_node_ptr = dep_node_new;
                 if (dep->ready == FALSE) { /* dep->ready will always be FALSE */
                     dep->ready = TRUE;
                     dot_dag_print_edge( parent_task->taskid, task->taskid, DEPCOLOR );
@@ -1395,10 +1765,7 @@ void quark_avoid_war_dependencies( Quark *quark, Address_Set_Node *asn_old, Task
                 /* Once we return from this routine, this dep dependency will be processed */
                 break;
             }
-            dep_node_asn_old = icl_list_next(asn_old->waiting_deps, dep_node_asn_old);
-            if (dep_node_asn_old_to_be_deleted!=NULL) {
-                icl_list_delete(asn_old->waiting_deps, dep_node_asn_old_to_be_deleted, NULL);
-            }
+            dep_node_asn_old = dep_node_asn_old_next;
         }
     }
 }
@@ -1492,9 +1859,8 @@ static void address_set_node_accumulator_find_prepend(Quark *quark, Address_Set_
         Dependency *dependency = (Dependency *)swap_node->data;
         /* Move to front of the address_set_node waiting_deps list (if not already there) */
         if ( swap_node!=icl_list_first(address_set_node->waiting_deps) ) {
-                icl_list_t *tmp_swap_node = icl_list_prepend( address_set_node->waiting_deps, dependency );
-                dependency->address_set_waiting_deps_node_ptr = tmp_swap_node;
-                icl_list_delete( address_set_node->waiting_deps, swap_node, NULL );
+                icl_list_unlink( address_set_node->waiting_deps, swap_node );
+                icl_list_insert_node( address_set_node->waiting_deps, address_set_node->waiting_deps, swap_node, dependency );
         }
         /* Lock the dependency in place by setting ACC to false now */
         dependency->accumulator = FALSE;
@@ -1607,13 +1973,13 @@ static void quark_insert_task_dependencies(Quark * quark, Task * task)
         Address_Set_Node *address_set_node = (Address_Set_Node *)icl_hash_find( quark->address_set, dep->address );
         /* If not found, create a new address set node and add it to the hash */
         if ( address_set_node == NULL ) {
-            address_set_node = address_set_node_new( dep->address, dep->size );
+            address_set_node = address_set_node_new( quark, dep->address, dep->size );
             icl_hash_insert( quark->address_set, address_set_node->address, address_set_node );
         }
         /* Convenience shortcut pointer so that we don't have to hash again */
         dep->address_set_node_ptr = address_set_node;
         /* Add the dependency to the list of waiting dependencies on this address set node */
-        icl_list_t *curr_dep_node = icl_list_append( address_set_node->waiting_deps, dep );
+        icl_list_t *curr_dep_node = icl_list_append_node( address_set_node->waiting_deps, &dep->address_set_waiting_deps_node, dep );
         /* Convenience shortcut pointer so we don't have to scan the waiting dependencies */
         dep->address_set_waiting_deps_node_ptr = curr_dep_node;
         /* Track num of waiting input, output and inout to be used to check false dependency resolution */
@@ -1636,8 +2002,8 @@ static void quark_insert_task_dependencies(Quark * quark, Task * task)
                     task->num_dependencies_remaining--;
                 }
                 /* Remove the redundent dependency from waiting deps and from the task */
-                icl_list_delete( address_set_node->waiting_deps, prev_dep_node, NULL );
-                icl_list_delete( task->dependency_list, prev_dep->task_dependency_list_node_ptr, NULL );
+                icl_list_unlink( address_set_node->waiting_deps, prev_dep_node );
+                icl_list_unlink( task->dependency_list, prev_dep->task_dependency_list_node_ptr );
                 /* Update the prev_dep_node ptr since it has changed */
                 prev_dep_node = icl_list_prev( address_set_node->waiting_deps, curr_dep_node);
             }
@@ -1724,18 +2090,105 @@ static void work_set_affinity_and_call_main_loop(Worker *worker)
     return;
 }
 
+/* **************************************************************************** */
+/**
+ * Take a task from the ready lists of victim_rank: the highest
+ * priority task from my own lists, locked tasks first within a
+ * bucket, or, if the victim is busy running a task, the lowest
+ * priority task that is not locked to a thread.
+ */
+static Task *worker_take_task(Quark *quark, int worker_rank, int victim_rank)
+{
+    Worker *victim = quark->worker[victim_rank];
+    Task *task = NULL;
+    int i;
+
+    /* Only look through the buckets if there is likely to be a task */
+    if ( quark_atomic_load( &victim->ready_list_size ) <= 0 ) return NULL;
+    if ( worker_rank == victim_rank ) {
+        for ( i = QUARK_PRIORITY_BUCKETS-1; i >= 0 && task == NULL; i-- ) {
+            task = ready_list_take( &victim->locked_list[i] );
+            if ( task == NULL )
+                task = ready_list_take( &victim->ready_list[i] );
+        }
+    } else if ( victim->executing_task == TRUE ) {
+        for ( i = 0; i < QUARK_PRIORITY_BUCKETS && task == NULL; i++ )
+            task = ready_list_take( &victim->ready_list[i] );
+    }
+    if ( task != NULL )
+        quark_atomic_fetch_add( &victim->ready_list_size, -1 );
+    return task;
+}
+
+/* **************************************************************************** */
+/**
+ * Block an idle worker until a task is inserted after the ready lists
+ * were last scanned (the ready_epoch differs from epoch), or the
+ * worker is told to finalize.  Returns TRUE if the worker blocked.
+ */
+static bool worker_park(Quark *quark, Worker *worker, long long epoch)
+{
+    bool waited = FALSE;
+    pthread_mutex_lock_wrap( &worker->park_mutex );
+    quark_atomic_store( &worker->parked, TRUE );
+    quark_atomic_fetch_add( &quark->num_parked, 1 );
+    while ( !worker->finalize && quark_atomic_load( &quark->ready_epoch ) == epoch ) {
+        pthread_cond_wait_ready_list( &worker->park_cond, &worker->park_mutex );
+        waited = TRUE;
+    }
+    quark_atomic_fetch_add( &quark->num_parked, -1 );
+    quark_atomic_store( &worker->parked, FALSE );
+    pthread_mutex_unlock_wrap( &worker->park_mutex );
+    return waited;
+}
+
+/* **************************************************************************** */
+/**
+ * Wake a worker blocked in worker_park.
+ */
+static void worker_wake(Worker *worker)
+{
+    pthread_mutex_lock_wrap( &worker->park_mutex );
+    pthread_cond_signal( &worker->park_cond );
+    pthread_mutex_unlock_wrap( &worker->park_mutex );
+}
+
+/* **************************************************************************** */
+/**
+ * Wake one parked worker, searching from the one after rank, so that
+ * it can steal from the busy worker rank.  worker_park only returns
+ * when the ready_epoch changes, so it is incremented first.
+ */
+static void worker_wake_thief(Quark *quark, int rank)
+{
+    int i;
+    if ( quark_atomic_load( &quark->num_parked ) <= 0 ) return;
+    for ( i = 1; i < quark->num_threads; i++ ) {
+        Worker *thief = quark->worker[(rank + i) % quark->num_threads];
+        if ( quark_atomic_load( &thief->parked ) ) {
+            quark_atomic_fetch_add( &quark->ready_epoch, 1 );
+            worker_wake( thief );
+            return;
+        }
+    }
+}
+
 /* **************************************************************************** */
 /**
  * Called by the workers (and master) to continue executing tasks
- * until some exit condition is reached.
+ * until some exit condition is reached.  Idle workers scan the ready
+ * lists up to worker->idle_spin times, then park until a task is
+ * inserted.  The spin limit doubles when a task turns up while
+ * spinning, and halves when the worker has to park, so workers stop
+ * burning CPU when the DAG is too narrow to keep them busy.
  */
 static void work_main_loop(Worker *worker)
 {
     Quark *quark = worker->quark_ptr;
-    Worker *worker_victim = NULL;
-    task_priority_tree_node_t *task_priority_tree_node = NULL;
     Task *task = NULL;
     int ready_list_victim = -1;
+    int spins = 0;
+    long long epoch = 0;
 
     /* Busy wait while not ready */
     do {} while ( !quark->start );
@@ -1753,55 +2206,38 @@ static void work_main_loop(Worker *worker)
          * then trying to steal from someone else */
         task = NULL;
         ready_list_victim = worker_rank;
+        spins = 0;
+        epoch = quark_atomic_load( &quark->ready_epoch );
         /* Loop while looking for tasks */
         while ( task==NULL && !worker->finalize ) {
 
             /* Process all completed tasks before doing work */
             if ( worker_rank==0 || worker_rank%10==1 ) process_completed_tasks(quark);
 
-            worker_victim = quark->worker[ready_list_victim];
-            task_priority_tree_node = NULL;
-            assert ( worker_victim->ready_list_size >= 0 );
-            if ( worker_victim->ready_list_size != 0 ) {
-                /* Only lock if there is likely to be an item in the ready list */
-                if ( pthread_mutex_trylock_ready_list( &worker_victim->ready_list_mutex ) == 0) {
-                    /* if (pthread_mutex_lock_ready_list(&worker_victim->ready_list_mutex)==0) { */
-                    /* Check front of my own queue, back of everyone else's queue */
-                    if ( worker_rank == ready_list_victim )
-                        task_priority_tree_node = RB_MIN( task_priority_tree_head_s, worker_victim->ready_list );
-                    else if ( worker_rank!=ready_list_victim && worker_victim->executing_task==TRUE )
-                        task_priority_tree_node = RB_MAX( task_priority_tree_head_s, worker_victim->ready_list );
-                    else
-                        task_priority_tree_node = NULL;
-                    /* Access task, checking to make sure it is not pinned to a thread */
-                    if ( task_priority_tree_node != NULL ) {
-                        task = task_priority_tree_node->task;
-                        /* If task should be locked to a thread, and this is not that thread, set task to NULL and continue */
-                        if ( task->lock_to_thread>=0 && task->lock_to_thread!=worker_rank) {
-                            task = NULL;
-                        } else {
-                            /* If task found, remove it from the ready list */
-                            RB_REMOVE( task_priority_tree_head_s, worker_victim->ready_list, task_priority_tree_node );
-                            free( task_priority_tree_node );
-                            worker_victim->ready_list_size--;
-                        }
-                    }
-                    pthread_mutex_unlock_ready_list( &worker_victim->ready_list_mutex );
-                }
-            }
+            task = worker_take_task( quark, worker_rank, ready_list_victim );
             /* If no task found */
             if (task == NULL) {
                 /* Choose the next victim queue */
                 ready_list_victim = (ready_list_victim + 1) % quark->num_threads;
                 /* Break for master when a scan of all queues is finished and no tasks were found */
                 if ( worker_rank==0 && ready_list_victim==0 ) break;
-                /* If there are no tasks, wait for a task to be introduced, then check own queue first */
-                if ( quark->num_queued_tasks==0 && !worker->finalize && worker_rank!=0 )  {
-                    do { assert( quark->num_queued_tasks >= 0); } while ( quark->num_queued_tasks==0 && !worker->finalize ) ;
-                    ready_list_victim = worker_rank;
+                /* After a scan of all queues, spin or park, then check own queue first */
+                if ( ready_list_victim == worker_rank ) {
+                    if ( ++spins < worker->idle_spin ) {
+                        quark_cpu_relax();
+                    } else {
+                        /* Do not leave completed tasks behind while parked */
+                        process_completed_tasks(quark);
+                        if ( worker_park( quark, worker, epoch ) && worker->idle_spin > 1 )
+                            worker->idle_spin /= 2;
+                        spins = 0;
+                    }
+                    epoch = quark_atomic_load( &quark->ready_epoch );
                 }
             }
         }
+        if ( task!=NULL && spins > 0 && worker->idle_spin < quark->idle_spin_max )
+            worker->idle_spin = ( 2*worker->idle_spin < quark->idle_spin_max ? 2*worker->idle_spin : quark->idle_spin_max );
         /* EXECUTE THE TASK IF FOUND */
         if ( task!=NULL ) {
             //if ( quark->num_tasks != 1 ) { printf("quark->num_tasks %d %d %d\n", quark->num_tasks, quark->low_water_mark, quark->high_water_mark ); abort(); }
@@ -1815,10 +2251,19 @@ static void work_main_loop(Worker *worker)
                 worker->executing_task = TRUE;
                 task->status = RUNNING;
                 pthread_mutex_unlock_wrap( &task->task_mutex );
-                scratch_allocate( task );
+                /* Tasks queued here while this worker was looking for
+                 * one woke nobody, since it was not busy; now that it
+                 * is, let a parked worker steal them.  The read-modify-write
+                 * orders the store to executing_task before the read of the
+                 * size, as the insertion does the other way round */
+                if ( quark_atomic_fetch_add( &worker->ready_list_size, 0 ) > 0 )
+                    worker_wake_thief( quark, worker_rank );
+                scratch_allocate( worker, task );
                 worker->current_task_ptr = task;
+                double start = quark_get_time();
                 task->function( quark );
-                scratch_deallocate( task );
+                worker->busy_time += quark_get_time() - start;
+                scratch_deallocate( worker, task );
                 task->status = DONE;
                 worker->executing_task = FALSE;
             }
@@ -2016,7 +2461,7 @@ static void worker_remove_completed_task_enqueue_for_later_processing(Quark *qua
     threads_remaining_for_this_task = --task->task_thread_count;
     pthread_mutex_unlock_wrap( &task->task_mutex );
     if ( threads_remaining_for_this_task == 0 ) {
-        completed_tasks_node_t *node = malloc(sizeof(completed_tasks_node_t));
+        completed_tasks_node_t *node = &task->completed_node;
         node->task = task;
         node->workerid = worker_rank;
         pthread_mutex_lock_completed_tasks( &quark->completed_tasks_mutex );
@@ -2042,7 +2487,6 @@ static void process_completed_tasks(Quark *quark)
             }
             if ( node != NULL ) {
                 remove_completed_task_and_check_for_ready( quark, node->task, node->workerid );
-                free( node );
             }
             pthread_mutex_unlock_asn( &quark->address_set_mutex );
         }
@@ -2097,7 +2541,7 @@ static void remove_completed_task_and_check_for_ready(Quark *quark, Task *task,
             quark_avoid_war_dependencies( quark, address_set_node, task );
         }
         /* Remove competed dependency from address_set_node waiting_deps list */
-        icl_list_delete( address_set_node->waiting_deps, dep->address_set_waiting_deps_node_ptr, NULL );
+        icl_list_unlink( address_set_node->waiting_deps, dep->address_set_waiting_deps_node_ptr );
         /* Check initial INPUT next_deps attached to address_set_node */
         address_set_node_initial_input_check_and_launch( quark, address_set_node, dep, worker_rank );
        /* Handle any initial GATHERV dependencies */
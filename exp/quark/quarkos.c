@@ -59,6 +59,14 @@ kern_return_t thread_policy_set(thread_act_t thread, thread_policy_flavor_t flav
 // maximum cores per context
 #define CONTEXT_THREADS_MAX  256
 
+/* When linked with MAGMA built with -DMAGMA_SETAFFINITY, bind workers using
+ * its topology-aware placement ($MAGMA_AFFINITY), instead of worker i on CPU i. */
+#if (defined QUARK_OS_LINUX) && (defined __GNUC__)
+#define QUARK_HAVE_MAGMA_AFFINITY 1
+#pragma weak magma_affinity_get_cpu
+int magma_affinity_get_cpu(int thread_nr);
+#endif
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -194,6 +202,26 @@ int quark_yield() {
 #endif
 }
 
+/** ****************************************************************************
+   Wall clock time in seconds, to account the time spent in tasks.
+ */
+#ifndef QUARK_OS_WINDOWS
+#include <sys/time.h>
+#endif
+
+double quark_get_time() {
+#if QUARK_OS_WINDOWS
+    LARGE_INTEGER count, freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1.e-6;
+#endif
+}
+
 #ifdef QUARK_OS_WINDOWS
 #define QUARK_GETENV(var, str) {                    \
         int len = 512;                               \
@@ -250,6 +278,13 @@ int *quark_get_affthreads(/* int *coresbind */) {
     /* Env variable does not exist, we search the system number of core */
     QUARK_GETENV("QUARK_AFF_THREADS", envstr);
     if ( envstr == NULL) {
+#if (defined QUARK_HAVE_MAGMA_AFFINITY)
+        if ( magma_affinity_get_cpu != NULL && magma_affinity_get_cpu( 0 ) >= 0 ) {
+            for (i = 0; i < CONTEXT_THREADS_MAX; i++)
+                coresbind[i] = magma_affinity_get_cpu( i );
+        }
+        else
+#endif
         for (i = 0; i < CONTEXT_THREADS_MAX; i++)
             coresbind[i] = i % sys_corenbr;
     }
@@ -10,7 +10,10 @@
 */
 #include "common_magma.h"
 
-#define  A(m,n) (a+(n)*(*lda)+(m))
+// in the tile layout, the tile at rows m and columns n
+#define  A(m,n) (a+(n)*(*lda)+(m)*(tiled ? min(nb,(cols)-(n)) : 1))
+// distance between the tiles of block column n, 0 in column-major layout
+#define  STRIDE(n) (tiled ? nb*min(nb,(cols)-(n)) : 0)
 #define  T(m) (work+(m)*(nb))
 #define  W(k,n) &(local_work[(mt)*(n-1)+(k)])
 
@@ -68,7 +71,14 @@ void SCHED_zlarfb(Quark* quark)
   cuDoubleComplex *T;
   cuDoubleComplex **W;
 
-  quark_unpack_args_13(quark, M, N, MM, NN, IB, V, LDV, C, LDC, T, LDT, W, LDW);
+  magma_int_t NB;
+  magma_int_t STRIDEV;
+  magma_int_t STRIDEC;
+
+  magma_int_t r, KK;
+
+  quark_unpack_args_16(quark, M, N, MM, NN, IB, V, LDV, C, LDC, T, LDT, W, LDW,
+    NB, STRIDEV, STRIDEC);
 
   if (M < 0) {
     printf("SCHED_zlarfb:  illegal value of M\n");
@@ -91,8 +101,21 @@ void SCHED_zlarfb(Quark* quark)
 
   magma_int_t K=M-MM;
 
-  blasf77_zgemm(MagmaConjTransStr, "n", &NN, &MM, &K,
-    &c_one, &C[MM], &LDC, &V[MM], &LDV, &c_one, *W, &LDW);
+  if (STRIDEV == 0) {
+
+    blasf77_zgemm(MagmaConjTransStr, "n", &NN, &MM, &K,
+      &c_one, &C[MM], &LDC, &V[MM], &LDV, &c_one, *W, &LDW);
+
+  } else {
+
+    // one tile of V and C at a time; K > 0 only if MM = NB
+    for (r = MM; r < M; r += NB) {
+      KK = min(NB, M-r);
+      blasf77_zgemm(MagmaConjTransStr, "n", &NN, &MM, &KK,
+        &c_one, C+(r/NB)*STRIDEC, &LDC, V+(r/NB)*STRIDEV, &LDV, &c_one, *W, &LDW);
+    }
+
+  }
 
   blasf77_ztrmm("r", "u", "n", "n", 
     &NN, &MM, &c_one, T, &LDT, *W, &LDW);
@@ -111,11 +134,12 @@ void SCHED_zgeqrt(Quark* quark)
   magma_int_t LDT;
   cuDoubleComplex *TAU;
   cuDoubleComplex *WORK;
+  magma_int_t STRIDE;
 
   magma_int_t iinfo;
   magma_int_t lwork=-1;
 
-  quark_unpack_args_9(quark, M, N, IB, A, LDA, T, LDT, TAU, WORK);
+  quark_unpack_args_10(quark, M, N, IB, A, LDA, T, LDT, TAU, WORK, STRIDE);
 
   if (M < 0) { 
     printf("SCHED_zgeqrt: illegal value of M\n");
@@ -129,7 +153,7 @@ void SCHED_zgeqrt(Quark* quark)
     printf("SCHED_zgeqrt: illegal value of IB\n");
   }
 
-  if ((LDA < max(1,M)) && (M > 0)) {
+  if ((LDA < max(1,M)) && (M > 0) && (STRIDE == 0)) {
     printf("SCHED_zgeqrt: illegal value of LDA\n");
   }
 
@@ -137,11 +161,25 @@ void SCHED_zgeqrt(Quark* quark)
     printf("SCHED_zgeqrt: illegal value of LDT\n");
   }
 
-  lapackf77_zgeqrf(&M, &N, A, &LDA, TAU, WORK, &lwork, &iinfo);
+  // in the tile layout, factor the stack of tiles as one column-major panel
+  cuDoubleComplex *P = A;
+  magma_int_t LDP = LDA;
+  if (STRIDE != 0) {
+    P = (cuDoubleComplex*) malloc(M*N*sizeof(cuDoubleComplex));
+    LDP = M;
+    magma_ztile_copy(1, M, N, A, LDA, STRIDE, IB, P, LDP);
+  }
+
+  lapackf77_zgeqrf(&M, &N, P, &LDP, TAU, WORK, &lwork, &iinfo);
   lwork=(magma_int_t)MAGMA_Z_REAL(WORK[0]);
-  lapackf77_zgeqrf(&M, &N, A, &LDA, TAU, WORK, &lwork, &iinfo);
+  lapackf77_zgeqrf(&M, &N, P, &LDP, TAU, WORK, &lwork, &iinfo);
 
-  lapackf77_zlarft("F", "C", &M, &N, A, &LDA, TAU, T, &LDT);
+  lapackf77_zlarft("F", "C", &M, &N, P, &LDP, TAU, T, &LDT);
+
+  if (STRIDE != 0) {
+    magma_ztile_copy(0, M, N, A, LDA, STRIDE, IB, P, LDP);
+    free(P);
+  }
 
 }
 
@@ -205,10 +243,30 @@ static void SCHED_zgemm(Quark *quark)
 
   magma_int_t dkdk;
 
-  quark_unpack_args_13(quark, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, fake, dkdk);
+  magma_int_t nb;
+  magma_int_t stridea;
+  magma_int_t stridec;
+
+  magma_int_t r, mm;
+
+  quark_unpack_args_16(quark, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, fake, dkdk,
+    nb, stridea, stridec);
       
-  blasf77_zgemm("n", MagmaConjTransStr, 
-    &m, &n, &k, &alpha, a, &lda, *b, &ldb, &beta, c, &ldc);
+  if (stridea == 0) {
+
+    blasf77_zgemm("n", MagmaConjTransStr, 
+      &m, &n, &k, &alpha, a, &lda, *b, &ldb, &beta, c, &ldc);
+
+  } else {
+
+    // one tile of a and c at a time
+    for (r = 0; r < m; r += nb) {
+      mm = min(nb, m-r);
+      blasf77_zgemm("n", MagmaConjTransStr, 
+        &mm, &n, &k, &alpha, a+(r/nb)*stridea, &lda, *b, &ldb, &beta, c+(r/nb)*stridec, &ldc);
+    }
+
+  }
 
 }
 
@@ -227,8 +285,10 @@ void QUARK_Insert_Task_zgemm(Quark *quark, Quark_Task_Flags *task_flags,
   magma_int_t ldc,
   cuDoubleComplex *fake,
   char *dag_label,
-  magma_int_t priority, 
-  magma_int_t dkdk)
+  magma_int_t dkdk,
+  magma_int_t nb,
+  magma_int_t stridea,
+  magma_int_t stridec)
 {
 
   QUARK_Insert_Task(quark, SCHED_zgemm, task_flags,
@@ -244,8 +304,10 @@ void QUARK_Insert_Task_zgemm(Quark *quark, Quark_Task_Flags *task_flags,
     sizeof(cuDoubleComplex)*ldb*ldb, c,      INOUT | LOCALITY,
     sizeof(magma_int_t),           &ldc,   VALUE,
     sizeof(cuDoubleComplex)*ldb*ldb, fake,   OUTPUT | GATHERV,
-    sizeof(magma_int_t),           &priority, VALUE | TASK_PRIORITY,
     sizeof(magma_int_t),&dkdk,VALUE,
+    sizeof(magma_int_t),           &nb,    VALUE,
+    sizeof(magma_int_t),           &stridea, VALUE,
+    sizeof(magma_int_t),           &stridec, VALUE,
     strlen(dag_label)+1,   dag_label, VALUE | TASKLABEL,
 6,                     "purple",   VALUE | TASKCOLOR,
     0);
@@ -263,8 +325,7 @@ void QUARK_Insert_Task_ztrmm(Quark *quark, Quark_Task_Flags *task_flags,
   cuDoubleComplex beta,
   cuDoubleComplex *c,
   magma_int_t ldc,
-  char *dag_label,
-  magma_int_t priority)
+  char *dag_label)
 {
 
   QUARK_Insert_Task(quark, SCHED_ztrmm, task_flags,
@@ -279,7 +340,6 @@ void QUARK_Insert_Task_ztrmm(Quark *quark, Quark_Task_Flags *task_flags,
     sizeof(cuDoubleComplex)*ldb*ldb, c,      INOUT | LOCALITY,
     sizeof(magma_int_t),           &ldc,   VALUE,
     sizeof(cuDoubleComplex)*ldb*ldb, NULL,   SCRATCH,
-    sizeof(magma_int_t),           &priority, VALUE | TASK_PRIORITY,
     strlen(dag_label)+1,   dag_label, VALUE | TASKLABEL,
     6,                     "orange",   VALUE | TASKCOLOR,
     0);
@@ -294,11 +354,10 @@ void QUARK_Insert_Task_zgeqrt(Quark *quark, Quark_Task_Flags *task_flags,
   cuDoubleComplex *t,
   magma_int_t ldt,
   cuDoubleComplex *tau,
+  magma_int_t stride,
   char *dag_label)
 {
 
-  magma_int_t priority = 1000;
-
   QUARK_Insert_Task(quark, SCHED_zgeqrt, task_flags,
     sizeof(magma_int_t),           &m,        VALUE,
     sizeof(magma_int_t),           &n,        VALUE,
@@ -309,7 +368,7 @@ void QUARK_Insert_Task_zgeqrt(Quark *quark, Quark_Task_Flags *task_flags,
     sizeof(magma_int_t),           &ldt,      VALUE,
     sizeof(cuDoubleComplex)*ldt,     tau,       OUTPUT,
     sizeof(cuDoubleComplex)*ldt*ldt, NULL,      SCRATCH,
-    sizeof(magma_int_t),           &priority, VALUE | TASK_PRIORITY,
+    sizeof(magma_int_t),           &stride,   VALUE,
     strlen(dag_label)+1,   dag_label, VALUE | TASKLABEL,
     6,                     "green",   VALUE | TASKCOLOR,
     0);
@@ -332,7 +391,9 @@ void QUARK_Insert_Task_zlarfb(Quark *quark, Quark_Task_Flags *task_flags,
   cuDoubleComplex **w,
   magma_int_t ldw,
   char *dag_label,
-  magma_int_t priority)
+  magma_int_t nb,
+  magma_int_t stridev,
+  magma_int_t stridec)
 
 {
 
@@ -350,13 +411,158 @@ void QUARK_Insert_Task_zlarfb(Quark *quark, Quark_Task_Flags *task_flags,
     sizeof(magma_int_t),         &ldt,      VALUE,
     sizeof(cuDoubleComplex*),      w,         OUTPUT | LOCALITY,
     sizeof(magma_int_t),         &ldw,      VALUE,
-    sizeof(magma_int_t),         &priority, VALUE | TASK_PRIORITY,
+    sizeof(magma_int_t),         &nb,       VALUE,
+    sizeof(magma_int_t),         &stridev,  VALUE,
+    sizeof(magma_int_t),         &stridec,  VALUE,
     strlen(dag_label)+1, dag_label, VALUE | TASKLABEL,
-    6,                   "cyan",    VALUE | TASKCOLOR,
+    5,                   "cyan",    VALUE | TASKCOLOR,
     0);
 
 }
 
+// inserts the tasks of the factorization, for A in column-major layout
+// or, if tiled, in the tile layout of magma_zlapack_to_tile_mc
+static void
+zgeqrf_mc_dag(magma_context *cntxt, magma_int_t *m, magma_int_t *n,
+              cuDoubleComplex *a, magma_int_t *lda, cuDoubleComplex *tau,
+              cuDoubleComplex *work, magma_int_t tiled)
+{
+  magma_int_t i,j,l;
+
+  magma_int_t ii=-1,jj=-1,ll=-1;
+
+  Quark* quark = cntxt->quark;
+
+  // DAG labels
+  char sgeqrt_dag_label[1000]; 
+  char slarfb_dag_label[1000];
+  char strmm_dag_label[1000];
+  char sgemm_dag_label[1000];
+
+  cuDoubleComplex c_one = MAGMA_Z_ONE;
+  cuDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
+
+  magma_int_t nb = (cntxt->nb ==-1)? magma_get_zpotrf_nb(*n): cntxt->nb;
+
+  // leading dimension of the tiles
+  magma_int_t cols = *n;
+  magma_int_t ld = tiled ? nb : *lda;
+
+  magma_int_t k = min(*m,*n);
+
+  magma_int_t nt = (((*n)%nb) == 0) ? (*n)/nb : (*n)/nb + 1;
+  magma_int_t mt = (((*m)%nb) == 0) ? (*m)/nb : (*m)/nb + 1;
+
+  cuDoubleComplex **local_work = (cuDoubleComplex**) malloc(sizeof(cuDoubleComplex*)*(nt-1)*mt);
+  memset(local_work, 0, sizeof(cuDoubleComplex*)*(nt-1)*mt);
+
+  // a task applying panel k to block column j has priority
+  // magma_task_priority(cntxt, j-k)
+  Quark_Task_Flags task_flags = Quark_Task_Flags_Initializer;
+
+  // traverse diagonal blocks
+  for (i = 0; i < k; i += nb) {
+
+    ii++;
+
+    jj = ii;
+
+    sprintf(sgeqrt_dag_label, "GEQRT %d",ii);
+
+    // factor diagonal block, also compute T matrix
+    QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, 0));
+
+    QUARK_Insert_Task_zgeqrt(quark, 
+      &task_flags, (*m)-i, min(nb,(*n)-i), A(i,i), ld, T(i), nb, &tau[i], STRIDE(i), sgeqrt_dag_label);
+
+    if (i > 0) {
+
+      // update panels in a left looking fashion
+      for (j = (i-nb) + (2*nb); j < *n; j += nb) { 
+
+        jj++;
+
+        ll = ii-1;
+
+        sprintf(slarfb_dag_label, "LARFB %d %d",ii-1, jj);
+
+        QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, jj-(ii-1)));
+
+        // perform part of update
+        QUARK_Insert_Task_zlarfb(quark, &task_flags, 
+          (*m)-(i-nb), min(nb,(*n)-(i-nb)), min(nb,(*m)-(i-nb)), min(nb,(*n)-j), nb, 
+          A(i-nb,i-nb), ld, A(i-nb,j), ld, T(i-nb), nb, W(ii-1,jj), nb, slarfb_dag_label,
+          nb, STRIDE(i-nb), STRIDE(j));
+
+        sprintf(strmm_dag_label, "TRMM %d %d",ii-1, jj);
+
+        // perform more of update
+        QUARK_Insert_Task_ztrmm(quark, &task_flags, min(nb,(*m)-(i-nb)), min(nb,(*n)-j), c_neg_one, 
+          A(i-nb,i-nb), ld, W(ii-1,jj), nb, c_one, A(i-nb,j), ld, strmm_dag_label);
+
+          sprintf(sgemm_dag_label, "GEMM %d %d %d",ii-1, jj, ll);
+
+          // finish update
+          QUARK_Insert_Task_zgemm(quark, &task_flags, (*m)-i, min(nb,(*n)-j), min(nb,(*n)-(i-nb)), c_neg_one,
+            A(i,i-nb), ld, W(ii-1,jj), nb, c_one, A(i,j), ld, A(i,j), sgemm_dag_label, jj,
+            nb, STRIDE(i-nb), STRIDE(j));
+
+      }
+
+    }
+
+    j = i + nb;
+
+    jj = ii;
+
+    // handle case of short wide rectangular matrix
+    if (j < (*n)) {
+
+      jj++;
+
+      ll = ii;
+
+      sprintf(slarfb_dag_label, "LARFB %d %d",ii, jj);
+
+      QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, jj-ii));
+
+      // perform part of update
+      QUARK_Insert_Task_zlarfb(quark, &task_flags, 
+        (*m)-i, min(nb,(*n)-i), min(nb,(*m)-i), min(nb,(*n)-j), nb, 
+        A(i,i), ld, A(i,j), ld, T(i), nb, W(ii,jj), nb, slarfb_dag_label,
+        nb, STRIDE(i), STRIDE(j));
+
+      sprintf(strmm_dag_label, "TRMM %d %d",ii, jj);
+
+      // perform more of update 
+      QUARK_Insert_Task_ztrmm(quark, &task_flags, min(nb,(*m)-i), min(nb,(*n)-j), c_neg_one, 
+        A(i,i), ld, W(ii,jj), nb, c_one, A(i,j), ld, strmm_dag_label);
+
+        sprintf(sgemm_dag_label, "GEMM %d %d %d",ii, jj, ll);
+
+        // finish update
+        QUARK_Insert_Task_zgemm(quark, &task_flags, (*m)-i-nb, min(nb,(*n)-j), min(nb,(*n)-i), c_neg_one,
+          A(i+nb,i), ld, W(ii,jj), nb, c_one, A(i+nb,j), ld, A(i+nb,j), sgemm_dag_label, jj,
+          nb, STRIDE(i), STRIDE(j));
+
+    }
+
+  }
+
+  // wait for all tasks to finish executing
+  QUARK_Barrier(quark);
+  
+  // free memory
+  for(k = 0 ; k < (nt-1)*mt; k++) {
+    if (local_work[k] != NULL) {
+      free(local_work[k]);
+    }
+  }
+  free(local_work);
+  
+}
+
+
 extern "C" magma_int_t 
 magma_zgeqrf_mc( magma_context *cntxt, magma_int_t *m, magma_int_t *n,
                  cuDoubleComplex *a,    magma_int_t *lda, cuDoubleComplex *tau,
@@ -374,6 +580,8 @@ magma_zgeqrf_mc( magma_context *cntxt, magma_int_t *m, magma_int_t *n,
 
     ZGEQRF computes a QR factorization of a complex M-by-N matrix A:   
     A = Q * R.   
+    The tasks on the critical path get higher priorities, for the   
+    CNTXT->lookahead block columns after each panel.   
 
     Arguments   
     =========   
@@ -438,22 +646,9 @@ magma_zgeqrf_mc( magma_context *cntxt, magma_int_t *m, magma_int_t *n,
     //return result;
   }
 
-  magma_int_t i,j,l;
-
-  magma_int_t ii=-1,jj=-1,ll=-1;
-
-  Quark* quark = cntxt->quark;
-
-  // DAG labels
-  char sgeqrt_dag_label[1000]; 
-  char slarfb_dag_label[1000];
-  char strmm_dag_label[1000];
-  char sgemm_dag_label[1000];
-
   *info = 0;
 
   cuDoubleComplex c_one = MAGMA_Z_ONE;
-  cuDoubleComplex c_neg_one = MAGMA_Z_NEG_ONE;
 
   magma_int_t nb = (cntxt->nb ==-1)? magma_get_zpotrf_nb(*n): cntxt->nb;
 
@@ -485,111 +680,109 @@ magma_zgeqrf_mc( magma_context *cntxt, magma_int_t *m, magma_int_t *n,
     return 0;
   }
 
-  magma_int_t nt = (((*n)%nb) == 0) ? (*n)/nb : (*n)/nb + 1;
-  magma_int_t mt = (((*m)%nb) == 0) ? (*m)/nb : (*m)/nb + 1;
-
-  cuDoubleComplex **local_work = (cuDoubleComplex**) malloc(sizeof(cuDoubleComplex*)*(nt-1)*mt);
-  memset(local_work, 0, sizeof(cuDoubleComplex*)*(nt-1)*mt);
-
-  magma_int_t priority;
-
-  // traverse diagonal blocks
-  for (i = 0; i < k; i += nb) {
-
-    ii++;
-
-    jj = ii;
-
-    sprintf(sgeqrt_dag_label, "GEQRT %d",ii);
-
-    // factor diagonal block, also compute T matrix
-    QUARK_Insert_Task_zgeqrt(quark, 
-      0, (*m)-i, min(nb,(*n)-i), A(i,i), *lda, T(i), nb, &tau[i], sgeqrt_dag_label);
-
-    if (i > 0) {
-
-      priority = 100;
+  zgeqrf_mc_dag(cntxt, m, n, a, lda, tau, work, 0);
 
-      // update panels in a left looking fashion
-      for (j = (i-nb) + (2*nb); j < *n; j += nb) { 
-
-        jj++;
-
-        ll = ii-1;
-
-        sprintf(slarfb_dag_label, "LARFB %d %d",ii-1, jj);
+  return MAGMA_SUCCESS;
+}
 
-        // perform part of update
-        QUARK_Insert_Task_zlarfb(quark, 0, 
-          (*m)-(i-nb), min(nb,(*n)-(i-nb)), min(nb,(*m)-(i-nb)), min(nb,(*n)-j), nb, 
-          A(i-nb,i-nb), *lda, A(i-nb,j), *lda, T(i-nb), nb, W(ii-1,jj), nb, slarfb_dag_label, priority);
+extern "C" magma_int_t 
+magma_zgeqrf_tile_mc( magma_context *cntxt, magma_int_t *m, magma_int_t *n,
+                      cuDoubleComplex *a,    magma_int_t *lda, cuDoubleComplex *tau,
+                      cuDoubleComplex *work, magma_int_t *lwork,
+                      magma_int_t *info)
+{
+/*  -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
 
-        sprintf(strmm_dag_label, "TRMM %d %d",ii-1, jj);
+    Purpose   
+    =======   
 
-        // perform more of update
-        QUARK_Insert_Task_ztrmm(quark, 0, min(nb,(*m)-(i-nb)), min(nb,(*n)-j), c_neg_one, 
-          A(i-nb,i-nb), *lda, W(ii-1,jj), nb, c_one, A(i-nb,j), *lda, strmm_dag_label, priority);
+    ZGEQRF_TILE computes a QR factorization of a complex M-by-N matrix A   
+    stored in tile layout, as converted by magma_zlapack_to_tile_mc with   
+    the same context: A = Q * R.   
 
-          sprintf(sgemm_dag_label, "GEMM %d %d %d",ii-1, jj, ll);
+    The tasks are those of magma_zgeqrf_mc. The updates loop over the   
+    tiles of a block column, and each panel is copied to a column-major   
+    array to be factored.   
 
-          // finish update
-          QUARK_Insert_Task_zgemm(quark, 0, (*m)-i, min(nb,(*n)-j), min(nb,(*n)-(i-nb)), c_neg_one,
-            A(i,i-nb), *lda, W(ii-1,jj), nb, c_one, A(i,j), *lda, A(i,j), sgemm_dag_label, priority, jj);
-
-      }
+    Arguments   
+    =========   
+    CNTXT   (input) MAGMA_CONTEXT
+            CNTXT specifies the MAGMA hardware context for this routine.   
 
-    }
+    M       (input) INTEGER   
+            The number of rows of the matrix A.  M >= 0.   
 
-    j = i + nb;
+    N       (input) INTEGER   
+            The number of columns of the matrix A.  N >= 0.   
 
-    jj = ii;
+    A       (input/output) COMPLEX_16 array, dimension (LDA,N)   
+            On entry, the M-by-N matrix A in tile layout.   
+            On exit, R and the elementary reflectors as for   
+            magma_zgeqrf_mc, in tile layout.   
 
-    // handle case of short wide rectangular matrix
-    if (j < (*n)) {
+    LDA     (input) INTEGER   
+            The leading dimension of the array A in tile layout.   
+            LDA >= max(1,MT*NB), MT = ceil(M/NB).   
 
-      priority = 0;
+    TAU     (output) COMPLEX_16 array, dimension (min(M,N))   
+            The scalar factors of the elementary reflectors.   
 
-      jj++;
+    WORK    (workspace/output) COMPLEX_16 array, dimension (MAX(1,LWORK))   
+            On exit, if INFO = 0, WORK(1) returns the optimal LWORK.   
 
-      ll = ii;
+    LWORK   (input) INTEGER   
+            The dimension of the array WORK.  LWORK >= N*NB, or -1 for   
+            a workspace query, as for magma_zgeqrf_mc.   
 
-      sprintf(slarfb_dag_label, "LARFB %d %d",ii, jj);
+    INFO    (output) INTEGER   
+            = 0:  successful exit   
+            < 0:  if INFO = -i, the i-th argument had an illegal value   
+    ====================================================================    */
 
-      // perform part of update
-      QUARK_Insert_Task_zlarfb(quark, 0, 
-        (*m)-i, min(nb,(*n)-i), min(nb,(*m)-i), min(nb,(*n)-j), nb, 
-        A(i,i), *lda, A(i,j), *lda, T(i), nb, W(ii,jj), nb, slarfb_dag_label, priority);
+  *info = 0;
 
-      sprintf(strmm_dag_label, "TRMM %d %d",ii, jj);
+  cuDoubleComplex c_one = MAGMA_Z_ONE;
 
-      // perform more of update 
-      QUARK_Insert_Task_ztrmm(quark, 0, min(nb,(*m)-i), min(nb,(*n)-j), c_neg_one, 
-        A(i,i), *lda, W(ii,jj), nb, c_one, A(i,j), *lda, strmm_dag_label, priority);
+  magma_int_t nb = (cntxt->nb ==-1)? magma_get_zpotrf_nb(*n): cntxt->nb;
 
-        sprintf(sgemm_dag_label, "GEMM %d %d %d",ii, jj, ll);
+  magma_int_t lwkopt = *n * nb;
+  work[0] = MAGMA_Z_MAKE( (double)lwkopt, 0 );
 
-        // finish update
-        QUARK_Insert_Task_zgemm(quark, 0, (*m)-i-nb, min(nb,(*n)-j), min(nb,(*n)-i), c_neg_one,
-          A(i+nb,i), *lda, W(ii,jj), nb, c_one, A(i+nb,j), *lda, A(i+nb,j), sgemm_dag_label, priority, jj);
+  long int lquery = *lwork == -1;
 
+  // check input arguments
+  if (*m < 0) {
+    *info = -1;
+  } else if (*n < 0) {
+    *info = -2;
+  } else if (*lda < max(1,((*m)+nb-1)/nb*nb)) {
+    *info = -4;
+  } else if (*lwork < max(1,*n) && ! lquery) {
+    *info = -7;
+  }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return MAGMA_ERR_ILLEGAL_VALUE;
     }
+  else if (lquery)
+    return 0;
 
+  if (min(*m,*n) == 0) {
+    work[0] = c_one;
+    return 0;
   }
 
-  // wait for all tasks to finish executing
-  QUARK_Barrier(quark);
-  
-  // free memory
-  for(k = 0 ; k < (nt-1)*mt; k++) {
-    if (local_work[k] != NULL) {
-      free(local_work[k]);
-    }
-  }
-  free(local_work);
-  
+  zgeqrf_mc_dag(cntxt, m, n, a, lda, tau, work, 1);
+
+  return MAGMA_SUCCESS;
 }
 
 #undef A
+#undef STRIDE
 #undef T
 #undef W
 
@@ -9,8 +9,15 @@
 
 */
 #include "common_magma.h"
+#include <sched.h>
 
-#define  A(m,n) (a+(n)*(*lda)+(m))
+#define PRECISION_z
+
+// in the tile layout, the tile at rows m and columns n
+#define  A(m,n) (a+(n)*(*lda)+(m)*(tiled ? min(nb,(cols)-(n)) : 1))
+
+// distance between the tiles of block column n, 0 in column-major layout
+#define  STRIDE(n) (tiled ? nb*min(nb,(cols)-(n)) : 0)
 
 /* Task execution code */
 static void SCHED_zgemm(Quark* quark)
@@ -46,14 +53,15 @@ static void SCHED_panel_update(Quark* quark)
   int K;
   cuDoubleComplex *A3;
   cuDoubleComplex *A4;
+  int STRIDE;
 
-  int ione=1;
   cuDoubleComplex mone = MAGMA_Z_NEG_ONE;
   cuDoubleComplex one = MAGMA_Z_ONE;
     
-  quark_unpack_args_10(quark, N, A1, LDA, K2, IPIV, A2, M, K, A3, A4);
+  quark_unpack_args_11(quark, N, A1, LDA, K2, IPIV, A2, M, K, A3, A4, STRIDE);
 
-  lapackf77_zlaswp(&N, A1, &LDA, &ione, &K2, IPIV, &ione); 
+  /* the pivots reach below A1, into the tiles under it; K = nb */
+  magma_ztile_laswp(N, A1, LDA, STRIDE, K, K2, IPIV);
 
   blasf77_ztrsm("l", "l", "n", "u",
     &K2, &N, &one, A2, &LDA, A1, &LDA);
@@ -67,6 +75,240 @@ static void SCHED_panel_update(Quark* quark)
 
 }
 
+/* Most threads a panel task runs on */
+#define ZGETRF_PANEL_MAXTHREADS 48
+
+/* State shared by the threads of one multi-threaded panel task. QUARK
+   runs the task function once on each of its threads, and does not
+   tell a thread its rank within the task, so the threads take ranks
+   from a counter as they arrive. The pivot candidates of the threads
+   are kept apart from each other to avoid false sharing. */
+typedef struct {
+  int thcnt;
+  double sfmin;
+  volatile int rank;
+  volatile int arrived;
+  volatile int sense;
+  cuDoubleComplex *panel;
+  struct {
+    cuDoubleComplex val;
+    double amax;
+    int imax;
+    char pad[64];
+  } cand[ZGETRF_PANEL_MAXTHREADS];
+} zgetrf_panel_t;
+
+/* Sense-reversing barrier of the threads of a panel task; each thread
+   keeps its own sense, starting at 0 */
+static void zgetrf_panel_barrier(zgetrf_panel_t *p, int *sense)
+{
+  *sense = !(*sense);
+
+  if (__sync_add_and_fetch(&p->arrived, 1) == p->thcnt) {
+    p->arrived = 0;
+    __sync_synchronize();
+    p->sense = *sense;
+  } else {
+    int spins = 0;
+    while (p->sense != *sense) {
+      /* yield if the cores are oversubscribed */
+      if (++spins == 10000) {
+        sched_yield();
+        spins = 0;
+      }
+    }
+  }
+
+  __sync_synchronize();
+}
+
+/* Splits n items among cnt threads; thread idx gets *size items from *off */
+static void zgetrf_psplit(int n, int idx, int cnt, int *off, int *size)
+{
+  int q = n / cnt, r = n % cnt;
+
+  if (idx < r) {
+    *size = q + 1;
+    *off  = idx * (q + 1);
+  } else {
+    *size = q;
+    *off  = r * (q + 1) + (idx - r) * q;
+  }
+}
+
+/* The magnitude izamax uses */
+static inline double zgetrf_cabs1(cuDoubleComplex z)
+{
+#if defined(PRECISION_z) || defined(PRECISION_c)
+  return fabs(MAGMA_Z_REAL(z)) + fabs(MAGMA_Z_IMAG(z));
+#else
+  return fabs(z);
+#endif
+}
+
+/* Applies the interchanges of rows k1 to k2-1 of IPIV to n columns of A */
+static void zgetrf_laswp1(int n, cuDoubleComplex *A, int LDA,
+                          int k1, int k2, const int *IPIV)
+{
+  int i, j;
+  cuDoubleComplex tmp;
+
+  for (j = 0; j < n; j++) {
+    for (i = k1; i < k2; i++) {
+      tmp = A[j*LDA + IPIV[i] - 1];
+      A[j*LDA + IPIV[i] - 1] = A[j*LDA + i];
+      A[j*LDA + i] = tmp;
+    }
+  }
+}
+
+/* Updates the n2 columns right of the n1 columns factored from column
+   COL: swaps and triangular solve split by columns, then the gemm split
+   by rows */
+static void zgetrf_reclap_update(int M, int COL, int n1, int n2,
+                                 cuDoubleComplex *A, int LDA, int *IPIV,
+                                 zgetrf_panel_t *p, int thidx, int *sense)
+{
+  cuDoubleComplex mone = MAGMA_Z_NEG_ONE;
+  cuDoubleComplex one = MAGMA_Z_ONE;
+
+  cuDoubleComplex *A1 = A + COL*LDA;
+  cuDoubleComplex *A2 = A1 + n1*LDA;
+  int off, size;
+
+  zgetrf_panel_barrier(p, sense);
+
+  zgetrf_psplit(n2, thidx, p->thcnt, &off, &size);
+
+  if (size > 0) {
+    zgetrf_laswp1(size, A2 + off*LDA, LDA, COL, COL + n1, IPIV);
+
+    blasf77_ztrsm("l", "l", "n", "u",
+      &n1, &size, &one, A1 + COL, &LDA, A2 + off*LDA + COL, &LDA);
+  }
+
+  zgetrf_panel_barrier(p, sense);
+
+  zgetrf_psplit(M, thidx, p->thcnt, &off, &size);
+  if (thidx == 0) {
+    size -= COL + n1;
+    off = COL + n1;
+  }
+
+  blasf77_zgemm("n", "n",
+    &size, &n2, &n1, &mone, A1 + off, &LDA, A2 + COL, &LDA, &one, A2 + off, &LDA);
+}
+
+/* Factors the N columns of the M-by-N panel A from column COL,
+   recursively splitting them in halves; each row of A belongs to one
+   thread, and the threads agree on each pivot through p->cand */
+static void zgetrf_reclap_rec(int M, int N, int COL,
+                              cuDoubleComplex *A, int LDA, int *IPIV, int *info,
+                              zgetrf_panel_t *p, int thidx, int *sense)
+{
+  cuDoubleComplex *A1 = A + COL*LDA;
+  int off, size;
+
+  if (N > 1) {
+
+    int n1 = N / 2;
+    int n2 = N - n1;
+
+    zgetrf_reclap_rec(M, n1, COL, A, LDA, IPIV, info, p, thidx, sense);
+
+    zgetrf_reclap_update(M, COL, n1, n2, A, LDA, IPIV, p, thidx, sense);
+
+    zgetrf_reclap_rec(M, n2, COL + n1, A, LDA, IPIV, info, p, thidx, sense);
+
+    /* apply the interchanges of the right half to the left half */
+    zgetrf_psplit(n1, thidx, p->thcnt, &off, &size);
+    if (size > 0)
+      zgetrf_laswp1(size, A1 + off*LDA, LDA, COL + n1, COL + N, IPIV);
+
+  } else {
+
+    int i, j, jp = 0, w = 0, ione = 1;
+    double amax = -1.;
+    cuDoubleComplex diag, piv, rpiv;
+
+    zgetrf_panel_barrier(p, sense);
+
+    zgetrf_psplit(M, thidx, p->thcnt, &off, &size);
+    if (thidx == 0) {
+      size -= COL;
+      off = COL;
+    }
+
+    diag = A1[COL];
+
+    for (i = 0; i < size; i++) {
+      if (zgetrf_cabs1(A1[off + i]) > amax) {
+        amax = zgetrf_cabs1(A1[off + i]);
+        jp = i;
+      }
+    }
+
+    p->cand[thidx].val  = A1[off + jp];
+    p->cand[thidx].amax = amax;
+    p->cand[thidx].imax = off + jp;
+
+    zgetrf_panel_barrier(p, sense);
+
+    /* the first of the largest candidates, as izamax */
+    for (j = 1; j < p->thcnt; j++)
+      if (p->cand[j].amax > p->cand[w].amax)
+        w = j;
+
+    piv = p->cand[w].val;
+
+    if (!MAGMA_Z_EQUAL(piv, MAGMA_Z_ZERO)) {
+
+      j = (thidx == 0) ? 1 : 0;
+      size -= j;
+
+      if (MAGMA_Z_ABS(piv) >= p->sfmin) {
+        rpiv = MAGMA_Z_DIV(MAGMA_Z_ONE, piv);
+        blasf77_zscal(&size, &rpiv, A1 + off + j, &ione);
+      } else {
+        for (i = 0; i < size; i++)
+          A1[off + j + i] = MAGMA_Z_DIV(A1[off + j + i], piv);
+      }
+
+      /* the row swap within this column */
+      if (thidx == w && p->cand[w].imax != COL)
+        A1[p->cand[w].imax] = MAGMA_Z_DIV(diag, piv);
+
+    } else if (*info == 0) {
+      *info = COL + 1;
+    }
+
+    if (thidx == 0) {
+      A1[COL] = piv;
+      IPIV[COL] = p->cand[w].imax + 1;
+    }
+
+    zgetrf_panel_barrier(p, sense);
+  }
+}
+
+/* Recursive LU factorization of the M-by-N column-major panel A, with
+   partial pivoting, by the p->thcnt threads of a panel task; thidx is
+   the rank of the calling thread. Needs p->thcnt <= M/N, so that the
+   rows of thread 0 hold the diagonal. Returns INFO as zgetrf. */
+static int zgetrf_reclap(int M, int N, cuDoubleComplex *A, int LDA, int *IPIV,
+                         zgetrf_panel_t *p, int thidx, int *sense)
+{
+  int info = 0;
+  int minMN = min(M, N);
+
+  zgetrf_reclap_rec(M, minMN, 0, A, LDA, IPIV, &info, p, thidx, sense);
+
+  if (N > minMN)
+    zgetrf_reclap_update(M, 0, minMN, N - minMN, A, LDA, IPIV, p, thidx, sense);
+
+  return info;
+}
+
 /* Task execution code */
 void SCHED_zgetrf(Quark* quark)
 {
@@ -78,11 +320,69 @@ void SCHED_zgetrf(Quark* quark)
 
   int *iinfo;
 
+  int NB;
+  int STRIDE;
+
+  zgetrf_panel_t *PANEL;
+
   int info;
 
-  quark_unpack_args_5(quark, M, N, A, LDA, IPIV);
+  quark_unpack_args_9(quark, M, N, A, LDA, IPIV, iinfo, NB, STRIDE, PANEL);
+
+  if (PANEL != NULL) {
+
+    /* one of the PANEL->thcnt threads of the task */
+    int thidx = __sync_fetch_and_add(&PANEL->rank, 1);
+    int sense = 0;
 
-  lapackf77_zgetrf(&M, &N, A, &LDA, IPIV, &info); 
+    if (STRIDE == 0) {
+
+      info = zgetrf_reclap(M, N, A, LDA, IPIV, PANEL, thidx, &sense);
+
+    } else {
+
+      /* the threads copy the tiles of their rows to one column-major panel,
+         allocated by zgetrf_mc_dag and freed here */
+      int off, size;
+
+      zgetrf_psplit((M+NB-1)/NB, thidx, PANEL->thcnt, &off, &size);
+      size = min(size*NB, M - off*NB);
+      if (size > 0)
+        magma_ztile_copy(1, size, N, A + off*STRIDE, LDA, STRIDE, NB, PANEL->panel + off*NB, M);
+
+      info = zgetrf_reclap(M, N, PANEL->panel, M, IPIV, PANEL, thidx, &sense);
+      zgetrf_panel_barrier(PANEL, &sense);
+
+      if (size > 0)
+        magma_ztile_copy(0, size, N, A + off*STRIDE, LDA, STRIDE, NB, PANEL->panel + off*NB, M);
+      zgetrf_panel_barrier(PANEL, &sense);
+
+      if (thidx == 0) {
+        free(PANEL->panel);
+        PANEL->panel = NULL;
+      }
+
+    }
+
+    if (thidx != 0)
+      return;
+
+  } else if (STRIDE == 0) {
+
+    lapackf77_zgetrf(&M, &N, A, &LDA, IPIV, &info); 
+
+  } else {
+
+    /* factor the stack of tiles as one column-major panel */
+    cuDoubleComplex *panel = (cuDoubleComplex*) malloc(M*N*sizeof(cuDoubleComplex));
+
+    magma_ztile_copy(1, M, N, A, LDA, STRIDE, NB, panel, M);
+    lapackf77_zgetrf(&M, &N, panel, &M, IPIV, &info); 
+    magma_ztile_copy(0, M, N, A, LDA, STRIDE, NB, panel, M);
+
+    free(panel);
+
+  }
 
   if (info > 0) {
     iinfo[1] = iinfo[0] + info;
@@ -98,78 +398,23 @@ void SCHED_zlaswp(Quark* quark)
   int LDA;
   int K2;
   int *IPIV;
+  int STRIDE;
 
-  int ione=1;
+  quark_unpack_args_6(quark, N, A, LDA, K2, IPIV, STRIDE);
 
-  quark_unpack_args_5(quark, N, A, LDA, K2, IPIV);
-
-  lapackf77_zlaswp(&N, A, &LDA, &ione, &K2, IPIV, &ione); 
+  /* here N = nb */
+  magma_ztile_laswp(N, A, LDA, STRIDE, N, K2, IPIV);
 
 }
 
-extern "C" magma_int_t 
-magma_zgetrf_mc(magma_context *cntxt,
+/* Inserts the tasks of the factorization, for A in column-major layout
+   or, if tiled, in the tile layout of magma_zlapack_to_tile_mc */
+static void
+zgetrf_mc_dag(magma_context *cntxt,
         int *m, int *n,
         cuDoubleComplex *a, int *lda,
-        int *ipiv, int *info)
+        int *ipiv, int tiled)
 {
-/*  -- MAGMA (version 1.5.0) --
-       Univ. of Tennessee, Knoxville
-       Univ. of California, Berkeley
-       Univ. of Colorado, Denver
-       @date September 2014
-
-    Purpose   
-    =======   
-    ZGETRF computes an LU factorization of a general COMPLEX_16 
-    M-by-N matrix A using partial pivoting with row interchanges.   
-
-    The factorization has the form   
-       A = P * L * U   
-    where P is a permutation matrix, L is lower triangular with unit   
-    diagonal elements (lower trapezoidal if m > n), and U is upper   
-    triangular (upper trapezoidal if m < n).   
-
-    This is the right-looking Level 3 BLAS version of the algorithm.   
-
-    Arguments   
-    =========   
-    CNTXT   (input) MAGMA_CONTEXT
-            CNTXT specifies the MAGMA hardware context for this routine.   
-
-    M       (input) INTEGER   
-            The number of rows of the matrix A.  M >= 0.   
-
-    N       (input) INTEGER   
-            The number of columns of the matrix A.  N >= 0.   
-
-    A       (input/output) COMPLEX_16 array, dimension (LDA,N)   
-            On entry, the M-by-N matrix to be factored.   
-            On exit, the factors L and U from the factorization   
-            A = P*L*U; the unit diagonal elements of L are not stored.   
-
-    LDA     (input) INTEGER   
-            The leading dimension of the array A.  LDA >= max(1,M).   
-
-    IPIV    (output) INTEGER array, dimension (min(M,N))   
-            The pivot indices; for 1 <= i <= min(M,N), row i of the   
-            matrix was interchanged with row IPIV(i).   
-
-    INFO    (output) INTEGER   
-            = 0:  successful exit   
-            < 0:  if INFO = -i, the i-th argument had an illegal value   
-            > 0:  if INFO = i, U(i,i) is exactly zero. The factorization   
-                  has been completed, but the factor U is exactly   
-                  singular, and division by zero will occur if it is used   
-                  to solve a system of equations.   
-    =====================================================================    */
-
-    if (cntxt->num_cores == 1 && cntxt->num_gpus == 1)
-      {
-    //int result = magma_zgetrf(*m, *n, a, *lda, ipiv, info);
-    //return result;
-      }
-    
     int EN_BEE   = cntxt->nb;
     Quark* quark = cntxt->quark;
 
@@ -185,31 +430,38 @@ magma_zgetrf_mc(magma_context *cntxt,
 
     int M,N,MM,NN,MMM,K;
 
-    int priority=0;
+    /* a task applying panel k to block column j has priority
+       magma_task_priority(cntxt, j-k) */
+    Quark_Task_Flags task_flags = Quark_Task_Flags_Initializer;
 
-    *info = 0;
-    
     int nb = (EN_BEE==-1)? magma_get_zpotrf_nb(*n): EN_BEE;
 
-    /* Check arguments */
-    if (*m < 0) {
-      *info = -1;
-    } else if (*n < 0) {
-      *info = -2;
-    } else if (*lda < max(1,*m)) {
-      *info = -4;
-    }
-    if (*info != 0) {
-        magma_xerbla( __func__, -(*info) );
-        return MAGMA_ERR_ILLEGAL_VALUE;
-    }
-    
+    /* Leading dimension of the tiles */
+    int cols = *n;
+    int ld = tiled ? nb : *lda;
+    int stride_i, stride_j;
+
     int k = min(*m,*n);
 
     int iinfo[2];
     iinfo[1] = 0;
 
     char label[10000];
+
+    /* The panel tasks run on workers 1 to panel_threads, as the master
+       may be inserting tasks when a panel becomes ready */
+    int panel_threads = min(cntxt->num_cores-1, ZGETRF_PANEL_MAXTHREADS);
+    zgetrf_panel_t *panel;
+    zgetrf_panel_t *panels = (zgetrf_panel_t*) calloc((k+nb-1)/nb, sizeof(zgetrf_panel_t));
+    if (panels == NULL)
+      panel_threads = 0;
+
+    Quark_Task_Flags *panel_flags;
+    Quark_Task_Flags serial_flags = Quark_Task_Flags_Initializer;
+    Quark_Task_Flags parallel_flags = Quark_Task_Flags_Initializer;
+    QUARK_Task_Flag_Set(&parallel_flags, TASK_LOCK_TO_THREAD, 1);
+    QUARK_Task_Flag_Set(&serial_flags, TASK_PRIORITY, magma_task_priority(cntxt, 0));
+    QUARK_Task_Flag_Set(&parallel_flags, TASK_PRIORITY, magma_task_priority(cntxt, 0));
     
     ii = -1;
     
@@ -220,8 +472,6 @@ magma_zgetrf_mc(magma_context *cntxt,
 
     jj = -1;
 
-    priority = 10000 - ii;
-
     /* Update panels in left looking fashion */
     for (j = 0; j < i; j += nb) 
       { 
@@ -229,17 +479,19 @@ magma_zgetrf_mc(magma_context *cntxt,
 
         NN=min(nb,(*n)-i);
         MM=min(nb,(*m)-j);
+        stride_i = STRIDE(i);
 
         l = j + nb;
 
         MMM = min(nb,(*m)-l);
 
         sprintf(label, "UPDATE %d %d", ii, jj);
+        QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, ii-jj));
         
-        QUARK_Insert_Task(quark, SCHED_panel_update, 0,
+        QUARK_Insert_Task(quark, SCHED_panel_update, &task_flags,
                   sizeof(int),             &NN,      VALUE,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(j,i),   INOUT,
-                  sizeof(int),             lda,        VALUE,
+                  sizeof(int),             &ld,        VALUE,
                   sizeof(int),             &MM,      VALUE,
                   sizeof(cuDoubleComplex)*nb,        &ipiv[j], INPUT,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(j,j),   INPUT,
@@ -247,7 +499,7 @@ magma_zgetrf_mc(magma_context *cntxt,
                   sizeof(int),             &nb,      VALUE,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(l,j),   INPUT,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(l,i),   INOUT,
-                  sizeof(int),             &priority,VALUE | TASK_PRIORITY,
+                  sizeof(int),             &stride_i,VALUE,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(i,i),   OUTPUT,
                   strlen(label)+1,         label,    VALUE | TASKLABEL,
                   5,                       "cyan",   VALUE | TASKCOLOR,
@@ -265,16 +517,16 @@ magma_zgetrf_mc(magma_context *cntxt,
         fakedep = (void *)(intptr_t)(j+1);
         
         sprintf(label, "GEMM %d %d %d", ii, jj, ll);
+        QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, ii-jj));
         
-        QUARK_Insert_Task(quark, SCHED_zgemm, 0,
+        QUARK_Insert_Task(quark, SCHED_zgemm, &task_flags,
                   sizeof(int),             &MMM,     VALUE,
                   sizeof(int),             &NN,      VALUE,
                   sizeof(int),             &nb,      VALUE,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(l,j),   INPUT,
-                  sizeof(int),             lda,        VALUE,
+                  sizeof(int),             &ld,        VALUE,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(j,i),   INPUT,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(l,i),   INOUT,
-                  sizeof(int),             &priority,VALUE | TASK_PRIORITY,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(i,i),   OUTPUT | GATHERV,
                   sizeof(void*),           fakedep,  OUTPUT | GATHERV,
                   strlen(label)+1,         label,    VALUE | TASKLABEL,
@@ -287,19 +539,42 @@ magma_zgetrf_mc(magma_context *cntxt,
     
     M=(*m)-i;
     N=min(nb,(*n)-i);
+    stride_i = STRIDE(i);
     
     iinfo[0] = i;
     
+    /* Tall panels are factored by several threads */
+    panel = NULL;
+    panel_flags = &serial_flags;
+    if (min(panel_threads, M/(4*N)) > 1) {
+      panel = &panels[ii];
+      /* tiles are copied to a column-major panel; without it, the panel
+         is factored by one thread */
+      if (stride_i != 0) {
+        panel->panel = (cuDoubleComplex*) malloc(M*N*sizeof(cuDoubleComplex));
+        if (panel->panel == NULL)
+          panel = NULL;
+      }
+    }
+    if (panel != NULL) {
+      panel->thcnt = min(panel_threads, M/(4*N));
+      panel->sfmin = lapackf77_dlamch("S");
+      panel_flags = &parallel_flags;
+      QUARK_Task_Flag_Set(panel_flags, TASK_THREAD_COUNT, panel->thcnt);
+    }
+
     sprintf(label, "GETRF %d", ii);
     
-    QUARK_Insert_Task(quark, SCHED_zgetrf, 0,
+    QUARK_Insert_Task(quark, SCHED_zgetrf, panel_flags,
               sizeof(int),             &M,       VALUE,
               sizeof(int),             &N,       VALUE,
               sizeof(cuDoubleComplex)*(*m)*(*n), A(i,i),   INOUT,
-              sizeof(int),             lda,        VALUE,
+              sizeof(int),             &ld,        VALUE,
               sizeof(cuDoubleComplex)*nb,        &ipiv[i], OUTPUT,
               sizeof(int),             iinfo,    OUTPUT,
-              sizeof(int),             &priority,VALUE | TASK_PRIORITY,
+              sizeof(int),             &nb,      VALUE,
+              sizeof(int),             &stride_i,VALUE,
+              sizeof(zgetrf_panel_t*), &panel,   VALUE,
               strlen(label)+1,         label,    VALUE | TASKLABEL,
               6,                       "green",  VALUE | TASKCOLOR,
               0);
@@ -316,8 +591,6 @@ magma_zgetrf_mc(magma_context *cntxt,
       K = (K+1)*nb;
     }
     
-    priority = 0;
-    
     /* If n > m */
     for (i = K; i < (*n); i += nb) 
       {
@@ -332,17 +605,19 @@ magma_zgetrf_mc(magma_context *cntxt,
 
         NN=min(nb,(*n)-i);
         MM=min(nb,(*m)-j);
+        stride_i = STRIDE(i);
         
         l = j + nb;
         
         MMM = min(nb,(*m)-l);
         
         sprintf(label, "UPDATE %d %d", ii, jj);
+        QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, ii-jj));
         
-        QUARK_Insert_Task(quark, SCHED_panel_update, 0,
+        QUARK_Insert_Task(quark, SCHED_panel_update, &task_flags,
                   sizeof(int),             &NN,      VALUE,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(j,i),   INOUT,
-                  sizeof(int),             lda,        VALUE,
+                  sizeof(int),             &ld,        VALUE,
                   sizeof(int),             &MM,      VALUE,
                   sizeof(cuDoubleComplex)*nb,        &ipiv[j], INPUT,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(j,j),   INPUT,
@@ -350,7 +625,7 @@ magma_zgetrf_mc(magma_context *cntxt,
                   sizeof(int),             &nb,      VALUE,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(l,j),   INPUT,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(l,i),   INOUT,
-                  sizeof(int),             &priority,VALUE | TASK_PRIORITY,
+                  sizeof(int),             &stride_i,VALUE,
                   sizeof(cuDoubleComplex)*(*m)*(*n), A(i,i),   OUTPUT,
                   strlen(label)+1,         label,    VALUE | TASKLABEL,
                   5,                       "cyan",   VALUE | TASKCOLOR,
@@ -368,16 +643,16 @@ magma_zgetrf_mc(magma_context *cntxt,
           fakedep = (void *)(intptr_t)(j+1);
           
           sprintf(label, "GEMM %d %d %d", ii, jj, ll);
+          QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, ii-jj));
           
-          QUARK_Insert_Task(quark, SCHED_zgemm, 0,
+          QUARK_Insert_Task(quark, SCHED_zgemm, &task_flags,
                 sizeof(int),             &MMM,     VALUE,
                 sizeof(int),             &NN,      VALUE,
                 sizeof(int),             &nb,      VALUE,
                 sizeof(cuDoubleComplex)*(*m)*(*n), A(l,j),   INPUT,
-                sizeof(int),             lda,        VALUE,
+                sizeof(int),             &ld,        VALUE,
                 sizeof(cuDoubleComplex)*(*m)*(*n), A(j,i),   INPUT,
                 sizeof(cuDoubleComplex)*(*m)*(*n), A(l,i),   INOUT,
-                sizeof(int),             &priority,VALUE | TASK_PRIORITY,
                 sizeof(cuDoubleComplex)*(*m)*(*n), A(i,i),   OUTPUT | GATHERV,
                 sizeof(void*),           fakedep,  OUTPUT | GATHERV,
                 strlen(label)+1,         label,    VALUE | TASKLABEL,
@@ -392,7 +667,7 @@ magma_zgetrf_mc(magma_context *cntxt,
     
     ii = -1;
     
-    /* Swap behinds */
+    /* Swap behinds, off the critical path */
     for (i = 0; i < k; i += nb) {
       
       ii++;
@@ -407,16 +682,17 @@ magma_zgetrf_mc(magma_context *cntxt,
     jj++;
     
     fakedep = (void *)(intptr_t)(j+1);
+    stride_j = STRIDE(j);
     
     sprintf(label, "LASWPF %d %d", ii, jj);
     
     QUARK_Insert_Task(quark, SCHED_zlaswp, 0,
               sizeof(int),             &nb,       VALUE,
               sizeof(cuDoubleComplex)*(*m)*(*n), A(i,j),    INOUT,
-              sizeof(int),             lda,         VALUE,
+              sizeof(int),             &ld,         VALUE,
               sizeof(int),             &MM,       VALUE,
               sizeof(cuDoubleComplex)*nb,        &ipiv[i],  INPUT,
-              sizeof(int),             &priority, VALUE | TASK_PRIORITY,
+              sizeof(int),             &stride_j, VALUE,
               sizeof(void*),           fakedep,   INPUT,
               sizeof(cuDoubleComplex)*(*m)*(*n), A(i+nb,j), OUTPUT,
               strlen(label)+1,         label,     VALUE | TASKLABEL,
@@ -441,8 +717,171 @@ magma_zgetrf_mc(magma_context *cntxt,
     } 
     
     QUARK_Barrier(quark);
+
+    free(panels);
+    
+}
+
+
+extern "C" magma_int_t 
+magma_zgetrf_mc(magma_context *cntxt,
+        int *m, int *n,
+        cuDoubleComplex *a, int *lda,
+        int *ipiv, int *info)
+{
+/*  -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+    Purpose   
+    =======   
+    ZGETRF computes an LU factorization of a general COMPLEX_16 
+    M-by-N matrix A using partial pivoting with row interchanges.   
+
+    The factorization has the form   
+       A = P * L * U   
+    where P is a permutation matrix, L is lower triangular with unit   
+    diagonal elements (lower trapezoidal if m > n), and U is upper   
+    triangular (upper trapezoidal if m < n).   
+
+    This is the right-looking Level 3 BLAS version of the algorithm.   
+    Panels of at least 4*NB rows per thread are factored by a   
+    recursive LU run by several threads, up to CNTXT->num_cores-1.   
+    The tasks on the critical path get higher priorities, for the   
+    CNTXT->lookahead block columns after each panel.   
+
+    Arguments   
+    =========   
+    CNTXT   (input) MAGMA_CONTEXT
+            CNTXT specifies the MAGMA hardware context for this routine.   
+
+    M       (input) INTEGER   
+            The number of rows of the matrix A.  M >= 0.   
+
+    N       (input) INTEGER   
+            The number of columns of the matrix A.  N >= 0.   
+
+    A       (input/output) COMPLEX_16 array, dimension (LDA,N)   
+            On entry, the M-by-N matrix to be factored.   
+            On exit, the factors L and U from the factorization   
+            A = P*L*U; the unit diagonal elements of L are not stored.   
+
+    LDA     (input) INTEGER   
+            The leading dimension of the array A.  LDA >= max(1,M).   
+
+    IPIV    (output) INTEGER array, dimension (min(M,N))   
+            The pivot indices; for 1 <= i <= min(M,N), row i of the   
+            matrix was interchanged with row IPIV(i).   
+
+    INFO    (output) INTEGER   
+            = 0:  successful exit   
+            < 0:  if INFO = -i, the i-th argument had an illegal value   
+            > 0:  if INFO = i, U(i,i) is exactly zero. The factorization   
+                  has been completed, but the factor U is exactly   
+                  singular, and division by zero will occur if it is used   
+                  to solve a system of equations.   
+    =====================================================================    */
+
+    if (cntxt->num_cores == 1 && cntxt->num_gpus == 1)
+      {
+    //int result = magma_zgetrf(*m, *n, a, *lda, ipiv, info);
+    //return result;
+      }
+    
+    *info = 0;
+    
+    /* Check arguments */
+    if (*m < 0) {
+      *info = -1;
+    } else if (*n < 0) {
+      *info = -2;
+    } else if (*lda < max(1,*m)) {
+      *info = -4;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return MAGMA_ERR_ILLEGAL_VALUE;
+    }
+    
+    zgetrf_mc_dag(cntxt, m, n, a, lda, ipiv, 0);
+
+    return MAGMA_SUCCESS;
+}
+
+extern "C" magma_int_t 
+magma_zgetrf_tile_mc(magma_context *cntxt,
+        int *m, int *n,
+        cuDoubleComplex *a, int *lda,
+        int *ipiv, int *info)
+{
+/*  -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+    Purpose   
+    =======   
+    ZGETRF_TILE computes an LU factorization of a general COMPLEX_16   
+    M-by-N matrix A stored in tile layout, as converted by   
+    magma_zlapack_to_tile_mc with the same context, using partial   
+    pivoting with row interchanges.   
+
+    The tasks are those of magma_zgetrf_mc. The row interchanges are   
+    applied across the tiles of a block column, and each panel is   
+    copied to a column-major array to be factored.   
+
+    Arguments   
+    =========   
+    CNTXT   (input) MAGMA_CONTEXT
+            CNTXT specifies the MAGMA hardware context for this routine.   
+
+    M       (input) INTEGER   
+            The number of rows of the matrix A.  M >= 0.   
+
+    N       (input) INTEGER   
+            The number of columns of the matrix A.  N >= 0.   
+
+    A       (input/output) COMPLEX_16 array, dimension (LDA,N)   
+            On entry, the M-by-N matrix to be factored, in tile layout.   
+            On exit, the factors L and U in tile layout.   
+
+    LDA     (input) INTEGER   
+            The leading dimension of the array A in tile layout.   
+            LDA >= max(1,MT*NB), MT = ceil(M/NB).   
+
+    IPIV    (output) INTEGER array, dimension (min(M,N))   
+            The pivot indices, as for magma_zgetrf_mc.   
+
+    INFO    (output) INTEGER   
+            = 0:  successful exit   
+            < 0:  if INFO = -i, the i-th argument had an illegal value   
+    =====================================================================    */
+
+    int nb = (cntxt->nb==-1)? magma_get_zpotrf_nb(*n): cntxt->nb;
+
+    *info = 0;
+
+    /* Check arguments */
+    if (*m < 0) {
+      *info = -1;
+    } else if (*n < 0) {
+      *info = -2;
+    } else if (*lda < max(1,((*m)+nb-1)/nb*nb)) {
+      *info = -4;
+    }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return MAGMA_ERR_ILLEGAL_VALUE;
+    }
     
+    zgetrf_mc_dag(cntxt, m, n, a, lda, ipiv, 1);
+
+    return MAGMA_SUCCESS;
 }
 
 #undef A
+#undef STRIDE
 
@@ -10,7 +10,8 @@
 */
 #include "common_magma.h"
 
-#define A(m,n) (a+(n)*(*lda)+(m))
+// in the tile layout, the tile at rows m and columns n
+#define A(m,n) (a+(n)*(*lda)+(m)*(tiled ? min(nb,(cols)-(n)) : 1))
 
 // task execution code
 static void SCHED_zgemm(Quark* quark)
@@ -130,97 +131,31 @@ void SCHED_ztrsm(Quark* quark)
 
 }
 
-extern "C" magma_int_t 
-magma_zpotrf_mc(magma_context *cntxt, char *uplo,
-        magma_int_t *n,
-        cuDoubleComplex *a, magma_int_t *lda,
-        magma_int_t *info)
+// inserts the tasks of the factorization, for A in column-major layout
+// or, if tiled, in the tile layout of magma_zlapack_to_tile_mc
+static void
+zpotrf_mc_dag(magma_context *cntxt, magma_int_t upper, magma_int_t *n,
+              cuDoubleComplex *a, magma_int_t *lda, magma_int_t tiled)
 {
-/*  -- MAGMA (version 1.5.0) --
-       Univ. of Tennessee, Knoxville
-       Univ. of California, Berkeley
-       Univ. of Colorado, Denver
-       @date September 2014
-
-    Purpose   
-    =======   
-    ZPOTRF computes the Cholesky factorization of a Hermitian   
-    positive definite matrix A.   
-
-    The factorization has the form   
-       A = U**T * U,  if UPLO = 'U', or   
-       A = L  * L**T,  if UPLO = 'L',   
-    where U is an upper triangular matrix and L is lower triangular.   
-
-    This is the block version of the algorithm, calling Level 3 BLAS.   
-
-    Arguments   
-    =========   
-    CNTXT   (input) MAGMA_CONTEXT
-            CNTXT specifies the MAGMA hardware context for this routine.   
-
-    UPLO    (input) CHARACTER*1   
-            = 'U':  Upper triangle of A is stored;   
-            = 'L':  Lower triangle of A is stored.   
-
-    N       (input) INTEGER   
-            The order of the matrix A.  N >= 0.   
-
-    A       (input/output) COMPLEX_16 array, dimension (LDA,N)   
-            On entry, the Hermitian matrix A.  If UPLO = 'U', the leading   
-            N-by-N upper triangular part of A contains the upper   
-            triangular part of the matrix A, and the strictly lower   
-            triangular part of A is not referenced.  If UPLO = 'L', the   
-            leading N-by-N lower triangular part of A contains the lower   
-            triangular part of the matrix A, and the strictly upper   
-            triangular part of A is not referenced.   
-
-            On exit, if INFO = 0, the factor U or L from the Cholesky   
-            factorization A = U**T*U or A = L*L**T.   
-
-    LDA     (input) INTEGER   
-            The leading dimension of the array A.  LDA >= max(1,N).   
-
-    INFO    (output) INTEGER   
-            = 0:  successful exit   
-            < 0:  if INFO = -i, the i-th argument had an illegal value   
-            > 0:  if INFO = i, the leading minor of order i is not   
-                  positive definite, and the factorization could not be   
-                  completed.   
-    =====================================================================   */
-
-  if (cntxt->num_cores == 1 && cntxt->num_gpus == 1)
-  {
-    //magma_int_t result = magma_zpotrf(*uplo, *n, a, *lda, info);
-    //return result;
-  }
-
-  // check arguments
-  magma_int_t upper = (magma_int_t) lsame_(uplo, "U");                                          
-  *info = 0;
-  if (! upper && ! lsame_(uplo, "L")) {
-    *info = -1;
-  } else if (*n < 0) {
-    *info = -2;
-  } else if (*lda < max(1,*n)) {
-    *info = -4;
-  }
-    if (*info != 0) {
-        magma_xerbla( __func__, -(*info) );
-        return MAGMA_ERR_ILLEGAL_VALUE;
-    }
-
   Quark* quark = cntxt->quark;
 
   // get block size
   magma_int_t nb = (cntxt->nb ==-1)? magma_get_zpotrf_nb(*n): cntxt->nb;
 
+  // leading dimension of the tiles
+  magma_int_t cols = *n;
+  magma_int_t ld = tiled ? nb : *lda;
+
   magma_int_t i,j,k;
   magma_int_t ii,jj,kk;
   magma_int_t temp,temp2,temp3;
 
   char label[10000];
 
+  // a task applying the factor of step k to blocks that step j needs
+  // has priority magma_task_priority(cntxt, j-k)
+  Quark_Task_Flags task_flags = Quark_Task_Flags_Initializer;
+
   magma_int_t iinfo[2];
   iinfo[1] = 0;
   ii = -1;
@@ -233,19 +168,22 @@ magma_zpotrf_mc(magma_context *cntxt, char *uplo,
     // if not first block
     if (i > 0) {
 
-      // first do large syrk, then split
-      if (i < (*n)/2) {
+      // first do large syrk, then split; in the tile layout the
+      // large syrk would span several tiles, so always split
+      if (i < (*n)/2 && !tiled) {
 
         sprintf(label, "SYRK %d", ii);
 
+        QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, 1));
+
         if (upper) {
 
-          QUARK_Insert_Task(quark, SCHED_zsyrk, 0,
+          QUARK_Insert_Task(quark, SCHED_zsyrk, &task_flags,
             sizeof(magma_int_t),             &upper,    VALUE,
             sizeof(magma_int_t),             &temp2,    VALUE,
             sizeof(magma_int_t),             &i,        VALUE,
             sizeof(cuDoubleComplex)*(*n)*(*n), A(0,i),    INPUT,
-            sizeof(magma_int_t),             lda,       VALUE,
+            sizeof(magma_int_t),             &ld,       VALUE,
             sizeof(cuDoubleComplex)*(*n)*(*n), A(i,i),    INOUT,
             sizeof(cuDoubleComplex)*(*n)*(*n), A(i-nb,i), INPUT,
             strlen(label)+1,         label,     VALUE | TASKLABEL,
@@ -254,12 +192,12 @@ magma_zpotrf_mc(magma_context *cntxt, char *uplo,
 
         } else {
 
-          QUARK_Insert_Task(quark, SCHED_zsyrk, 0,
+          QUARK_Insert_Task(quark, SCHED_zsyrk, &task_flags,
             sizeof(magma_int_t),             &upper,    VALUE,
             sizeof(magma_int_t),             &temp2,    VALUE,
             sizeof(magma_int_t),             &i,        VALUE,
             sizeof(cuDoubleComplex)*(*n)*(*n), A(i,0),    INPUT,
-            sizeof(magma_int_t),             lda,       VALUE,
+            sizeof(magma_int_t),             &ld,       VALUE,
             sizeof(cuDoubleComplex)*(*n)*(*n), A(i,i),    INOUT,
             sizeof(cuDoubleComplex)*(*n)*(*n), A(i,i-nb), INPUT,
             strlen(label)+1,         label,     VALUE | TASKLABEL,
@@ -277,14 +215,16 @@ magma_zpotrf_mc(magma_context *cntxt, char *uplo,
 
           sprintf(label, "SYRK %d %d", ii, jj);
 
+          QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, ii-jj));
+
           if (upper) {
 
-            QUARK_Insert_Task(quark, SCHED_zsyrk, 0,
+            QUARK_Insert_Task(quark, SCHED_zsyrk, &task_flags,
               sizeof(magma_int_t),             &upper,    VALUE,
               sizeof(magma_int_t),             &temp2,    VALUE,
               sizeof(magma_int_t),             &nb,       VALUE,
               sizeof(cuDoubleComplex)*(*n)*(*n), A(j,i),    INPUT,
-              sizeof(magma_int_t),             lda,       VALUE,
+              sizeof(magma_int_t),             &ld,       VALUE,
               sizeof(cuDoubleComplex)*(*n)*(*n), A(i,i),    INOUT,
               strlen(label)+1,         label,     VALUE | TASKLABEL,
               6,                       "green",   VALUE | TASKCOLOR,
@@ -292,12 +232,12 @@ magma_zpotrf_mc(magma_context *cntxt, char *uplo,
 
           } else {
 
-            QUARK_Insert_Task(quark, SCHED_zsyrk, 0,
+            QUARK_Insert_Task(quark, SCHED_zsyrk, &task_flags,
               sizeof(magma_int_t),             &upper,    VALUE,
               sizeof(magma_int_t),             &temp2,    VALUE,
               sizeof(magma_int_t),             &nb,       VALUE,
               sizeof(cuDoubleComplex)*(*n)*(*n), A(i,j),    INPUT,
-              sizeof(magma_int_t),             lda,       VALUE,
+              sizeof(magma_int_t),             &ld,       VALUE,
               sizeof(cuDoubleComplex)*(*n)*(*n), A(i,i),    INOUT,
               strlen(label)+1,         label,     VALUE | TASKLABEL,
               6,                       "green",   VALUE | TASKCOLOR,
@@ -322,14 +262,16 @@ magma_zpotrf_mc(magma_context *cntxt, char *uplo,
 
             sprintf(label, "GEMM %d %d %d", ii, jj, kk);
 
+            QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, ii-kk));
+
             if (upper) {
-              QUARK_Insert_Task(quark, SCHED_zgemm, 0,
+              QUARK_Insert_Task(quark, SCHED_zgemm, &task_flags,
                 sizeof(magma_int_t),             &upper,    VALUE,
                 sizeof(magma_int_t),             &nb,       VALUE,
                 sizeof(magma_int_t),             &temp,     VALUE,
                 sizeof(magma_int_t),             &nb,       VALUE,
                 sizeof(cuDoubleComplex)*(*n)*(*n), A(k,i), INPUT,
-                sizeof(magma_int_t),             lda,       VALUE,
+                sizeof(magma_int_t),             &ld,       VALUE,
                 sizeof(cuDoubleComplex)*(*n)*(*n), A(k,j),    INPUT,
                 sizeof(cuDoubleComplex)*(*n)*(*n), A(i,j), INOUT,
                 strlen(label)+1,         label,     VALUE | TASKLABEL,
@@ -338,13 +280,13 @@ magma_zpotrf_mc(magma_context *cntxt, char *uplo,
 
             } else {
 
-              QUARK_Insert_Task(quark, SCHED_zgemm, 0,
+              QUARK_Insert_Task(quark, SCHED_zgemm, &task_flags,
                 sizeof(magma_int_t),             &upper,    VALUE,
                 sizeof(magma_int_t),             &temp,     VALUE,
                 sizeof(magma_int_t),             &nb,       VALUE,
                 sizeof(magma_int_t),             &nb,       VALUE,
                 sizeof(cuDoubleComplex)*(*n)*(*n), A(j,k), INPUT,
-                sizeof(magma_int_t),             lda,       VALUE,
+                sizeof(magma_int_t),             &ld,       VALUE,
                 sizeof(cuDoubleComplex)*(*n)*(*n), A(i,k),    INPUT,
                 sizeof(cuDoubleComplex)*(*n)*(*n), A(j,i), INOUT,
                 strlen(label)+1,         label,     VALUE | TASKLABEL,
@@ -360,11 +302,13 @@ magma_zpotrf_mc(magma_context *cntxt, char *uplo,
 
     sprintf(label, "POTRF %d", ii);
 
-    QUARK_Insert_Task(quark, SCHED_zpotrf, 0,
+    QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, 0));
+
+    QUARK_Insert_Task(quark, SCHED_zpotrf, &task_flags,
       sizeof(magma_int_t),             &upper,    VALUE,
       sizeof(magma_int_t),             &temp2,    VALUE,
       sizeof(cuDoubleComplex)*(*n)*(*n), A(i,i),    INOUT,
-      sizeof(magma_int_t),             lda,       VALUE,
+      sizeof(magma_int_t),             &ld,       VALUE,
       sizeof(magma_int_t),             iinfo,     OUTPUT,
       strlen(label)+1,         label,     VALUE | TASKLABEL,
       5,                       "cyan",    VALUE | TASKCOLOR,
@@ -380,14 +324,16 @@ magma_zpotrf_mc(magma_context *cntxt, char *uplo,
 
         sprintf(label, "TRSM %d", ii);
 
+        QUARK_Task_Flag_Set(&task_flags, TASK_PRIORITY, magma_task_priority(cntxt, (j-i)/nb));
+
         if (upper) {
 
-          QUARK_Insert_Task(quark, SCHED_ztrsm, 0,
+          QUARK_Insert_Task(quark, SCHED_ztrsm, &task_flags,
             sizeof(magma_int_t),             &upper,    VALUE,
             sizeof(magma_int_t),             &nb,       VALUE,
             sizeof(magma_int_t),             &temp,     VALUE,
             sizeof(cuDoubleComplex)*(*n)*(*n), A(i,i),    INPUT,
-            sizeof(magma_int_t),             lda,       VALUE,
+            sizeof(magma_int_t),             &ld,       VALUE,
             sizeof(cuDoubleComplex)*(*n)*(*n), A(i,j),    INOUT,
             strlen(label)+1,         label,     VALUE | TASKLABEL,
             4,                       "red",     VALUE | TASKCOLOR,
@@ -395,12 +341,12 @@ magma_zpotrf_mc(magma_context *cntxt, char *uplo,
 
         } else {
 
-          QUARK_Insert_Task(quark, SCHED_ztrsm, 0,
+          QUARK_Insert_Task(quark, SCHED_ztrsm, &task_flags,
             sizeof(magma_int_t),             &upper,    VALUE,
             sizeof(magma_int_t),             &temp,     VALUE,
             sizeof(magma_int_t),             &nb,       VALUE,
             sizeof(cuDoubleComplex)*(*n)*(*n), A(i,i),    INPUT,
-            sizeof(magma_int_t),             lda,       VALUE,
+            sizeof(magma_int_t),             &ld,       VALUE,
             sizeof(cuDoubleComplex)*(*n)*(*n), A(j,i),    INOUT,
             strlen(label)+1,         label,     VALUE | TASKLABEL,
             4,                       "red",     VALUE | TASKCOLOR,
@@ -413,6 +359,163 @@ magma_zpotrf_mc(magma_context *cntxt, char *uplo,
   QUARK_Barrier(quark);
 }
 
+extern "C" magma_int_t 
+magma_zpotrf_mc(magma_context *cntxt, char *uplo,
+        magma_int_t *n,
+        cuDoubleComplex *a, magma_int_t *lda,
+        magma_int_t *info)
+{
+/*  -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+    Purpose   
+    =======   
+    ZPOTRF computes the Cholesky factorization of a Hermitian   
+    positive definite matrix A.   
+
+    The factorization has the form   
+       A = U**T * U,  if UPLO = 'U', or   
+       A = L  * L**T,  if UPLO = 'L',   
+    where U is an upper triangular matrix and L is lower triangular.   
+
+    This is the block version of the algorithm, calling Level 3 BLAS.   
+    The tasks on the critical path get higher priorities, for the   
+    CNTXT->lookahead block columns after each panel.   
+
+    Arguments   
+    =========   
+    CNTXT   (input) MAGMA_CONTEXT
+            CNTXT specifies the MAGMA hardware context for this routine.   
+
+    UPLO    (input) CHARACTER*1   
+            = 'U':  Upper triangle of A is stored;   
+            = 'L':  Lower triangle of A is stored.   
+
+    N       (input) INTEGER   
+            The order of the matrix A.  N >= 0.   
+
+    A       (input/output) COMPLEX_16 array, dimension (LDA,N)   
+            On entry, the Hermitian matrix A.  If UPLO = 'U', the leading   
+            N-by-N upper triangular part of A contains the upper   
+            triangular part of the matrix A, and the strictly lower   
+            triangular part of A is not referenced.  If UPLO = 'L', the   
+            leading N-by-N lower triangular part of A contains the lower   
+            triangular part of the matrix A, and the strictly upper   
+            triangular part of A is not referenced.   
+
+            On exit, if INFO = 0, the factor U or L from the Cholesky   
+            factorization A = U**T*U or A = L*L**T.   
+
+    LDA     (input) INTEGER   
+            The leading dimension of the array A.  LDA >= max(1,N).   
+
+    INFO    (output) INTEGER   
+            = 0:  successful exit   
+            < 0:  if INFO = -i, the i-th argument had an illegal value   
+            > 0:  if INFO = i, the leading minor of order i is not   
+                  positive definite, and the factorization could not be   
+                  completed.   
+    =====================================================================   */
+
+  if (cntxt->num_cores == 1 && cntxt->num_gpus == 1)
+  {
+    //magma_int_t result = magma_zpotrf(*uplo, *n, a, *lda, info);
+    //return result;
+  }
+
+  // check arguments
+  magma_int_t upper = (magma_int_t) lsame_(uplo, "U");                                          
+  *info = 0;
+  if (! upper && ! lsame_(uplo, "L")) {
+    *info = -1;
+  } else if (*n < 0) {
+    *info = -2;
+  } else if (*lda < max(1,*n)) {
+    *info = -4;
+  }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return MAGMA_ERR_ILLEGAL_VALUE;
+    }
+
+  zpotrf_mc_dag(cntxt, upper, n, a, lda, 0);
+
+  return MAGMA_SUCCESS;
+}
+
+extern "C" magma_int_t 
+magma_zpotrf_tile_mc(magma_context *cntxt, char *uplo,
+        magma_int_t *n,
+        cuDoubleComplex *a, magma_int_t *lda,
+        magma_int_t *info)
+{
+/*  -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+    Purpose   
+    =======   
+    ZPOTRF_TILE computes the Cholesky factorization of a Hermitian   
+    positive definite matrix A stored in tile layout, as converted by   
+    magma_zlapack_to_tile_mc with the same context: the tiles of each   
+    block column are contiguous NB-by-NB arrays, so that each task   
+    works on memory that is contiguous instead of NB columns LDA apart.   
+
+    The tasks are those of magma_zpotrf_mc, except that the update of a   
+    diagonal block is always split into one task per tile.   
+
+    Arguments   
+    =========   
+    CNTXT   (input) MAGMA_CONTEXT
+            CNTXT specifies the MAGMA hardware context for this routine.   
+
+    UPLO    (input) CHARACTER*1   
+            = 'U':  Upper triangle of A is stored;   
+            = 'L':  Lower triangle of A is stored.   
+
+    N       (input) INTEGER   
+            The order of the matrix A.  N >= 0.   
+
+    A       (input/output) COMPLEX_16 array, dimension (LDA,N)   
+            On entry, the Hermitian matrix A in tile layout, as for   
+            magma_zpotrf_mc. On exit, if INFO = 0, the factor U or L in   
+            tile layout.   
+
+    LDA     (input) INTEGER   
+            The leading dimension of the array A in tile layout.   
+            LDA >= max(1,MT*NB), MT = ceil(N/NB).   
+
+    INFO    (output) INTEGER   
+            = 0:  successful exit   
+            < 0:  if INFO = -i, the i-th argument had an illegal value   
+    =====================================================================   */
+
+  // check arguments
+  magma_int_t upper = (magma_int_t) lsame_(uplo, "U");                                          
+  magma_int_t nb = (cntxt->nb ==-1)? magma_get_zpotrf_nb(*n): cntxt->nb;
+  *info = 0;
+  if (! upper && ! lsame_(uplo, "L")) {
+    *info = -1;
+  } else if (*n < 0) {
+    *info = -2;
+  } else if (*lda < max(1,((*n)+nb-1)/nb*nb)) {
+    *info = -4;
+  }
+    if (*info != 0) {
+        magma_xerbla( __func__, -(*info) );
+        return MAGMA_ERR_ILLEGAL_VALUE;
+    }
+
+  zpotrf_mc_dag(cntxt, upper, n, a, lda, 1);
+
+  return MAGMA_SUCCESS;
+}
+
 #undef A
 
 
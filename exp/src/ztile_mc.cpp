@@ -0,0 +1,365 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @precisions normal z -> s d c
+
+*/
+#include "common_magma.h"
+
+/*
+    Tile layout of the _mc factorizations
+
+    The M-by-N matrix is cut into NB-by-NB tiles, NB being the block size
+    of the factorizations (cntxt->nb, or magma_get_zpotrf_nb(N) if it is
+    -1). The tiles of block column J, of width W = min(NB,N-J*NB), are
+    stored one after the other, each as a column-major NB-by-W array with
+    leading dimension NB, and block column J starts at A + J*NB*LDT:
+
+       tile (I,J) = A + J*NB*LDT + I*NB*W,   LDT >= MT*NB,  MT = ceil(M/NB)
+
+    The last tile row is padded to NB rows, which are not referenced.
+    A block column of tiles is thus a stack of tiles, STRIDE = NB*W
+    elements apart, and row R of it starts at
+    A + (R/NB)*STRIDE + R%NB. The routines below that work on such stacks
+    take STRIDE = 0 for a column-major block column, in which row R starts
+    at A + R.
+*/
+
+#define ZTILE_ROW(a,lda,stride,nb,r) \
+  ((stride) == 0 ? (a)+(r) : (a)+((r)/(nb))*(stride)+((r)%(nb)))
+
+static magma_int_t ztile_nb(magma_context *cntxt, magma_int_t n)
+{
+  return (cntxt->nb == -1) ? magma_get_zpotrf_nb(n) : cntxt->nb;
+}
+
+/*
+    Applies the row interchanges of rows 1 to K2 in IPIV to the N columns
+    of a stack of tiles, as lapackf77_zlaswp(N, A, LDA, 1, K2, IPIV, 1)
+    does for a column-major matrix.
+*/
+extern "C" void
+magma_ztile_laswp(magma_int_t n, cuDoubleComplex *a, magma_int_t lda,
+                  magma_int_t stride, magma_int_t nb,
+                  magma_int_t k2, magma_int_t *ipiv)
+{
+  magma_int_t ione = 1;
+  magma_int_t i, j, p;
+  cuDoubleComplex tmp, *r1, *r2;
+
+  if (stride == 0) {
+    lapackf77_zlaswp(&n, a, &lda, &ione, &k2, ipiv, &ione);
+    return;
+  }
+
+  for (i = 0; i < k2; i++) {
+    p = ipiv[i] - 1;
+    if (p == i)
+      continue;
+    r1 = ZTILE_ROW(a, lda, stride, nb, i);
+    r2 = ZTILE_ROW(a, lda, stride, nb, p);
+    for (j = 0; j < n; j++) {
+      tmp = r1[j*lda];
+      r1[j*lda] = r2[j*lda];
+      r2[j*lda] = tmp;
+    }
+  }
+}
+
+/*
+    Copies the M-by-N stack of tiles A into the column-major B (GET != 0),
+    or B back into A (GET = 0). Panels that LAPACK factors as a whole are
+    copied this way in the tile layout.
+*/
+extern "C" void
+magma_ztile_copy(magma_int_t get, magma_int_t m, magma_int_t n,
+                 cuDoubleComplex *a, magma_int_t lda,
+                 magma_int_t stride, magma_int_t nb,
+                 cuDoubleComplex *b, magma_int_t ldb)
+{
+  magma_int_t r, mm;
+
+  for (r = 0; r < m; r += nb) {
+    mm = min(nb, m-r);
+    if (get)
+      lapackf77_zlacpy(MagmaUpperLowerStr, &mm, &n,
+                       ZTILE_ROW(a, lda, stride, nb, r), &lda, b+r, &ldb);
+    else
+      lapackf77_zlacpy(MagmaUpperLowerStr, &mm, &n,
+                       b+r, &ldb, ZTILE_ROW(a, lda, stride, nb, r), &lda);
+  }
+}
+
+/*
+    Transposes in place the R-by-C row-major matrix of chunks of NB
+    elements at A, following the cycles of the permutation; DONE holds
+    R*C flags and BUF one chunk.
+*/
+static void ztile_chunk_transpose(magma_int_t r, magma_int_t c, magma_int_t nb,
+                                  cuDoubleComplex *a, char *done,
+                                  cuDoubleComplex *buf)
+{
+  magma_int_t s, k, d, e;
+  cuDoubleComplex tmp;
+
+  memset(done, 0, r*c);
+  for (s = 0; s < r*c; s++) {
+    if (done[s])
+      continue;
+    memcpy(buf, a + s*nb, nb*sizeof(cuDoubleComplex));
+    k = s;
+    do {
+      d = (k % c)*r + k/c;
+      for (e = 0; e < nb; e++) {
+        tmp = a[d*nb+e];
+        a[d*nb+e] = buf[e];
+        buf[e] = tmp;
+      }
+      done[d] = 1;
+      k = d;
+    } while (k != s);
+  }
+}
+
+// task execution code
+static void SCHED_zlapack_to_tile(Quark* quark)
+{
+  magma_int_t TOTILE;
+  magma_int_t M;
+  magma_int_t W;
+  magma_int_t NB;
+  cuDoubleComplex *A;
+  magma_int_t LDA;
+  cuDoubleComplex *AT;
+  magma_int_t LDT;
+  char *DONE;
+  cuDoubleComplex *BUF;
+
+  magma_int_t c, r, mm, mt, mtnb;
+
+  quark_unpack_args_10(quark, TOTILE, M, W, NB, A, LDA, AT, LDT, DONE, BUF);
+
+  mt = (M + NB - 1)/NB;
+  mtnb = mt*NB;
+
+  if (A != AT) {
+
+    for (r = 0; r < M; r += NB) {
+      mm = min(NB, M-r);
+      if (TOTILE)
+        lapackf77_zlacpy(MagmaUpperLowerStr, &mm, &W, A+r, &LDA, AT+r*W, &NB);
+      else
+        lapackf77_zlacpy(MagmaUpperLowerStr, &mm, &W, AT+r*W, &NB, A+r, &LDA);
+    }
+
+  } else if (TOTILE) {
+
+    // pack the columns MT*NB apart, then move the chunks of NB rows:
+    // chunk (c,r) goes from c*MT+r to r*W+c
+    if (LDA > mtnb)
+      for (c = 1; c < W; c++)
+        memmove(A + c*mtnb, A + c*LDA, M*sizeof(cuDoubleComplex));
+    ztile_chunk_transpose(W, mt, NB, A, DONE, BUF);
+
+  } else {
+
+    ztile_chunk_transpose(mt, W, NB, A, DONE, BUF);
+    if (LDA > mtnb)
+      for (c = W-1; c > 0; c--)
+        memmove(A + c*LDA, A + c*mtnb, M*sizeof(cuDoubleComplex));
+
+  }
+}
+
+static void
+ztile_convert(magma_context *cntxt, magma_int_t totile,
+              magma_int_t *m, magma_int_t *n,
+              cuDoubleComplex *a, magma_int_t *lda,
+              cuDoubleComplex *at, magma_int_t *ldt)
+{
+  Quark* quark = cntxt->quark;
+  magma_int_t nb = ztile_nb(cntxt, *n);
+  magma_int_t mt = ((*m) + nb - 1)/nb;
+  magma_int_t j, w;
+
+  // the source is read, the destination written; in place both are one
+  int dir_a  = (a == at) ? INOUT : (totile ? INPUT : OUTPUT);
+  int dir_at = (a == at) ? INOUT : (totile ? OUTPUT : INPUT);
+
+  char label[10000];
+
+  // one task per block column
+  for (j = 0; j < (*n); j += nb) {
+
+    w = min(nb,(*n)-j);
+
+    sprintf(label, totile ? "TOTILE %d" : "TOLAPACK %d", j/nb);
+
+    QUARK_Insert_Task(quark, SCHED_zlapack_to_tile, 0,
+      sizeof(magma_int_t),               &totile,     VALUE,
+      sizeof(magma_int_t),               m,           VALUE,
+      sizeof(magma_int_t),               &w,          VALUE,
+      sizeof(magma_int_t),               &nb,         VALUE,
+      sizeof(cuDoubleComplex)*(*lda)*w,  a+j*(*lda),  dir_a,
+      sizeof(magma_int_t),               lda,         VALUE,
+      sizeof(cuDoubleComplex)*(*ldt)*w,  at+j*(*ldt), dir_at,
+      sizeof(magma_int_t),               ldt,         VALUE,
+      mt*w,                              NULL,        SCRATCH,
+      sizeof(cuDoubleComplex)*nb,        NULL,        SCRATCH,
+      strlen(label)+1,         label,     VALUE | TASKLABEL,
+      6,                       "green",   VALUE | TASKCOLOR,
+      0);
+  }
+
+  QUARK_Barrier(quark);
+}
+
+extern "C" magma_int_t
+magma_zlapack_to_tile_mc(magma_context *cntxt, magma_int_t *m, magma_int_t *n,
+                         cuDoubleComplex *a, magma_int_t *lda,
+                         cuDoubleComplex *at, magma_int_t *ldt,
+                         magma_int_t *info)
+{
+/*  -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+    Purpose
+    =======
+    ZLAPACK_TO_TILE copies the column-major M-by-N matrix A into AT in the
+    tile layout of magma_zpotrf_tile_mc, magma_zgetrf_tile_mc and
+    magma_zgeqrf_tile_mc: the tiles of each block column of NB columns
+    are stored one after the other, with leading dimension NB, and
+    block column J starts at AT + J*NB*LDT. NB is cntxt->nb, or
+    magma_get_zpotrf_nb(N) if that is -1, as in the factorizations.
+
+    Each block column is converted by a separate task. If AT = A, the
+    conversion is done in place, each task moving chunks of NB rows
+    along the cycles of the permutation with O(NB) workspace.
+
+    Arguments
+    =========
+    CNTXT   (input) MAGMA_CONTEXT
+            CNTXT specifies the MAGMA hardware context for this routine.
+
+    M       (input) INTEGER
+            The number of rows of the matrix A.  M >= 0.
+
+    N       (input) INTEGER
+            The number of columns of the matrix A.  N >= 0.
+
+    A       (input) COMPLEX_16 array, dimension (LDA,N)
+            The matrix in column-major layout. Overwritten if AT = A.
+
+    LDA     (input) INTEGER
+            The leading dimension of the array A.  LDA >= max(1,M).
+
+    AT      (output) COMPLEX_16 array, dimension (LDT,N)
+            The matrix in tile layout. Rows M+1 to MT*NB, with
+            MT = ceil(M/NB), are padding and are not set.
+
+    LDT     (input) INTEGER
+            The leading dimension of the array AT.  LDT >= MT*NB, and
+            LDT = LDA if AT = A.
+
+    INFO    (output) INTEGER
+            = 0:  successful exit
+            < 0:  if INFO = -i, the i-th argument had an illegal value
+    =====================================================================   */
+
+  magma_int_t nb = ztile_nb(cntxt, *n);
+
+  *info = 0;
+  if (*m < 0) {
+    *info = -2;
+  } else if (*n < 0) {
+    *info = -3;
+  } else if (*lda < max(1,*m)) {
+    *info = -5;
+  } else if (*ldt < max(1,((*m)+nb-1)/nb*nb) || (at == a && *ldt != *lda)) {
+    *info = -7;
+  }
+  if (*info != 0) {
+    magma_xerbla( __func__, -(*info) );
+    return MAGMA_ERR_ILLEGAL_VALUE;
+  }
+
+  ztile_convert(cntxt, 1, m, n, a, lda, at, ldt);
+  return MAGMA_SUCCESS;
+}
+
+extern "C" magma_int_t
+magma_ztile_to_lapack_mc(magma_context *cntxt, magma_int_t *m, magma_int_t *n,
+                         cuDoubleComplex *at, magma_int_t *ldt,
+                         cuDoubleComplex *a, magma_int_t *lda,
+                         magma_int_t *info)
+{
+/*  -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+    Purpose
+    =======
+    ZTILE_TO_LAPACK copies the M-by-N matrix AT in tile layout (see
+    magma_zlapack_to_tile_mc) into A in column-major layout, one task per
+    block column. If A = AT, the conversion is done in place.
+
+    Arguments
+    =========
+    CNTXT   (input) MAGMA_CONTEXT
+            CNTXT specifies the MAGMA hardware context for this routine.
+
+    M       (input) INTEGER
+            The number of rows of the matrix A.  M >= 0.
+
+    N       (input) INTEGER
+            The number of columns of the matrix A.  N >= 0.
+
+    AT      (input) COMPLEX_16 array, dimension (LDT,N)
+            The matrix in tile layout. Overwritten if A = AT.
+
+    LDT     (input) INTEGER
+            The leading dimension of the array AT.  LDT >= MT*NB, with
+            MT = ceil(M/NB), and LDT = LDA if A = AT.
+
+    A       (output) COMPLEX_16 array, dimension (LDA,N)
+            The matrix in column-major layout.
+
+    LDA     (input) INTEGER
+            The leading dimension of the array A.  LDA >= max(1,M).
+
+    INFO    (output) INTEGER
+            = 0:  successful exit
+            < 0:  if INFO = -i, the i-th argument had an illegal value
+    =====================================================================   */
+
+  magma_int_t nb = ztile_nb(cntxt, *n);
+
+  *info = 0;
+  if (*m < 0) {
+    *info = -2;
+  } else if (*n < 0) {
+    *info = -3;
+  } else if (*ldt < max(1,((*m)+nb-1)/nb*nb) || (at == a && *ldt != *lda)) {
+    *info = -5;
+  } else if (*lda < max(1,*m)) {
+    *info = -7;
+  }
+  if (*info != 0) {
+    magma_xerbla( __func__, -(*info) );
+    return MAGMA_ERR_ILLEGAL_VALUE;
+  }
+
+  ztile_convert(cntxt, 0, m, n, a, lda, at, ldt);
+  return MAGMA_SUCCESS;
+}
+
+#undef ZTILE_ROW
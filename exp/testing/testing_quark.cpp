@@ -0,0 +1,177 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <quark.h>
+
+// includes, project
+#include "magma.h"
+#include "testings.h"
+
+#define TILE(m,n) (A + (m) + (n)*NT)
+
+/* Empty tasks with the arguments of the tile Cholesky kernels, so that
+   only the cost of the scheduler is measured */
+void SCHED_potrf(Quark *quark)
+{
+    int n, lda;
+    double *A;
+    quark_unpack_args_3(quark, n, A, lda);
+}
+
+void SCHED_trsm(Quark *quark)
+{
+    int m, n, lda, ldb;
+    double alpha, *A, *B;
+    quark_unpack_args_7(quark, m, n, alpha, A, lda, B, ldb);
+}
+
+void SCHED_syrk(Quark *quark)
+{
+    int n, k, lda, ldc;
+    double alpha, beta, *A, *C;
+    quark_unpack_args_8(quark, n, k, alpha, A, lda, beta, C, ldc);
+}
+
+void SCHED_gemm(Quark *quark)
+{
+    int m, n, k, lda, ldb, ldc;
+    double alpha, beta, *A, *B, *C, *work;
+    quark_unpack_args_12(quark, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, work);
+}
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing the QUARK task insertion rate
+   Inserts the DAG of a right-looking tile Cholesky factorization of
+   NT x NT tiles, with empty tasks, and reports the time spent in
+   QUARK_Insert_Task, the total time until all tasks are done, the
+   tasks per second, and the CPU time used by all threads relative to
+   the elapsed time. Every task allocates its task structure, argument
+   copies and dependencies, and the gemm tasks a scratch buffer, so
+   this measures the memory management of the scheduler as well.
+   With -C 1 the master inserts and runs all tasks.
+*/
+int main( int argc, char** argv)
+{
+    magma_timestr_t start, inserted, end;
+    clock_t cpu_start, cpu_end;
+
+    magma_int_t NT = 0;
+    magma_int_t size[6] = {10, 20, 40, 80, 160, 320};
+    int nb = 128;
+    magma_int_t num_cores = 4;
+    magma_int_t i, k, m, n;
+    magma_int_t loop = argc;
+
+    if (argc != 1){
+      for(i = 1; i<argc; i++){
+        if (strcmp("-T", argv[i])==0)
+          NT = atoi(argv[++i]);
+        else if (strcmp("-C", argv[i])==0)
+          num_cores = atoi(argv[++i]);
+      }
+      if (NT==0) {
+        NT = size[5];
+        loop = 1;
+      } else {
+        size[0] = size[5] = NT;
+      }
+    } else {
+      printf("\nUsage: \n");
+      printf("  testing_quark -T %d -C %d\n\n", 40, 4);
+    }
+
+    Quark *quark = QUARK_New(num_cores);
+    double one = 1., mone = -1.;
+
+    printf("\n\n");
+    printf("  NT      tasks   insert (s)   total (s)     tasks/s   CPU time (s)   CPU/wall\n");
+    printf("================================================================================\n");
+    for(i=0; i<6; i++)
+      {
+    NT = size[i];
+    /* The tasks only use the tile addresses, one double stands for each tile */
+    double *A = (double*)malloc(NT*NT*sizeof(double));
+    magma_int_t ntasks = 0;
+
+    cpu_start = clock();
+    start = get_current_time();
+    for(k=0; k<NT; k++) {
+      QUARK_Insert_Task(quark, SCHED_potrf, 0,
+                        sizeof(int),     &nb,          VALUE,
+                        sizeof(double),  TILE(k,k),    INOUT,
+                        sizeof(int),     &nb,          VALUE,
+                        0);
+      ntasks++;
+      for(m=k+1; m<NT; m++) {
+        QUARK_Insert_Task(quark, SCHED_trsm, 0,
+                          sizeof(int),     &nb,          VALUE,
+                          sizeof(int),     &nb,          VALUE,
+                          sizeof(double),  &one,         VALUE,
+                          sizeof(double),  TILE(k,k),    INPUT,
+                          sizeof(int),     &nb,          VALUE,
+                          sizeof(double),  TILE(m,k),    INOUT,
+                          sizeof(int),     &nb,          VALUE,
+                          0);
+        ntasks++;
+      }
+      for(m=k+1; m<NT; m++) {
+        QUARK_Insert_Task(quark, SCHED_syrk, 0,
+                          sizeof(int),     &nb,          VALUE,
+                          sizeof(int),     &nb,          VALUE,
+                          sizeof(double),  &mone,        VALUE,
+                          sizeof(double),  TILE(m,k),    INPUT,
+                          sizeof(int),     &nb,          VALUE,
+                          sizeof(double),  &one,         VALUE,
+                          sizeof(double),  TILE(m,m),    INOUT,
+                          sizeof(int),     &nb,          VALUE,
+                          0);
+        ntasks++;
+        for(n=k+1; n<m; n++) {
+          QUARK_Insert_Task(quark, SCHED_gemm, 0,
+                            sizeof(int),     &nb,          VALUE,
+                            sizeof(int),     &nb,          VALUE,
+                            sizeof(int),     &nb,          VALUE,
+                            sizeof(double),  &mone,        VALUE,
+                            sizeof(double),  TILE(m,k),    INPUT,
+                            sizeof(int),     &nb,          VALUE,
+                            sizeof(double),  TILE(n,k),    INPUT,
+                            sizeof(int),     &nb,          VALUE,
+                            sizeof(double),  &one,         VALUE,
+                            sizeof(double),  TILE(m,n),    INOUT,
+                            sizeof(int),     &nb,          VALUE,
+                            sizeof(double)*nb, NULL,       SCRATCH,
+                            0);
+          ntasks++;
+        }
+      }
+    }
+    inserted = get_current_time();
+    QUARK_Barrier(quark);
+    end = get_current_time();
+    cpu_end = clock();
+
+    double total = GetTimerValue(start,end) / 1000.;
+    double cpu_time = (double)(cpu_end - cpu_start) / CLOCKS_PER_SEC;
+    printf("%4d   %8d   %10.3f   %9.3f   %9.0f   %12.3f   %8.2f\n",
+           (int) NT, (int) ntasks, GetTimerValue(start,inserted) / 1000., total,
+           ntasks / total, cpu_time, cpu_time / total);
+
+    free(A);
+
+    if (loop != 1)
+      break;
+      }
+
+    QUARK_Delete(quark);
+}
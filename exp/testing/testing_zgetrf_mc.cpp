@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
 #include <cuda.h>
 #include <cuda_runtime_api.h>
 #include <cublas.h>
@@ -77,6 +78,9 @@ double get_LU_error(magma_int_t M, magma_int_t N,
 
 /* ////////////////////////////////////////////////////////////////////////////
    -- Testing zgetrf_mc
+   Also reports the CPU time used by all threads relative to the elapsed
+   time. A small block size (-b) gives many small tasks and measures the
+   task throughput of the scheduler.
 */
 int main( int argc, char** argv) 
 {
@@ -85,6 +89,7 @@ int main( int argc, char** argv)
     double flops, gpu_perf, cpu_perf, cpu2_perf;
 
     magma_timestr_t start, end;
+    clock_t cpu_start, cpu_end;
 
     /* Matrix size */
     magma_int_t N=0, n2, lda, M=0;
@@ -148,8 +153,8 @@ int main( int argc, char** argv)
     context = magma_init(NULL, NULL, 0, num_cores, num_gpus, argc, argv);
 
     printf("\n\n");
-    printf("  M    N           GFlop/s        ||PA-LU|| / (||A||*N)\n");
-    printf("========================================================\n");
+    printf("  M    N           GFlop/s    CPU time (s)   CPU/wall    ||PA-LU|| / (||A||*N)\n");
+    printf("=================================================================================\n");
     for(i=0; i<10; i++){
 
       if (loop == 1) {
@@ -167,9 +172,11 @@ int main( int argc, char** argv)
          Performs operation using multi-core
          =================================================================== */
 
+      cpu_start = clock();
       start = get_current_time();
       magma_zgetrf_mc(context, &M, &N, h_A2, &M, ipiv, info);
       end = get_current_time();
+      cpu_end = clock();
 
       if (info[0] < 0)      
         printf("Argument %d of magma_sgeqrf_mc had an illegal value.\n", -info[0]);
@@ -178,8 +185,10 @@ int main( int argc, char** argv)
   
       double error = get_LU_error(M, N, h_A, M, h_A2, ipiv);
 
-      printf("%5d %5d       %6.2f                  %e\n",
-             M, N, cpu2_perf, error);
+      double cpu_time = (double)(cpu_end - cpu_start) / CLOCKS_PER_SEC;
+      printf("%5d %5d       %6.2f        %8.3f       %5.2f       %e\n",
+             M, N, cpu2_perf, cpu_time, 1000. * cpu_time / GetTimerValue(start, end),
+             error);
 
       if (loop != 1)
         break;
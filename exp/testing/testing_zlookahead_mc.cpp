@@ -0,0 +1,195 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @precisions normal z -> s d c
+
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <cuda.h>
+#include <cuda_runtime_api.h>
+#include <cublas.h>
+
+#include <quark.h>
+
+// includes, project
+#include "flops.h"
+#include "magma.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+/* Flops formula */
+#define PRECISION_z
+#if defined(PRECISION_z) || defined(PRECISION_c)
+#define FLOPS_POTRF(n)    ( 6.*FMULS_POTRF(n)    + 2.*FADDS_POTRF(n)    )
+#define FLOPS_GETRF(m, n) ( 6.*FMULS_GETRF(m, n) + 2.*FADDS_GETRF(m, n) )
+#define FLOPS_GEQRF(m, n) ( 6.*FMULS_GEQRF(m, n) + 2.*FADDS_GEQRF(m, n) )
+#else
+#define FLOPS_POTRF(n)    (    FMULS_POTRF(n)    +    FADDS_POTRF(n)    )
+#define FLOPS_GETRF(m, n) (    FMULS_GETRF(m, n) +    FADDS_GETRF(m, n) )
+#define FLOPS_GEQRF(m, n) (    FMULS_GEQRF(m, n) +    FADDS_GEQRF(m, n) )
+#endif
+
+#define MAX_LOOKAHEAD 4
+
+static const char *names[3] = { "potrf", "getrf", "geqrf" };
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing the lookahead of the multicore factorizations
+   For N from 2000 to 20000 (or -N), factors the same N x N matrix with
+   magma_zpotrf_mc, magma_zgetrf_mc and magma_zgeqrf_mc for each
+   lookahead depth from 0 to 4, and reports the GFlop/s and the time
+   each QUARK worker was idle, i.e., not executing tasks, in seconds.
+   Worker 0 is the master, which also inserts the tasks. The result is
+   compared to the one with lookahead 0, as the priorities only change
+   the order of independent tasks. -b sets the block size, -C the
+   number of cores.
+*/
+int main( int argc, char** argv)
+{
+    cuDoubleComplex *h_A, *h_R, *h_R0, *tau, *work;
+    magma_int_t *ipiv;
+    double flops, gflops, matnorm, dwork[1];
+
+    magma_timestr_t start, end;
+
+    /* Matrix size */
+    magma_int_t N=0, n2, lwork;
+    magma_int_t size[8] = {2000,3000,4000,5000,6000,8000,10000,20000};
+
+    magma_int_t i, j, r, l, w, info[1];
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4], ISEED0[4] = {0,0,0,1};
+
+    magma_int_t num_cores = 4;
+    magma_int_t num_gpus  = 0;
+
+    magma_int_t loop = argc;
+
+    cuDoubleComplex mone = MAGMA_Z_NEG_ONE;
+    char uplo[2] = "U";
+
+    if (argc != 1){
+      for(i = 1; i<argc; i++){
+        if (strcmp("-N", argv[i])==0)
+          N = atoi(argv[++i]);
+        else if (strcmp("-C", argv[i])==0)
+          num_cores = atoi(argv[++i]);
+      }
+      if (N==0) {
+        N = size[7];
+        loop = 1;
+      } else {
+        size[0] = size[7] = N;
+      }
+    } else {
+      printf("\nUsage: \n");
+      printf("  Make sure you set the number of BLAS threads to 1, e.g.,\n");
+      printf("   > setenv MKL_NUM_THREADS 1\n");
+      printf("   > testing_zlookahead_mc -N %d -C 4 -b 128\n\n", 4000);
+      N = size[7];
+    }
+
+    /* Initialize MAGMA hardware context, seeting how many CPU cores
+       and how many GPUs to be used in the consequent computations  */
+    magma_context *context;
+    context = magma_init(NULL, NULL, 0, num_cores, num_gpus, argc, argv);
+
+    double *busy = (double*)malloc(num_cores * sizeof(double));
+
+    printf("\n\n");
+    printf("      N   routine   lookahead   GFlop/s   ||R - R_0||_F / ||R_0||_F   idle time per worker (s)\n");
+    printf("======================================================================================================\n");
+    for(i=0; i<8; i++){
+
+      N = size[i];
+      magma_int_t nb = (context->nb == -1) ? magma_get_zpotrf_nb(N) : context->nb;
+      n2 = N*N;
+      lwork = N*nb;
+
+      TESTING_MALLOC( h_A,  cuDoubleComplex, n2    );
+      TESTING_MALLOC( h_R,  cuDoubleComplex, n2    );
+      TESTING_MALLOC( h_R0, cuDoubleComplex, n2    );
+      TESTING_MALLOC( ipiv, magma_int_t,     N     );
+      TESTING_MALLOC( tau,  cuDoubleComplex, N     );
+      TESTING_MALLOC( work, cuDoubleComplex, lwork );
+
+      /* The same matrix for all runs, Hermitian positive definite for potrf */
+      memcpy(ISEED, ISEED0, sizeof(ISEED));
+      lapackf77_zlarnv( &ione, ISEED, &n2, h_A );
+      for(j=0; j<N; j++)
+        MAGMA_Z_SET2REAL( h_A[j*N+j], ( MAGMA_Z_GET_X(h_A[j*N+j]) + 2.*N ) );
+
+      for(r=0; r<3; r++){
+
+        flops = (r == 0) ? FLOPS_POTRF( (double)N ) :
+                (r == 1) ? FLOPS_GETRF( (double)N, (double)N ) :
+                           FLOPS_GEQRF( (double)N, (double)N );
+        flops /= 1000000;
+
+        for(l=0; l<=MAX_LOOKAHEAD; l++){
+
+          context->lookahead = l;
+          lapackf77_zlacpy( MagmaUpperLowerStr, &N, &N, h_A, &N, h_R, &N );
+
+          for(w=0; w<num_cores; w++)
+            busy[w] = QUARK_Worker_Busy_Time(context->quark, w);
+
+          start = get_current_time();
+          if (r == 0)
+            magma_zpotrf_mc(context, uplo, &N, h_R, &N, info);
+          else if (r == 1)
+            magma_zgetrf_mc(context, &N, &N, h_R, &N, ipiv, info);
+          else
+            magma_zgeqrf_mc(context, &N, &N, h_R, &N, tau, work, &lwork, info);
+          end = get_current_time();
+          if (info[0] < 0)
+            printf("Argument %d of magma_z%s_mc had an illegal value.\n", -info[0], names[r]);
+          gflops = flops / GetTimerValue(start, end);
+
+          /* =====================================================================
+             Check the result compared to lookahead 0
+             =================================================================== */
+          double diff = 0.;
+          if (l == 0) {
+            lapackf77_zlacpy( MagmaUpperLowerStr, &N, &N, h_R, &N, h_R0, &N );
+          } else {
+            matnorm = lapackf77_zlange("f", &N, &N, h_R0, &N, dwork);
+            blasf77_zaxpy(&n2, &mone, h_R0, &ione, h_R, &ione);
+            diff = lapackf77_zlange("f", &N, &N, h_R, &N, dwork) / matnorm;
+          }
+
+          printf("%7d   %s        %d      %8.2f       %e          ",
+                 (int) N, names[r], (int) l, gflops, diff);
+          for(w=0; w<num_cores; w++)
+            printf(" %6.3f", GetTimerValue(start, end) / 1000. -
+                   (QUARK_Worker_Busy_Time(context->quark, w) - busy[w]));
+          printf("\n");
+          fflush(stdout);
+        }
+      }
+
+      TESTING_FREE( h_A  );
+      TESTING_FREE( h_R  );
+      TESTING_FREE( h_R0 );
+      TESTING_FREE( ipiv );
+      TESTING_FREE( tau  );
+      TESTING_FREE( work );
+
+      if (loop != 1)
+        break;
+    }
+
+    free(busy);
+
+    /* Shut down the MAGMA context */
+    magma_finalize(context);
+}
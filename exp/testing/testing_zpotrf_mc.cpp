@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
 #include <quark.h>
 #include <cuda.h>
 #include <cuda_runtime_api.h>
@@ -35,6 +36,10 @@
 
 /* ////////////////////////////////////////////////////////////////////////////
    -- Testing zpotrf_mc
+   Also reports the CPU time used by all threads relative to the elapsed
+   time, i.e., the number of cores kept busy. With small N or many cores
+   the DAG is too narrow for all cores, and idle workers should not add
+   to the CPU time.
 */
 int main( magma_int_t argc, char** argv) 
 {
@@ -43,6 +48,7 @@ int main( magma_int_t argc, char** argv)
     float gpu_perf, cpu_perf, cpu_perf2;
 
     magma_timestr_t start, end;
+    clock_t cpu_start, cpu_end;
 
     /* Matrix size */
     magma_int_t N=0, n2, lda;
@@ -99,8 +105,8 @@ int main( magma_int_t argc, char** argv)
 
     
     printf("\n\n");
-    printf("  N    Multicore GFlop/s    ||R||_F / ||A||_F\n");
-    printf("=============================================\n");
+    printf("  N    Multicore GFlop/s    CPU time (s)   CPU/wall    ||R||_F / ||A||_F\n");
+    printf("==========================================================================\n");
     for(i=0; i<10; i++)
       {
     N = lda = size[i];
@@ -127,10 +133,12 @@ int main( magma_int_t argc, char** argv)
     /* =====================================================================
        Performs operation using multi-core 
        =================================================================== */
+    cpu_start = clock();
     start = get_current_time();
     //magma_zpotrf_mc(context, "L", &N, h_A2, &lda, info);
     magma_zpotrf_mc(context, "U", &N, h_A2, &lda, info);
     end = get_current_time();
+    cpu_end = clock();
     
     if (info[0] < 0)  
       printf("Argument %d of magma_zpotrf_mc had an illegal value.\n", -info[0]);     
@@ -146,8 +154,9 @@ int main( magma_int_t argc, char** argv)
 
     matnorm = lapackf77_zlange("f", &N, &N, h_A, &N, work);
     blasf77_zaxpy(&n2, &mone, h_A, &one, h_A2, &one);
-    printf("%5d     %6.2f                %e\n", 
-           size[i], cpu_perf2,  
+    double cpu_time = (double)(cpu_end - cpu_start) / CLOCKS_PER_SEC;
+    printf("%5d     %6.2f             %8.3f       %5.2f       %e\n", 
+           size[i], cpu_perf2, cpu_time, 1000. * cpu_time / GetTimerValue(start,end),
            lapackf77_zlange("f", &N, &N, h_A2, &N, work) / matnorm);
 
     if (loop != 1)
@@ -0,0 +1,218 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @precisions normal z -> s d c
+
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <cuda.h>
+#include <cuda_runtime_api.h>
+#include <cublas.h>
+
+#include <quark.h>
+
+// includes, project
+#include "flops.h"
+#include "magma.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+/* Flops formula */
+#define PRECISION_z
+#if defined(PRECISION_z) || defined(PRECISION_c)
+#define FLOPS_POTRF(n)    ( 6.*FMULS_POTRF(n)    + 2.*FADDS_POTRF(n)    )
+#define FLOPS_GETRF(m, n) ( 6.*FMULS_GETRF(m, n) + 2.*FADDS_GETRF(m, n) )
+#define FLOPS_GEQRF(m, n) ( 6.*FMULS_GEQRF(m, n) + 2.*FADDS_GEQRF(m, n) )
+#else
+#define FLOPS_POTRF(n)    (    FMULS_POTRF(n)    +    FADDS_POTRF(n)    )
+#define FLOPS_GETRF(m, n) (    FMULS_GETRF(m, n) +    FADDS_GETRF(m, n) )
+#define FLOPS_GEQRF(m, n) (    FMULS_GEQRF(m, n) +    FADDS_GEQRF(m, n) )
+#endif
+
+static const char *names[3] = { "potrf", "getrf", "geqrf" };
+
+/* Factors the N x N matrix A with routine r, in tile layout if tiled */
+static void factor(magma_context *context, int r, int tiled, magma_int_t N,
+                   cuDoubleComplex *A, magma_int_t *ipiv, cuDoubleComplex *tau,
+                   cuDoubleComplex *work, magma_int_t lwork, magma_int_t *info)
+{
+    char uplo[2] = "U";
+
+    if (r == 0) {
+      if (tiled)
+        magma_zpotrf_tile_mc(context, uplo, &N, A, &N, info);
+      else
+        magma_zpotrf_mc(context, uplo, &N, A, &N, info);
+    } else if (r == 1) {
+      if (tiled)
+        magma_zgetrf_tile_mc(context, &N, &N, A, &N, ipiv, info);
+      else
+        magma_zgetrf_mc(context, &N, &N, A, &N, ipiv, info);
+    } else {
+      if (tiled)
+        magma_zgeqrf_tile_mc(context, &N, &N, A, &N, tau, work, &lwork, info);
+      else
+        magma_zgeqrf_mc(context, &N, &N, A, &N, tau, work, &lwork, info);
+    }
+}
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing the tile layout of the multicore factorizations
+   For N from 2000 to 40000 (or -N), factors the same N x N matrix with
+   magma_zpotrf_mc, magma_zgetrf_mc and magma_zgeqrf_mc in column-major
+   layout, and with the _tile_mc versions in tile layout after converting
+   it in place with magma_zlapack_to_tile_mc. Reports the GFlop/s in both
+   layouts, the time of the conversion to and from the tile layout, and
+   the GFlop/s counting it. The tile result, converted back, is compared
+   to the column-major one. -b sets the block size, which is also the
+   tile size, -C the number of cores; N is rounded up to a multiple of
+   the tile size, as the in-place conversion needs LDA = N.
+*/
+int main( int argc, char** argv)
+{
+    cuDoubleComplex *h_A, *h_R, *tau, *work;
+    magma_int_t *ipiv;
+    double flops, perf[3], matnorm, dwork[1];
+
+    magma_timestr_t start, end;
+
+    /* Matrix size */
+    magma_int_t N=0, n2, lwork;
+    magma_int_t size[10] = {2000,4000,6000,8000,10000,15000,20000,25000,30000,40000};
+
+    magma_int_t i, j, r, info[1];
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4], ISEED0[4] = {0,0,0,1};
+
+    magma_int_t num_cores = 4;
+    magma_int_t num_gpus  = 0;
+
+    magma_int_t loop = argc;
+
+    cuDoubleComplex mone = MAGMA_Z_NEG_ONE;
+
+    if (argc != 1){
+      for(i = 1; i<argc; i++){
+        if (strcmp("-N", argv[i])==0)
+          N = atoi(argv[++i]);
+        else if (strcmp("-C", argv[i])==0)
+          num_cores = atoi(argv[++i]);
+      }
+      if (N==0) {
+        N = size[9];
+        loop = 1;
+      } else {
+        size[0] = size[9] = N;
+      }
+    } else {
+      printf("\nUsage: \n");
+      printf("  Make sure you set the number of BLAS threads to 1, e.g.,\n");
+      printf("   > setenv MKL_NUM_THREADS 1\n");
+      printf("   > testing_ztile_mc -N %d -C 4 -b 128\n\n", 8000);
+      N = size[9];
+    }
+
+    /* Initialize MAGMA hardware context, seeting how many CPU cores
+       and how many GPUs to be used in the consequent computations  */
+    magma_context *context;
+    context = magma_init(NULL, NULL, 0, num_cores, num_gpus, argc, argv);
+
+    printf("\n\n");
+    printf("      N   routine   LAPACK layout   tile layout   tile+conversion   conversion (s)   ||R_tile - R||_F / ||R||_F\n");
+    printf("                          (GFlop/s)     (GFlop/s)         (GFlop/s)\n");
+    printf("====================================================================================================\n");
+    for(i=0; i<10; i++){
+
+      N = size[i];
+      magma_int_t nb = (context->nb == -1) ? magma_get_zpotrf_nb(N) : context->nb;
+      N = ((N + nb - 1) / nb) * nb;
+      n2 = N*N;
+      lwork = N*nb;
+
+      TESTING_MALLOC( h_A,  cuDoubleComplex, n2    );
+      TESTING_MALLOC( h_R,  cuDoubleComplex, n2    );
+      TESTING_MALLOC( ipiv, magma_int_t,     N     );
+      TESTING_MALLOC( tau,  cuDoubleComplex, N     );
+      TESTING_MALLOC( work, cuDoubleComplex, lwork );
+
+      for(r=0; r<3; r++){
+
+        flops = (r == 0) ? FLOPS_POTRF( (double)N ) :
+                (r == 1) ? FLOPS_GETRF( (double)N, (double)N ) :
+                           FLOPS_GEQRF( (double)N, (double)N );
+        flops /= 1000000;
+
+        /* The same matrix for both layouts, Hermitian positive definite for potrf */
+        memcpy(ISEED, ISEED0, sizeof(ISEED));
+        lapackf77_zlarnv( &ione, ISEED, &n2, h_R );
+        if (r == 0)
+          for(j=0; j<N; j++)
+            MAGMA_Z_SET2REAL( h_R[j*N+j], ( MAGMA_Z_GET_X(h_R[j*N+j]) + 2.*N ) );
+        lapackf77_zlacpy( MagmaUpperLowerStr, &N, &N, h_R, &N, h_A, &N );
+
+        /* =====================================================================
+           Column-major layout
+           =================================================================== */
+        start = get_current_time();
+        factor(context, r, 0, N, h_R, ipiv, tau, work, lwork, info);
+        end = get_current_time();
+        if (info[0] < 0)
+          printf("Argument %d of magma_z%s_mc had an illegal value.\n", -info[0], names[r]);
+        perf[0] = flops / GetTimerValue(start, end);
+
+        /* =====================================================================
+           Tile layout, converted in place
+           =================================================================== */
+        start = get_current_time();
+        magma_zlapack_to_tile_mc(context, &N, &N, h_A, &N, h_A, &N, info);
+        end = get_current_time();
+        double t_conv = GetTimerValue(start, end);
+
+        start = get_current_time();
+        factor(context, r, 1, N, h_A, ipiv, tau, work, lwork, info);
+        end = get_current_time();
+        if (info[0] < 0)
+          printf("Argument %d of magma_z%s_tile_mc had an illegal value.\n", -info[0], names[r]);
+        double t_fact = GetTimerValue(start, end);
+        perf[1] = flops / t_fact;
+
+        start = get_current_time();
+        magma_ztile_to_lapack_mc(context, &N, &N, h_A, &N, h_A, &N, info);
+        end = get_current_time();
+        t_conv += GetTimerValue(start, end);
+        perf[2] = flops / (t_fact + t_conv);
+
+        /* =====================================================================
+           Check the result compared to the column-major layout
+           =================================================================== */
+        matnorm = lapackf77_zlange("f", &N, &N, h_R, &N, dwork);
+        blasf77_zaxpy(&n2, &mone, h_R, &ione, h_A, &ione);
+
+        printf("%7d   %s        %8.2f      %8.2f          %8.2f         %8.3f       %e\n",
+               (int) N, names[r], perf[0], perf[1], perf[2], t_conv / 1000.,
+               lapackf77_zlange("f", &N, &N, h_A, &N, dwork) / matnorm);
+        fflush(stdout);
+      }
+
+      TESTING_FREE( h_A  );
+      TESTING_FREE( h_R  );
+      TESTING_FREE( ipiv );
+      TESTING_FREE( tau  );
+      TESTING_FREE( work );
+
+      if (loop != 1)
+        break;
+    }
+
+    /* Shut down the MAGMA context */
+    magma_finalize(context);
+}
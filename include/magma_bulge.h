@@ -38,6 +38,30 @@ extern "C" {
 
     magma_int_t magma_bulge_get_blkcnt(magma_int_t n, magma_int_t nb, magma_int_t Vblksiz);
 
+    // scheduling of the bulge chasing tasks in hb2st/sb2st
+    typedef enum {
+        MagmaBulgeStatic  = 0,  // v9_9col: tile columns assigned to threads round-robin
+        MagmaBulgeDynamic = 1   // groups of tasks handed in order to idle threads
+    } magma_bulge_sched_t;
+
+    magma_bulge_sched_t magma_bulge_get_sched();
+    magma_int_t magma_bulge_get_grsiz(magma_int_t n, magma_int_t nb, magma_int_t threads, magma_int_t elemsize);
+
+    // placement of the band matrix and V, TAU, T workspaces in hb2st/sb2st
+    typedef enum {
+        MagmaBulgeNumaNone       = 0,  // used in place, zeroed by the calling thread
+        MagmaBulgeNumaFirstTouch = 1,  // used in place, zeroed by the thread that owns each block
+        MagmaBulgeNumaInterleave = 2   // band copied to a workspace interleaved over all NUMA nodes (needs libnuma)
+    } magma_bulge_numa_t;
+
+    magma_bulge_numa_t magma_bulge_get_numa();
+    void magma_bulge_numa_interleave(void *ptr, size_t size);
+    void magma_bulge_numa_copy_band(magma_int_t my_core_id, magma_int_t cores_num, magma_int_t n, magma_int_t nb, magma_int_t grsiz,
+                                    magma_int_t elemsize, const void *Asrc, void *Adst, magma_int_t lda);
+    void magma_bulge_numa_zero_VT(magma_int_t my_core_id, magma_int_t cores_num, magma_int_t n, magma_int_t nb, magma_int_t grsiz,
+                                  magma_int_t Vblksiz, magma_int_t elemsize,
+                                  void *V, magma_int_t ldv, void *TAU, void *T, magma_int_t ldt);
+
 #ifdef __cplusplus
 }
 #endif
@@ -424,7 +424,8 @@ typedef enum {
     Magma_CSRD         = 424,
     Magma_CSRL         = 427,
     Magma_CSRU         = 428,
-    Magma_CSRCOO       = 429
+    Magma_CSRCOO       = 429,
+    Magma_STENCIL      = 430
 } magma_storage_t;
 
 
@@ -488,6 +489,12 @@ typedef enum {
     Magma_UNITDIAG     = 513
 } magma_scale_t;
 
+typedef enum {
+    Magma_NOREORDER    = 521,
+    Magma_RCM          = 522,
+    Magma_ND           = 523
+} magma_reorder_t;
+
 
 // When adding constants, remember to do these steps as appropriate:
 // 1)  add magma_xxxx_const()  converter below and in control/constants.cpp
@@ -495,7 +502,7 @@ typedef enum {
 // 2b) update min & max here, which are used to check bounds for magma2lapack_constants[]
 // 2c) add lapack_xxxx_const() converter below and in control/constants.cpp
 #define Magma2lapack_Min  MagmaFalse     // 0
-#define Magma2lapack_Max  MagmaRowwise   // 402
+#define Magma2lapack_Max  Magma_ND       // 523
 
 
 // ----------------------------------------
@@ -585,6 +592,8 @@ const char* lapack_range_const ( magma_range_t  magma_const );
 const char* lapack_vect_const  ( magma_vect_t   magma_const );
 const char* lapack_direct_const( magma_direct_t magma_const );
 const char* lapack_storev_const( magma_storev_t magma_const );
+const char* lapack_storage_const( magma_storage_t magma_const );
+const char* lapack_reorder_const( magma_reorder_t magma_const );
 
 static inline char lapacke_const       ( int magma_const            ) { return *lapack_const       ( magma_const ); }
 static inline char lapacke_bool_const  ( magma_bool_t   magma_const ) { return *lapack_bool_const  ( magma_const ); }
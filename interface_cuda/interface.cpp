@@ -28,6 +28,7 @@ void acmlversion(int *major, int *minor, int *patch);
 
 #include "common_magma.h"
 #include "error.h"
+#include "magma_thread_team.h"
 
 #ifdef HAVE_CUBLAS
 
@@ -69,12 +70,13 @@ magma_int_t magma_init()
 }
 
 // --------------------
-// Frees information about CUDA devices.
+// Frees information about CUDA devices, and exits the thread team.
 extern "C"
 magma_int_t magma_finalize()
 {
     free( g_magma_devices );
     g_magma_devices = NULL;
+    magma_thread_team_finalize();
     return MAGMA_SUCCESS;
 }
 
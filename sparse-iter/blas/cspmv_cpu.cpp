@@ -0,0 +1,621 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from zspmv_cpu.cpp normal z -> c, Tue Sep  2 12:38:36 2014
+
+*/
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "common_magma.h"
+#include "magmasparse_types.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+
+
+// Host SpMV kernels for matrices with memory_location Magma_CPU.
+// All compute Y = alpha * A * X + beta * Y for num_vecs vectors, where
+// vector i of X starts at x + i*n and vector i of Y at y + i*m.
+// Each thread works on its own rows, so no reductions are needed.
+// Matrices with fewer than MAGMA_SPARSE_OMP_THRESHOLD nonzeros are done by
+// a single thread.
+
+// rows per block in the ELL kernel
+#define ELL_BLOCK 64
+
+// grid points per block of a grid line in the stencil kernel
+#define STENCIL_XBLOCK 512
+
+
+// ---------------------------------------------
+// Returns the number of threads to use for a matrix with nnz nonzeros.
+static magma_int_t
+spmv_nthread( magma_int_t nnz )
+{
+#ifdef _OPENMP
+    if ( nnz >= MAGMA_SPARSE_OMP_THRESHOLD )
+        return omp_get_max_threads();
+#endif
+    return 1;
+}
+
+
+/**
+    Purpose
+    -------
+
+    This routine computes Y = alpha *  A *  X + beta * Y on the CPU
+    for num_vecs vectors. The input format is CSR (val, row, col).
+    Threads take contiguous ranges of rows with about the same number of
+    nonzeros.
+
+    Arguments
+    ---------
+
+    @param
+    transA      magma_trans_t
+                transposition parameter for A
+
+    @param
+    m           magma_int_t
+                number of rows in A
+
+    @param
+    n           magma_int_t
+                number of columns in A
+
+    @param
+    num_vecs    magma_int_t
+                number of vectors
+
+    @param
+    alpha       magmaFloatComplex
+                scalar multiplier
+
+    @param
+    val         magmaFloatComplex*
+                array containing values of A in CSR
+
+    @param
+    rowptr      magma_index_t*
+                rowpointer of A in CSR
+
+    @param
+    colind      magma_index_t*
+                columnindices of A in CSR
+
+    @param
+    x           magmaFloatComplex*
+                input vector x
+
+    @param
+    beta        magmaFloatComplex
+                scalar multiplier
+
+    @param
+    y           magmaFloatComplex*
+                input/output vector y
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+magma_int_t
+magma_cgecsrmv_cpu( magma_trans_t transA,
+                    magma_int_t m, magma_int_t n,
+                    magma_int_t num_vecs,
+                    magmaFloatComplex alpha,
+                    const magmaFloatComplex *val,
+                    const magma_index_t *rowptr,
+                    const magma_index_t *colind,
+                    const magmaFloatComplex *x,
+                    magmaFloatComplex beta,
+                    magmaFloatComplex *y ){
+
+    magma_int_t nnz = rowptr[m];
+
+#ifdef _OPENMP
+    magma_int_t nthread = spmv_nthread( nnz );
+    #pragma omp parallel num_threads( nthread )
+#endif
+    {
+#ifdef _OPENMP
+        magma_int_t id  = omp_get_thread_num();
+        magma_int_t tot = omp_get_num_threads();
+#else
+        magma_int_t id  = 0;
+        magma_int_t tot = 1;
+#endif
+        // rows [rb, re), with about nnz/tot nonzeros
+        magma_int_t rb, re;
+        magma_sparse_row_partition( rowptr, m, id, tot, &rb, &re );
+
+        for( magma_int_t row=rb; row < re; row++ ){
+            magma_int_t start = rowptr[ row ];
+            magma_int_t end   = rowptr[ row+1 ];
+            for( magma_int_t i=0; i < num_vecs; i++ ){
+                const magmaFloatComplex *xi = x + i*n;
+                magmaFloatComplex dot = MAGMA_C_ZERO;
+                for( magma_int_t j=start; j < end; j++ )
+                    dot += val[ j ] * xi[ colind[j] ];
+                y[ row + i*m ] = dot * alpha + beta * y[ row + i*m ];
+            }
+        }
+    }
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    This routine computes Y = alpha *  A *  X + beta * Y on the CPU
+    for num_vecs vectors. The input format is ELLPACK, with the
+    nnz_per_row entries of each row stored contiguously.
+
+    Arguments
+    ---------
+
+    @param
+    transA      magma_trans_t
+                transposition parameter for A
+
+    @param
+    m           magma_int_t
+                number of rows in A
+
+    @param
+    n           magma_int_t
+                number of columns in A
+
+    @param
+    num_vecs    magma_int_t
+                number of vectors
+
+    @param
+    nnz_per_row magma_int_t
+                number of elements in the longest row
+
+    @param
+    alpha       magmaFloatComplex
+                scalar multiplier
+
+    @param
+    val         magmaFloatComplex*
+                array containing values of A in ELLPACK
+
+    @param
+    colind      magma_index_t*
+                columnindices of A in ELLPACK
+
+    @param
+    x           magmaFloatComplex*
+                input vector x
+
+    @param
+    beta        magmaFloatComplex
+                scalar multiplier
+
+    @param
+    y           magmaFloatComplex*
+                input/output vector y
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+magma_int_t
+magma_cgeellmv_cpu( magma_trans_t transA,
+                    magma_int_t m, magma_int_t n,
+                    magma_int_t num_vecs,
+                    magma_int_t nnz_per_row,
+                    magmaFloatComplex alpha,
+                    const magmaFloatComplex *val,
+                    const magma_index_t *colind,
+                    const magmaFloatComplex *x,
+                    magmaFloatComplex beta,
+                    magmaFloatComplex *y ){
+
+#ifdef _OPENMP
+    magma_int_t nthread = spmv_nthread( m*nnz_per_row );
+    #pragma omp parallel for num_threads( nthread ) schedule( static )
+#endif
+    for( magma_int_t row=0; row < m; row++ ){
+        const magmaFloatComplex *v = val    + row*nnz_per_row;
+        const magma_index_t      *c = colind + row*nnz_per_row;
+        for( magma_int_t i=0; i < num_vecs; i++ ){
+            const magmaFloatComplex *xi = x + i*n;
+            magmaFloatComplex dot = MAGMA_C_ZERO;
+            for( magma_int_t k=0; k < nnz_per_row; k++ )
+                dot += v[ k ] * xi[ c[k] ];
+            y[ row + i*m ] = dot * alpha + beta * y[ row + i*m ];
+        }
+    }
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    This routine computes Y = alpha *  A *  X + beta * Y on the CPU
+    for num_vecs vectors. The input format is ELL, with entry k of
+    row i stored at k*m + i.
+    Each thread does blocks of ELL_BLOCK rows, accumulating
+    all rows of a block at once, so the innermost loop runs with unit
+    stride through val and colind and can be vectorized.
+
+    Arguments
+    ---------
+
+    @param
+    transA      magma_trans_t
+                transposition parameter for A
+
+    @param
+    m           magma_int_t
+                number of rows in A
+
+    @param
+    n           magma_int_t
+                number of columns in A
+
+    @param
+    num_vecs    magma_int_t
+                number of vectors
+
+    @param
+    nnz_per_row magma_int_t
+                number of elements in the longest row
+
+    @param
+    alpha       magmaFloatComplex
+                scalar multiplier
+
+    @param
+    val         magmaFloatComplex*
+                array containing values of A in ELL
+
+    @param
+    colind      magma_index_t*
+                columnindices of A in ELL
+
+    @param
+    x           magmaFloatComplex*
+                input vector x
+
+    @param
+    beta        magmaFloatComplex
+                scalar multiplier
+
+    @param
+    y           magmaFloatComplex*
+                input/output vector y
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+magma_int_t
+magma_cgeelltmv_cpu( magma_trans_t transA,
+                     magma_int_t m, magma_int_t n,
+                     magma_int_t num_vecs,
+                     magma_int_t nnz_per_row,
+                     magmaFloatComplex alpha,
+                     const magmaFloatComplex *val,
+                     const magma_index_t *colind,
+                     const magmaFloatComplex *x,
+                     magmaFloatComplex beta,
+                     magmaFloatComplex *y ){
+
+    magma_int_t nblock = (m + ELL_BLOCK-1) / ELL_BLOCK;
+
+#ifdef _OPENMP
+    magma_int_t nthread = spmv_nthread( m*nnz_per_row );
+    #pragma omp parallel for num_threads( nthread ) schedule( static )
+#endif
+    for( magma_int_t b=0; b < nblock; b++ ){
+        magmaFloatComplex dot[ ELL_BLOCK ];
+        magma_int_t rb = b*ELL_BLOCK;
+        magma_int_t nr = min( (magma_int_t) ELL_BLOCK, m - rb );
+        for( magma_int_t i=0; i < num_vecs; i++ ){
+            const magmaFloatComplex *xi = x + i*n;
+            for( magma_int_t r=0; r < nr; r++ )
+                dot[ r ] = MAGMA_C_ZERO;
+            for( magma_int_t k=0; k < nnz_per_row; k++ ){
+                const magmaFloatComplex *v = val    + k*m + rb;
+                const magma_index_t      *c = colind + k*m + rb;
+                for( magma_int_t r=0; r < nr; r++ )
+                    dot[ r ] += v[ r ] * xi[ c[r] ];
+            }
+            magmaFloatComplex *yi = y + i*m + rb;
+            for( magma_int_t r=0; r < nr; r++ )
+                yi[ r ] = dot[ r ] * alpha + beta * yi[ r ];
+        }
+    }
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    This routine computes Y = alpha *  A *  X + beta * Y on the CPU
+    for num_vecs vectors. The input format is SELLP, in which entry k of
+    local row r of slice s is stored at rowptr[s] + k*blocksize + r.
+    As for ELL, all rows of a slice are accumulated at once, so the
+    innermost loop runs with unit stride and can be vectorized.
+    Slices have different lengths, so threads take them dynamically.
+
+    Arguments
+    ---------
+
+    @param
+    transA      magma_trans_t
+                transposition parameter for A
+
+    @param
+    m           magma_int_t
+                number of rows in A
+
+    @param
+    n           magma_int_t
+                number of columns in A
+
+    @param
+    num_vecs    magma_int_t
+                number of vectors
+
+    @param
+    blocksize   magma_int_t
+                number of rows in one slice
+
+    @param
+    slices      magma_int_t
+                number of slices
+
+    @param
+    alignment   magma_int_t
+                number of elements each row of a slice is padded to
+                a multiple of
+
+    @param
+    alpha       magmaFloatComplex
+                scalar multiplier
+
+    @param
+    val         magmaFloatComplex*
+                array containing values of A in SELLP
+
+    @param
+    colind      magma_index_t*
+                columnindices of A in SELLP
+
+    @param
+    rowptr      magma_index_t*
+                slice pointer of A in SELLP
+
+    @param
+    x           magmaFloatComplex*
+                input vector x
+
+    @param
+    beta        magmaFloatComplex
+                scalar multiplier
+
+    @param
+    y           magmaFloatComplex*
+                input/output vector y
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+magma_int_t
+magma_cgesellpmv_cpu( magma_trans_t transA,
+                      magma_int_t m, magma_int_t n,
+                      magma_int_t num_vecs,
+                      magma_int_t blocksize,
+                      magma_int_t slices,
+                      magma_int_t alignment,
+                      magmaFloatComplex alpha,
+                      const magmaFloatComplex *val,
+                      const magma_index_t *colind,
+                      const magma_index_t *rowptr,
+                      const magmaFloatComplex *x,
+                      magmaFloatComplex beta,
+                      magmaFloatComplex *y ){
+
+    magma_int_t nthread = spmv_nthread( rowptr[slices] );
+
+    // one accumulator of blocksize entries per thread
+    magmaFloatComplex *work;
+    magma_cmalloc_cpu( &work, nthread*blocksize );
+
+#ifdef _OPENMP
+    #pragma omp parallel num_threads( nthread )
+#endif
+    {
+#ifdef _OPENMP
+        magmaFloatComplex *dot = work + omp_get_thread_num()*blocksize;
+        #pragma omp for schedule( dynamic, 16 )
+#else
+        magmaFloatComplex *dot = work;
+#endif
+        for( magma_int_t s=0; s < slices; s++ ){
+            magma_int_t rb = s*blocksize;
+            magma_int_t nr = min( blocksize, m - rb );
+            magma_int_t offset = rowptr[ s ];
+            magma_int_t len = (rowptr[ s+1 ] - offset) / blocksize;
+            for( magma_int_t i=0; i < num_vecs; i++ ){
+                const magmaFloatComplex *xi = x + i*n;
+                for( magma_int_t r=0; r < blocksize; r++ )
+                    dot[ r ] = MAGMA_C_ZERO;
+                for( magma_int_t k=0; k < len; k++ ){
+                    const magmaFloatComplex *v = val    + offset + k*blocksize;
+                    const magma_index_t      *c = colind + offset + k*blocksize;
+                    for( magma_int_t r=0; r < blocksize; r++ )
+                        dot[ r ] += v[ r ] * xi[ c[r] ];
+                }
+                magmaFloatComplex *yi = y + i*m + rb;
+                for( magma_int_t r=0; r < nr; r++ )
+                    yi[ r ] = dot[ r ] * alpha + beta * yi[ r ];
+            }
+        }
+    }
+
+    magma_free_cpu( work );
+    return MAGMA_SUCCESS;
+}
+
+
+
+/**
+    Purpose
+    -------
+
+    This routine computes Y = alpha *  A *  X + beta * Y on the CPU
+    for num_vecs vectors, for the matrix-free stencil A on an
+    nx x ny x nz grid, see magma_cm_stencil. Grid point (x, y, z) is
+    row (z*ny + y)*nx + x.
+
+    Threads take contiguous ranges of grid lines in x. A block of a line
+    is accumulated one stencil point at a time: the range of x for which
+    the neighbour exists follows from the offset, so the innermost loop
+    is a branch-free axpy with unit stride on neighbouring lines of X,
+    which stay in cache from the previous lines. Only X and Y are read
+    and written, instead of the values and column indices of CSR.
+
+    Arguments
+    ---------
+
+    @param
+    transA      magma_trans_t
+                transposition parameter for A
+
+    @param
+    nx          magma_int_t
+                grid points in x
+
+    @param
+    ny          magma_int_t
+                grid points in y
+
+    @param
+    nz          magma_int_t
+                grid points in z
+
+    @param
+    num_vecs    magma_int_t
+                number of vectors
+
+    @param
+    npoints     magma_int_t
+                number of stencil points
+
+    @param
+    alpha       magmaFloatComplex
+                scalar multiplier
+
+    @param
+    val         magmaFloatComplex*
+                values of the stencil points
+
+    @param
+    offset      magma_index_t*
+                offsets (dx, dy, dz) of the stencil points
+
+    @param
+    x           magmaFloatComplex*
+                input vector x
+
+    @param
+    beta        magmaFloatComplex
+                scalar multiplier
+
+    @param
+    y           magmaFloatComplex*
+                input/output vector y
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+magma_int_t
+magma_cgestencilmv_cpu( magma_trans_t transA,
+                        magma_int_t nx, magma_int_t ny, magma_int_t nz,
+                        magma_int_t num_vecs,
+                        magma_int_t npoints,
+                        magmaFloatComplex alpha,
+                        const magmaFloatComplex *val,
+                        const magma_index_t *offset,
+                        const magmaFloatComplex *x,
+                        magmaFloatComplex beta,
+                        magmaFloatComplex *y ){
+
+    magma_int_t m = nx*ny*nz;
+    magma_int_t lines = ny*nz;
+    magma_int_t xblock = min( nx, (magma_int_t) STENCIL_XBLOCK );
+    magma_int_t nthread = spmv_nthread( m*npoints );
+
+    // one accumulator of xblock entries per thread
+    magmaFloatComplex *work;
+    magma_cmalloc_cpu( &work, nthread*xblock );
+
+#ifdef _OPENMP
+    #pragma omp parallel num_threads( nthread )
+#endif
+    {
+#ifdef _OPENMP
+        magmaFloatComplex *dot = work + omp_get_thread_num()*xblock;
+        #pragma omp for schedule( static )
+#else
+        magmaFloatComplex *dot = work;
+#endif
+        for( magma_int_t l=0; l < lines; l++ ){
+            magma_int_t ly = l % ny;
+            magma_int_t lz = l / ny;
+            for( magma_int_t i=0; i < num_vecs; i++ ){
+                const magmaFloatComplex *xi = x + i*m;
+                magmaFloatComplex *yi = y + i*m + l*nx;
+                for( magma_int_t xb=0; xb < nx; xb += xblock ){
+                    magma_int_t xe = min( xb + xblock, nx );
+                    for( magma_int_t r=0; r < xe-xb; r++ )
+                        dot[ r ] = MAGMA_C_ZERO;
+                    for( magma_int_t k=0; k < npoints; k++ ){
+                        magma_int_t dx = offset[3*k];
+                        magma_int_t dy = offset[3*k+1];
+                        magma_int_t dz = offset[3*k+2];
+                        if( ly+dy < 0 || ly+dy >= ny || lz+dz < 0 || lz+dz >= nz )
+                            continue;
+                        // x in [lo, hi) has its neighbour x+dx in the line
+                        magma_int_t lo = max( xb, -dx );
+                        magma_int_t hi = min( xe, nx - dx );
+                        const magmaFloatComplex v = val[ k ];
+                        const magmaFloatComplex *xl = xi
+                                + ((lz+dz)*ny + ly+dy)*nx;
+                        for( magma_int_t r=lo; r < hi; r++ )
+                            dot[ r-xb ] += v * xl[ r+dx ];
+                    }
+                    for( magma_int_t r=0; r < xe-xb; r++ )
+                        yi[ xb+r ] = dot[ r ] * alpha + beta * yi[ xb+r ];
+                }
+            }
+        }
+    }
+
+    magma_free_cpu( work );
+    return MAGMA_SUCCESS;
+}
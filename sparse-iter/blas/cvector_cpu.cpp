@@ -0,0 +1,513 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from zvector_cpu.cpp normal z -> c, Tue Sep  2 12:38:36 2014
+
+*/
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "common_magma.h"
+#include "magmasparse_types.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+
+
+// Vector kernels for the Krylov solvers on the CPU.
+// Where the GPU solvers call several BLAS-1 routines in a row on the same
+// vectors, these kernels do the updates in one pass and also return the
+// norm or dot product the solver needs next.
+// Vectors shorter than MAGMA_SPARSE_OMP_THRESHOLD are done by a single thread.
+
+
+/**
+    Purpose
+    -------
+
+    Returns x^H * y for vectors of length n on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           magmaFloatComplex*
+                input vector x
+
+    @param
+    y           magmaFloatComplex*
+                input vector y
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+magmaFloatComplex
+magma_cdotc_cpu( magma_int_t n,
+                 const magmaFloatComplex *x,
+                 const magmaFloatComplex *y ){
+
+    float re = 0., im = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:re,im )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        magmaFloatComplex tmp = MAGMA_C_CNJG( x[i] ) * y[i];
+        re += MAGMA_C_REAL( tmp );
+        im += MAGMA_C_IMAG( tmp );
+    }
+    return MAGMA_C_MAKE( re, im );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes dots[0] = x^H * y and dots[1] = x^H * x in one pass
+    on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           magmaFloatComplex*
+                input vector x
+
+    @param
+    y           magmaFloatComplex*
+                input vector y
+
+    @param
+    dots        magmaFloatComplex*
+                array of length 2, the dot products
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+magma_int_t
+magma_cdotc2_cpu( magma_int_t n,
+                  const magmaFloatComplex *x,
+                  const magmaFloatComplex *y,
+                  magmaFloatComplex *dots ){
+
+    float re = 0., im = 0., xx = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:re,im,xx )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        magmaFloatComplex tmp = MAGMA_C_CNJG( x[i] ) * y[i];
+        re += MAGMA_C_REAL( tmp );
+        im += MAGMA_C_IMAG( tmp );
+        xx += MAGMA_C_REAL( x[i] ) * MAGMA_C_REAL( x[i] )
+            + MAGMA_C_IMAG( x[i] ) * MAGMA_C_IMAG( x[i] );
+    }
+    dots[0] = MAGMA_C_MAKE( re, im );
+    dots[1] = MAGMA_C_MAKE( xx, 0. );
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Returns the Euclidean norm of x on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           magmaFloatComplex*
+                input vector x
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+float
+magma_scnrm2_cpu( magma_int_t n,
+                  const magmaFloatComplex *x ){
+
+    // Each thread takes the norm of its part with BLAS, which scales to avoid
+    // overflow and underflow. The parts are combined as in LAPACK's dlassq:
+    // norm = scale * sqrt( ssq ), where scale is the largest part so far.
+    // A NaN part would fail both comparisons and be dropped, so it is
+    // stored in scale instead, making the norm NaN.
+    float scale = 0., ssq = 1.;
+#ifdef _OPENMP
+    #pragma omp parallel if( n >= MAGMA_SPARSE_OMP_THRESHOLD )
+#endif
+    {
+        magma_int_t id = 0, tot = 1;
+#ifdef _OPENMP
+        id  = omp_get_thread_num();
+        tot = omp_get_num_threads();
+#endif
+        magma_int_t ib = (magma_int_t) (((size_t) n * id) / tot);
+        magma_int_t ie = (magma_int_t) (((size_t) n * (id+1)) / tot);
+        float part = magma_cblas_scnrm2( ie - ib, x + ib, 1 );
+#ifdef _OPENMP
+        #pragma omp critical
+#endif
+        {
+            if( part != part ){
+                scale = part;
+            }
+            else if( part > scale ){
+                ssq   = 1. + ssq * (scale/part) * (scale/part);
+                scale = part;
+            }
+            else if( part > 0. ){
+                ssq  += (part/scale) * (part/scale);
+            }
+        }
+    }
+    return scale * sqrt( ssq );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes y = alpha * x + beta * y on the CPU.
+    If beta is zero, y is not read, so this also copies and scales x.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       magmaFloatComplex
+                scalar multiplier
+
+    @param
+    x           magmaFloatComplex*
+                input vector x
+
+    @param
+    beta        magmaFloatComplex
+                scalar multiplier
+
+    @param
+    y           magmaFloatComplex*
+                input/output vector y
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+magma_int_t
+magma_caxpby_cpu( magma_int_t n,
+                  magmaFloatComplex alpha,
+                  const magmaFloatComplex *x,
+                  magmaFloatComplex beta,
+                  magmaFloatComplex *y ){
+
+    if( MAGMA_C_EQUAL( beta, MAGMA_C_ZERO )){
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            y[i] = alpha * x[i];
+    }
+    else{
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            y[i] = alpha * x[i] + beta * y[i];
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes z = alpha * x + beta * y + gamma * z on the CPU.
+    If gamma is zero, z is not read.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       magmaFloatComplex
+                scalar multiplier
+
+    @param
+    x           magmaFloatComplex*
+                input vector x
+
+    @param
+    beta        magmaFloatComplex
+                scalar multiplier
+
+    @param
+    y           magmaFloatComplex*
+                input vector y
+
+    @param
+    gamma       magmaFloatComplex
+                scalar multiplier
+
+    @param
+    z           magmaFloatComplex*
+                input/output vector z
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+magma_int_t
+magma_caxpbypcz_cpu( magma_int_t n,
+                     magmaFloatComplex alpha,
+                     const magmaFloatComplex *x,
+                     magmaFloatComplex beta,
+                     const magmaFloatComplex *y,
+                     magmaFloatComplex gamma,
+                     magmaFloatComplex *z ){
+
+    if( MAGMA_C_EQUAL( gamma, MAGMA_C_ZERO )){
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            z[i] = alpha * x[i] + beta * y[i];
+    }
+    else{
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            z[i] = alpha * x[i] + beta * y[i] + gamma * z[i];
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the solution and residual update of CG on the CPU,
+        x = x + alpha * p
+        r = r - alpha * q,
+    and returns r^H * r.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       magmaFloatComplex
+                step length
+
+    @param
+    p           magmaFloatComplex*
+                search direction
+
+    @param
+    q           magmaFloatComplex*
+                A times the search direction
+
+    @param
+    x           magmaFloatComplex*
+                input/output solution approximation
+
+    @param
+    r           magmaFloatComplex*
+                input/output residual
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+float
+magma_ccgupdate_cpu( magma_int_t n,
+                     magmaFloatComplex alpha,
+                     const magmaFloatComplex *p,
+                     const magmaFloatComplex *q,
+                     magmaFloatComplex *x,
+                     magmaFloatComplex *r ){
+
+    float nrm = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:nrm )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        x[i] += alpha * p[i];
+        magmaFloatComplex ri = r[i] - alpha * q[i];
+        r[i] = ri;
+        nrm += MAGMA_C_REAL( ri ) * MAGMA_C_REAL( ri )
+             + MAGMA_C_IMAG( ri ) * MAGMA_C_IMAG( ri );
+    }
+    return nrm;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the solution and residual update of BiCGSTAB on the CPU,
+        x = x + alpha * y + omega * z
+        r = s - omega * t,
+    sets rho = rr^H * r for the next iteration, and returns r^H * r.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       magmaFloatComplex
+                scalar multiplier
+
+    @param
+    omega       magmaFloatComplex
+                scalar multiplier
+
+    @param
+    y           magmaFloatComplex*
+                (preconditioned) search direction
+
+    @param
+    z           magmaFloatComplex*
+                (preconditioned) intermediate residual
+
+    @param
+    s           magmaFloatComplex*
+                intermediate residual
+
+    @param
+    t           magmaFloatComplex*
+                A times z
+
+    @param
+    rr          magmaFloatComplex*
+                shadow residual
+
+    @param
+    x           magmaFloatComplex*
+                input/output solution approximation
+
+    @param
+    r           magmaFloatComplex*
+                output residual
+
+    @param
+    rho         magmaFloatComplex*
+                output rr^H * r
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+float
+magma_cbicgupdate_cpu( magma_int_t n,
+                       magmaFloatComplex alpha,
+                       magmaFloatComplex omega,
+                       const magmaFloatComplex *y,
+                       const magmaFloatComplex *z,
+                       const magmaFloatComplex *s,
+                       const magmaFloatComplex *t,
+                       const magmaFloatComplex *rr,
+                       magmaFloatComplex *x,
+                       magmaFloatComplex *r,
+                       magmaFloatComplex *rho ){
+
+    float nrm = 0., re = 0., im = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:nrm,re,im )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        x[i] += alpha * y[i] + omega * z[i];
+        magmaFloatComplex ri = s[i] - omega * t[i];
+        r[i] = ri;
+        magmaFloatComplex tmp = MAGMA_C_CNJG( rr[i] ) * ri;
+        re += MAGMA_C_REAL( tmp );
+        im += MAGMA_C_IMAG( tmp );
+        nrm += MAGMA_C_REAL( ri ) * MAGMA_C_REAL( ri )
+             + MAGMA_C_IMAG( ri ) * MAGMA_C_IMAG( ri );
+    }
+    *rho = MAGMA_C_MAKE( re, im );
+    return nrm;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes x = d .* b on the CPU, i.e., applies the Jacobi
+    preconditioner with the inverse diagonal d.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    d           magmaFloatComplex*
+                inverse diagonal of A
+
+    @param
+    b           magmaFloatComplex*
+                input vector b
+
+    @param
+    x           magmaFloatComplex*
+                output vector x
+
+
+    @ingroup magmasparse_cblas
+    ********************************************************************/
+
+magma_int_t
+magma_cjacobi_diagscal_cpu( magma_int_t n,
+                            const magmaFloatComplex *d,
+                            const magmaFloatComplex *b,
+                            magmaFloatComplex *x ){
+
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+    for( magma_int_t i=0; i < n; i++ )
+        x[i] = d[i] * b[i];
+    return MAGMA_SUCCESS;
+}
@@ -0,0 +1,379 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from zmerge_cpu.cpp normal z -> d, Tue Sep  2 12:38:36 2014
+
+*/
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "common_magma.h"
+#include "magmasparse_types.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+
+
+// Host versions of the merged CG and BiCGSTAB kernels in zmergecg.cu and
+// zmergebicgstab.cu, for A in CSR on the CPU.
+// One call does a whole iteration in a single parallel region. Each thread
+// keeps the same rows, about nnz/nthreads nonzeros, in all steps, and fuses
+// the SpMV and the vector updates of its rows with the dot products that
+// follow them. The partial sums of thread t go to part[t*MERGE_PAD + k];
+// each step uses its own slots k, so a barrier after each reduction is
+// enough, and every thread adds the partial sums in the same order.
+// Matrices with fewer than MAGMA_SPARSE_OMP_THRESHOLD rows are done by a
+// single thread.
+
+// partial sums per thread, at least one cache line apart
+#define MERGE_PAD 16
+
+
+// ---------------------------------------------
+// Returns the number of threads to use for n rows.
+static magma_int_t
+merge_nthread( magma_int_t n )
+{
+#ifdef _OPENMP
+    if ( n >= MAGMA_SPARSE_OMP_THRESHOLD )
+        return omp_get_max_threads();
+#endif
+    return 1;
+}
+
+
+// ---------------------------------------------
+// Returns the sum of part[t*MERGE_PAD + k] over the tot threads.
+static double
+merge_sum( const double *part, magma_int_t tot, magma_int_t k )
+{
+    double sum = 0.;
+    for( magma_int_t t=0; t < tot; t++ )
+        sum += part[ t*MERGE_PAD + k ];
+    return sum;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Does one iteration of the merged CG on the CPU, for A in CSR:
+        z = A d,            den = d^H z,
+        alpha = nom / den,
+        x = x + alpha d,    r = r - alpha z,    nom' = r^H r,
+        d = r + nom' / nom d.
+    The SpMV is fused with d^H z, and the update of x and r with r^H r,
+    so the iteration reads and writes the vectors in three passes.
+    If den <= 0, only z and den are computed.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_d_sparse_matrix
+                system matrix in CSR, on the CPU
+
+    @param
+    x           double*
+                input/output solution approximation
+
+    @param
+    r           double*
+                input/output residual
+
+    @param
+    d           double*
+                input/output search direction
+
+    @param
+    z           double*
+                output A times the search direction
+
+    @param
+    nom         double*
+                input r^H r, output r^H r of the updated residual
+
+    @param
+    den         double*
+                output d^H A d
+
+
+    @ingroup magmasparse_dblas
+    ********************************************************************/
+
+magma_int_t
+magma_dcgmerge_cpu( magma_d_sparse_matrix A,
+                    double *x,
+                    double *r,
+                    double *d,
+                    double *z,
+                    double *nom,
+                    double *den ){
+
+    magma_int_t n = A.num_rows;
+    const double *val = A.val;
+    const magma_index_t *row = A.row, *col = A.col;
+    double nom_old = *nom;
+
+    magma_int_t nthread = merge_nthread( n );
+    double *part;
+    magma_malloc_cpu( (void**) &part, nthread*MERGE_PAD*sizeof(*part) );
+
+#ifdef _OPENMP
+    #pragma omp parallel num_threads( nthread )
+#endif
+    {
+#ifdef _OPENMP
+        magma_int_t id  = omp_get_thread_num();
+        magma_int_t tot = omp_get_num_threads();
+#else
+        magma_int_t id  = 0;
+        magma_int_t tot = 1;
+#endif
+        // rows [rb, re), with about nnz/tot nonzeros
+        magma_int_t rb, re;
+        magma_sparse_row_partition( row, n, id, tot, &rb, &re );
+        double *mypart = part + id*MERGE_PAD;
+
+        // z = A d, den = d^H z
+        double dz = 0.;
+        for( magma_int_t i=rb; i < re; i++ ){
+            double dot = MAGMA_D_ZERO;
+            for( magma_int_t j=row[i]; j < row[i+1]; j++ )
+                dot += val[ j ] * d[ col[j] ];
+            z[i] = dot;
+            dz += MAGMA_D_REAL( d[i] ) * MAGMA_D_REAL( dot )
+                + MAGMA_D_IMAG( d[i] ) * MAGMA_D_IMAG( dot );
+        }
+        mypart[0] = dz;
+#ifdef _OPENMP
+        #pragma omp barrier
+#endif
+        dz = merge_sum( part, tot, 0 );
+
+        if ( dz > 0. ) {
+            // x = x + alpha d, r = r - alpha z, nom = r^H r
+            double alpha = MAGMA_D_MAKE( nom_old / dz, 0. );
+            double rr = 0.;
+            for( magma_int_t i=rb; i < re; i++ ){
+                x[i] += alpha * d[i];
+                double ri = r[i] - alpha * z[i];
+                r[i] = ri;
+                rr += MAGMA_D_REAL( ri ) * MAGMA_D_REAL( ri )
+                    + MAGMA_D_IMAG( ri ) * MAGMA_D_IMAG( ri );
+            }
+            mypart[1] = rr;
+#ifdef _OPENMP
+            #pragma omp barrier
+#endif
+            rr = merge_sum( part, tot, 1 );
+
+            // d = r + beta d
+            double beta = MAGMA_D_MAKE( rr / nom_old, 0. );
+            for( magma_int_t i=rb; i < re; i++ )
+                d[i] = r[i] + beta * d[i];
+
+            if ( id == 0 )
+                *nom = rr;
+        }
+        if ( id == 0 )
+            *den = dz;
+    }
+
+    magma_free_cpu( part );
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Does one iteration of the merged BiCGSTAB on the CPU, for A in CSR:
+        beta = rho / rho_old * alpha / omega,
+        p = r + beta ( p - omega v ),
+        v = A p,                alpha = rho / rr^H v,
+        s = r - alpha v,
+        t = A s,                omega = t^H s / t^H t,
+        x = x + alpha p + omega s,
+        r = s - omega t,        rho_old = rho,  rho = rr^H r,  nom = r^H r.
+    Both SpMVs are fused with the dot products of their results, and the
+    update of x and r with rr^H r and r^H r, so the iteration reads and
+    writes the vectors in five passes.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_d_sparse_matrix
+                system matrix in CSR, on the CPU
+
+    @param
+    skp         double*
+                input/output scalars [alpha|beta|omega|rho_old|rho|nom]
+
+    @param
+    rr          double*
+                shadow residual
+
+    @param
+    r           double*
+                input/output residual
+
+    @param
+    p           double*
+                input/output search direction
+
+    @param
+    v           double*
+                input/output A times the search direction
+
+    @param
+    s           double*
+                output intermediate residual
+
+    @param
+    t           double*
+                output A times s
+
+    @param
+    x           double*
+                input/output solution approximation
+
+
+    @ingroup magmasparse_dblas
+    ********************************************************************/
+
+magma_int_t
+magma_dbicgmerge_cpu( magma_d_sparse_matrix A,
+                      double *skp,
+                      const double *rr,
+                      double *r,
+                      double *p,
+                      double *v,
+                      double *s,
+                      double *t,
+                      double *x ){
+
+    magma_int_t n = A.num_rows;
+    const double *val = A.val;
+    const magma_index_t *row = A.row, *col = A.col;
+    double rho = skp[4];
+    double beta = rho / skp[3] * skp[0] / skp[2];
+    double mob = MAGMA_D_NEG_ONE * skp[2] * beta;
+
+    magma_int_t nthread = merge_nthread( n );
+    double *part;
+    magma_malloc_cpu( (void**) &part, nthread*MERGE_PAD*sizeof(*part) );
+
+#ifdef _OPENMP
+    #pragma omp parallel num_threads( nthread )
+#endif
+    {
+#ifdef _OPENMP
+        magma_int_t id  = omp_get_thread_num();
+        magma_int_t tot = omp_get_num_threads();
+#else
+        magma_int_t id  = 0;
+        magma_int_t tot = 1;
+#endif
+        // rows [rb, re), with about nnz/tot nonzeros
+        magma_int_t rb, re;
+        magma_sparse_row_partition( row, n, id, tot, &rb, &re );
+        double *mypart = part + id*MERGE_PAD;
+        double tmp;
+
+        // p = r + beta ( p - omega v ), rounded as in magma_daxpbypcz_cpu
+        for( magma_int_t i=rb; i < re; i++ )
+            p[i] = r[i] + mob * v[i] + beta * p[i];
+#ifdef _OPENMP
+        #pragma omp barrier
+#endif
+
+        // v = A p, alpha = rho / rr^H v
+        double re1 = 0., im1 = 0.;
+        for( magma_int_t i=rb; i < re; i++ ){
+            double dot = MAGMA_D_ZERO;
+            for( magma_int_t j=row[i]; j < row[i+1]; j++ )
+                dot += val[ j ] * p[ col[j] ];
+            v[i] = dot;
+            tmp = MAGMA_D_CNJG( rr[i] ) * dot;
+            re1 += MAGMA_D_REAL( tmp );
+            im1 += MAGMA_D_IMAG( tmp );
+        }
+        mypart[0] = re1;
+        mypart[1] = im1;
+#ifdef _OPENMP
+        #pragma omp barrier
+#endif
+        double alpha = rho / MAGMA_D_MAKE( merge_sum( part, tot, 0 ),
+                                                       merge_sum( part, tot, 1 ));
+
+        // s = r - alpha v
+        for( magma_int_t i=rb; i < re; i++ )
+            s[i] = r[i] - alpha * v[i];
+#ifdef _OPENMP
+        #pragma omp barrier
+#endif
+
+        // t = A s, omega = t^H s / t^H t
+        double re2 = 0., im2 = 0., tt = 0.;
+        for( magma_int_t i=rb; i < re; i++ ){
+            double dot = MAGMA_D_ZERO;
+            for( magma_int_t j=row[i]; j < row[i+1]; j++ )
+                dot += val[ j ] * s[ col[j] ];
+            t[i] = dot;
+            tmp = MAGMA_D_CNJG( dot ) * s[i];
+            re2 += MAGMA_D_REAL( tmp );
+            im2 += MAGMA_D_IMAG( tmp );
+            tt += MAGMA_D_REAL( dot ) * MAGMA_D_REAL( dot )
+                + MAGMA_D_IMAG( dot ) * MAGMA_D_IMAG( dot );
+        }
+        mypart[2] = re2;
+        mypart[3] = im2;
+        mypart[4] = tt;
+#ifdef _OPENMP
+        #pragma omp barrier
+#endif
+        double omega = MAGMA_D_MAKE( merge_sum( part, tot, 2 ),
+                                                 merge_sum( part, tot, 3 ))
+                                   / merge_sum( part, tot, 4 );
+
+        // x = x + alpha p + omega s, r = s - omega t, rho = rr^H r, nom = r^H r
+        double re3 = 0., im3 = 0., nrm = 0.;
+        for( magma_int_t i=rb; i < re; i++ ){
+            x[i] += alpha * p[i] + omega * s[i];
+            double ri = s[i] - omega * t[i];
+            r[i] = ri;
+            tmp = MAGMA_D_CNJG( rr[i] ) * ri;
+            re3 += MAGMA_D_REAL( tmp );
+            im3 += MAGMA_D_IMAG( tmp );
+            nrm += MAGMA_D_REAL( ri ) * MAGMA_D_REAL( ri )
+                 + MAGMA_D_IMAG( ri ) * MAGMA_D_IMAG( ri );
+        }
+        mypart[5] = re3;
+        mypart[6] = im3;
+        mypart[7] = nrm;
+#ifdef _OPENMP
+        #pragma omp barrier
+#endif
+        if ( id == 0 ){
+            skp[0] = alpha;
+            skp[1] = beta;
+            skp[2] = omega;
+            skp[3] = rho;
+            skp[4] = MAGMA_D_MAKE( merge_sum( part, tot, 5 ),
+                                   merge_sum( part, tot, 6 ));
+            skp[5] = MAGMA_D_MAKE( merge_sum( part, tot, 7 ), 0. );
+        }
+    }
+
+    magma_free_cpu( part );
+    return MAGMA_SUCCESS;
+}
@@ -0,0 +1,513 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from zvector_cpu.cpp normal z -> d, Tue Sep  2 12:38:36 2014
+
+*/
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "common_magma.h"
+#include "magmasparse_types.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+
+
+// Vector kernels for the Krylov solvers on the CPU.
+// Where the GPU solvers call several BLAS-1 routines in a row on the same
+// vectors, these kernels do the updates in one pass and also return the
+// norm or dot product the solver needs next.
+// Vectors shorter than MAGMA_SPARSE_OMP_THRESHOLD are done by a single thread.
+
+
+/**
+    Purpose
+    -------
+
+    Returns x^H * y for vectors of length n on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           double*
+                input vector x
+
+    @param
+    y           double*
+                input vector y
+
+
+    @ingroup magmasparse_dblas
+    ********************************************************************/
+
+double
+magma_ddotc_cpu( magma_int_t n,
+                 const double *x,
+                 const double *y ){
+
+    double re = 0., im = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:re,im )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        double tmp = MAGMA_D_CNJG( x[i] ) * y[i];
+        re += MAGMA_D_REAL( tmp );
+        im += MAGMA_D_IMAG( tmp );
+    }
+    return MAGMA_D_MAKE( re, im );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes dots[0] = x^H * y and dots[1] = x^H * x in one pass
+    on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           double*
+                input vector x
+
+    @param
+    y           double*
+                input vector y
+
+    @param
+    dots        double*
+                array of length 2, the dot products
+
+
+    @ingroup magmasparse_dblas
+    ********************************************************************/
+
+magma_int_t
+magma_ddotc2_cpu( magma_int_t n,
+                  const double *x,
+                  const double *y,
+                  double *dots ){
+
+    double re = 0., im = 0., xx = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:re,im,xx )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        double tmp = MAGMA_D_CNJG( x[i] ) * y[i];
+        re += MAGMA_D_REAL( tmp );
+        im += MAGMA_D_IMAG( tmp );
+        xx += MAGMA_D_REAL( x[i] ) * MAGMA_D_REAL( x[i] )
+            + MAGMA_D_IMAG( x[i] ) * MAGMA_D_IMAG( x[i] );
+    }
+    dots[0] = MAGMA_D_MAKE( re, im );
+    dots[1] = MAGMA_D_MAKE( xx, 0. );
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Returns the Euclidean norm of x on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           double*
+                input vector x
+
+
+    @ingroup magmasparse_dblas
+    ********************************************************************/
+
+double
+magma_dnrm2_cpu( magma_int_t n,
+                  const double *x ){
+
+    // Each thread takes the norm of its part with BLAS, which scales to avoid
+    // overflow and underflow. The parts are combined as in LAPACK's dlassq:
+    // norm = scale * sqrt( ssq ), where scale is the largest part so far.
+    // A NaN part would fail both comparisons and be dropped, so it is
+    // stored in scale instead, making the norm NaN.
+    double scale = 0., ssq = 1.;
+#ifdef _OPENMP
+    #pragma omp parallel if( n >= MAGMA_SPARSE_OMP_THRESHOLD )
+#endif
+    {
+        magma_int_t id = 0, tot = 1;
+#ifdef _OPENMP
+        id  = omp_get_thread_num();
+        tot = omp_get_num_threads();
+#endif
+        magma_int_t ib = (magma_int_t) (((size_t) n * id) / tot);
+        magma_int_t ie = (magma_int_t) (((size_t) n * (id+1)) / tot);
+        double part = magma_cblas_dnrm2( ie - ib, x + ib, 1 );
+#ifdef _OPENMP
+        #pragma omp critical
+#endif
+        {
+            if( part != part ){
+                scale = part;
+            }
+            else if( part > scale ){
+                ssq   = 1. + ssq * (scale/part) * (scale/part);
+                scale = part;
+            }
+            else if( part > 0. ){
+                ssq  += (part/scale) * (part/scale);
+            }
+        }
+    }
+    return scale * sqrt( ssq );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes y = alpha * x + beta * y on the CPU.
+    If beta is zero, y is not read, so this also copies and scales x.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       double
+                scalar multiplier
+
+    @param
+    x           double*
+                input vector x
+
+    @param
+    beta        double
+                scalar multiplier
+
+    @param
+    y           double*
+                input/output vector y
+
+
+    @ingroup magmasparse_dblas
+    ********************************************************************/
+
+magma_int_t
+magma_daxpby_cpu( magma_int_t n,
+                  double alpha,
+                  const double *x,
+                  double beta,
+                  double *y ){
+
+    if( MAGMA_D_EQUAL( beta, MAGMA_D_ZERO )){
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            y[i] = alpha * x[i];
+    }
+    else{
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            y[i] = alpha * x[i] + beta * y[i];
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes z = alpha * x + beta * y + gamma * z on the CPU.
+    If gamma is zero, z is not read.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       double
+                scalar multiplier
+
+    @param
+    x           double*
+                input vector x
+
+    @param
+    beta        double
+                scalar multiplier
+
+    @param
+    y           double*
+                input vector y
+
+    @param
+    gamma       double
+                scalar multiplier
+
+    @param
+    z           double*
+                input/output vector z
+
+
+    @ingroup magmasparse_dblas
+    ********************************************************************/
+
+magma_int_t
+magma_daxpbypcz_cpu( magma_int_t n,
+                     double alpha,
+                     const double *x,
+                     double beta,
+                     const double *y,
+                     double gamma,
+                     double *z ){
+
+    if( MAGMA_D_EQUAL( gamma, MAGMA_D_ZERO )){
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            z[i] = alpha * x[i] + beta * y[i];
+    }
+    else{
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            z[i] = alpha * x[i] + beta * y[i] + gamma * z[i];
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the solution and residual update of CG on the CPU,
+        x = x + alpha * p
+        r = r - alpha * q,
+    and returns r^H * r.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       double
+                step length
+
+    @param
+    p           double*
+                search direction
+
+    @param
+    q           double*
+                A times the search direction
+
+    @param
+    x           double*
+                input/output solution approximation
+
+    @param
+    r           double*
+                input/output residual
+
+
+    @ingroup magmasparse_dblas
+    ********************************************************************/
+
+double
+magma_dcgupdate_cpu( magma_int_t n,
+                     double alpha,
+                     const double *p,
+                     const double *q,
+                     double *x,
+                     double *r ){
+
+    double nrm = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:nrm )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        x[i] += alpha * p[i];
+        double ri = r[i] - alpha * q[i];
+        r[i] = ri;
+        nrm += MAGMA_D_REAL( ri ) * MAGMA_D_REAL( ri )
+             + MAGMA_D_IMAG( ri ) * MAGMA_D_IMAG( ri );
+    }
+    return nrm;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the solution and residual update of BiCGSTAB on the CPU,
+        x = x + alpha * y + omega * z
+        r = s - omega * t,
+    sets rho = rr^H * r for the next iteration, and returns r^H * r.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       double
+                scalar multiplier
+
+    @param
+    omega       double
+                scalar multiplier
+
+    @param
+    y           double*
+                (preconditioned) search direction
+
+    @param
+    z           double*
+                (preconditioned) intermediate residual
+
+    @param
+    s           double*
+                intermediate residual
+
+    @param
+    t           double*
+                A times z
+
+    @param
+    rr          double*
+                shadow residual
+
+    @param
+    x           double*
+                input/output solution approximation
+
+    @param
+    r           double*
+                output residual
+
+    @param
+    rho         double*
+                output rr^H * r
+
+
+    @ingroup magmasparse_dblas
+    ********************************************************************/
+
+double
+magma_dbicgupdate_cpu( magma_int_t n,
+                       double alpha,
+                       double omega,
+                       const double *y,
+                       const double *z,
+                       const double *s,
+                       const double *t,
+                       const double *rr,
+                       double *x,
+                       double *r,
+                       double *rho ){
+
+    double nrm = 0., re = 0., im = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:nrm,re,im )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        x[i] += alpha * y[i] + omega * z[i];
+        double ri = s[i] - omega * t[i];
+        r[i] = ri;
+        double tmp = MAGMA_D_CNJG( rr[i] ) * ri;
+        re += MAGMA_D_REAL( tmp );
+        im += MAGMA_D_IMAG( tmp );
+        nrm += MAGMA_D_REAL( ri ) * MAGMA_D_REAL( ri )
+             + MAGMA_D_IMAG( ri ) * MAGMA_D_IMAG( ri );
+    }
+    *rho = MAGMA_D_MAKE( re, im );
+    return nrm;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes x = d .* b on the CPU, i.e., applies the Jacobi
+    preconditioner with the inverse diagonal d.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    d           double*
+                inverse diagonal of A
+
+    @param
+    b           double*
+                input vector b
+
+    @param
+    x           double*
+                output vector x
+
+
+    @ingroup magmasparse_dblas
+    ********************************************************************/
+
+magma_int_t
+magma_djacobi_diagscal_cpu( magma_int_t n,
+                            const double *d,
+                            const double *b,
+                            double *x ){
+
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+    for( magma_int_t i=0; i < n; i++ )
+        x[i] = d[i] * b[i];
+    return MAGMA_SUCCESS;
+}
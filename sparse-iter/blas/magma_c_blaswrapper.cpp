@@ -40,7 +40,9 @@
 
     @param
     x           magma_c_vector
-                input vector x  
+                input vector x; for num_vecs vectors, x.num_rows must be
+                num_vecs * A.num_cols, else MAGMA_ERR_ILLEGAL_VALUE
+                is returned
                 
     @param
     beta        magmaFloatComplex
@@ -66,6 +68,10 @@ magma_c_spmv(   magmaFloatComplex alpha, magma_c_sparse_matrix A,
 
     // DEV case
     if( A.memory_location == Magma_DEV ){
+        if( A.storage_type == Magma_STENCIL ){
+            printf("error: format not supported.\n");
+            return MAGMA_ERR_NOT_SUPPORTED;
+        }
         if( A.num_cols == x.num_rows ){
              if( A.storage_type == Magma_CSR 
                             || A.storage_type == Magma_CSRL 
@@ -165,6 +171,10 @@ magma_c_spmv(   magmaFloatComplex alpha, magma_c_sparse_matrix A,
              }
         }
         else if( A.num_cols < x.num_rows ){
+            if( x.num_rows % A.num_cols != 0 ){
+                printf("error: vector length is not a multiple of the columns.\n");
+                return MAGMA_ERR_ILLEGAL_VALUE;
+            }
             magma_int_t num_vecs = x.num_rows / A.num_cols;
             if( A.storage_type == Magma_CSR ){
                  //printf("using CSR kernel for SpMV: ");
@@ -212,10 +222,60 @@ magma_c_spmv(   magmaFloatComplex alpha, magma_c_sparse_matrix A,
          
          
     }
-    // CPU case missing!     
+    // CPU case
     else{
-        printf("error: CPU not yet supported.\n");
-        return MAGMA_ERR_NOT_SUPPORTED;
+        if( A.num_cols > x.num_rows || A.num_cols == 0 ){
+            printf("error: vector length does not match the matrix.\n");
+            return MAGMA_ERR_NOT_SUPPORTED;
+        }
+        if( x.num_rows % A.num_cols != 0 ){
+            printf("error: vector length is not a multiple of the columns.\n");
+            return MAGMA_ERR_ILLEGAL_VALUE;
+        }
+        magma_int_t num_vecs = x.num_rows / A.num_cols;
+        if( A.storage_type == Magma_CSR 
+                        || A.storage_type == Magma_CSRL 
+                        || A.storage_type == Magma_CSRU ){
+            magma_cgecsrmv_cpu( MagmaNoTrans, A.num_rows, A.num_cols, 
+                num_vecs, alpha, A.val, A.row, A.col, x.val, beta, y.val );
+            return MAGMA_SUCCESS;
+        }
+        else if( A.storage_type == Magma_ELLPACK ){
+            magma_cgeellmv_cpu( MagmaNoTrans, A.num_rows, A.num_cols, 
+                num_vecs, A.max_nnz_row, alpha, A.val, A.col, 
+                x.val, beta, y.val );
+            return MAGMA_SUCCESS;
+        }
+        else if( A.storage_type == Magma_ELL ){
+            magma_cgeelltmv_cpu( MagmaNoTrans, A.num_rows, A.num_cols, 
+                num_vecs, A.max_nnz_row, alpha, A.val, A.col, 
+                x.val, beta, y.val );
+            return MAGMA_SUCCESS;
+        }
+        else if( A.storage_type == Magma_SELLC 
+                        || A.storage_type == Magma_SELLP ){
+            magma_cgesellpmv_cpu( MagmaNoTrans, A.num_rows, A.num_cols, 
+                num_vecs, A.blocksize, A.numblocks, A.alignment, 
+                alpha, A.val, A.col, A.row, x.val, beta, y.val );
+            return MAGMA_SUCCESS;
+        }
+        else if( A.storage_type == Magma_STENCIL ){
+            magma_cgestencilmv_cpu( MagmaNoTrans, A.row[0], A.row[1], A.row[2],
+                num_vecs, A.max_nnz_row, alpha, A.val, A.col, 
+                x.val, beta, y.val );
+            return MAGMA_SUCCESS;
+        }
+        else if( A.storage_type == Magma_DENSE && num_vecs == 1 ){
+            // A is stored row by row, i.e., A^T column by column
+            magma_int_t ione = 1;
+            blasf77_cgemv( MagmaTransStr, &A.num_cols, &A.num_rows, &alpha, 
+                           A.val, &A.num_cols, x.val, &ione, &beta, y.val, &ione );
+            return MAGMA_SUCCESS;
+        }
+        else {
+            printf("error: format not supported.\n");
+            return MAGMA_ERR_NOT_SUPPORTED;
+        }
     }
     return MAGMA_SUCCESS;
 }
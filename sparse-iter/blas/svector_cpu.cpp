@@ -0,0 +1,513 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from zvector_cpu.cpp normal z -> s, Tue Sep  2 12:38:36 2014
+
+*/
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "common_magma.h"
+#include "magmasparse_types.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+
+
+// Vector kernels for the Krylov solvers on the CPU.
+// Where the GPU solvers call several BLAS-1 routines in a row on the same
+// vectors, these kernels do the updates in one pass and also return the
+// norm or dot product the solver needs next.
+// Vectors shorter than MAGMA_SPARSE_OMP_THRESHOLD are done by a single thread.
+
+
+/**
+    Purpose
+    -------
+
+    Returns x^H * y for vectors of length n on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           float*
+                input vector x
+
+    @param
+    y           float*
+                input vector y
+
+
+    @ingroup magmasparse_sblas
+    ********************************************************************/
+
+float
+magma_sdotc_cpu( magma_int_t n,
+                 const float *x,
+                 const float *y ){
+
+    float re = 0., im = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:re,im )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        float tmp = MAGMA_S_CNJG( x[i] ) * y[i];
+        re += MAGMA_S_REAL( tmp );
+        im += MAGMA_S_IMAG( tmp );
+    }
+    return MAGMA_S_MAKE( re, im );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes dots[0] = x^H * y and dots[1] = x^H * x in one pass
+    on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           float*
+                input vector x
+
+    @param
+    y           float*
+                input vector y
+
+    @param
+    dots        float*
+                array of length 2, the dot products
+
+
+    @ingroup magmasparse_sblas
+    ********************************************************************/
+
+magma_int_t
+magma_sdotc2_cpu( magma_int_t n,
+                  const float *x,
+                  const float *y,
+                  float *dots ){
+
+    float re = 0., im = 0., xx = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:re,im,xx )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        float tmp = MAGMA_S_CNJG( x[i] ) * y[i];
+        re += MAGMA_S_REAL( tmp );
+        im += MAGMA_S_IMAG( tmp );
+        xx += MAGMA_S_REAL( x[i] ) * MAGMA_S_REAL( x[i] )
+            + MAGMA_S_IMAG( x[i] ) * MAGMA_S_IMAG( x[i] );
+    }
+    dots[0] = MAGMA_S_MAKE( re, im );
+    dots[1] = MAGMA_S_MAKE( xx, 0. );
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Returns the Euclidean norm of x on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           float*
+                input vector x
+
+
+    @ingroup magmasparse_sblas
+    ********************************************************************/
+
+float
+magma_snrm2_cpu( magma_int_t n,
+                  const float *x ){
+
+    // Each thread takes the norm of its part with BLAS, which scales to avoid
+    // overflow and underflow. The parts are combined as in LAPACK's dlassq:
+    // norm = scale * sqrt( ssq ), where scale is the largest part so far.
+    // A NaN part would fail both comparisons and be dropped, so it is
+    // stored in scale instead, making the norm NaN.
+    float scale = 0., ssq = 1.;
+#ifdef _OPENMP
+    #pragma omp parallel if( n >= MAGMA_SPARSE_OMP_THRESHOLD )
+#endif
+    {
+        magma_int_t id = 0, tot = 1;
+#ifdef _OPENMP
+        id  = omp_get_thread_num();
+        tot = omp_get_num_threads();
+#endif
+        magma_int_t ib = (magma_int_t) (((size_t) n * id) / tot);
+        magma_int_t ie = (magma_int_t) (((size_t) n * (id+1)) / tot);
+        float part = magma_cblas_snrm2( ie - ib, x + ib, 1 );
+#ifdef _OPENMP
+        #pragma omp critical
+#endif
+        {
+            if( part != part ){
+                scale = part;
+            }
+            else if( part > scale ){
+                ssq   = 1. + ssq * (scale/part) * (scale/part);
+                scale = part;
+            }
+            else if( part > 0. ){
+                ssq  += (part/scale) * (part/scale);
+            }
+        }
+    }
+    return scale * sqrt( ssq );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes y = alpha * x + beta * y on the CPU.
+    If beta is zero, y is not read, so this also copies and scales x.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       float
+                scalar multiplier
+
+    @param
+    x           float*
+                input vector x
+
+    @param
+    beta        float
+                scalar multiplier
+
+    @param
+    y           float*
+                input/output vector y
+
+
+    @ingroup magmasparse_sblas
+    ********************************************************************/
+
+magma_int_t
+magma_saxpby_cpu( magma_int_t n,
+                  float alpha,
+                  const float *x,
+                  float beta,
+                  float *y ){
+
+    if( MAGMA_S_EQUAL( beta, MAGMA_S_ZERO )){
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            y[i] = alpha * x[i];
+    }
+    else{
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            y[i] = alpha * x[i] + beta * y[i];
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes z = alpha * x + beta * y + gamma * z on the CPU.
+    If gamma is zero, z is not read.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       float
+                scalar multiplier
+
+    @param
+    x           float*
+                input vector x
+
+    @param
+    beta        float
+                scalar multiplier
+
+    @param
+    y           float*
+                input vector y
+
+    @param
+    gamma       float
+                scalar multiplier
+
+    @param
+    z           float*
+                input/output vector z
+
+
+    @ingroup magmasparse_sblas
+    ********************************************************************/
+
+magma_int_t
+magma_saxpbypcz_cpu( magma_int_t n,
+                     float alpha,
+                     const float *x,
+                     float beta,
+                     const float *y,
+                     float gamma,
+                     float *z ){
+
+    if( MAGMA_S_EQUAL( gamma, MAGMA_S_ZERO )){
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            z[i] = alpha * x[i] + beta * y[i];
+    }
+    else{
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            z[i] = alpha * x[i] + beta * y[i] + gamma * z[i];
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the solution and residual update of CG on the CPU,
+        x = x + alpha * p
+        r = r - alpha * q,
+    and returns r^H * r.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       float
+                step length
+
+    @param
+    p           float*
+                search direction
+
+    @param
+    q           float*
+                A times the search direction
+
+    @param
+    x           float*
+                input/output solution approximation
+
+    @param
+    r           float*
+                input/output residual
+
+
+    @ingroup magmasparse_sblas
+    ********************************************************************/
+
+float
+magma_scgupdate_cpu( magma_int_t n,
+                     float alpha,
+                     const float *p,
+                     const float *q,
+                     float *x,
+                     float *r ){
+
+    float nrm = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:nrm )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        x[i] += alpha * p[i];
+        float ri = r[i] - alpha * q[i];
+        r[i] = ri;
+        nrm += MAGMA_S_REAL( ri ) * MAGMA_S_REAL( ri )
+             + MAGMA_S_IMAG( ri ) * MAGMA_S_IMAG( ri );
+    }
+    return nrm;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the solution and residual update of BiCGSTAB on the CPU,
+        x = x + alpha * y + omega * z
+        r = s - omega * t,
+    sets rho = rr^H * r for the next iteration, and returns r^H * r.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       float
+                scalar multiplier
+
+    @param
+    omega       float
+                scalar multiplier
+
+    @param
+    y           float*
+                (preconditioned) search direction
+
+    @param
+    z           float*
+                (preconditioned) intermediate residual
+
+    @param
+    s           float*
+                intermediate residual
+
+    @param
+    t           float*
+                A times z
+
+    @param
+    rr          float*
+                shadow residual
+
+    @param
+    x           float*
+                input/output solution approximation
+
+    @param
+    r           float*
+                output residual
+
+    @param
+    rho         float*
+                output rr^H * r
+
+
+    @ingroup magmasparse_sblas
+    ********************************************************************/
+
+float
+magma_sbicgupdate_cpu( magma_int_t n,
+                       float alpha,
+                       float omega,
+                       const float *y,
+                       const float *z,
+                       const float *s,
+                       const float *t,
+                       const float *rr,
+                       float *x,
+                       float *r,
+                       float *rho ){
+
+    float nrm = 0., re = 0., im = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:nrm,re,im )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        x[i] += alpha * y[i] + omega * z[i];
+        float ri = s[i] - omega * t[i];
+        r[i] = ri;
+        float tmp = MAGMA_S_CNJG( rr[i] ) * ri;
+        re += MAGMA_S_REAL( tmp );
+        im += MAGMA_S_IMAG( tmp );
+        nrm += MAGMA_S_REAL( ri ) * MAGMA_S_REAL( ri )
+             + MAGMA_S_IMAG( ri ) * MAGMA_S_IMAG( ri );
+    }
+    *rho = MAGMA_S_MAKE( re, im );
+    return nrm;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes x = d .* b on the CPU, i.e., applies the Jacobi
+    preconditioner with the inverse diagonal d.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    d           float*
+                inverse diagonal of A
+
+    @param
+    b           float*
+                input vector b
+
+    @param
+    x           float*
+                output vector x
+
+
+    @ingroup magmasparse_sblas
+    ********************************************************************/
+
+magma_int_t
+magma_sjacobi_diagscal_cpu( magma_int_t n,
+                            const float *d,
+                            const float *b,
+                            float *x ){
+
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+    for( magma_int_t i=0; i < n; i++ )
+        x[i] = d[i] * b[i];
+    return MAGMA_SUCCESS;
+}
@@ -0,0 +1,513 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @precisions normal z -> c d s
+
+*/
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "common_magma.h"
+#include "magmasparse_types.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+
+
+// Vector kernels for the Krylov solvers on the CPU.
+// Where the GPU solvers call several BLAS-1 routines in a row on the same
+// vectors, these kernels do the updates in one pass and also return the
+// norm or dot product the solver needs next.
+// Vectors shorter than MAGMA_SPARSE_OMP_THRESHOLD are done by a single thread.
+
+
+/**
+    Purpose
+    -------
+
+    Returns x^H * y for vectors of length n on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           magmaDoubleComplex*
+                input vector x
+
+    @param
+    y           magmaDoubleComplex*
+                input vector y
+
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+magmaDoubleComplex
+magma_zdotc_cpu( magma_int_t n,
+                 const magmaDoubleComplex *x,
+                 const magmaDoubleComplex *y ){
+
+    double re = 0., im = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:re,im )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        magmaDoubleComplex tmp = MAGMA_Z_CNJG( x[i] ) * y[i];
+        re += MAGMA_Z_REAL( tmp );
+        im += MAGMA_Z_IMAG( tmp );
+    }
+    return MAGMA_Z_MAKE( re, im );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes dots[0] = x^H * y and dots[1] = x^H * x in one pass
+    on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           magmaDoubleComplex*
+                input vector x
+
+    @param
+    y           magmaDoubleComplex*
+                input vector y
+
+    @param
+    dots        magmaDoubleComplex*
+                array of length 2, the dot products
+
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+magma_int_t
+magma_zdotc2_cpu( magma_int_t n,
+                  const magmaDoubleComplex *x,
+                  const magmaDoubleComplex *y,
+                  magmaDoubleComplex *dots ){
+
+    double re = 0., im = 0., xx = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:re,im,xx )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        magmaDoubleComplex tmp = MAGMA_Z_CNJG( x[i] ) * y[i];
+        re += MAGMA_Z_REAL( tmp );
+        im += MAGMA_Z_IMAG( tmp );
+        xx += MAGMA_Z_REAL( x[i] ) * MAGMA_Z_REAL( x[i] )
+            + MAGMA_Z_IMAG( x[i] ) * MAGMA_Z_IMAG( x[i] );
+    }
+    dots[0] = MAGMA_Z_MAKE( re, im );
+    dots[1] = MAGMA_Z_MAKE( xx, 0. );
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Returns the Euclidean norm of x on the CPU.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    x           magmaDoubleComplex*
+                input vector x
+
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+double
+magma_dznrm2_cpu( magma_int_t n,
+                  const magmaDoubleComplex *x ){
+
+    // Each thread takes the norm of its part with BLAS, which scales to avoid
+    // overflow and underflow. The parts are combined as in LAPACK's dlassq:
+    // norm = scale * sqrt( ssq ), where scale is the largest part so far.
+    // A NaN part would fail both comparisons and be dropped, so it is
+    // stored in scale instead, making the norm NaN.
+    double scale = 0., ssq = 1.;
+#ifdef _OPENMP
+    #pragma omp parallel if( n >= MAGMA_SPARSE_OMP_THRESHOLD )
+#endif
+    {
+        magma_int_t id = 0, tot = 1;
+#ifdef _OPENMP
+        id  = omp_get_thread_num();
+        tot = omp_get_num_threads();
+#endif
+        magma_int_t ib = (magma_int_t) (((size_t) n * id) / tot);
+        magma_int_t ie = (magma_int_t) (((size_t) n * (id+1)) / tot);
+        double part = magma_cblas_dznrm2( ie - ib, x + ib, 1 );
+#ifdef _OPENMP
+        #pragma omp critical
+#endif
+        {
+            if( part != part ){
+                scale = part;
+            }
+            else if( part > scale ){
+                ssq   = 1. + ssq * (scale/part) * (scale/part);
+                scale = part;
+            }
+            else if( part > 0. ){
+                ssq  += (part/scale) * (part/scale);
+            }
+        }
+    }
+    return scale * sqrt( ssq );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes y = alpha * x + beta * y on the CPU.
+    If beta is zero, y is not read, so this also copies and scales x.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       magmaDoubleComplex
+                scalar multiplier
+
+    @param
+    x           magmaDoubleComplex*
+                input vector x
+
+    @param
+    beta        magmaDoubleComplex
+                scalar multiplier
+
+    @param
+    y           magmaDoubleComplex*
+                input/output vector y
+
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+magma_int_t
+magma_zaxpby_cpu( magma_int_t n,
+                  magmaDoubleComplex alpha,
+                  const magmaDoubleComplex *x,
+                  magmaDoubleComplex beta,
+                  magmaDoubleComplex *y ){
+
+    if( MAGMA_Z_EQUAL( beta, MAGMA_Z_ZERO )){
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            y[i] = alpha * x[i];
+    }
+    else{
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            y[i] = alpha * x[i] + beta * y[i];
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes z = alpha * x + beta * y + gamma * z on the CPU.
+    If gamma is zero, z is not read.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       magmaDoubleComplex
+                scalar multiplier
+
+    @param
+    x           magmaDoubleComplex*
+                input vector x
+
+    @param
+    beta        magmaDoubleComplex
+                scalar multiplier
+
+    @param
+    y           magmaDoubleComplex*
+                input vector y
+
+    @param
+    gamma       magmaDoubleComplex
+                scalar multiplier
+
+    @param
+    z           magmaDoubleComplex*
+                input/output vector z
+
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+magma_int_t
+magma_zaxpbypcz_cpu( magma_int_t n,
+                     magmaDoubleComplex alpha,
+                     const magmaDoubleComplex *x,
+                     magmaDoubleComplex beta,
+                     const magmaDoubleComplex *y,
+                     magmaDoubleComplex gamma,
+                     magmaDoubleComplex *z ){
+
+    if( MAGMA_Z_EQUAL( gamma, MAGMA_Z_ZERO )){
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            z[i] = alpha * x[i] + beta * y[i];
+    }
+    else{
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( magma_int_t i=0; i < n; i++ )
+            z[i] = alpha * x[i] + beta * y[i] + gamma * z[i];
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the solution and residual update of CG on the CPU,
+        x = x + alpha * p
+        r = r - alpha * q,
+    and returns r^H * r.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       magmaDoubleComplex
+                step length
+
+    @param
+    p           magmaDoubleComplex*
+                search direction
+
+    @param
+    q           magmaDoubleComplex*
+                A times the search direction
+
+    @param
+    x           magmaDoubleComplex*
+                input/output solution approximation
+
+    @param
+    r           magmaDoubleComplex*
+                input/output residual
+
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+double
+magma_zcgupdate_cpu( magma_int_t n,
+                     magmaDoubleComplex alpha,
+                     const magmaDoubleComplex *p,
+                     const magmaDoubleComplex *q,
+                     magmaDoubleComplex *x,
+                     magmaDoubleComplex *r ){
+
+    double nrm = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:nrm )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        x[i] += alpha * p[i];
+        magmaDoubleComplex ri = r[i] - alpha * q[i];
+        r[i] = ri;
+        nrm += MAGMA_Z_REAL( ri ) * MAGMA_Z_REAL( ri )
+             + MAGMA_Z_IMAG( ri ) * MAGMA_Z_IMAG( ri );
+    }
+    return nrm;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the solution and residual update of BiCGSTAB on the CPU,
+        x = x + alpha * y + omega * z
+        r = s - omega * t,
+    sets rho = rr^H * r for the next iteration, and returns r^H * r.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    alpha       magmaDoubleComplex
+                scalar multiplier
+
+    @param
+    omega       magmaDoubleComplex
+                scalar multiplier
+
+    @param
+    y           magmaDoubleComplex*
+                (preconditioned) search direction
+
+    @param
+    z           magmaDoubleComplex*
+                (preconditioned) intermediate residual
+
+    @param
+    s           magmaDoubleComplex*
+                intermediate residual
+
+    @param
+    t           magmaDoubleComplex*
+                A times z
+
+    @param
+    rr          magmaDoubleComplex*
+                shadow residual
+
+    @param
+    x           magmaDoubleComplex*
+                input/output solution approximation
+
+    @param
+    r           magmaDoubleComplex*
+                output residual
+
+    @param
+    rho         magmaDoubleComplex*
+                output rr^H * r
+
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+double
+magma_zbicgupdate_cpu( magma_int_t n,
+                       magmaDoubleComplex alpha,
+                       magmaDoubleComplex omega,
+                       const magmaDoubleComplex *y,
+                       const magmaDoubleComplex *z,
+                       const magmaDoubleComplex *s,
+                       const magmaDoubleComplex *t,
+                       const magmaDoubleComplex *rr,
+                       magmaDoubleComplex *x,
+                       magmaDoubleComplex *r,
+                       magmaDoubleComplex *rho ){
+
+    double nrm = 0., re = 0., im = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:nrm,re,im )
+#endif
+    for( magma_int_t i=0; i < n; i++ ){
+        x[i] += alpha * y[i] + omega * z[i];
+        magmaDoubleComplex ri = s[i] - omega * t[i];
+        r[i] = ri;
+        magmaDoubleComplex tmp = MAGMA_Z_CNJG( rr[i] ) * ri;
+        re += MAGMA_Z_REAL( tmp );
+        im += MAGMA_Z_IMAG( tmp );
+        nrm += MAGMA_Z_REAL( ri ) * MAGMA_Z_REAL( ri )
+             + MAGMA_Z_IMAG( ri ) * MAGMA_Z_IMAG( ri );
+    }
+    *rho = MAGMA_Z_MAKE( re, im );
+    return nrm;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes x = d .* b on the CPU, i.e., applies the Jacobi
+    preconditioner with the inverse diagonal d.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                vector length
+
+    @param
+    d           magmaDoubleComplex*
+                inverse diagonal of A
+
+    @param
+    b           magmaDoubleComplex*
+                input vector b
+
+    @param
+    x           magmaDoubleComplex*
+                output vector x
+
+
+    @ingroup magmasparse_zblas
+    ********************************************************************/
+
+magma_int_t
+magma_zjacobi_diagscal_cpu( magma_int_t n,
+                            const magmaDoubleComplex *d,
+                            const magmaDoubleComplex *b,
+                            magmaDoubleComplex *x ){
+
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+    for( magma_int_t i=0; i < n; i++ )
+        x[i] = d[i] * b[i];
+    return MAGMA_SUCCESS;
+}
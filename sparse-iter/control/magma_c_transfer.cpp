@@ -62,6 +62,14 @@ magma_c_mtransfer( magma_c_sparse_matrix A,
                    magma_location_t src,
                    magma_location_t dst){
     magma_int_t stat;
+    B->sym = A.sym;
+
+    // the matrix-free stencil lives on the CPU only
+    if( A.storage_type == Magma_STENCIL
+            && ( src == Magma_DEV || dst == Magma_DEV )){
+        printf("error: Magma_STENCIL matrices cannot be transferred to the device.\n");
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
 
     // first case: copy matrix from host to device
     if( src == Magma_CPU && dst == Magma_DEV ){
@@ -467,6 +475,32 @@ magma_c_mtransfer( magma_c_sparse_matrix A,
                 B->row[i] = A.row[i];
             }
         }
+        //STENCIL-type
+        if( A.storage_type == Magma_STENCIL ){
+            // fill in information for B
+            B->storage_type = A.storage_type;
+            B->diagorder_type = A.diagorder_type;
+            B->memory_location = Magma_CPU;
+            B->num_rows = A.num_rows;
+            B->num_cols = A.num_cols;
+            B->nnz = A.nnz;
+            B->max_nnz_row = A.max_nnz_row;
+            B->diameter = A.diameter;
+            // memory allocation
+            magma_cmalloc_cpu( &B->val, A.max_nnz_row );
+            magma_index_malloc_cpu( &B->col, 3*A.max_nnz_row );
+            magma_index_malloc_cpu( &B->row, 3 );
+            // data transfer
+            for( magma_int_t i=0; i<A.max_nnz_row; i++ ){
+                B->val[i] = A.val[i];
+            }
+            for( magma_int_t i=0; i<3*A.max_nnz_row; i++ ){
+                B->col[i] = A.col[i];
+            }
+            for( magma_int_t i=0; i<3; i++ ){
+                B->row[i] = A.row[i];
+            }
+        }
         //DENSE-type
         if( A.storage_type == Magma_DENSE ){
             // fill in information for B
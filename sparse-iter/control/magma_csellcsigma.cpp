@@ -0,0 +1,367 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from magma_zsellcsigma.cpp normal z -> c, Tue Sep  2 12:38:36 2014
+*/
+
+#include <algorithm>
+
+#include "magma_lapack.h"
+#include "common_magma.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// number of SpMVs timed for each candidate in magma_c_sellcsigma_tune,
+// of which the fastest counts
+#define SELL_TUNE_NREP 10
+
+
+// ---------------------------------------------
+// Orders the rows of each window of sigma rows by decreasing length,
+// keeping the order of rows with equal length: perm[i] is the row of A
+// that becomes row i.
+struct sell_longer {
+    const magma_index_t *row;
+    bool operator() ( magma_index_t a, magma_index_t b ) const {
+        return row[a+1] - row[a] > row[b+1] - row[b];
+    }
+};
+
+static void
+sell_sigma_order( magma_int_t n, const magma_index_t *row, magma_int_t sigma,
+                  magma_index_t *perm )
+{
+    magma_int_t i, windows = ( n + sigma - 1 ) / sigma;
+    sell_longer longer;
+    longer.row = row;
+    for( i=0; i < n; i++ )
+        perm[i] = i;
+    if( sigma <= 1 )
+        return;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+    for( i=0; i < windows; i++ ){
+        std::stable_sort( perm + i*sigma, perm + min( (i+1)*sigma, n ), longer );
+    }
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the number of entries stored for a CSR matrix A in SELL-C-sigma,
+    i.e., in SELL-P with slices of C rows padded to a multiple of alignment,
+    after sorting the rows by length within windows of sigma rows, as
+    magma_c_sellcsigma does. The ratio stored / A.nnz is the padding
+    overhead: the amount of memory and arithmetic of the SpMV relative to
+    CSR, without the row pointer.
+    No matrix is built, so this is cheap compared to the conversion.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_c_sparse_matrix
+                input matrix in CSR on the CPU
+
+    @param
+    C           magma_int_t
+                rows per slice
+
+    @param
+    sigma       magma_int_t
+                rows per sorting window, 1 for no sorting
+
+    @param
+    alignment   magma_int_t
+                the row length in each slice is padded to a multiple of it
+
+    @param
+    stored      magma_int_t*
+                number of stored entries including padding
+
+    @ingroup magmasparse_caux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_c_sellp_padding( magma_c_sparse_matrix A, magma_int_t C,
+                       magma_int_t sigma, magma_int_t alignment,
+                       magma_int_t *stored ){
+
+    if( A.storage_type != Magma_CSR || A.memory_location != Magma_CPU ){
+        printf("error: padding needs a CSR matrix on the CPU.\n");
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+    magma_int_t n = A.num_rows;
+    magma_int_t slices = ( n + C - 1 ) / C;
+    magma_int_t i, sum = 0;
+    magma_index_t *perm;
+    magma_index_malloc_cpu( &perm, n );
+    sell_sigma_order( n, A.row, sigma, perm );
+
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction(+:sum)
+#endif
+    for( i=0; i < slices; i++ ){
+        magma_int_t j, w = 0;
+        for( j=i*C; j < min( (i+1)*C, n ); j++ )
+            w = max( w, (magma_int_t) (A.row[perm[j]+1] - A.row[perm[j]]) );
+        sum += ( (w + alignment - 1) / alignment ) * alignment * C;
+    }
+    *stored = sum;
+
+    magma_free_cpu( perm );
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Converts a matrix A to SELL-C-sigma: the rows of each window of sigma
+    consecutive rows are sorted by decreasing length, so rows of similar
+    length share a slice and less padding is needed, and the result is
+    stored in SELL-P with the blocksize C and the alignment set in B on
+    input, as for magma_c_mconvert.
+
+    The sorting is applied as the symmetric permutation B = P A P^T of
+    magma_c_mpermute, so B is used as any other matrix, e.g. in the
+    solvers, with the right-hand side and solution permuted by
+    magma_c_vpermute: y = A x is P^T (B (P x)). Rows only move within
+    their window, so for sigma much smaller than the number of rows the
+    locality of the accesses to x is kept. sigma = 1 is plain SELL-P,
+    and only multiples of C larger than C reduce the padding.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_c_sparse_matrix
+                input matrix, square
+
+    @param
+    B           magma_c_sparse_matrix*
+                output matrix in SELLP on the CPU,
+                with blocksize and alignment set on input
+
+    @param
+    sigma       magma_int_t
+                rows per sorting window
+
+    @param
+    perm        magma_index_t**
+                permutation: row i of B is row perm[i] of A,
+                allocated with magma_index_malloc_cpu; NULL on failure
+
+    @ingroup magmasparse_caux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_c_sellcsigma( magma_c_sparse_matrix A, magma_c_sparse_matrix *B,
+                    magma_int_t sigma, magma_index_t **perm ){
+
+    if( A.num_rows != A.num_cols ){
+        printf("error: SELL-C-sigma needs a square matrix.\n");
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+    magma_int_t stat;
+    magma_c_sparse_matrix hA, CA, PA;
+    *perm = NULL;
+    if( A.memory_location != Magma_CPU ){
+        stat = magma_c_mtransfer( A, &hA, A.memory_location, Magma_CPU );
+        if( stat != MAGMA_SUCCESS )
+            return stat;
+    }
+    else
+        hA = A;
+    if( hA.storage_type != Magma_CSR ){
+        stat = magma_c_mconvert( hA, &CA, hA.storage_type, Magma_CSR );
+        if( stat != MAGMA_SUCCESS ){
+            if( A.memory_location != Magma_CPU )
+                magma_c_mfree( &hA );
+            return stat;
+        }
+    }
+    else
+        CA = hA;
+
+    stat = magma_index_malloc_cpu( perm, CA.num_rows );
+    if( stat == MAGMA_SUCCESS ){
+        sell_sigma_order( CA.num_rows, CA.row, sigma, *perm );
+        stat = magma_c_mpermute( CA, &PA, *perm );
+    }
+    if( stat == MAGMA_SUCCESS ){
+        stat = magma_c_mconvert( PA, B, Magma_CSR, Magma_SELLP );
+        magma_c_mfree( &PA );
+    }
+    if( stat != MAGMA_SUCCESS ){
+        magma_free_cpu( *perm );
+        *perm = NULL;
+    }
+
+    if( hA.storage_type != Magma_CSR )
+        magma_c_mfree( &CA );
+    if( A.memory_location != Magma_CPU )
+        magma_c_mfree( &hA );
+    return stat;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Chooses the slice size C and the sorting window sigma of SELL-C-sigma
+    for a matrix A by timing the host SpMV, and returns A in the best
+    format found. The candidates are C = 4, 8, 16, 32 and, for each C,
+    sigma = 1, 16 C, 256 C, and 4096 C, with the alignment set in B on input;
+    sigma = C would only reorder rows within their slice, which does not
+    change the padding.
+    Each candidate is converted with magma_c_sellcsigma and timed as the
+    fastest of SELL_TUNE_NREP SpMVs on the CPU; the matrix of the fastest
+    candidate is kept. Since the time is measured with the threads the
+    SpMV will use, the choice holds for this machine and thread count.
+    A candidate that fails to convert is skipped; if all fail, the error
+    of the last one is returned.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_c_sparse_matrix
+                input matrix, square
+
+    @param
+    B           magma_c_sparse_matrix*
+                output matrix in SELLP on the CPU, with the alignment
+                set on input; on output B->blocksize is the chosen C
+
+    @param
+    sigma       magma_int_t*
+                chosen sorting window
+
+    @param
+    perm        magma_index_t**
+                permutation of B as in magma_c_sellcsigma
+
+    @param
+    verbose     magma_int_t
+                if > 0, prints padding and SpMV time of each candidate
+
+    @ingroup magmasparse_caux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_c_sellcsigma_tune( magma_c_sparse_matrix A, magma_c_sparse_matrix *B,
+                         magma_int_t *sigma, magma_index_t **perm,
+                         magma_int_t verbose ){
+
+    magmaFloatComplex c_zero = MAGMA_C_ZERO, c_one = MAGMA_C_ONE;
+    magma_int_t alignment = max( B->alignment, (magma_int_t) 1 );
+    magma_int_t Cs[] = { 4, 8, 16, 32 };
+    magma_int_t windows[] = { 0, 16, 256, 4096 };   // sigma / C, 0 for no sorting
+    real_Double_t best = 0., t, tmin;
+    bool found = false;
+
+    if( A.num_rows != A.num_cols ){
+        printf("error: SELL-C-sigma needs a square matrix.\n");
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+    magma_int_t stat;
+    magma_c_sparse_matrix hA, CA, T;
+    if( A.memory_location != Magma_CPU ){
+        stat = magma_c_mtransfer( A, &hA, A.memory_location, Magma_CPU );
+        if( stat != MAGMA_SUCCESS )
+            return stat;
+    }
+    else
+        hA = A;
+    if( hA.storage_type != Magma_CSR ){
+        stat = magma_c_mconvert( hA, &CA, hA.storage_type, Magma_CSR );
+        if( stat != MAGMA_SUCCESS ){
+            if( A.memory_location != Magma_CPU )
+                magma_c_mfree( &hA );
+            return stat;
+        }
+    }
+    else
+        CA = hA;
+
+    magma_c_vector x, y;
+    magma_c_vinit( &x, Magma_CPU, CA.num_cols, c_one );
+    magma_c_vinit( &y, Magma_CPU, CA.num_rows, c_zero );
+
+    if( verbose > 0 ){
+        printf( "#     C    sigma   padding   SpMV (ms)\n" );
+    }
+    for( magma_int_t ic=0; ic < 4; ic++ ){
+        for( magma_int_t is=0; is < 4; is++ ){
+            magma_int_t C = Cs[ic];
+            magma_int_t s = max( windows[is]*C, (magma_int_t) 1 );
+            // windows beyond the matrix size all give the same order
+            if( is > 1 && windows[is-1]*C >= CA.num_rows )
+                continue;
+            magma_int_t stored;
+            magma_index_t *p;
+            stat = magma_c_sellp_padding( CA, C, s, alignment, &stored );
+            if( stat != MAGMA_SUCCESS )
+                continue;
+
+            T.blocksize = C;
+            T.alignment = alignment;
+            stat = magma_c_sellcsigma( CA, &T, s, &p );
+            if( stat != MAGMA_SUCCESS )
+                continue;
+            for( magma_int_t irep=0; irep < SELL_TUNE_NREP; irep++ ){
+                t = magma_wtime();
+                magma_c_spmv( c_one, T, x, c_zero, y );
+                t = magma_wtime() - t;
+                tmin = ( irep == 0 ? t : min( tmin, t ));
+            }
+            if( verbose > 0 ){
+                printf( "  %4d  %7d   %7.3f   %9.3f\n", (int) C, (int) s,
+                        (float) stored / max( CA.nnz, (magma_int_t) 1 ),
+                        tmin*1e3 );
+            }
+            if( !found || tmin < best ){
+                if( found ){
+                    magma_c_mfree( B );
+                    magma_free_cpu( *perm );
+                }
+                found = true;
+                best = tmin;
+                *B = T;
+                *perm = p;
+                *sigma = s;
+            }
+            else {
+                magma_c_mfree( &T );
+                magma_free_cpu( p );
+            }
+        }
+    }
+
+    magma_c_vfree( &x );
+    magma_c_vfree( &y );
+    if( hA.storage_type != Magma_CSR )
+        magma_c_mfree( &CA );
+    if( A.memory_location != Magma_CPU )
+        magma_c_mfree( &hA );
+    return ( found ? MAGMA_SUCCESS : stat );
+}
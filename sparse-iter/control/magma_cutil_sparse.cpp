@@ -43,10 +43,18 @@ const char *usage_sparse =
 "               2   SELL-P\n"
 " --blocksize x Set a specific blocksize for SELL-P format.\n"   
 " --alignment x Set a specific alignment for SELL-P format.\n"   
+" --location x  Possibility to choose where the solver runs:\n"
+"               0   GPU\n"
+"               1   CPU (CG, BiCGSTAB, GMRES and their preconditioned\n"
+"                   versions with Jacobi or ILU(0) / IC(0))\n"
 " --mscale      Possibility to scale the original matrix:\n"
 "               0   no scaling\n"
 "               1   symmetric scaling to unit diagonal\n"
 "               2   scaling tu unit row-norm\n"
+" --reorder     Possibility to reorder the rows and columns of the matrix:\n"
+"               0   no reordering\n"
+"               1   Reverse Cuthill-McKee\n"
+"               2   nested dissection\n"
 " --solver      Possibility to choose a solver:\n"
 "               0   CG\n"
 "               1   merged CG\n"
@@ -95,8 +103,9 @@ magma_cparse_opts( int argc, char** argv, magma_copts *opts, int *matrices )
     opts->alignment = 8;
     opts->output_format = Magma_CSR;
     opts->input_location = Magma_CPU;
-    opts->output_location = Magma_CPU;
+    opts->output_location = Magma_DEV;
     opts->scaling = Magma_NOSCALE;
+    opts->reordering = Magma_NOREORDER;
     opts->solver_par.epsilon = 10e-16;
     opts->solver_par.maxiter = 1000;
     opts->solver_par.verbose = 0;
@@ -135,6 +144,13 @@ magma_cparse_opts( int argc, char** argv, magma_copts *opts, int *matrices )
                 case 2: opts->scaling = Magma_UNITROW; break;
             }
 
+        }else if ( strcmp("--reorder", argv[i]) == 0 ) {
+            info = atoi( argv[++i] );
+            switch( info ) {
+                case 0: opts->reordering = Magma_NOREORDER; break;
+                case 1: opts->reordering = Magma_RCM; break;
+                case 2: opts->reordering = Magma_ND; break;
+            }
         }else if ( strcmp("--solver", argv[i]) == 0 ) {
             info = atoi( argv[++i] );
             switch( info ) {
@@ -171,6 +187,12 @@ magma_cparse_opts( int argc, char** argv, magma_copts *opts, int *matrices )
             opts->blocksize = atoi( argv[++i] );
         }else if ( strcmp("--alignment", argv[i]) == 0 ) {
             opts->alignment = atoi( argv[++i] );
+        }else if ( strcmp("--location", argv[i]) == 0 ) {
+            info = atoi( argv[++i] );
+            switch( info ) {
+                case 0: opts->output_location = Magma_DEV; break;
+                case 1: opts->output_location = Magma_CPU; break;
+            }
         }else if ( strcmp("--verbose", argv[i]) == 0 ) {
             opts->solver_par.verbose = atoi( argv[++i] );
         }  else if ( strcmp("--maxiter", argv[i]) == 0 ) {
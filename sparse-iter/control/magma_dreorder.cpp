@@ -0,0 +1,631 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from magma_zreorder.cpp normal z -> d, Tue Sep  2 12:38:36 2014
+*/
+
+#include <vector>
+#include <algorithm>
+
+#include "magma_lapack.h"
+#include "common_magma.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// parts of at most this many vertices are not dissected further
+#define REORDER_ND_LEAF 128
+
+
+// ---------------------------------------------
+// Graph of the symmetric pattern of A + A^T without the diagonal:
+// the neighbours of vertex i are adj[ xadj[i] .. xadj[i+1]-1 ], sorted and
+// unique. A is n x n CSR on the CPU; xadj and adj are allocated here.
+static void
+reorder_graph( magma_d_sparse_matrix A, magma_index_t **xadj, magma_index_t **adj )
+{
+    magma_int_t n = A.num_rows;
+    magma_index_t i, j, c, k, *pos;
+
+    magma_index_malloc_cpu( xadj, n+1 );
+    magma_index_malloc_cpu( &pos, n );
+    for( i=0; i <= n; i++ )
+        (*xadj)[i] = 0;
+    for( i=0; i < n; i++ ){
+        for( j=A.row[i]; j < A.row[i+1]; j++ ){
+            c = A.col[j];
+            if( c != i ){
+                (*xadj)[i+1]++;
+                (*xadj)[c+1]++;
+            }
+        }
+    }
+    for( i=0; i < n; i++ ){
+        (*xadj)[i+1] += (*xadj)[i];
+        pos[i] = (*xadj)[i];
+    }
+    magma_index_malloc_cpu( adj, (*xadj)[n] );
+    for( i=0; i < n; i++ ){
+        for( j=A.row[i]; j < A.row[i+1]; j++ ){
+            c = A.col[j];
+            if( c != i ){
+                (*adj)[ pos[i]++ ] = c;
+                (*adj)[ pos[c]++ ] = i;
+            }
+        }
+    }
+    // sort the neighbours and remove the duplicates of symmetric entries
+    k = 0;
+    for( i=0; i < n; i++ ){
+        magma_index_t b = (*xadj)[i], e = (*xadj)[i+1];
+        std::sort( *adj + b, *adj + e );
+        (*xadj)[i] = k;
+        for( j=b; j < e; j++ ){
+            if( j == b || (*adj)[j] != (*adj)[j-1] )
+                (*adj)[k++] = (*adj)[j];
+        }
+    }
+    (*xadj)[n] = k;
+    magma_free_cpu( pos );
+}
+
+
+// ---------------------------------------------
+// Breadth-first search from root through the vertices v with
+// mark[v] == label. Stores the vertices in level order in order, and the
+// start of each level in lev, and returns the number of levels.
+// Vertices are visited once per search, tracked with visit[v] == stamp.
+// If sorted is set, the new neighbours of each vertex are taken in
+// increasing order of degree (Cuthill-McKee order).
+static magma_int_t
+reorder_bfs( const magma_index_t *xadj, const magma_index_t *adj,
+             const magma_index_t *mark, magma_index_t label,
+             magma_index_t *visit, magma_index_t stamp,
+             magma_index_t root, int sorted,
+             magma_index_t *order, magma_index_t *lev )
+{
+    magma_index_t head = 0, tail = 1, end = 1, i, j, k, v, w;
+    magma_int_t nlev = 1;
+
+    order[0] = root;
+    visit[root] = stamp;
+    lev[0] = 0;
+    lev[1] = 1;
+    while( head < tail ){
+        // one level: order[head .. end-1]
+        for( ; head < end; head++ ){
+            v = order[head];
+            magma_index_t first = tail;
+            for( j=xadj[v]; j < xadj[v+1]; j++ ){
+                w = adj[j];
+                if( mark[w] == label && visit[w] != stamp ){
+                    visit[w] = stamp;
+                    order[tail++] = w;
+                }
+            }
+            if( sorted ){
+                for( i=first+1; i < tail; i++ ){
+                    w = order[i];
+                    magma_index_t d = xadj[w+1] - xadj[w];
+                    for( k=i; k > first && xadj[order[k-1]+1] - xadj[order[k-1]] > d; k-- )
+                        order[k] = order[k-1];
+                    order[k] = w;
+                }
+            }
+        }
+        if( tail > end )
+            lev[++nlev] = tail;
+        end = tail;
+    }
+    return nlev;
+}
+
+
+// ---------------------------------------------
+// Finds a pseudo-peripheral vertex of the component of root among the
+// vertices with mark[v] == label (George and Liu): repeats the search from
+// a vertex of minimal degree in the last level while the number of levels
+// grows. Leaves the level structure of the returned vertex in order and
+// lev, and its number of levels in nlev.
+static magma_index_t
+reorder_peripheral( const magma_index_t *xadj, const magma_index_t *adj,
+                    const magma_index_t *mark, magma_index_t label,
+                    magma_index_t *visit, magma_index_t *stamp,
+                    magma_index_t root, int sorted,
+                    magma_index_t *order, magma_index_t *lev, magma_int_t *nlev )
+{
+    magma_index_t i, u, *order2, *lev2;
+    magma_int_t nlev2;
+
+    *nlev = reorder_bfs( xadj, adj, mark, label, visit, ++(*stamp), root,
+                         sorted, order, lev );
+    magma_index_t cnt = lev[*nlev];
+    magma_index_malloc_cpu( &order2, cnt );
+    magma_index_malloc_cpu( &lev2, cnt+1 );
+    while( true ){
+        u = order[ lev[*nlev-1] ];
+        for( i=lev[*nlev-1]+1; i < lev[*nlev]; i++ ){
+            if( xadj[order[i]+1] - xadj[order[i]] < xadj[u+1] - xadj[u] )
+                u = order[i];
+        }
+        nlev2 = reorder_bfs( xadj, adj, mark, label, visit, ++(*stamp), u,
+                             sorted, order2, lev2 );
+        if( nlev2 <= *nlev )
+            break;
+        root = u;
+        *nlev = nlev2;
+        for( i=0; i < cnt; i++ )
+            order[i] = order2[i];
+        for( i=0; i <= nlev2; i++ )
+            lev[i] = lev2[i];
+    }
+    magma_free_cpu( order2 );
+    magma_free_cpu( lev2 );
+    return root;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the Reverse Cuthill-McKee ordering of a square matrix, which
+    reduces its bandwidth and profile. The ordering is computed for the
+    pattern of A + A^T. Each connected component is numbered by a
+    breadth-first search from a pseudo-peripheral vertex, visiting the
+    neighbours of each vertex in increasing order of degree, and the
+    resulting order is reversed.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_d_sparse_matrix
+                square matrix in CSR format on the CPU
+
+    @param
+    perm        magma_index_t*
+                array of A.num_rows entries; on output, row i of the
+                reordered matrix is row perm[i] of A
+
+    @ingroup magmasparse_daux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_d_rcm( magma_d_sparse_matrix A, magma_index_t *perm ){
+
+    magma_int_t n = A.num_rows, nlev;
+    magma_index_t *xadj, *adj, *mark, *visit, *lev, stamp = 0, i, k;
+
+    reorder_graph( A, &xadj, &adj );
+    magma_index_malloc_cpu( &mark, n );
+    magma_index_malloc_cpu( &visit, n );
+    magma_index_malloc_cpu( &lev, n+1 );
+    for( i=0; i < n; i++ ){
+        mark[i] = 0;
+        visit[i] = 0;
+    }
+
+    k = 0;
+    for( i=0; i < n; i++ ){
+        if( mark[i] != 0 )
+            continue;
+        // number the component of i, starting from a peripheral vertex
+        reorder_peripheral( xadj, adj, mark, 0, visit, &stamp, i, 1,
+                            perm + k, lev, &nlev );
+        for( magma_index_t j=k; j < k + lev[nlev]; j++ )
+            mark[ perm[j] ] = 1;
+        k += lev[nlev];
+    }
+    std::reverse( perm, perm + n );
+
+    magma_free_cpu( xadj );
+    magma_free_cpu( adj );
+    magma_free_cpu( mark );
+    magma_free_cpu( visit );
+    magma_free_cpu( lev );
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes a nested dissection ordering of a square matrix, which
+    reduces the fill of sparse factorizations and splits the matrix into
+    independent blocks. The ordering is computed for the pattern of
+    A + A^T. Each part of the graph is bisected by the middle level of a
+    breadth-first search from a pseudo-peripheral vertex; the two halves
+    are numbered first, then the separator, and the halves are dissected
+    in the same way until they have at most 128 vertices, which are
+    numbered in Reverse Cuthill-McKee order. Disconnected parts are split
+    into their components first.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_d_sparse_matrix
+                square matrix in CSR format on the CPU
+
+    @param
+    perm        magma_index_t*
+                array of A.num_rows entries; on output, row i of the
+                reordered matrix is row perm[i] of A
+
+    @ingroup magmasparse_daux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_d_nd( magma_d_sparse_matrix A, magma_index_t *perm ){
+
+    magma_int_t n = A.num_rows, nlev;
+    magma_index_t *xadj, *adj, *mark, *visit, *lev, *tmp, stamp = 0;
+    magma_index_t i, j, label = 0;
+
+    reorder_graph( A, &xadj, &adj );
+    magma_index_malloc_cpu( &mark, n );
+    magma_index_malloc_cpu( &visit, n );
+    magma_index_malloc_cpu( &lev, n+1 );
+    magma_index_malloc_cpu( &tmp, n );
+    for( i=0; i < n; i++ ){
+        perm[i] = i;
+        mark[i] = 0;
+        visit[i] = 0;
+    }
+
+    // parts still to dissect: the vertices perm[b .. e-1], all with
+    // mark == label
+    struct part { magma_index_t b, e, label; };
+    std::vector< part > stack;
+    if( n > 0 ){
+        part p = { 0, (magma_index_t) n, 0 };
+        stack.push_back( p );
+    }
+    while( ! stack.empty() ){
+        part p = stack.back();
+        stack.pop_back();
+        magma_index_t cnt = p.e - p.b;
+        int leaf = ( cnt <= REORDER_ND_LEAF );
+
+        reorder_peripheral( xadj, adj, mark, p.label, visit, &stamp,
+                            perm[p.b], leaf, tmp, lev, &nlev );
+
+        if( lev[nlev] < cnt ){
+            // disconnected: one part for each component
+            magma_index_t k = 0, c = lev[nlev];
+            for( i=p.b; k < cnt; i++ ){
+                if( k > 0 ){
+                    if( visit[perm[i]] == stamp )
+                        continue;
+                    c = lev[ reorder_bfs( xadj, adj, mark, p.label, visit, stamp,
+                                          perm[i], 0, tmp+k, lev ) ];
+                }
+                part q = { p.b + k, p.b + k + c, ++label };
+                for( j=k; j < k + c; j++ )
+                    mark[tmp[j]] = q.label;
+                stack.push_back( q );
+                k += c;
+            }
+            for( i=0; i < cnt; i++ )
+                perm[p.b+i] = tmp[i];
+        }
+        else if( leaf || nlev < 3 ){
+            // Reverse Cuthill-McKee order of the part
+            for( i=0; i < cnt; i++ ){
+                perm[p.e-1-i] = tmp[i];
+                mark[tmp[i]] = -1;
+            }
+        }
+        else {
+            // separator: the first level after which half the part is numbered
+            magma_index_t s = 1;
+            while( s < nlev-2 && lev[s+1] < cnt/2 )
+                s++;
+            magma_index_t n1 = lev[s], n2 = cnt - lev[s+1];
+            part p1 = { p.b, p.b + n1, ++label };
+            part p2 = { p.b + n1, p.b + n1 + n2, ++label };
+            for( i=0; i < n1; i++ ){
+                perm[p.b+i] = tmp[i];
+                mark[tmp[i]] = p1.label;
+            }
+            for( i=0; i < n2; i++ ){
+                perm[p.b+n1+i] = tmp[lev[s+1]+i];
+                mark[tmp[lev[s+1]+i]] = p2.label;
+            }
+            for( j=lev[s]; j < lev[s+1]; j++ ){
+                perm[p.b+n1+n2+j-lev[s]] = tmp[j];
+                mark[tmp[j]] = -1;
+            }
+            stack.push_back( p1 );
+            stack.push_back( p2 );
+        }
+    }
+
+    magma_free_cpu( xadj );
+    magma_free_cpu( adj );
+    magma_free_cpu( mark );
+    magma_free_cpu( visit );
+    magma_free_cpu( lev );
+    magma_free_cpu( tmp );
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Applies a symmetric permutation to a square matrix: B = P A P^T, where
+    row and column i of B are row and column perm[i] of A.
+    Returns MAGMA_ERR_NOT_SUPPORTED if A is not square.
+    A is converted to CSR on the CPU if needed; B is CSR on the CPU, with
+    sorted column indices.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_d_sparse_matrix
+                input matrix
+
+    @param
+    B           magma_d_sparse_matrix*
+                output matrix
+
+    @param
+    perm        const magma_index_t*
+                permutation of A.num_rows entries
+
+    @ingroup magmasparse_daux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_d_mpermute( magma_d_sparse_matrix A, magma_d_sparse_matrix *B,
+                  const magma_index_t *perm ){
+
+    if( A.num_rows != A.num_cols ){
+        printf("error: permutation needs a square matrix.\n");
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+    magma_d_sparse_matrix hA, CA;
+    if( A.memory_location != Magma_CPU )
+        magma_d_mtransfer( A, &hA, A.memory_location, Magma_CPU );
+    else
+        hA = A;
+    if( hA.storage_type != Magma_CSR )
+        magma_d_mconvert( hA, &CA, hA.storage_type, Magma_CSR );
+    else
+        CA = hA;
+
+    magma_int_t n = CA.num_rows, nnz = CA.row[n];
+    magma_index_t *inv, i;
+    magma_index_malloc_cpu( &inv, n );
+    for( i=0; i < n; i++ )
+        inv[ perm[i] ] = i;
+
+    *B = CA;
+    B->storage_type = Magma_CSR;
+    B->memory_location = Magma_CPU;
+    magma_index_malloc_cpu( &B->row, n+1 );
+    magma_index_malloc_cpu( &B->col, nnz );
+    magma_dmalloc_cpu( &B->val, nnz );
+    B->row[0] = 0;
+    for( i=0; i < n; i++ )
+        B->row[i+1] = B->row[i] + CA.row[perm[i]+1] - CA.row[perm[i]];
+
+#ifdef _OPENMP
+    #pragma omp parallel for if( nnz >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+    for( i=0; i < n; i++ ){
+        magma_index_t j, k = B->row[i];
+        for( j=CA.row[perm[i]]; j < CA.row[perm[i]+1]; j++, k++ ){
+            B->col[k] = inv[ CA.col[j] ];
+            B->val[k] = CA.val[j];
+        }
+    }
+    magma_d_csrsortmerge( n, B->row, &B->col, &B->val, &B->nnz );
+    magma_d_mbandwidth( *B, &B->diameter, NULL );
+
+    magma_free_cpu( inv );
+    if( hA.storage_type != Magma_CSR )
+        magma_d_mfree( &CA );
+    if( A.memory_location != Magma_CPU )
+        magma_d_mfree( &hA );
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Permutes a vector on the CPU: y = P x, with y[i] = x[perm[i]], which
+    takes a vector to the ordering of magma_d_mpermute, or y = P^T x, with
+    y[perm[i]] = x[i], which takes it back.
+
+    Arguments
+    ---------
+
+    @param
+    trans       magma_trans_t
+                MagmaNoTrans for y = P x, MagmaTrans for y = P^T x
+
+    @param
+    perm        const magma_index_t*
+                permutation of x.num_rows entries
+
+    @param
+    x           magma_d_vector
+                input vector
+
+    @param
+    y           magma_d_vector
+                output vector of the same size
+
+    @ingroup magmasparse_daux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_d_vpermute( magma_trans_t trans, const magma_index_t *perm,
+                  magma_d_vector x, magma_d_vector y ){
+
+    magma_int_t n = x.num_rows, i;
+    if( trans == MagmaNoTrans ){
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( i=0; i < n; i++ )
+            y.val[i] = x.val[ perm[i] ];
+    }
+    else {
+#ifdef _OPENMP
+        #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static )
+#endif
+        for( i=0; i < n; i++ )
+            y.val[ perm[i] ] = x.val[i];
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Computes the bandwidth max |i - j| over the nonzeros (i,j) of a CSR
+    matrix on the CPU, and its profile, the sum over the rows i of i - j
+    for the leftmost nonzero (i,j) with j <= i.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_d_sparse_matrix
+                matrix in CSR format on the CPU
+
+    @param
+    bandwidth   magma_int_t*
+                bandwidth
+
+    @param
+    profile     magma_int_t*
+                profile, or NULL
+
+    @ingroup magmasparse_daux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_d_mbandwidth( magma_d_sparse_matrix A, magma_int_t *bandwidth,
+                    magma_int_t *profile ){
+
+    if( A.memory_location != Magma_CPU || A.storage_type != Magma_CSR )
+        return MAGMA_ERR_NOT_SUPPORTED;
+
+    magma_int_t bw = 0, prof = 0, i;
+#ifdef _OPENMP
+    #pragma omp parallel for if( A.nnz >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( max:bw ) reduction( +:prof )
+#endif
+    for( i=0; i < A.num_rows; i++ ){
+        magma_int_t lo = i, hi = i;
+        for( magma_index_t j=A.row[i]; j < A.row[i+1]; j++ ){
+            lo = min( lo, (magma_int_t) A.col[j] );
+            hi = max( hi, (magma_int_t) A.col[j] );
+        }
+        bw = max( bw, max( i - lo, hi - i ));
+        prof += i - lo;
+    }
+    *bandwidth = bw;
+    if( profile != NULL )
+        *profile = prof;
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Reorders the rows and columns of a square matrix symmetrically with
+    the given reordering, to reduce the bandwidth (Reverse Cuthill-McKee)
+    or the fill of factorizations (nested dissection). This is the
+    reordering stage between reading or scaling a matrix and converting
+    it with magma_d_mconvert.
+    Returns MAGMA_ERR_NOT_SUPPORTED if A is not square.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_d_sparse_matrix
+                input matrix
+
+    @param
+    B           magma_d_sparse_matrix*
+                output matrix P A P^T, CSR on the CPU
+
+    @param
+    reordering  magma_reorder_t
+                Magma_NOREORDER, Magma_RCM, or Magma_ND
+
+    @param
+    perm        magma_index_t**
+                on output, the permutation, allocated with
+                magma_index_malloc_cpu; vectors go to the new ordering
+                with magma_d_vpermute( MagmaNoTrans, ... ), and back with
+                MagmaTrans
+
+    @ingroup magmasparse_daux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_d_mreorder( magma_d_sparse_matrix A, magma_d_sparse_matrix *B,
+                  magma_reorder_t reordering, magma_index_t **perm ){
+
+    if( A.num_rows != A.num_cols ){
+        printf("error: reordering needs a square matrix.\n");
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+    magma_d_sparse_matrix hA, CA;
+    if( A.memory_location != Magma_CPU )
+        magma_d_mtransfer( A, &hA, A.memory_location, Magma_CPU );
+    else
+        hA = A;
+    if( hA.storage_type != Magma_CSR )
+        magma_d_mconvert( hA, &CA, hA.storage_type, Magma_CSR );
+    else
+        CA = hA;
+
+    magma_index_malloc_cpu( perm, CA.num_rows );
+    if( reordering == Magma_RCM )
+        magma_d_rcm( CA, *perm );
+    else if( reordering == Magma_ND )
+        magma_d_nd( CA, *perm );
+    else {
+        for( magma_int_t i=0; i < CA.num_rows; i++ )
+            (*perm)[i] = i;
+    }
+    magma_d_mpermute( CA, B, *perm );
+
+    if( hA.storage_type != Magma_CSR )
+        magma_d_mfree( &CA );
+    if( A.memory_location != Magma_CPU )
+        magma_d_mfree( &hA );
+    return MAGMA_SUCCESS;
+}
@@ -423,7 +423,20 @@ magma_dsolverinfo_free( magma_d_solver_par *solver_par,
         magma_free_cpu( precond_par->U.blockinfo );
         precond_par->U.blockinfo = NULL;
     }
-    if( precond_par->solver == Magma_ILU ||
+    if( precond_par->L.memory_location == Magma_CPU &&
+        ( precond_par->solver == Magma_ILU ||
+          precond_par->solver == Magma_ICC ) ){
+        // level schedules of the L and U solves from magma_dilusetup_cpu
+        if( precond_par->int_array_1 != NULL ){
+            magma_free_cpu( precond_par->int_array_1 );
+            precond_par->int_array_1 = NULL;
+        }
+        if( precond_par->int_array_2 != NULL ){
+            magma_free_cpu( precond_par->int_array_2 );
+            precond_par->int_array_2 = NULL;
+        }
+    }
+    else if( precond_par->solver == Magma_ILU ||
         precond_par->solver == Magma_AILU ||
         precond_par->solver == Magma_ICC||
         precond_par->solver == Magma_AICC ){
@@ -590,6 +603,8 @@ magma_dsolverinfo_init( magma_d_solver_par *solver_par,
     precond_par->UD.row = NULL;
     precond_par->UD.blockinfo = NULL;
 
+    precond_par->int_array_1 = NULL;
+    precond_par->int_array_2 = NULL;
 
     return MAGMA_SUCCESS;
 }
@@ -122,6 +122,15 @@ magma_s_mfree( magma_s_sparse_matrix *A ){
             A->nnz = 0;        
             return MAGMA_SUCCESS;                 
         } 
+        if( A->storage_type == Magma_STENCIL ){
+            free( A->val );
+            free( A->row );
+            free( A->col );
+            A->num_rows = 0;
+            A->num_cols = 0;
+            A->nnz = 0;        
+            return MAGMA_SUCCESS;                 
+        } 
         if( A->storage_type == Magma_ELLRT ){
             free( A->val );
             free( A->row );
@@ -144,9 +153,12 @@ magma_s_mfree( magma_s_sparse_matrix *A ){
                                         || A->storage_type == Magma_CSRD
                                         || A->storage_type == Magma_CSRL
                                         || A->storage_type == Magma_CSRU ){
-            free( A->val );
-            free( A->col );
-            free( A->row );
+            // arrays used in place from a file by magma_s_csr_binary
+            if( magma_s_csr_unmapbinary( A ) != MAGMA_SUCCESS ){
+                free( A->val );
+                free( A->col );
+                free( A->row );
+            }
             A->num_rows = 0;
             A->num_cols = 0;
             A->nnz = 0;        
@@ -157,10 +157,18 @@ magma_s_mconvert( magma_s_sparse_matrix A,
                   magma_storage_t new_format ){
 
     float zero = MAGMA_S_MAKE( 0.0, 0.0 );
+    B->sym = A.sym;
 
     // check whether matrix on CPU
     if( A.memory_location == Magma_CPU ){
 
+        // STENCIL to any format: generate the matrix
+        if( old_format == Magma_STENCIL ){
+            if( new_format == Magma_STENCIL )
+                return magma_s_mtransfer( A, B, Magma_CPU, Magma_CPU );
+            return magma_sm_stencil_expand( A, new_format, B );
+        }
+
         // CSR to CSR
         if( old_format == Magma_CSR && new_format == Magma_CSR ){
             // fill in information for B
@@ -383,10 +391,11 @@ magma_s_mconvert( magma_s_sparse_matrix A,
             magma_s_mconvert( A, B, Magma_CSR, Magma_CSR );
             return MAGMA_SUCCESS; 
         }
-        // CSRCSC to CSR
+        // COO to CSR
         if( old_format == Magma_COO && new_format == Magma_CSR ){
-           // A.storage_type = Magma_CSR;
-          //  magma_s_mconvert( A, B, Magma_CSR, Magma_CSR );
+
+            // sorted columns, duplicates summed
+            magma_s_coo2csr( A, B );
             return MAGMA_SUCCESS; 
         }
         // CSR to ELLPACK    
@@ -0,0 +1,329 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from magma_zcoo2csr.cpp normal z -> s, Tue Sep  2 12:38:36 2014
+*/
+
+#include <vector>
+#include <algorithm>
+
+#include "magma_lapack.h"
+#include "common_magma.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+// ---------------------------------------------
+// Sorts the k entries of a CSR row by column, keeping the order of equal
+// columns, then sums entries with equal columns into the first of them.
+// Short rows use insertion sort, long rows a stable sort of (col, val) pairs.
+// Returns the number of entries left.
+struct s_csr_entry {
+    magma_index_t col;
+    float val;
+    bool operator< ( const s_csr_entry& b ) const { return col < b.col; }
+};
+
+static magma_int_t
+s_csr_sortmerge_row( magma_index_t *col, float *val, magma_int_t k )
+{
+    magma_int_t i, j;
+    for( i=1; i < k && col[i-1] < col[i]; i++ )
+        ;
+    if( i >= k )
+        return k;       // sorted, no duplicates
+    if( k <= 32 ){
+        for( i=1; i < k; i++ ){
+            magma_index_t c = col[i];
+            float v = val[i];
+            for( j=i; j > 0 && col[j-1] > c; j-- ){
+                col[j] = col[j-1];
+                val[j] = val[j-1];
+            }
+            col[j] = c;
+            val[j] = v;
+        }
+    }
+    else {
+        std::vector< s_csr_entry > tmp( k );
+        for( i=0; i < k; i++ ){
+            tmp[i].col = col[i];
+            tmp[i].val = val[i];
+        }
+        std::stable_sort( tmp.begin(), tmp.end() );
+        for( i=0; i < k; i++ ){
+            col[i] = tmp[i].col;
+            val[i] = tmp[i].val;
+        }
+    }
+    j = 0;
+    for( i=1; i < k; i++ ){
+        if( col[i] == col[j] )
+            val[j] += val[i];
+        else {
+            j++;
+            col[j] = col[i];
+            val[j] = val[i];
+        }
+    }
+    return j+1;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Sorts the column indices in each row of a CSR matrix, and sums entries
+    with the same row and column into one entry, so the result has sorted
+    and unique column indices. Equal entries are summed in their original
+    order.
+
+    Rows are sorted in place, in parallel over ranges of rows with about
+    the same number of nonzeros. If there were duplicates, col and val are
+    compacted into new arrays allocated with magma_index_malloc_cpu and
+    magma_smalloc_cpu, the old ones are freed, and row and nnz are updated.
+    Otherwise no memory beyond one index per row is allocated.
+
+    Arguments
+    ---------
+
+    @param
+    num_rows    magma_int_t
+                number of rows
+
+    @param
+    row         magma_index_t*
+                row pointer, num_rows+1 entries
+
+    @param
+    col         magma_index_t**
+                column indices, allocated with magma_index_malloc_cpu
+
+    @param
+    val         float**
+                values, allocated with magma_smalloc_cpu
+
+    @param
+    nnz         magma_int_t*
+                number of nonzeros, on output after merging duplicates
+
+    @ingroup magmasparse_saux
+    ********************************************************************/
+
+magma_int_t
+magma_s_csrsortmerge( magma_int_t num_rows,
+                      magma_index_t *row,
+                      magma_index_t **col,
+                      float **val,
+                      magma_int_t *nnz ){
+
+    magma_int_t old_nnz = row[num_rows];
+    magma_int_t nthread = 1;
+#ifdef _OPENMP
+    if ( old_nnz >= MAGMA_SPARSE_OMP_THRESHOLD )
+        nthread = omp_get_max_threads();
+#endif
+
+    // len[i] is the length of row i after merging, part[t+1] the number of
+    // nonzeros in the rows of thread t, and then the offset of its rows
+    magma_index_t *len, *part;
+    magma_index_malloc_cpu( &len, num_rows );
+    magma_index_malloc_cpu( &part, nthread+1 );
+    magma_index_t *new_col = NULL;
+    float *new_val = NULL;
+
+#ifdef _OPENMP
+    #pragma omp parallel num_threads( nthread )
+#endif
+    {
+#ifdef _OPENMP
+        magma_int_t id  = omp_get_thread_num();
+        magma_int_t tot = omp_get_num_threads();
+#else
+        magma_int_t id  = 0;
+        magma_int_t tot = 1;
+#endif
+        // rows [rb, re), with about nnz/tot nonzeros
+        magma_int_t rb, re;
+        magma_sparse_row_partition( row, num_rows, id, tot, &rb, &re );
+        magma_int_t i, j, t;
+
+        // 1. sort and merge my rows in place
+        magma_index_t sum = 0;
+        for( i=rb; i < re; i++ ){
+            len[i] = s_csr_sortmerge_row( *col + row[i], *val + row[i],
+                                          row[i+1] - row[i] );
+            sum += len[i];
+        }
+        part[id+1] = sum;
+#ifdef _OPENMP
+        #pragma omp barrier
+        #pragma omp single
+#endif
+        {
+            part[0] = 0;
+            for( t=0; t < tot; t++ )
+                part[t+1] += part[t];
+            if( part[tot] < old_nnz ){
+                magma_index_malloc_cpu( &new_col, part[tot] );
+                magma_smalloc_cpu( &new_val, part[tot] );
+            }
+        }
+
+        // 2. if there were duplicates, move my rows to their new place,
+        //    and update the row pointer once all threads have read it
+        if( new_col != NULL ){
+            magma_index_t k = part[id];
+            for( i=rb; i < re; i++ ){
+                for( j=0; j < len[i]; j++ ){
+                    new_col[k+j] = (*col)[row[i]+j];
+                    new_val[k+j] = (*val)[row[i]+j];
+                }
+                k += len[i];
+            }
+#ifdef _OPENMP
+            #pragma omp barrier
+#endif
+            k = part[id];
+            for( i=rb; i < re; i++ ){
+                k += len[i];
+                row[i+1] = k;
+            }
+        }
+    }
+
+    if( new_col != NULL ){
+        magma_free_cpu( *col );
+        magma_free_cpu( *val );
+        *col = new_col;
+        *val = new_val;
+    }
+    *nnz = row[num_rows];
+
+    magma_free_cpu( len );
+    magma_free_cpu( part );
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Converts a matrix in COO format on the CPU to CSR, with sorted column
+    indices in each row and duplicate entries summed.
+    A.row holds the row index and A.col the column index of each of the
+    A.nnz entries, in any order.
+
+    The entries are placed with a counting sort by row, linear in
+    num_rows + nnz: threads count their contiguous range of entries per
+    row in their own histogram, and the histograms give each thread its own
+    slots in every row, so the scatter needs no atomics and keeps the
+    order of the entries within each row. The rows, which are short in
+    typical matrices, are then sorted and merged by magma_s_csrsortmerge.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_s_sparse_matrix
+                input matrix in COO format on the CPU
+
+    @param
+    B           magma_s_sparse_matrix*
+                output matrix in CSR format on the CPU
+
+    @ingroup magmasparse_saux
+    ********************************************************************/
+
+magma_int_t
+magma_s_coo2csr( magma_s_sparse_matrix A, magma_s_sparse_matrix *B ){
+
+    magma_int_t n_rows = A.num_rows;
+    magma_int_t nnz = A.nnz;
+    magma_int_t nthread = 1;
+#ifdef _OPENMP
+    // each histogram is n_rows long, keep them within 2*nnz entries
+    if ( nnz >= MAGMA_SPARSE_OMP_THRESHOLD ) {
+        nthread = min( (magma_int_t) omp_get_max_threads(),
+                       max( (magma_int_t) 1, 2*nnz / max( n_rows, (magma_int_t) 1 )));
+    }
+#endif
+
+    B->storage_type = Magma_CSR;
+    B->memory_location = Magma_CPU;
+    B->num_rows = A.num_rows;
+    B->num_cols = A.num_cols;
+    B->diameter = A.diameter;
+    magma_smalloc_cpu( &B->val, nnz );
+    magma_index_malloc_cpu( &B->row, n_rows+1 );
+    magma_index_malloc_cpu( &B->col, nnz );
+
+    // cnt[ t*n_rows + r ] is first the count of thread t's entries in row r,
+    // then the offset of thread t's first entry within row r.
+    // part[t] is the offset of the first entry in thread t's range of rows.
+    magma_index_t *cnt, *part;
+    magma_index_malloc_cpu( &cnt, nthread*n_rows );
+    magma_index_malloc_cpu( &part, nthread+1 );
+
+#ifdef _OPENMP
+    #pragma omp parallel num_threads( nthread )
+#endif
+    {
+#ifdef _OPENMP
+        magma_int_t id  = omp_get_thread_num();
+        magma_int_t tot = omp_get_num_threads();
+#else
+        magma_int_t id  = 0;
+        magma_int_t tot = 1;
+#endif
+        // entries [jb, je) of the input
+        magma_int_t jb = ((size_t) nnz * id) / tot;
+        magma_int_t je = ((size_t) nnz * (id+1)) / tot;
+        magma_index_t *mycnt = cnt + id*n_rows;
+        magma_int_t r, j;
+
+        // 1. count entries per row
+        for( r=0; r < n_rows; r++ )
+            mycnt[r] = 0;
+        for( j=jb; j < je; j++ )
+            mycnt[ A.row[j] ]++;
+#ifdef _OPENMP
+        #pragma omp barrier
+#endif
+
+        // 2. offsets of each thread within each row, and the row pointer
+        magma_sparse_bucket_offsets( cnt, n_rows, B->row, part, id, tot );
+
+        // 3. scatter my entries
+        for( j=jb; j < je; j++ ){
+            r = A.row[j];
+            magma_index_t k = B->row[r] + mycnt[r];
+            mycnt[r]++;
+            B->col[k] = A.col[j];
+            B->val[k] = A.val[j];
+        }
+    }
+
+    magma_free_cpu( cnt );
+    magma_free_cpu( part );
+
+    // 4. sort the rows by column and merge duplicates
+    magma_s_csrsortmerge( n_rows, B->row, &B->col, &B->val, &B->nnz );
+
+    B->max_nnz_row = 0;
+    for( magma_int_t i=0; i < n_rows; i++ )
+        B->max_nnz_row = max( B->max_nnz_row, B->row[i+1] - B->row[i] );
+
+    return MAGMA_SUCCESS;
+}
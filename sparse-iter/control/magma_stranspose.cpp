@@ -12,9 +12,14 @@
 #include "magma_lapack.h"
 #include "common_magma.h"
 #include "magmasparse.h"
+#include "magmasparse_internal.h"
 
 #include <assert.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // includes CUDA
 #include <cuda_runtime_api.h>
 #include <cublas.h>
@@ -23,11 +28,99 @@
 
 
 
+// ---------------------------------------------
+// Transposes the n_rows x n_cols CSR matrix (val, row, col) into
+// (new_val, new_row, new_col), which must hold nnz, n_cols+1, and nnz entries.
+// Counting sort by column, linear in n_rows + n_cols + nnz.
+// Threads take contiguous ranges of rows with about the same number of
+// nonzeros, and count their nonzeros per column in their own histogram.
+// Turning the histograms into offsets gives each thread its own slots in
+// every output row, after those of all threads with earlier rows,
+// so the scatter needs no atomics and the column indices of the
+// transposed matrix come out sorted.
+// Each histogram is n_cols long, so the number of threads is limited to
+// keep them within 2*nnz entries in total.
+static void
+magma_s_csrtranspose_cpu(
+    magma_int_t n_rows,
+    magma_int_t n_cols,
+    const float *val,
+    const magma_index_t *row,
+    const magma_index_t *col,
+    float *new_val,
+    magma_index_t *new_row,
+    magma_index_t *new_col )
+{
+    magma_int_t nnz = row[n_rows];
+    magma_int_t nthread = 1;
+#ifdef _OPENMP
+    if ( nnz >= MAGMA_SPARSE_OMP_THRESHOLD ) {
+        nthread = min( (magma_int_t) omp_get_max_threads(),
+                       max( (magma_int_t) 1, 2*nnz / max( n_cols, (magma_int_t) 1 )));
+    }
+#endif
+
+    // cnt[ t*n_cols + c ] is first the count of thread t's nonzeros in column c,
+    // then the offset of thread t's first nonzero within row c of the result.
+    // part[t] is the offset of the first nonzero in thread t's range of result rows.
+    magma_index_t *cnt, *part;
+    magma_index_malloc_cpu( &cnt, nthread*n_cols );
+    magma_index_malloc_cpu( &part, nthread+1 );
+
+#ifdef _OPENMP
+    #pragma omp parallel num_threads( nthread )
+#endif
+    {
+#ifdef _OPENMP
+        magma_int_t id  = omp_get_thread_num();
+        magma_int_t tot = omp_get_num_threads();
+#else
+        magma_int_t id  = 0;
+        magma_int_t tot = 1;
+#endif
+        // rows [rb, re) of the input, with about nnz/tot nonzeros
+        magma_int_t rb, re;
+        magma_sparse_row_partition( row, n_rows, id, tot, &rb, &re );
+        magma_index_t *mycnt = cnt + id*n_cols;
+        magma_int_t c, j, r;
+
+        // 1. count nonzeros per column
+        for( c=0; c < n_cols; c++ )
+            mycnt[c] = 0;
+        for( j=row[rb]; j < row[re]; j++ )
+            mycnt[ col[j] ]++;
+#ifdef _OPENMP
+        #pragma omp barrier
+#endif
+
+        // 2. offsets of each thread within each result row,
+        //    and the row pointer of the result
+        magma_sparse_bucket_offsets( cnt, n_cols, new_row, part, id, tot );
+
+        // 3. scatter my nonzeros
+        for( r=rb; r < re; r++ ){
+            for( j=row[r]; j < row[r+1]; j++ ){
+                c = col[j];
+                magma_index_t k = new_row[c] + mycnt[c];
+                mycnt[c]++;
+                new_val[k] = val[j];
+                new_col[k] = r;
+            }
+        }
+    }
+
+    magma_free_cpu( cnt );
+    magma_free_cpu( part );
+}
+
+
 /**
     Purpose
     -------
 
     Transposes a matrix stored in CSR format.
+    The output arrays are allocated with new[], and must be freed by the
+    caller with delete[].
 
 
     Arguments
@@ -47,7 +140,7 @@
 
     @param
     val         float*
-                value array of input matrix 
+                value array of input matrix
 
     @param
     row         magma_index_t*
@@ -55,7 +148,7 @@
 
     @param
     col         magma_index_t*
-                column indices of input matrix 
+                column indices of input matrix
 
     @param
     new_n_rows  magma_index_t*
@@ -71,7 +164,7 @@
 
     @param
     new_val     float**
-                value array of transposed matrix 
+                value array of transposed matrix
 
     @param
     new_row     magma_index_t**
@@ -85,128 +178,66 @@
     @ingroup magmasparse_saux
     ********************************************************************/
 
-magma_int_t s_transpose_csr(    magma_int_t n_rows, 
-                                magma_int_t n_cols, 
-                                magma_int_t nnz, 
-                                float *val, 
-                                magma_index_t *row, 
-                                magma_index_t *col, 
-                                magma_int_t *new_n_rows, 
-                                magma_int_t *new_n_cols, 
-                                magma_int_t *new_nnz, 
-                                float **new_val, 
-                                magma_index_t **new_row, 
+magma_int_t s_transpose_csr(    magma_int_t n_rows,
+                                magma_int_t n_cols,
+                                magma_int_t nnz,
+                                float *val,
+                                magma_index_t *row,
+                                magma_index_t *col,
+                                magma_int_t *new_n_rows,
+                                magma_int_t *new_n_cols,
+                                magma_int_t *new_nnz,
+                                float **new_val,
+                                magma_index_t **new_row,
                                 magma_index_t **new_col ){
 
+    nnz = row[n_rows];
+    *new_n_rows = n_cols;
+    *new_n_cols = n_rows;
+    *new_nnz = nnz;
 
+    //csr structure for transposed matrix
+    *new_val = new float[nnz];
+    *new_row = new magma_index_t[n_cols+1];
+    *new_col = new magma_index_t[nnz];
 
-  nnz = row[n_rows];
-  *new_n_rows = n_cols;
-  *new_n_cols = n_rows;
-  *new_nnz = nnz;
-
-  float ** valtemp;
-  magma_index_t ** coltemp;
-  valtemp = (float**)malloc((n_rows)*sizeof(float*));
-  coltemp =(magma_index_t**)malloc((n_rows)*sizeof(magma_index_t*));
-
-  // temporary 2-dimensional arrays valtemp/coltemp 
-  // where val[i] is the array with the values of the i-th column of the matrix
-  magma_index_t *nnztemp;
-  magma_index_malloc_cpu( &nnztemp, n_rows );
-  
-  for( magma_int_t i=0; i<n_rows; i++ )
-    nnztemp[i]=0;
-  for( magma_int_t i=0; i<nnz; i++ )
-    nnztemp[col[i]]++;    
-
-  for( magma_int_t i=0; i<n_rows; i++ ){
-    valtemp[i] = 
-        (float*)malloc((nnztemp[i])*sizeof(float));
-    coltemp[i] = (magma_index_t*)malloc(nnztemp[i]*sizeof(magma_index_t));
-  }
-
-  for( magma_int_t i=0; i<n_rows; i++ )
-    nnztemp[i]=0;
-
-  for( magma_int_t j=0; j<n_rows; j++ ){
-    for( magma_int_t i=row[j]; i<row[j+1]; i++ ){
-      valtemp[col[i]][nnztemp[col[i]]]=val[i];
-      coltemp[col[i]][nnztemp[col[i]]]=j;
-      nnztemp[col[i]]++;    
-    }
-  }
-
-  //csr structure for transposed matrix
-  *new_val = new float[nnz];
-  *new_row = new magma_index_t[n_rows+1];
-  *new_col = new magma_index_t[nnz];
-
-  //fill the transposed csr structure
-  magma_int_t nnztmp=0;
-  (*new_row)[0]=0;
-  for( magma_int_t j=0; j<n_rows; j++ ){
-    for( magma_int_t i=0; i<nnztemp[j]; i++ ){
-      (*new_val)[nnztmp]=valtemp[j][i];
-      (*new_col)[nnztmp]=coltemp[j][i];
-      nnztmp++;
-    }
-    (*new_row)[j+1]=nnztmp;
-  }
-
-//usually the temporary memory should be freed afterwards
-//however, it does not work
-/*
-  for( magma_int_t j=0; j<n_rows; j++ ){
-    free(valtemp[j]);
-    free(coltemp[j]);
-  }
-  free(valtemp);free(coltemp);
-      printf("check9\n");
-    fflush(stdout);
-*/
+    magma_s_csrtranspose_cpu( n_rows, n_cols, val, row, col,
+                              *new_val, *new_row, *new_col );
 
-    magma_free_cpu( nnztemp );
-    
     return MAGMA_SUCCESS;
 }
 
-magma_int_t 
-magma_s_mtranspose( magma_s_sparse_matrix A, magma_s_sparse_matrix *B ){
 
-        magma_s_cucsrtranspose( A, B );
-/*
-    if( A.memory_location == Magma_CPU ){
-        if( A.storage_type == Magma_CSR ){
-            s_transpose_csr( A.num_rows, A.num_cols, A.nnz, A.val, A.row, A.col, 
-                                &(B->num_rows), &(B->num_cols), &(B->nnz), 
-                                &(B->val), &(B->row), &(B->col) );
-            B->memory_location = Magma_CPU;
-            B->storage_type = Magma_CSR;
-        }
-        else{
-            magma_s_sparse_matrix C, D;
-            magma_s_mconvert( A, &C, A.storage_type, Magma_CSR);
-            magma_s_mtranspose( C, &D );
-            magma_s_mconvert( D, B, Magma_CSR, A.storage_type );
-            magma_s_mfree(&C);
-            magma_s_mfree(&D);
+/**
+    Purpose
+    -------
 
-        }
-        return MAGMA_SUCCESS;   
-    }
-    else{
-        magma_s_sparse_matrix C, D;
-        magma_s_mtransfer( A, &C, A.memory_location, Magma_CPU);
-        magma_s_mtranspose( C, &D );
-        magma_s_mtransfer( D, B, Magma_CPU, A.memory_location );
-        magma_s_mfree(&C);
-        magma_s_mfree(&D);
-        return MAGMA_SUCCESS;
-    }
+    Transposes a sparse matrix.
+    Matrices on the CPU are transposed by magma_s_csrtranspose,
+    matrices on the device by magma_s_cucsrtranspose.
 
-*/
-    return MAGMA_SUCCESS;
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_s_sparse_matrix
+                input matrix
+
+    @param
+    B           magma_s_sparse_matrix*
+                output matrix, in the same format and location as A
+
+    @ingroup magmasparse_saux
+    ********************************************************************/
+
+magma_int_t
+magma_s_mtranspose( magma_s_sparse_matrix A, magma_s_sparse_matrix *B ){
+
+    if( A.memory_location == Magma_CPU )
+        return magma_s_csrtranspose( A, B );
+    else
+        return magma_s_cucsrtranspose( A, B );
 }
 
 
@@ -215,7 +246,9 @@ magma_s_mtranspose( magma_s_sparse_matrix A, magma_s_sparse_matrix *B ){
     Purpose
     -------
 
-    Helper function to transpose CSR matrix.
+    Helper function to transpose CSR matrix on the CPU.
+    Other formats are converted to CSR and back; CSRL becomes CSRU and
+    vice versa. Matrices on the device are transferred to the CPU and back.
 
 
     Arguments
@@ -232,59 +265,60 @@ magma_s_mtranspose( magma_s_sparse_matrix A, magma_s_sparse_matrix *B ){
     @ingroup magmasparse_saux
     ********************************************************************/
 
-magma_int_t 
+magma_int_t
 magma_s_csrtranspose( magma_s_sparse_matrix A, magma_s_sparse_matrix *B ){
 
-    if( A.storage_type != Magma_CSR ){
+    if( A.memory_location != Magma_CPU ){
+        magma_s_sparse_matrix C, D;
+        magma_s_mtransfer( A, &C, A.memory_location, Magma_CPU );
+        magma_s_csrtranspose( C, &D );
+        magma_s_mtransfer( D, B, Magma_CPU, A.memory_location );
+        magma_s_mfree( &C );
+        magma_s_mfree( &D );
+        return MAGMA_SUCCESS;
+    }
+    else if( A.storage_type != Magma_CSR ){
         magma_s_sparse_matrix ACSR, BCSR;
         magma_s_mconvert( A, &ACSR, A.storage_type, Magma_CSR );
-        magma_s_cucsrtranspose( ACSR, &BCSR );
-        magma_s_mconvert( BCSR, B, Magma_CSR, A.storage_type );
-        
+        magma_s_csrtranspose( ACSR, &BCSR );
+
+        if( A.storage_type == Magma_CSRL )
+            B->storage_type = Magma_CSRU;
+        else if( A.storage_type == Magma_CSRU )
+            B->storage_type = Magma_CSRL;
+        else
+            B->storage_type = A.storage_type;
+
+        magma_s_mconvert( BCSR, B, Magma_CSR, B->storage_type );
+        magma_s_mfree( &ACSR );
+        magma_s_mfree( &BCSR );
         return MAGMA_SUCCESS;
     }
     else{
 
-        magma_int_t i, j, new_nnz=0, lrow;
-
         // fill in information for B
         B->storage_type = Magma_CSR;
         B->memory_location = A.memory_location;
-        B->num_rows = A.num_rows;
-        B->num_cols = A.num_cols;
+        B->num_rows = A.num_cols;
+        B->num_cols = A.num_rows;
         B->nnz = A.nnz;
-        B->max_nnz_row = A.max_nnz_row;
         B->diameter = A.diameter;
 
         magma_smalloc_cpu( &B->val, A.nnz );
-        magma_index_malloc_cpu( &B->row, A.num_rows+1 );
+        magma_index_malloc_cpu( &B->row, A.num_cols+1 );
         magma_index_malloc_cpu( &B->col, A.nnz );
 
-        for( magma_int_t i=0; i<A.nnz; i++){
-            B->val[i] = A.val[i];
-            B->col[i] = A.col[i];
-        }
-        for( magma_int_t i=0; i<A.num_rows+1; i++){
-            B->row[i] = A.row[i];
-        }
-        for( lrow = 0; lrow < A.num_rows; lrow++ ){
-            B->row[lrow] = new_nnz;
-            for( i=0; i<A.num_rows; i++ ){
-                for( j=A.row[i]; j<A.row[i+1]; j++ ){
-                    if( A.col[j] == lrow ){
-                        B->val[ new_nnz ] = A.val[ j ];
-                        B->col[ new_nnz ] = i;
-                        new_nnz++; 
-                    }
-                }
-            }
-        }
-        B->row[ B->num_rows ] = new_nnz;
+        magma_s_csrtranspose_cpu( A.num_rows, A.num_cols, A.val, A.row, A.col,
+                                  B->val, B->row, B->col );
 
-        return MAGMA_SUCCESS;
+        B->max_nnz_row = 0;
+        for( magma_int_t i=0; i<B->num_rows; i++ )
+            B->max_nnz_row = max( B->max_nnz_row,
+                                  (magma_int_t) (B->row[i+1] - B->row[i]) );
 
+        return MAGMA_SUCCESS;
     }
-    return MAGMA_SUCCESS; 
+    return MAGMA_SUCCESS;
 }
 
 
@@ -15,11 +15,17 @@
 #include <iostream>
 #include <ostream>
 #include <assert.h>
+#include <limits>
 #include <stdio.h>
 
 #include "magmasparse_z.h"
 #include "magma.h"
 #include "mmio.h"
+#include "magmasparse_internal.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 using namespace std;
@@ -124,112 +130,491 @@ magma_zmgenerator(  magma_int_t n,
 
 
 
+// ---------------------------------------------
+// Neighbours of a grid point in a stencil: offsets off[3*k..3*k+2] =
+// (dx, dy, dz), in the order of their columns, and values. The value for a
+// neighbour is minus the product of the coefficients of the directions in
+// which it is displaced; the diagonal is the sum of all off-diagonal
+// magnitudes. Returns the number of points including the diagonal, or 0
+// if the stencil is not supported.
+static magma_int_t
+z_stencil_points( magma_int_t points, double ax, double ay, double az,
+                  magma_int_t *off, magmaDoubleComplex *vals )
+{
+    magma_int_t k = 0, kdiag = 0, dx, dy, dz, dist;
+    double w, diag = 0.;
+    bool use;
+    for( dz=-1; dz <= 1; dz++ ){
+    for( dy=-1; dy <= 1; dy++ ){
+    for( dx=-1; dx <= 1; dx++ ){
+        dist = (dx != 0) + (dy != 0) + (dz != 0);
+        switch( points ){
+            case 5:  use = ( dz == 0 && dist <= 1 ); break;
+            case 9:  use = ( dz == 0 ); break;
+            case 7:  use = ( dist <= 1 ); break;
+            case 19: use = ( dist <= 2 ); break;
+            case 27: use = true; break;
+            default: return 0;
+        }
+        if( !use )
+            continue;
+        off[3*k] = dx;
+        off[3*k+1] = dy;
+        off[3*k+2] = dz;
+        if( dist == 0 )
+            kdiag = k;
+        else {
+            w = ( dx ? ax : 1. ) * ( dy ? ay : 1. ) * ( dz ? az : 1. );
+            vals[k] = MAGMA_Z_MAKE( -w, 0. );
+            diag += w;
+        }
+        k++;
+    }
+    }
+    }
+    vals[kdiag] = MAGMA_Z_MAKE( diag, 0. );
+    return k;
+}
+
+
+// ---------------------------------------------
+// Writes the row of grid point (x, y, z) to col[j*stride], val[j*stride]
+// and returns its length; only counts if col is NULL.
+static magma_int_t
+z_stencil_row( magma_int_t nx, magma_int_t ny, magma_int_t nz,
+               magma_int_t x, magma_int_t y, magma_int_t z,
+               magma_int_t npoints, const magma_int_t *off,
+               const magmaDoubleComplex *vals,
+               magma_index_t *col, magmaDoubleComplex *val, magma_int_t stride )
+{
+    magma_int_t k, j = 0;
+    magma_index_t row = (z*ny + y)*nx + x;
+    for( k=0; k < npoints; k++ ){
+        magma_int_t dx = off[3*k], dy = off[3*k+1], dz = off[3*k+2];
+        if( x+dx < 0 || x+dx >= nx || y+dy < 0 || y+dy >= ny
+                                   || z+dz < 0 || z+dz >= nz )
+            continue;
+        if( col != NULL ){
+            col[j*stride] = row + (dz*ny + dy)*nx + dx;
+            val[j*stride] = vals[k];
+        }
+        j++;
+    }
+    return j;
+}
+
+
+// ---------------------------------------------
+// Builds the matrix of the stencil given by its points in the given
+// storage format, see magma_zm_stencil.
+static magma_int_t
+z_stencil_build( magma_int_t nx, magma_int_t ny, magma_int_t nz,
+                 magma_int_t npoints, const magma_int_t *off,
+                 const magmaDoubleComplex *vals,
+                 magma_storage_t storage, magma_z_sparse_matrix *A )
+{
+    size_t n = (size_t) nx * ny * nz;
+    if( n > (size_t) std::numeric_limits<magma_index_t>::max() ){
+        printf("error: %lu rows exceed the index range.\n", (unsigned long) n );
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+
+    // other formats are converted from CSR
+    if( storage != Magma_CSR && storage != Magma_SELLC
+                             && storage != Magma_SELLP ){
+        magma_z_sparse_matrix hA;
+        magma_int_t info = z_stencil_build( nx, ny, nz, npoints, off, vals,
+                                            Magma_CSR, &hA );
+        if( info != MAGMA_SUCCESS )
+            return info;
+        info = magma_z_mconvert( hA, A, Magma_CSR, storage );
+        magma_z_mfree( &hA );
+        return info;
+    }
+
+    // CSR is SELL-C with slices of one row and alignment 1
+    magma_int_t C = 1, alignment = 1;
+    if( storage != Magma_CSR ){
+        C = max( A->blocksize, (magma_int_t) 1 );
+        alignment = max( A->alignment, (magma_int_t) 1 );
+    }
+    magma_int_t slices = ( n + C - 1 ) / C;
+
+    magma_int_t nthread = 1;
+#ifdef _OPENMP
+    if ( n >= MAGMA_SPARSE_OMP_THRESHOLD )
+        nthread = omp_get_max_threads();
+#endif
+
+    A->storage_type = storage;
+    if( storage != Magma_CSR && alignment > 1 )
+        A->storage_type = Magma_SELLP;
+    A->memory_location = Magma_CPU;
+    A->sym = Magma_SYMMETRIC;
+    A->num_rows = n;
+    A->num_cols = n;
+    A->val = NULL;
+    A->col = NULL;
+    magma_index_malloc_cpu( &A->row, slices+1 );
+    if( storage != Magma_CSR ){
+        A->blocksize = C;
+        A->alignment = alignment;
+        A->numblocks = slices;
+    }
+
+    // the farthest neighbour that exists for some point
+    A->diameter = 0;
+    for( magma_int_t k=0; k < npoints; k++ ){
+        if( ( off[3*k]   == 0 || nx > 1 ) && ( off[3*k+1] == 0 || ny > 1 )
+                                          && ( off[3*k+2] == 0 || nz > 1 ) ){
+            magma_int_t d = (off[3*k+2]*ny + off[3*k+1])*nx + off[3*k];
+            A->diameter = max( A->diameter, (d < 0 ? -d : d) );
+        }
+    }
+
+    // part[t+1] is first the number of entries in the slices of thread t,
+    // then the offset of its slices; width[t] the widest of its slices
+    size_t *part;
+    magma_index_t *width;
+    magma_malloc_cpu( (void**) &part, (nthread+1)*sizeof(size_t) );
+    magma_index_malloc_cpu( &width, nthread );
+    bool overflow = false;
+
+#ifdef _OPENMP
+    #pragma omp parallel num_threads( nthread )
+#endif
+    {
+#ifdef _OPENMP
+        magma_int_t id  = omp_get_thread_num();
+        magma_int_t tot = omp_get_num_threads();
+#else
+        magma_int_t id  = 0;
+        magma_int_t tot = 1;
+#endif
+        // slices [sb, se)
+        magma_int_t sb = ((size_t) slices * id) / tot;
+        magma_int_t se = ((size_t) slices * (id+1)) / tot;
+        magma_int_t i, j, k, x, y, z, len, w;
+        size_t sum = 0;
+
+        // 1. width of my slices: the longest row, padded to the alignment
+        width[id] = 0;
+        x = (sb*C) % nx;
+        y = ((sb*C) / nx) % ny;
+        z = (sb*C) / ((size_t) nx*ny);
+        for( i=sb; i < se; i++ ){
+            w = 0;
+            for( j=0; j < C && (size_t) i*C+j < n; j++ ){
+                len = z_stencil_row( nx, ny, nz, x, y, z, npoints, off, vals,
+                                     NULL, NULL, 0 );
+                w = max( w, len );
+                if( ++x == nx ){
+                    x = 0;
+                    if( ++y == ny ){
+                        y = 0;
+                        z++;
+                    }
+                }
+            }
+            w = ( (w + alignment - 1) / alignment ) * alignment;
+            width[id] = max( width[id], w );
+            A->row[i+1] = w*C;
+            sum += (size_t) w*C;
+        }
+        part[id+1] = sum;
+#ifdef _OPENMP
+        #pragma omp barrier
+        #pragma omp single
+#endif
+        {
+            part[0] = 0;
+            for( k=0; k < tot; k++ )
+                part[k+1] += part[k];
+            A->row[0] = 0;
+            A->max_nnz_row = 0;
+            for( k=0; k < tot; k++ )
+                A->max_nnz_row = max( A->max_nnz_row, (magma_int_t) width[k] );
+            if( part[tot] > (size_t) std::numeric_limits<magma_index_t>::max() )
+                overflow = true;
+            else {
+                magma_zmalloc_cpu( &A->val, part[tot] );
+                magma_index_malloc_cpu( &A->col, part[tot] );
+            }
+        }
+
+        // 2. fill my slices, padding with explicit zeros
+        if( !overflow ){
+            size_t start = part[id];
+            x = (sb*C) % nx;
+            y = ((sb*C) / nx) % ny;
+            z = (sb*C) / ((size_t) nx*ny);
+            for( i=sb; i < se; i++ ){
+                w = A->row[i+1] / C;
+                for( j=0; j < C; j++ ){
+                    len = 0;
+                    if( (size_t) i*C+j < n ){
+                        len = z_stencil_row( nx, ny, nz, x, y, z, npoints, off,
+                                  vals, A->col + start + j, A->val + start + j, C );
+                        if( ++x == nx ){
+                            x = 0;
+                            if( ++y == ny ){
+                                y = 0;
+                                z++;
+                            }
+                        }
+                    }
+                    for( k=len; k < w; k++ ){
+                        A->col[ start + j + k*C ] = 0;
+                        A->val[ start + j + k*C ] = MAGMA_Z_ZERO;
+                    }
+                }
+                start += (size_t) w*C;
+                A->row[i+1] = start;
+            }
+        }
+    }
+
+    magma_free_cpu( part );
+    magma_free_cpu( width );
+
+    if( overflow ){
+        printf("error: the matrix exceeds the index range.\n");
+        magma_free_cpu( A->row );
+        A->row = NULL;
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+    A->nnz = A->row[slices];
+
+    return MAGMA_SUCCESS;
+}
+
+
+
+
 /**
     Purpose
     -------
 
-    Generate a 27-point stencil for a 3D FD discretization.
+    Generate the matrix of a 2D or 3D stencil on a regular nx x ny x nz
+    grid with Dirichlet boundary, with the points numbered x fastest.
+    Supported stencils are the 2D 5-point and 9-point stencils, which
+    couple each z-plane only within itself, and the 3D 7-point,
+    19-point (no corners) and 27-point stencils.
+
+    The off-diagonal entry for a neighbour is minus the product of the
+    coefficients ax, ay, az of the directions in which it is displaced,
+    so ax = ay = az = 1 gives the usual -1 entries, and for example
+    az = 0.01 a problem with weak coupling in z. The diagonal is the sum
+    of the magnitudes of the off-diagonal entries of an interior row, so
+    the matrix is symmetric positive definite for positive coefficients.
+
+    The matrix is written directly in the requested format, without an
+    intermediate: the length of each row is known from the position of
+    its grid point, so the threads count their rows, the offsets follow
+    from a prefix sum, and each thread fills its own rows, which also
+    places them in its memory. The columns of each row are sorted.
+    For Magma_SELLC and Magma_SELLP, A->blocksize and A->alignment have
+    to be set on input, as for magma_z_mconvert; other formats are
+    generated in CSR and converted.
+
+    For Magma_STENCIL, the matrix is not generated but described by the
+    stencil: A->row holds nx, ny, nz, A->col the offsets (dx, dy, dz) of
+    the A->max_nnz_row points of the stencil in the order of their columns,
+    and A->val their values. A->nnz is the number of nonzeros of the
+    matrix. magma_z_spmv and the Jacobi preconditioner apply it directly
+    on the grid; magma_z_mconvert generates the matrix in other formats.
 
     Arguments
     ---------
 
     @param
-    n           magma_int_t
-                number of rows
+    points      magma_int_t
+                stencil: 5, 9, 7, 19, or 27
+
+    @param
+    nx          magma_int_t
+                grid points in x
+
+    @param
+    ny          magma_int_t
+                grid points in y
+
+    @param
+    nz          magma_int_t
+                grid points in z, 1 for 2D problems
+
+    @param
+    ax          double
+                coefficient of the coupling in x
+
+    @param
+    ay          double
+                coefficient of the coupling in y
+
+    @param
+    az          double
+                coefficient of the coupling in z
+
+    @param
+    storage     magma_storage_t
+                storage format of the matrix
 
     @param
     A           magma_z_sparse_matrix*
-                matrix to generate   
+                matrix to generate on the CPU
 
     @ingroup magmasparse_zaux
     ********************************************************************/
 
 extern "C"
 magma_int_t
-magma_zm_27stencil(  magma_int_t n,
-                     magma_z_sparse_matrix *A ){
+magma_zm_stencil(   magma_int_t points,
+                    magma_int_t nx,
+                    magma_int_t ny,
+                    magma_int_t nz,
+                    double ax,
+                    double ay,
+                    double az,
+                    magma_storage_t storage,
+                    magma_z_sparse_matrix *A ){
+
+    magma_int_t off[3*27];
+    magmaDoubleComplex vals[27];
+    magma_int_t npoints = z_stencil_points( points, ax, ay, az, off, vals );
+    if( npoints == 0 || nx < 1 || ny < 1 || nz < 1 ){
+        printf("error: %d-point stencil on a %d x %d x %d grid not supported.\n",
+               (int) points, (int) nx, (int) ny, (int) nz );
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+    if( storage != Magma_STENCIL )
+        return z_stencil_build( nx, ny, nz, npoints, off, vals, storage, A );
 
-    magma_int_t i,j,k;
-    magma_z_sparse_matrix hA;
-    
-    // generate matrix of desired structure and size (3d 27-point stencil)
-    magma_int_t nn = n*n*n;
-    magma_int_t offdiags = 13;
-    magma_index_t *diag_offset;
-    magmaDoubleComplex *diag_vals;
-    magma_zmalloc_cpu( &diag_vals, offdiags+1 );
-    magma_index_malloc_cpu( &diag_offset, offdiags+1 );
-    diag_offset[0] = 0;
-    diag_offset[1] = 1;
-    diag_offset[2] = n-1;
-    diag_offset[3] = n;
-    diag_offset[4] = n+1;
-    diag_offset[5] = n*n-n-1;
-    diag_offset[6] = n*n-n;
-    diag_offset[7] = n*n-n+1;
-    diag_offset[8] = n*n-1;
-    diag_offset[9] = n*n;
-    diag_offset[10] = n*n+1;
-    diag_offset[11] = n*n+n-1;
-    diag_offset[12] = n*n+n;
-    diag_offset[13] = n*n+n+1;
-
-    diag_vals[0] = MAGMA_Z_MAKE( 26.0, 0.0 );
-    diag_vals[1] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[2] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[3] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[4] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[5] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[6] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[7] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[8] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[9] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[10] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[11] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[12] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[13] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    magma_zmgenerator( nn, offdiags, diag_offset, diag_vals, &hA );
-
-
-    // now set some entries to zero (boundary...)
-    for( i=0; i<n*n; i++ ){
-    for( j=0; j<n; j++ ){
-        magma_index_t row = i*n+j;
-        magma_index_t l_bound = i*n;
-        magma_index_t u_bound = (i+1)*n;
-        for( k=hA.row[row]; k<hA.row[row+1]; k++){
-
-            if((hA.col[k] == row-1 ||
-                hA.col[k] == row-n-1 ||
-                hA.col[k] == row+n-1 ||
-                hA.col[k] == row-n*n+n-1 ||
-                hA.col[k] == row+n*n-n-1 ||
-                hA.col[k] == row-n*n-1 ||
-                hA.col[k] == row+n*n-1 ||
-                hA.col[k] == row-n*n-n-1 ||
-                hA.col[k] == row+n*n+n-1 ) && (row+1)%n == 1 )
-                    
-                    hA.val[k] = MAGMA_Z_MAKE( 0.0, 0.0 );
-
-            if((hA.col[k] == row+1 ||
-                hA.col[k] == row-n+1 ||
-                hA.col[k] == row+n+1 ||
-                hA.col[k] == row-n*n+n+1 ||
-                hA.col[k] == row+n*n-n+1 ||
-                hA.col[k] == row-n*n+1 ||
-                hA.col[k] == row+n*n+1 ||
-                hA.col[k] == row-n*n-n+1 ||
-                hA.col[k] == row+n*n+n+1 ) && (row)%n ==n-1 )
-                    
-                    hA.val[k] = MAGMA_Z_MAKE( 0.0, 0.0 );
+    size_t n = (size_t) nx * ny * nz;
+    if( n > (size_t) std::numeric_limits<magma_index_t>::max() ){
+        printf("error: %lu rows exceed the index range.\n", (unsigned long) n );
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+    A->storage_type = Magma_STENCIL;
+    A->memory_location = Magma_CPU;
+    A->sym = Magma_SYMMETRIC;
+    A->num_rows = n;
+    A->num_cols = n;
+    A->max_nnz_row = npoints;
+    magma_index_malloc_cpu( &A->row, 3 );
+    magma_index_malloc_cpu( &A->col, 3*npoints );
+    magma_zmalloc_cpu( &A->val, npoints );
+    A->row[0] = nx;
+    A->row[1] = ny;
+    A->row[2] = nz;
+
+    // a point with offset (dx, dy, dz) couples (nx-|dx|) (ny-|dy|) (nz-|dz|)
+    // pairs of grid points; the sum is checked against the index range
+    // before it is stored, as in the generated formats
+    size_t nnz = 0;
+    A->diameter = 0;
+    for( magma_int_t k=0; k < npoints; k++ ){
+        magma_int_t dx = off[3*k], dy = off[3*k+1], dz = off[3*k+2];
+        A->col[3*k]   = dx;
+        A->col[3*k+1] = dy;
+        A->col[3*k+2] = dz;
+        A->val[k] = vals[k];
+        size_t cnt = (size_t) max( nx - abs( dx ), 0 ) * max( ny - abs( dy ), 0 )
+                                                       * max( nz - abs( dz ), 0 );
+        if( cnt > 0 ){
+            magma_int_t d = (dz*ny + dy)*nx + dx;
+            A->diameter = max( A->diameter, (d < 0 ? -d : d) );
         }
-        
+        nnz += cnt;
     }
+    if( nnz > (size_t) std::numeric_limits<magma_index_t>::max() ){
+        printf("error: the matrix exceeds the index range.\n");
+        magma_free_cpu( A->row );
+        magma_free_cpu( A->col );
+        magma_free_cpu( A->val );
+        A->row = NULL;
+        A->col = NULL;
+        A->val = NULL;
+        return MAGMA_ERR_NOT_SUPPORTED;
     }
-    magma_z_mconvert( hA, A, Magma_CSR, Magma_CSR );
-    magma_z_mfree( &hA );
+    A->nnz = nnz;
 
     return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Generates the matrix described by a matrix-free stencil A
+    (Magma_STENCIL, see magma_zm_stencil) in another storage format.
+    For Magma_SELLC and Magma_SELLP, B->blocksize and B->alignment have
+    to be set on input.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_z_sparse_matrix
+                stencil on the CPU
+
+    @param
+    storage     magma_storage_t
+                storage format of B
+
+    @param
+    B           magma_z_sparse_matrix*
+                generated matrix on the CPU
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_zm_stencil_expand( magma_z_sparse_matrix A,
+                         magma_storage_t storage,
+                         magma_z_sparse_matrix *B ){
+
+    magma_int_t off[3*27];
+    if( A.storage_type != Magma_STENCIL || A.memory_location != Magma_CPU
+                                        || A.max_nnz_row > 27 ){
+        printf("error: stencil on the CPU expected.\n");
+        return MAGMA_ERR_NOT_SUPPORTED;
+    }
+    for( magma_int_t k=0; k < 3*A.max_nnz_row; k++ )
+        off[k] = A.col[k];
+    return z_stencil_build( A.row[0], A.row[1], A.row[2], A.max_nnz_row,
+                            off, A.val, storage, B );
+}
+
+
+/**
+    Purpose
+    -------
+
+    Generate a 27-point stencil for a 3D FD discretization
+    on an n x n x n grid, in CSR.
+
+    Arguments
+    ---------
+
+    @param
+    n           magma_int_t
+                number of grid points in each direction
+
+    @param
+    A           magma_z_sparse_matrix*
+                matrix to generate   
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t
+magma_zm_27stencil(  magma_int_t n,
+                     magma_z_sparse_matrix *A ){
+
+    return magma_zm_stencil( 27, n, n, n, 1., 1., 1., Magma_CSR, A );
 }   
 
 
@@ -238,14 +623,15 @@ magma_zm_27stencil(  magma_int_t n,
     Purpose
     -------
 
-    Generate a 5-point stencil for a 2D FD discretization.
+    Generate a 5-point stencil for a 2D FD discretization
+    on an n x n grid, in CSR.
 
     Arguments
     ---------
 
     @param
     n           magma_int_t
-                number of rows
+                number of grid points in each direction
 
     @param
     A           magma_z_sparse_matrix*
@@ -259,48 +645,5 @@ magma_int_t
 magma_zm_5stencil(  magma_int_t n,
                     magma_z_sparse_matrix *A ){
 
-    magma_int_t i,j,k;
-    magma_z_sparse_matrix hA;
-    
-    // generate matrix of desired structure and size (2d 5-point stencil)
-    magma_int_t nn = n*n;
-    magma_int_t offdiags = 2;
-    magma_index_t *diag_offset;
-    magmaDoubleComplex *diag_vals;
-    magma_zmalloc_cpu( &diag_vals, offdiags+1 );
-    magma_index_malloc_cpu( &diag_offset, offdiags+1 );
-    diag_offset[0] = 0;
-    diag_offset[1] = 1;
-    diag_offset[2] = n;
-
-    diag_vals[0] = MAGMA_Z_MAKE( 4.0, 0.0 );
-    diag_vals[1] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    diag_vals[2] = MAGMA_Z_MAKE( -1.0, 0.0 );
-    magma_zmgenerator( nn, offdiags, diag_offset, diag_vals, &hA );
-
-    // now set some entries to zero (boundary...)
-    for( i=0; i<n; i++ ){
-    for( j=0; j<n; j++ ){
-        magma_index_t row = i*n+j;
-        magma_index_t l_bound = i*n;
-        magma_index_t u_bound = (i+1)*n;
-        for( k=hA.row[row]; k<hA.row[row+1]; k++){
-
-            if((hA.col[k] == row-1 ) && (row+1)%n == 1 )
-                    
-                    hA.val[k] = MAGMA_Z_MAKE( 0.0, 0.0 );
-
-            if((hA.col[k] == row+1 ) && (row)%n ==n-1 )
-                    
-                    hA.val[k] = MAGMA_Z_MAKE( 0.0, 0.0 );
-        }
-        
-    }
-    }
-
-    magma_z_mconvert( hA, A, Magma_CSR, Magma_CSR );
-    magma_z_mfree( &hA );
-
-    return MAGMA_SUCCESS;
+    return magma_zm_stencil( 5, n, n, 1, 1., 1., 1., Magma_CSR, A );
 }   
-
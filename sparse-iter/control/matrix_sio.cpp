@@ -12,6 +12,8 @@
 //  in this file, many routines are taken from 
 //  the IO functions provided by MatrixMarket
 
+#define PRECISION_s
+
 #include <fstream>
 #include <stdlib.h>
 #include <string>
@@ -20,21 +22,714 @@
 #include <ostream>
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if ! defined( _WIN32 ) && ! defined( _WIN64 )
+#include <sys/mman.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "magmasparse_s.h"
 #include "magma.h"
 #include "mmio.h"
+#include "magmasparse_internal.h"
 
 
 using namespace std;
 
+
+// ---------------------------------------------
+// Fast Matrix Market reader, shared by read_s_csr_from_mtx, magma_s_csr_mtx,
+// and magma_s_csr_mtxsymm.
+// The banner and size line are read with mmio; the entries are parsed
+// straight from the memory-mapped file (or, where mmap is not available,
+// from a copy read with fread) by the OpenMP threads, each taking a chunk
+// of the file that starts and ends at a line boundary.
+// Entries go directly into CSR without a COO copy: in a first pass each
+// thread parses just the indices and counts its entries per row; turning
+// the counts into offsets (as in magma_s_csrtranspose) gives each thread
+// its own slots in every row, so in the second pass, which parses the
+// values, threads place their entries without atomics. Rows keep the
+// file order, as before, then are sorted by column, and duplicate
+// entries are summed, by magma_s_csrsortmerge.
+
+// Powers of ten that are exact in float precision.
+static const real_Double_t mtx_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline int
+mtx_is_space( char c )
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Parses a positive integer at p; returns the character after it,
+// or NULL if there is none or it is too long.
+static inline const char*
+mtx_parse_index( const char *p, const char *end, size_t *v )
+{
+    size_t x = 0;
+    if( p < end && *p == '+' )
+        p++;
+    const char *start = p;
+    while( p < end && *p >= '0' && *p <= '9' && p - start < 18 ){
+        x = 10*x + (*p - '0');
+        p++;
+    }
+    if( p == start || (p < end && ! mtx_is_space( *p )) )
+        return NULL;
+    *v = x;
+    return p;
+}
+
+// Parses a floating point number at p; returns the character after it,
+// or NULL if it is not a number.
+// Numbers with at most 19 significant digits and a power of ten of at
+// most 22 are computed as mantissa * 10^e or mantissa / 10^-e, which is
+// correctly rounded when the mantissa is below 2^53 (Clinger's fast path);
+// all others are passed to strtod, so results match fscanf( "%lf" ).
+static inline const char*
+mtx_parse_double( const char *p, const char *end, real_Double_t *v )
+{
+    const char *start = p;
+    unsigned long long mant = 0;
+    int ndigit = 0, exp10 = 0, neg = 0, any = 0;
+
+    if( p < end && (*p == '-' || *p == '+') ){
+        neg = (*p == '-');
+        p++;
+    }
+    while( p < end && *p >= '0' && *p <= '9' ){
+        if( mant != 0 || *p != '0' ){
+            if( ndigit < 19 )
+                mant = 10*mant + (*p - '0');
+            else
+                exp10++;
+            ndigit++;
+        }
+        any = 1;
+        p++;
+    }
+    if( p < end && *p == '.' ){
+        p++;
+        while( p < end && *p >= '0' && *p <= '9' ){
+            if( mant != 0 || *p != '0' ){
+                if( ndigit < 19 ){
+                    mant = 10*mant + (*p - '0');
+                    exp10--;
+                }
+                ndigit++;
+            }
+            else {
+                exp10--;
+            }
+            any = 1;
+            p++;
+        }
+    }
+    if( any && p < end && (*p == 'e' || *p == 'E') ){
+        const char *q = p + 1;
+        int eneg = 0, e = 0, edigit = 0;
+        if( q < end && (*q == '-' || *q == '+') ){
+            eneg = (*q == '-');
+            q++;
+        }
+        while( q < end && *q >= '0' && *q <= '9' ){
+            if( e < 100000 )
+                e = 10*e + (*q - '0');
+            edigit++;
+            q++;
+        }
+        if( edigit > 0 ){
+            exp10 += (eneg ? -e : e);
+            p = q;
+        }
+    }
+
+    if( any && (p == end || mtx_is_space( *p ))
+        && ndigit <= 19 && mant < (1ULL << 53) && exp10 >= -22 && exp10 <= 22 ){
+        real_Double_t x = (real_Double_t) mant;
+        if( exp10 < 0 )
+            x /= mtx_pow10[ -exp10 ];
+        else
+            x *= mtx_pow10[ exp10 ];
+        *v = (neg ? -x : x);
+        return p;
+    }
+
+    // slow path: strtod on a nul-terminated copy, as the file isn't terminated
+    char buf[128];
+    p = start;
+    size_t len = 0;
+    while( p < end && ! mtx_is_space( *p ) && len < sizeof(buf)-1 ){
+        buf[len++] = *p++;
+    }
+    buf[len] = '\0';
+    char *last;
+    *v = strtod( buf, &last );
+    if( len == 0 || last != buf + len || (p < end && ! mtx_is_space( *p )) )
+        return NULL;
+    return p;
+}
+
+// Parses one line [p, end) of entries.
+// Returns 0 for blank and comment lines, 1 for an entry, -1 on errors.
+static inline int
+mtx_parse_line( const char *p, const char *end, int pattern, int values,
+                size_t *r, size_t *c, real_Double_t *v )
+{
+    while( p < end && mtx_is_space( *p ))
+        p++;
+    if( p == end || *p == '%' )
+        return 0;
+    if( (p = mtx_parse_index( p, end, r )) == NULL )
+        return -1;
+    while( p < end && mtx_is_space( *p ))
+        p++;
+    if( (p = mtx_parse_index( p, end, c )) == NULL )
+        return -1;
+    if( pattern ){
+        *v = 1.;
+    }
+    else if( values ){
+        while( p < end && mtx_is_space( *p ))
+            p++;
+        if( mtx_parse_double( p, end, v ) == NULL )
+            return -1;
+    }
+    return 1;
+}
+
+// Returns the start of the id-th of tot chunks of [begin, end),
+// moved forward to the start of a line.
+static const char*
+mtx_chunk( const char *begin, const char *end, magma_int_t id, magma_int_t tot )
+{
+    if( id <= 0 )
+        return begin;
+    if( id >= tot )
+        return end;
+    const char *p = begin + ((size_t) (end - begin) * id) / tot;
+    if( p[-1] != '\n' ){
+        p = (const char*) memchr( p, '\n', end - p );
+        p = (p == NULL ? end : p + 1);
+    }
+    return p;
+}
+
+// Reads the Matrix Market file into CSR arrays allocated with
+// magma_smalloc_cpu and magma_index_malloc_cpu, with columns sorted in each row
+// and duplicate entries summed.
+// Pattern matrices get ones as values.
+// If expand is set, symmetric matrices get both off-diagonal entries.
+// Sets symmetric if the file is symmetric, and has_zero if it stores zeros.
+static void
+s_read_mtx( const char *filename, int expand,
+            magma_int_t *n_row, magma_int_t *n_col, magma_int_t *nnz,
+            float **val, magma_index_t **row, magma_index_t **col,
+            int *symmetric, int *has_zero )
+{
+  FILE *fid;
+  MM_typecode matcode;
+
+  fid = fopen(filename, "r");
+
+  if (fid == NULL) {
+    printf("#Unable to open file %s\n", filename);
+    exit(1);
+  }
+
+  if (mm_read_banner(fid, &matcode) != 0) {
+    printf("#Could not process lMatrix Market banner.\n");
+    exit(1);
+  }
+
+  if (!mm_is_valid(matcode)) {
+    printf("#Invalid lMatrix Market file.\n");
+    exit(1);
+  }
+
+  if (!((mm_is_real(matcode) || mm_is_integer(matcode)
+        || mm_is_pattern(matcode)) && mm_is_coordinate(matcode)
+            && mm_is_sparse(matcode))) {
+    printf("#Sorry, this application does not support ");
+    printf("#Market Market type: [%s]\n", mm_typecode_to_str(matcode));
+    printf("#Only real-valued or pattern coordinate matrices are supported\n");
+    exit(1);
+  }
+
+  magma_index_t num_rows, num_cols, num_nonzeros;
+  if (mm_read_mtx_crd_size(fid,&num_rows,&num_cols,&num_nonzeros) !=0)
+    exit(1);
+
+  printf("# Reading sparse matrix from file (%s):",filename);
+  fflush(stdout);
+
+  // map the entries, after the size line
+  long offset = ftell( fid );
+  fseek( fid, 0, SEEK_END );
+  size_t file_size = ftell( fid );
+  char *buf = NULL;
+  int mapped = 0;
+#if ! defined( _WIN32 ) && ! defined( _WIN64 )
+  if( file_size > 0 ){
+      buf = (char*) mmap( NULL, file_size, PROT_READ, MAP_PRIVATE, fileno( fid ), 0 );
+      if( buf == MAP_FAILED ){
+          buf = NULL;
+      }
+      else {
+          mapped = 1;
+          madvise( buf, file_size, MADV_WILLNEED );
+      }
+  }
+#endif
+  if( ! mapped ){
+      buf = (char*) malloc( file_size + 1 );
+      assert( buf != NULL );
+      fseek( fid, 0, SEEK_SET );
+      if( fread( buf, 1, file_size, fid ) != file_size ){
+          printf("#Unable to read file %s\n", filename);
+          exit(1);
+      }
+  }
+  const char *begin = buf + offset;
+  const char *end   = buf + file_size;
+
+  int pattern = mm_is_pattern( matcode );
+  *symmetric  = mm_is_symmetric( matcode );
+  expand      = expand && *symmetric;
+
+  magma_int_t nthread = 1;
+#ifdef _OPENMP
+  if ( num_nonzeros >= MAGMA_SPARSE_OMP_THRESHOLD ) {
+      // 2*num_nonzeros overflows magma_index_t for large files
+      size_t per_row = 2*(size_t) num_nonzeros / max( num_rows, 1 );
+      nthread = (magma_int_t) min( (size_t) omp_get_max_threads(),
+                                   max( (size_t) 1, per_row ));
+  }
+#endif
+
+  // cnt[ t*num_rows + r ] is first the number of thread t's entries in row r,
+  // then the offset of thread t's first entry within row r.
+  // part[t] is the offset of the first entry in thread t's range of rows.
+  magma_index_t *cnt, *part, *nent, *nerr, *nzero;
+  magma_index_malloc_cpu( &cnt, (size_t) nthread*num_rows );
+  magma_index_malloc_cpu( &part, nthread+1 );
+  magma_index_malloc_cpu( &nent, nthread );
+  magma_index_malloc_cpu( &nerr, nthread );
+  magma_index_malloc_cpu( &nzero, nthread );
+  magma_index_malloc_cpu( row, num_rows+1 );
+  memset( nzero, 0, nthread*sizeof(magma_index_t) );
+  memset( nerr, 0, nthread*sizeof(magma_index_t) );
+  int failed = 0;
+
+#ifdef _OPENMP
+  #pragma omp parallel num_threads( nthread )
+#endif
+  {
+#ifdef _OPENMP
+      magma_int_t id  = omp_get_thread_num();
+      magma_int_t tot = omp_get_num_threads();
+#else
+      magma_int_t id  = 0;
+      magma_int_t tot = 1;
+#endif
+      const char *cb = mtx_chunk( begin, end, id,   tot );
+      const char *ce = mtx_chunk( begin, end, id+1, tot );
+      magma_index_t *mycnt = cnt + (size_t) id*num_rows;
+      const char *p, *le;
+      size_t r, c;
+      real_Double_t v;
+      magma_int_t i, t;
+
+      // 1. count my entries per row, checking the indices and values
+      for( i=0; i < num_rows; i++ )
+          mycnt[i] = 0;
+      nent[id] = 0;
+      nerr[id] = 0;
+      for( p = cb; p < ce; p = le + 1 ){
+          le = (const char*) memchr( p, '\n', ce - p );
+          if( le == NULL )
+              le = ce;
+          int ok = mtx_parse_line( p, le, pattern, 1, &r, &c, &v );
+          if( ok == 0 )
+              continue;
+          if( ok < 0 || r < 1 || r > (size_t) num_rows || c < 1 || c > (size_t) num_cols
+              || (expand && c > (size_t) num_rows) ){
+              nerr[id]++;
+              continue;
+          }
+          nent[id]++;
+          mycnt[r-1]++;
+          if( expand && r != c )
+              mycnt[c-1]++;
+      }
+#ifdef _OPENMP
+      #pragma omp barrier
+      #pragma omp single
+#endif
+      {
+          magma_int_t total = 0, errors = 0;
+          for( t=0; t < tot; t++ ){
+              total  += nent[t];
+              errors += nerr[t];
+          }
+          if( errors > 0 || total != num_nonzeros ){
+              printf("\n#Invalid entries in file %s: %d entries read, "
+                     "%d expected, %d invalid.\n",
+                     filename, (int) total, (int) num_nonzeros, (int) errors);
+              failed = 1;
+          }
+      }
+
+      if( ! failed ){
+          // 2. offsets of each thread within each row, and the row pointer
+          magma_sparse_bucket_offsets( cnt, num_rows, *row, part, id, tot );
+#ifdef _OPENMP
+          #pragma omp single
+#endif
+          {
+              magma_smalloc_cpu( val, part[tot] );
+              magma_index_malloc_cpu( col, part[tot] );
+          }
+
+          // 3. parse my entries again, with values, into their slots
+          for( p = cb; p < ce; p = le + 1 ){
+              le = (const char*) memchr( p, '\n', ce - p );
+              if( le == NULL )
+                  le = ce;
+              int ok = mtx_parse_line( p, le, pattern, 1, &r, &c, &v );
+              if( ok == 0 )
+                  continue;
+              if( ok < 0 ){
+                  // cannot happen after pass 1, but never leave a slot unset
+                  nerr[id]++;
+                  continue;
+              }
+              r--;
+              c--;
+              nzero[id] += (v == 0);
+              magma_index_t k = (*row)[r] + mycnt[r];
+              mycnt[r]++;
+              (*col)[k] = c;
+              (*val)[k] = MAGMA_S_MAKE( v, 0. );
+              if( expand && r != c ){
+                  k = (*row)[c] + mycnt[c];
+                  mycnt[c]++;
+                  (*col)[k] = r;
+                  (*val)[k] = MAGMA_S_MAKE( v, 0. );
+              }
+          }
+      }
+  }
+
+  for( magma_int_t t=0; t < nthread && ! failed; t++ ){
+    if( nerr[t] > 0 ){
+      printf("\n#Invalid entries in file %s.\n", filename);
+      failed = 1;
+    }
+  }
+  if( failed )
+    exit(1);
+
+  // 4. sort the rows by column and sum duplicate entries
+  magma_s_csrsortmerge( num_rows, *row, col, val, nnz );
+
+  *n_row = num_rows;
+  *n_col = num_cols;
+  *has_zero = 0;
+  for( magma_int_t t=0; t < nthread; t++ )
+    *has_zero |= (nzero[t] > 0);
+
+  magma_free_cpu( cnt );
+  magma_free_cpu( part );
+  magma_free_cpu( nent );
+  magma_free_cpu( nerr );
+  magma_free_cpu( nzero );
+#if ! defined( _WIN32 ) && ! defined( _WIN64 )
+  if( mapped )
+    munmap( buf, file_size );
+#endif
+  if( ! mapped )
+    free( buf );
+  fclose(fid);
+  printf(" done\n");
+}
+
+
+// ---------------------------------------------
+// Binary CSR files, written by write_s_csrtobinary and read by
+// magma_s_csr_binary and read_s_csr_from_binary.
+// A 128 byte header is followed by the row pointer, the column indices,
+// and the values, each starting at a multiple of S_BINARY_ALIGN bytes, so
+// the arrays are aligned when used in place from a mapping of the file.
+// All counts and offsets are 64 bit. Numbers are stored in the byte order
+// of the writing machine; on a machine with the other byte order, the
+// version does not match.
+// The data checksum covers the three sections including their zero
+// padding; the reader that maps the file checks only the header, as
+// checking the data would read the whole file.
+
+#if defined(PRECISION_z)
+#define S_BINARY_PRECISION 'z'
+#elif defined(PRECISION_c)
+#define S_BINARY_PRECISION 'c'
+#elif defined(PRECISION_d)
+#define S_BINARY_PRECISION 'd'
+#else
+#define S_BINARY_PRECISION 's'
+#endif
+
+#define S_BINARY_VERSION 1
+#define S_BINARY_ALIGN   64
+
+typedef struct {
+    char     magic[8];          // "MAGMACSR"
+    uint32_t version;           // S_BINARY_VERSION
+    uint32_t header_size;       // sizeof( s_binary_header )
+    uint32_t precision;         // 's', 'd', 'c', or 'z'
+    uint32_t storage_type;      // Magma_CSR
+    uint32_t index_size;        // sizeof( magma_index_t )
+    uint32_t value_size;        // size of one value
+    uint64_t num_rows;
+    uint64_t num_cols;
+    uint64_t nnz;
+    uint64_t max_nnz_row;
+    uint64_t row_offset;        // byte offsets of the sections
+    uint64_t col_offset;
+    uint64_t val_offset;
+    uint64_t file_size;
+    uint64_t data_checksum;
+    uint32_t sym;               // Magma_GENERAL or Magma_SYMMETRIC
+    uint32_t reserved32;
+    uint64_t reserved64;
+    uint64_t header_checksum;   // of the bytes before it
+} s_binary_header;
+
+static uint64_t
+s_binary_align( uint64_t n )
+{
+    return (n + S_BINARY_ALIGN - 1) / S_BINARY_ALIGN * S_BINARY_ALIGN;
+}
+
+// Sets the section offsets and the file size from the sizes in h.
+static void
+s_binary_layout( s_binary_header *h )
+{
+    h->row_offset = s_binary_align( sizeof( s_binary_header ));
+    h->col_offset = s_binary_align( h->row_offset
+                                    + (h->num_rows+1) * h->index_size );
+    h->val_offset = s_binary_align( h->col_offset + h->nnz * h->index_size );
+    h->file_size  = s_binary_align( h->val_offset + h->nnz * h->value_size );
+}
+
+// Adds the size bytes at p, which are the 64 bit words first, first+1, ...
+// of the checksummed range, to the sums a and b, which give the checksum
+// a ^ (b * 0x9e3779b97f4a7c15). A partial last word is padded with zeros.
+// p must be 8 byte aligned.
+static void
+s_binary_sum( const void *p, uint64_t size, uint64_t first,
+              uint64_t *a, uint64_t *b )
+{
+    const uint64_t *w = (const uint64_t*) p;
+    int64_t n = size / 8, i;
+    uint64_t sa = 0, sb = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for if( n >= MAGMA_SPARSE_OMP_THRESHOLD ) schedule( static ) reduction( +:sa,sb )
+#endif
+    for( i=0; i < n; i++ ){
+        sa += w[i];
+        sb += (first + i + 1) * w[i];
+    }
+    if( size % 8 != 0 ){
+        uint64_t t = 0;
+        memcpy( &t, w + n, size % 8 );
+        sa += t;
+        sb += (first + n + 1) * t;
+    }
+    *a += sa;
+    *b += sb;
+}
+
+static uint64_t
+s_binary_header_checksum( const s_binary_header *h )
+{
+    uint64_t a = 0, b = 0;
+    s_binary_sum( h, offsetof( s_binary_header, header_checksum ), 0, &a, &b );
+    return a ^ (b * 0x9e3779b97f4a7c15ULL);
+}
+
+static uint64_t
+s_binary_data_checksum( const s_binary_header *h, const magma_index_t *row,
+                        const magma_index_t *col, const float *val )
+{
+    uint64_t a = 0, b = 0;
+    s_binary_sum( row, (h->num_rows+1) * h->index_size, 0, &a, &b );
+    s_binary_sum( col, h->nnz * h->index_size,
+                  (h->col_offset - h->row_offset) / 8, &a, &b );
+    s_binary_sum( val, h->nnz * h->value_size,
+                  (h->val_offset - h->row_offset) / 8, &a, &b );
+    return a ^ (b * 0x9e3779b97f4a7c15ULL);
+}
+
+// Writes the size bytes at p, then zeros up to the multiple of S_BINARY_ALIGN.
+static int
+s_binary_write( FILE *fid, const void *p, uint64_t size )
+{
+    static const char zeros[ S_BINARY_ALIGN ] = { 0 };
+    uint64_t pad = s_binary_align( size ) - size;
+    return fwrite( p, 1, size, fid ) == size
+        && fwrite( zeros, 1, pad, fid ) == pad;
+}
+
+// Reads and checks the header of the binary file fid.
+static magma_int_t
+s_binary_read_header( FILE *fid, const char *filename, s_binary_header *h )
+{
+    s_binary_header e;
+    uint64_t file_size;
+    uint64_t index_max = ((uint64_t) 1 << (8*sizeof( magma_index_t ) - 1)) - 1;
+
+    fseek( fid, 0, SEEK_END );
+    file_size = ftell( fid );
+    fseek( fid, 0, SEEK_SET );
+    if( fread( h, sizeof( s_binary_header ), 1, fid ) != 1
+        || memcmp( h->magic, "MAGMACSR", 8 ) != 0 ){
+        printf("#%s is not a binary CSR file.\n", filename);
+        return MAGMA_ERR_ILLEGAL_VALUE;
+    }
+    if( h->version != S_BINARY_VERSION
+        || h->header_size != sizeof( s_binary_header )){
+        printf("#%s has version %u of the binary format, or another byte order;"
+               " expected version %d.\n", filename, h->version, S_BINARY_VERSION );
+        return MAGMA_ERR_ILLEGAL_VALUE;
+    }
+    if( h->header_checksum != s_binary_header_checksum( h )){
+        printf("#%s has a corrupted header.\n", filename);
+        return MAGMA_ERR_ILLEGAL_VALUE;
+    }
+    if( h->precision != S_BINARY_PRECISION
+        || h->value_size != sizeof( float )
+        || h->storage_type != Magma_CSR ){
+        printf("#%s stores a matrix in precision %c, expected %c.\n",
+               filename, (char) h->precision, S_BINARY_PRECISION );
+        return MAGMA_ERR_ILLEGAL_VALUE;
+    }
+    if( h->index_size != sizeof( magma_index_t )
+        || h->nnz >= index_max || h->num_rows >= index_max
+        || h->num_cols >= index_max ){
+        printf("#%s stores %u byte indices or is too large for %d byte indices.\n",
+               filename, h->index_size, (int) sizeof( magma_index_t ));
+        return MAGMA_ERR_ILLEGAL_VALUE;
+    }
+    e = *h;
+    s_binary_layout( &e );
+    if( e.row_offset != h->row_offset || e.col_offset != h->col_offset
+        || e.val_offset != h->val_offset || e.file_size != h->file_size
+        || file_size < h->file_size ){
+        printf("#%s is truncated or has a wrong layout.\n", filename);
+        return MAGMA_ERR_ILLEGAL_VALUE;
+    }
+    return MAGMA_SUCCESS;
+}
+
+// Mappings of binary files whose arrays CSR matrices use in place,
+// by row pointer.
+struct s_binary_map {
+    magma_index_t *row;
+    void *base;
+    size_t size;
+    s_binary_map *next;
+};
+static s_binary_map *s_binary_maps = NULL;
+
+// Reads the binary file into CSR arrays.
+// If map is set and mmap is available, the arrays point into a private,
+// copy-on-write mapping of the file. Otherwise they are allocated with
+// magma_smalloc_cpu and magma_index_malloc_cpu, and the data checksum
+// is checked.
+static magma_int_t
+s_read_binary( const char *filename, int map, s_binary_header *h,
+               float **val, magma_index_t **row, magma_index_t **col )
+{
+    magma_int_t info;
+    FILE *fid = fopen( filename, "rb" );
+    if( fid == NULL ){
+        printf("#Unable to open file %s.\n", filename);
+        return MAGMA_ERR_NOT_FOUND;
+    }
+    info = s_binary_read_header( fid, filename, h );
+    if( info != MAGMA_SUCCESS ){
+        fclose( fid );
+        return info;
+    }
+
+#if ! defined( _WIN32 ) && ! defined( _WIN64 )
+    if( map ){
+        void *base = mmap( NULL, h->file_size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE, fileno( fid ), 0 );
+        if( base != MAP_FAILED ){
+            fclose( fid );
+            *row = (magma_index_t*) ((char*) base + h->row_offset);
+            *col = (magma_index_t*) ((char*) base + h->col_offset);
+            *val = (float*) ((char*) base + h->val_offset);
+            s_binary_map *m = new s_binary_map;
+            m->row  = *row;
+            m->base = base;
+            m->size = h->file_size;
+#ifdef _OPENMP
+            #pragma omp critical( s_binary_maps )
+#endif
+            {
+                m->next = s_binary_maps;
+                s_binary_maps = m;
+            }
+            return MAGMA_SUCCESS;
+        }
+    }
+#endif
+
+    magma_index_malloc_cpu( row, h->num_rows+1 );
+    magma_index_malloc_cpu( col, h->nnz );
+    magma_smalloc_cpu( val, h->nnz );
+    if( fseek( fid, h->row_offset, SEEK_SET ) != 0
+        || fread( *row, h->index_size, h->num_rows+1, fid ) != h->num_rows+1
+        || fseek( fid, h->col_offset, SEEK_SET ) != 0
+        || fread( *col, h->index_size, h->nnz, fid ) != h->nnz
+        || fseek( fid, h->val_offset, SEEK_SET ) != 0
+        || fread( *val, h->value_size, h->nnz, fid ) != h->nnz ){
+        printf("#Error reading file %s.\n", filename);
+        info = MAGMA_ERR_FILESYSTEM;
+    }
+    else if( h->data_checksum != s_binary_data_checksum( h, *row, *col, *val )){
+        printf("#%s has corrupted data.\n", filename);
+        info = MAGMA_ERR_ILLEGAL_VALUE;
+    }
+    fclose( fid );
+    if( info != MAGMA_SUCCESS ){
+        magma_free_cpu( *row );
+        magma_free_cpu( *col );
+        magma_free_cpu( *val );
+    }
+    return info;
+}
+
+
 /**
     Purpose
     -------
 
-    Reads in a matrix stored in coo format from a binary and converts it
-    into CSR format. It duplicates the off-diagonal entries in the 
-    symmetric case.
+    Reads a CSR matrix from a binary file written by write_s_csrtobinary
+    into arrays allocated with magma_smalloc_cpu and magma_index_malloc_cpu.
+    Each array is read with one fread, and the checksum of the data is
+    checked. magma_s_csr_binary reads the file faster, in place.
 
 
     Arguments
@@ -66,7 +761,7 @@ using namespace std;
 
     @param
     filename    const char*
-                filname of the mtx matrix
+                filname of the binary matrix
 
     @ingroup magmasparse_saux
     ********************************************************************/
@@ -80,61 +775,195 @@ magma_int_t read_s_csr_from_binary( magma_int_t* n_row,
                                     magma_index_t **col, 
                                     const char * filename ){
 
+  s_binary_header h;
+  magma_int_t info = s_read_binary( filename, 0, &h, val, row, col );
+  if( info != MAGMA_SUCCESS )
+    return info;
 
-  std::fstream binary_test(filename);
+  *n_row = h.num_rows;
+  *n_col = h.num_cols;
+  *nnz   = h.nnz;
+  return MAGMA_SUCCESS;
+}
 
 
-  if(binary_test){
-    printf("#Start reading...");
-    fflush(stdout);
+/**
+    Purpose
+    -------
+
+    Reads a CSR matrix from a binary file written by write_s_csrtobinary.
+    Where mmap is available, the file is mapped privately and A.val, A.row,
+    and A.col point into the mapping, so reading takes about constant time,
+    and the pages are read from the file when they are first used. Writes
+    to the arrays go to private copies of the pages and do not change the
+    file. Only the header is checked; read_s_csr_from_binary also checks
+    the data.
+    magma_s_mfree unmaps the file; the arrays must not be freed otherwise.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_s_sparse_matrix*
+                matrix in magma sparse matrix format
+
+    @param
+    filename    const char*
+                filname of the binary matrix
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t magma_s_csr_binary( magma_s_sparse_matrix *A, const char *filename ){
+
+  s_binary_header h;
+  magma_int_t info = s_read_binary( filename, 1, &h, &A->val, &A->row, &A->col );
+  if( info != MAGMA_SUCCESS )
+    return info;
+
+  A->storage_type = Magma_CSR;
+  A->memory_location = Magma_CPU;
+  A->sym = ( h.sym == Magma_SYMMETRIC ? Magma_SYMMETRIC : Magma_GENERAL );
+  A->num_rows = h.num_rows;
+  A->num_cols = h.num_cols;
+  A->nnz = h.nnz;
+  A->max_nnz_row = h.max_nnz_row;
+  return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    If the arrays of the CSR matrix A are used in place from a binary file
+    read by magma_s_csr_binary, unmaps the file. Called by magma_s_mfree.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_s_sparse_matrix*
+                matrix in magma sparse matrix format
+
+    @return
+    MAGMA_SUCCESS if the file was unmapped, MAGMA_ERR_NOT_FOUND if A does
+    not use a mapped file
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t magma_s_csr_unmapbinary( magma_s_sparse_matrix *A ){
+
+  s_binary_map *m = NULL, **p;
+  if( s_binary_maps == NULL )
+    return MAGMA_ERR_NOT_FOUND;
+#ifdef _OPENMP
+  #pragma omp critical( s_binary_maps )
+#endif
+  {
+    for( p = &s_binary_maps; *p != NULL; p = &(*p)->next ){
+      if( (*p)->row == A->row ){
+        m = *p;
+        *p = m->next;
+        break;
+      }
+    }
   }
-  else{
+  if( m == NULL )
+    return MAGMA_ERR_NOT_FOUND;
+#if ! defined( _WIN32 ) && ! defined( _WIN64 )
+  munmap( m->base, m->size );
+#endif
+  delete m;
+  return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Writes a matrix to a binary file that magma_s_csr_binary and
+    read_s_csr_from_binary read. The file has a versioned header with the
+    size, precision, storage type, and checksums, followed by the CSR
+    arrays; see s_binary_header. Matrices in other formats or on the
+    device are converted to CSR on the CPU first.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_s_sparse_matrix
+                matrix in magma sparse matrix format
+
+    @param
+    filename    const char*
+                filname of the binary matrix
+
+    @ingroup magmasparse_zaux
+    ********************************************************************/
+
+extern "C"
+magma_int_t write_s_csrtobinary( magma_s_sparse_matrix A, const char *filename ){
+
+  magma_s_sparse_matrix hA, B;
+  magma_int_t info = MAGMA_SUCCESS;
+
+  if( A.memory_location != Magma_CPU )
+    magma_s_mtransfer( A, &hA, A.memory_location, Magma_CPU );
+  else
+    hA = A;
+  if( hA.storage_type != Magma_CSR )
+    magma_s_mconvert( hA, &B, hA.storage_type, Magma_CSR );
+  else
+    B = hA;
+
+  s_binary_header h;
+  memset( &h, 0, sizeof( h ));
+  memcpy( h.magic, "MAGMACSR", 8 );
+  h.version      = S_BINARY_VERSION;
+  h.header_size  = sizeof( s_binary_header );
+  h.precision    = S_BINARY_PRECISION;
+  h.storage_type = Magma_CSR;
+  h.index_size   = sizeof( magma_index_t );
+  h.value_size   = sizeof( float );
+  h.num_rows     = B.num_rows;
+  h.num_cols     = B.num_cols;
+  h.nnz          = B.row[ B.num_rows ];
+  // sym is not set by every routine that creates a matrix, so only
+  // Magma_SYMMETRIC is kept and anything else is written as Magma_GENERAL
+  h.sym          = ( A.sym == Magma_SYMMETRIC ? Magma_SYMMETRIC : Magma_GENERAL );
+  for( magma_int_t i=0; i < B.num_rows; i++ )
+    h.max_nnz_row = max( h.max_nnz_row, (uint64_t) (B.row[i+1] - B.row[i]) );
+  s_binary_layout( &h );
+  h.data_checksum   = s_binary_data_checksum( &h, B.row, B.col, B.val );
+  h.header_checksum = s_binary_header_checksum( &h );
+
+  FILE *fid = fopen( filename, "wb" );
+  if( fid == NULL ){
     printf("#Unable to open file %s.\n", filename);
-    fflush(stdout);
-    exit(1);
+    info = MAGMA_ERR_NOT_FOUND;
   }
-  binary_test.close();
-  
-  
-  std::fstream binary_rfile(filename,std::ios::binary|std::ios::in);
-  
-  
-  //read number of rows
-  binary_rfile.read(reinterpret_cast<char *>(n_row),sizeof(int));
-  
-  //read number of columns
-  binary_rfile.read(reinterpret_cast<char *>(n_col),sizeof(int));
-  
-  //read number of nonzeros
-  binary_rfile.read(reinterpret_cast<char *>(nnz),sizeof(int));
-  
-  
-  *val = new float[*nnz];
-  *col = new magma_index_t[*nnz];
-  *row = new magma_index_t[*n_row+1];
-  
-  
-  //read row pointer
-  for(magma_int_t i=0;i<=*n_row;i++){
-    binary_rfile.read(reinterpret_cast<char *>(&(*row)[i]),sizeof(int));
-  }
-  
-  //read col
-  for(magma_int_t i=0;i<*nnz;i++){
-    binary_rfile.read(reinterpret_cast<char *>(&(*col)[i]),sizeof(int));
-  }
-  
-  //read val
-  for(magma_int_t i=0;i<*nnz;i++){
-    binary_rfile.read(reinterpret_cast<char *>(&(*val)[i]),sizeof(float));
+  else {
+    if( ! s_binary_write( fid, &h, sizeof( h ))
+        || ! s_binary_write( fid, B.row, (h.num_rows+1) * h.index_size )
+        || ! s_binary_write( fid, B.col, h.nnz * h.index_size )
+        || ! s_binary_write( fid, B.val, h.nnz * h.value_size )){
+      printf("#Error writing file %s.\n", filename);
+      info = MAGMA_ERR_FILESYSTEM;
+    }
+    if( fclose( fid ) != 0 )
+      info = MAGMA_ERR_FILESYSTEM;
   }
 
-  binary_rfile.close();
-  
-  printf("#Finished reading.");
-  fflush(stdout);
-
-  return MAGMA_SUCCESS;
+  if( hA.storage_type != Magma_CSR )
+    magma_s_mfree( &B );
+  if( A.memory_location != Magma_CPU )
+    magma_s_mfree( &hA );
+  return info;
 }
 
 
@@ -198,256 +1027,18 @@ magma_int_t read_s_csr_from_mtx(    magma_storage_t *type,
                                     magma_index_t **row, 
                                     magma_index_t **col, 
                                     const char *filename ){
-  
-  FILE *fid;
-  MM_typecode matcode;
-    
-  fid = fopen(filename, "r");
-  
-  if (fid == NULL) {
-    printf("#Unable to open file %s\n", filename);
-    exit(1);
-  }
-  
-  if (mm_read_banner(fid, &matcode) != 0) {
-    printf("#Could not process lMatrix Market banner.\n");
-    exit(1);
-  }
-  
-  if (!mm_is_valid(matcode)) {
-    printf("#Invalid lMatrix Market file.\n");
-    exit(1);
-  }
-  
-  if (!((mm_is_real(matcode) || mm_is_integer(matcode) 
-      || mm_is_pattern(matcode)) && mm_is_coordinate(matcode) 
-                                        && mm_is_sparse(matcode))) {
-    printf("#Sorry, this application does not support ");
-    printf("#Market Market type: [%s]\n", mm_typecode_to_str(matcode));
-    printf("#Only real-valued or pattern coordinate matrices supported\n");
-    exit(1);
-  }
-  
-  magma_index_t num_rows, num_cols, num_nonzeros;
-  if (mm_read_mtx_crd_size(fid,&num_rows,&num_cols,&num_nonzeros) !=0)
-    exit(1);
-  
-  (*type) = Magma_CSR;
-  (*location) = Magma_CPU;
-  (*n_row) = (magma_index_t) num_rows;
-  (*n_col) = (magma_index_t) num_cols;
-  (*nnz)   = (magma_index_t) num_nonzeros;
-
-  magma_index_t *coo_col, *coo_row;
-  float *coo_val;
-  
-  coo_col = (magma_index_t *) malloc(*nnz*sizeof(magma_index_t));
-  assert(coo_col != NULL);
 
-  coo_row = (magma_index_t *) malloc(*nnz*sizeof(magma_index_t)); 
-  assert( coo_row != NULL);
-
-  coo_val = (float *) malloc(*nnz*sizeof(float));
-  assert( coo_val != NULL);
-
-
-  printf("# Reading sparse matrix from file (%s):",filename);
-  fflush(stdout);
+  int symmetric, has_zero;
 
+  (*type) = Magma_CSR;
+  (*location) = Magma_CPU;
+  s_read_mtx( filename, 1, n_row, n_col, nnz, val, row, col,
+              &symmetric, &has_zero );
 
-  if (mm_is_real(matcode) || mm_is_integer(matcode)){
-    for(magma_int_t i = 0; i < *nnz; ++i){
-      magma_index_t ROW ,COL;
-      float VAL;  // always read in a float and convert later if necessary
-      
-      fscanf(fid, " %d %d %f \n", &ROW, &COL, &VAL);   
-      
-      coo_row[i] = (magma_index_t) ROW - 1; 
-      coo_col[i] = (magma_index_t) COL - 1;
-      coo_val[i] = MAGMA_S_MAKE( VAL, 0.);
-    }
-  } else {
-    printf("Unrecognized data type\n");
-    exit(1);
-  }
-  
-  fclose(fid);
-  printf(" done\n");
-  
-  
-
-  if(mm_is_symmetric(matcode)) { //duplicate off diagonal entries
-  printf("detected symmetric case\n");
-    magma_index_t off_diagonals = 0;
-    for(magma_int_t i = 0; i < *nnz; ++i){
-      if(coo_row[i] != coo_col[i])
-        ++off_diagonals;
-    }
-    
-    magma_index_t true_nonzeros = 2*off_diagonals + (*nnz - off_diagonals);
-    
-    
+  if( symmetric ) { //off diagonal entries are duplicated
+    printf("detected symmetric case\n");
     printf("total number of nonzeros: %d\n", (int) *nnz);
-
-    
-    
-    magma_index_t* new_row = 
-        (magma_index_t *) malloc(true_nonzeros*sizeof(magma_index_t)) ; 
-    magma_index_t* new_col = 
-        (magma_index_t *) malloc(true_nonzeros*sizeof(magma_index_t)) ; 
-    float* new_val = 
-      (float *) malloc(true_nonzeros*sizeof(float)) ; 
-    
-    magma_index_t ptr = 0;
-    for(magma_int_t i = 0; i < *nnz; ++i) {
-        if(coo_row[i] != coo_col[i]) {
-        new_row[ptr] = coo_row[i];  
-        new_col[ptr] = coo_col[i];  
-        new_val[ptr] = coo_val[i];
-        ptr++;
-        new_col[ptr] = coo_row[i];  
-        new_row[ptr] = coo_col[i];  
-        new_val[ptr] = coo_val[i];
-        ptr++;  
-      } else 
-      {
-        new_row[ptr] = coo_row[i];  
-        new_col[ptr] = coo_col[i];  
-        new_val[ptr] = coo_val[i];
-        ptr++;
-      }
-    }      
-    
-    free (coo_row);
-    free (coo_col);
-    free (coo_val);
-
-    coo_row = new_row;  
-    coo_col = new_col; 
-    coo_val = new_val;   
-    
-    *nnz = true_nonzeros;
-    
-
-  } //end symmetric case
-  
-  float tv;
-  magma_index_t ti;
-  
-  
-  //If matrix is not in standard format, sorting is necessary
-  /*
-  
-    std::cout << "Sorting the cols...." << std::endl;
-  // bubble sort (by cols)
-  for (int i=0; i<*nnz-1; ++i)
-    for (int j=0; j<*nnz-i-1; ++j)
-      if (coo_col[j] > coo_col[j+1] ){
-
-        ti = coo_col[j];
-        coo_col[j] = coo_col[j+1];
-        coo_col[j+1] = ti;
-
-        ti = coo_row[j];
-        coo_row[j] = coo_row[j+1];
-        coo_row[j+1] = ti;
-
-        tv = coo_val[j];
-        coo_val[j] = coo_val[j+1];
-        coo_val[j+1] = tv;
-
-      }
-
-  std::cout << "Sorting the rows...." << std::endl;
-  // bubble sort (by rows)
-  for (int i=0; i<*nnz-1; ++i)
-    for (int j=0; j<*nnz-i-1; ++j)
-      if ( coo_row[j] > coo_row[j+1] ){
-
-        ti = coo_col[j];
-        coo_col[j] = coo_col[j+1];
-        coo_col[j+1] = ti;
-
-        ti = coo_row[j];
-        coo_row[j] = coo_row[j+1];
-        coo_row[j+1] = ti;
-
-        tv = coo_val[j];
-        coo_val[j] = coo_val[j+1];
-        coo_val[j+1] = tv;
-
-      }
-  std::cout << "Sorting: done" << std::endl;
-  
-  */
-  
-  
-  (*val) = (float *) malloc(*nnz*sizeof(float)) ;
-  assert((*val) != NULL);
-  
-  (*col) = (magma_index_t *) malloc(*nnz*sizeof(magma_index_t));
-  assert((*col) != NULL);
-  
-  (*row) = (magma_index_t *) malloc((*n_row+1)*sizeof(magma_index_t)) ;
-  assert((*row) != NULL);
-  
-
-  
-  
-  // original code from  Nathan Bell and Michael Garland
-  // the output CSR structure is NOT sorted!
-
-  for (magma_index_t i = 0; i < num_rows; i++)
-    (*row)[i] = 0;
-  
-  for (magma_index_t i = 0; i < *nnz; i++)
-    (*row)[coo_row[i]]++;
-  
-  
-  //cumsum the nnz per row to get Bp[]
-  for(magma_int_t i = 0, cumsum = 0; i < num_rows; i++){     
-    magma_index_t temp = (*row)[i];
-    (*row)[i] = cumsum;
-    cumsum += temp;
-  }
-  (*row)[num_rows] = *nnz;
-  
-  //write Aj,Ax into Bj,Bx
-  for(magma_int_t i = 0; i < *nnz; i++){
-    magma_index_t row_  = coo_row[i];
-    magma_index_t dest = (*row)[row_];
-    
-    (*col)[dest] = coo_col[i];
-    
-    (*val)[dest] = coo_val[i];
-    
-    (*row)[row_]++;
-  }
-  
-  for(int i = 0, last = 0; i <= num_rows; i++){
-    int temp = (*row)[i];
-    (*row)[i]  = last;
-    last   = temp;
   }
-  
-  (*row)[*n_row]=*nnz;
-     
-
-  for (magma_index_t k=0; k<*n_row; ++k)
-    for (magma_index_t i=(*row)[k]; i<(*row)[k+1]-1; ++i) 
-      for (magma_index_t j=(*row)[k]; j<(*row)[k+1]-1; ++j) 
-
-      if ( (*col)[j] > (*col)[j+1] ){
-
-        ti = (*col)[j];
-        (*col)[j] = (*col)[j+1];
-        (*col)[j+1] = ti;
-
-        tv = (*val)[j];
-        (*val)[j] = (*val)[j+1];
-        (*val)[j+1] = tv;
-
-      }
 
   return MAGMA_SUCCESS;
 }
@@ -552,6 +1143,9 @@ magma_int_t write_s_csr_mtx(    magma_int_t n_row,
                         MAGMA_S_REAL((new_val)[rowtemp1+j]) << std::endl;
       rowindex++;
     }
+    delete[] new_val;
+    delete[] new_row;
+    delete[] new_col;
     printf(" done\n");
 
   }
@@ -658,6 +1252,9 @@ magma_int_t print_s_csr_mtx(    magma_int_t n_row,
                         MAGMA_S_REAL((new_val)[rowtemp1+j]) << std::endl;
       rowindex++;
     }
+    delete[] new_val;
+    delete[] new_row;
+    delete[] new_col;
   }
   else{
     cout<< "%%MatrixMarket matrix coordinate real general RowMajor" <<std::endl;
@@ -822,255 +1419,19 @@ extern "C"
 magma_int_t magma_s_csr_mtx( magma_s_sparse_matrix *A, const char *filename ){
 
   int csr_compressor = 0;       // checks for zeros in original file
+  int symmetric;
 
-  FILE *fid;
-  MM_typecode matcode;
-    
-  fid = fopen(filename, "r");
-  
-  if (fid == NULL) {
-    printf("#Unable to open file %s\n", filename);
-    exit(1);
-  }
-  
-  if (mm_read_banner(fid, &matcode) != 0) {
-    printf("#Could not process lMatrix Market banner.\n");
-    exit(1);
-  }
-  
-  if (!mm_is_valid(matcode)) {
-    printf("#Invalid lMatrix Market file.\n");
-    exit(1);
-  }
-  
-  if (!((mm_is_real(matcode) || mm_is_integer(matcode) 
-        || mm_is_pattern(matcode)) && mm_is_coordinate(matcode) 
-            && mm_is_sparse(matcode))) {
-    printf("#Sorry, this application does not support ");
-    printf("#Market Market type: [%s]\n", mm_typecode_to_str(matcode));
-    printf("#Only real-valued or pattern coordinate matrices are supported\n");
-    exit(1);
-  }
-  
-  magma_index_t num_rows, num_cols, num_nonzeros;
-  if (mm_read_mtx_crd_size(fid,&num_rows,&num_cols,&num_nonzeros) !=0)
-    exit(1);
-  
   (A->storage_type) = Magma_CSR;
   (A->memory_location) = Magma_CPU;
-  (A->num_rows) = (magma_index_t) num_rows;
-  (A->num_cols) = (magma_index_t) num_cols;
-  (A->nnz)   = (magma_index_t) num_nonzeros;
-
-  magma_index_t *coo_col, *coo_row;
-  float *coo_val;
-  
-  coo_col = (magma_index_t *) malloc(A->nnz*sizeof(magma_index_t));
-  assert(coo_col != NULL);
-
-  coo_row = (magma_index_t *) malloc(A->nnz*sizeof(magma_index_t)); 
-  assert( coo_row != NULL);
-
-  coo_val = (float *) malloc(A->nnz*sizeof(float));
-  assert( coo_val != NULL);
-
-
-  printf("# Reading sparse matrix from file (%s):",filename);
-  fflush(stdout);
+  s_read_mtx( filename, 1, &A->num_rows, &A->num_cols, &A->nnz,
+              &A->val, &A->row, &A->col, &symmetric, &csr_compressor );
 
+  A->sym = Magma_GENERAL;
 
-  if (mm_is_real(matcode) || mm_is_integer(matcode)){
-    for(magma_int_t i = 0; i < A->nnz; ++i){
-      magma_index_t ROW ,COL;
-      float VAL;  // always read in a float and convert later if necessary
-      
-      fscanf(fid, " %d %d %f \n", &ROW, &COL, &VAL);   
-      if( VAL == 0 ) 
-        csr_compressor=1;
-      coo_row[i] = (magma_index_t) ROW - 1; 
-      coo_col[i] = (magma_index_t) COL - 1;
-      coo_val[i] = MAGMA_S_MAKE( VAL, 0.);
-    }
-  } else {
-    printf("Unrecognized data type\n");
-    exit(1);
-  }
-  
-  fclose(fid);
-  printf(" done\n");
-  
-  
-   A->sym = Magma_GENERAL;
-
-  if(mm_is_symmetric(matcode)) { //duplicate off diagonal entries
+  if( symmetric ) { //off diagonal entries are duplicated
     A->sym = Magma_SYMMETRIC;
-  //printf("detected symmetric case\n");
-    magma_index_t off_diagonals = 0;
-    for(magma_int_t i = 0; i < A->nnz; ++i){
-      if(coo_row[i] != coo_col[i])
-        ++off_diagonals;
-    }
-    magma_index_t true_nonzeros = 2 * off_diagonals + (A->nnz - off_diagonals);
-      
-    float *new_val;
-    magma_index_t* new_row;
-    magma_index_t* new_col;
-    magma_smalloc_cpu( &new_val, true_nonzeros );
-    magma_index_malloc_cpu( &new_row, true_nonzeros );
-    magma_index_malloc_cpu( &new_col, true_nonzeros );
-
-    magma_index_t ptr = 0;
-    for(magma_int_t i = 0; i < A->nnz; ++i) {
-        if(coo_row[i] != coo_col[i]) {
-        new_row[ptr] = coo_row[i];  
-        new_col[ptr] = coo_col[i];  
-        new_val[ptr] = coo_val[i];
-        ptr++;
-        new_col[ptr] = coo_row[i];  
-        new_row[ptr] = coo_col[i];  
-        new_val[ptr] = coo_val[i];
-        ptr++;  
-      } else 
-      {
-        new_row[ptr] = coo_row[i];  
-        new_col[ptr] = coo_col[i];  
-        new_val[ptr] = coo_val[i];
-        ptr++;
-      }
-    }      
-    
-    free (coo_row);
-    free (coo_col);
-    free (coo_val);
-
-    coo_row = new_row;  
-    coo_col = new_col; 
-    coo_val = new_val;     
-    A->nnz = true_nonzeros;
-    //printf("total number of nonzeros: %d\n",A->nnz);    
-
   } //end symmetric case
-  
-  float tv;
-  magma_index_t ti;
-  
-  
-  //If matrix is not in standard format, sorting is necessary
-  /*
-  
-    std::cout << "Sorting the cols...." << std::endl;
-  // bubble sort (by cols)
-  for (int i=0; i<A->nnz-1; ++i)
-    for (int j=0; j<A->nnz-i-1; ++j)
-      if (coo_col[j] > coo_col[j+1] ){
-
-        ti = coo_col[j];
-        coo_col[j] = coo_col[j+1];
-        coo_col[j+1] = ti;
-
-        ti = coo_row[j];
-        coo_row[j] = coo_row[j+1];
-        coo_row[j+1] = ti;
-
-        tv = coo_val[j];
-        coo_val[j] = coo_val[j+1];
-        coo_val[j+1] = tv;
 
-      }
-
-  std::cout << "Sorting the rows...." << std::endl;
-  // bubble sort (by rows)
-  for (int i=0; i<A->nnz-1; ++i)
-    for (int j=0; j<A->nnz-i-1; ++j)
-      if ( coo_row[j] > coo_row[j+1] ){
-
-        ti = coo_col[j];
-        coo_col[j] = coo_col[j+1];
-        coo_col[j+1] = ti;
-
-        ti = coo_row[j];
-        coo_row[j] = coo_row[j+1];
-        coo_row[j+1] = ti;
-
-        tv = coo_val[j];
-        coo_val[j] = coo_val[j+1];
-        coo_val[j+1] = tv;
-
-      }
-  std::cout << "Sorting: done" << std::endl;
-  
-  */
-  
-  
-  magma_smalloc_cpu( &A->val, A->nnz );
-  assert((A->val) != NULL);
-  
-  magma_index_malloc_cpu( &A->col, A->nnz );
-  assert((A->col) != NULL);
-  
-  magma_index_malloc_cpu( &A->row, A->num_rows+1 );
-  assert((A->row) != NULL);
-  
-
-  
-  
-  // original code from  Nathan Bell and Michael Garland
-  // the output CSR structure is NOT sorted!
-
-  for (magma_index_t i = 0; i < num_rows; i++)
-    (A->row)[i] = 0;
-  
-  for (magma_index_t i = 0; i < A->nnz; i++)
-    (A->row)[coo_row[i]]++;
-  
-  
-  //cumsum the nnz per row to get Bp[]
-  for(magma_int_t i = 0, cumsum = 0; i < num_rows; i++){     
-    magma_index_t temp = (A->row)[i];
-    (A->row)[i] = cumsum;
-    cumsum += temp;
-  }
-  (A->row)[num_rows] = A->nnz;
-  
-  //write Aj,Ax into Bj,Bx
-  for(magma_int_t i = 0; i < A->nnz; i++){
-    magma_index_t row_  = coo_row[i];
-    magma_index_t dest = (A->row)[row_];
-    
-    (A->col)[dest] = coo_col[i];
-    
-    (A->val)[dest] = coo_val[i];
-    
-    (A->row)[row_]++;
-  }
-  free (coo_row);
-  free (coo_col);
-  free (coo_val);
-  
-  for(int i = 0, last = 0; i <= num_rows; i++){
-    int temp = (A->row)[i];
-    (A->row)[i]  = last;
-    last   = temp;
-  }
-  
-  (A->row)[A->num_rows]=A->nnz;
-     
-
-  for (magma_index_t k=0; k<A->num_rows; ++k)
-    for (magma_index_t i=(A->row)[k]; i<(A->row)[k+1]-1; ++i) 
-      for (magma_index_t j=(A->row)[k]; j<(A->row)[k+1]-1; ++j) 
-
-      if ( (A->col)[j] > (A->col)[j+1] ){
-
-        ti = (A->col)[j];
-        (A->col)[j] = (A->col)[j+1];
-        (A->col)[j+1] = ti;
-
-        tv = (A->val)[j];
-        (A->val)[j] = (A->val)[j+1];
-        (A->val)[j+1] = tv;
-
-      }
   if( csr_compressor > 0){ // run the CSR compressor to remove zeros
       //printf("removing zeros: ");
       magma_s_sparse_matrix B;
@@ -1079,7 +1440,7 @@ magma_int_t magma_s_csr_mtx( magma_s_sparse_matrix *A, const char *filename ){
                         &(A->row),
                          &(A->col), 
                        &B.val, &B.row, &B.col, &B.num_rows ); 
-      B.nnz = B.row[num_rows];
+      B.nnz = B.row[A->num_rows];
      // printf(" remaining nonzeros:%d ", B.nnz); 
       magma_free_cpu( A->val ); 
       magma_free_cpu( A->row ); 
@@ -1119,210 +1480,19 @@ magma_int_t magma_s_csr_mtxsymm( magma_s_sparse_matrix *A,
                                  const char *filename ){
 
   int csr_compressor = 0;       // checks for zeros in original file
+  int symmetric;
 
-  FILE *fid;
-  MM_typecode matcode;
-    
-  fid = fopen(filename, "r");
-  
-  if (fid == NULL) {
-    printf("#Unable to open file %s\n", filename);
-    exit(1);
-  }
-  
-  if (mm_read_banner(fid, &matcode) != 0) {
-    printf("#Could not process lMatrix Market banner.\n");
-    exit(1);
-  }
-  
-  if (!mm_is_valid(matcode)) {
-    printf("#Invalid lMatrix Market file.\n");
-    exit(1);
-  }
-  
-  if (!((mm_is_real(matcode) || mm_is_integer(matcode) 
-        || mm_is_pattern(matcode)) && mm_is_coordinate(matcode) 
-            && mm_is_sparse(matcode))) {
-    printf("#Sorry, this application does not support ");
-    printf("#Market Market type: [%s]\n", mm_typecode_to_str(matcode));
-    printf("#Only real-valued or pattern coordinate matrices are supported\n");
-    exit(1);
-  }
-  
-  magma_index_t num_rows, num_cols, num_nonzeros;
-  if (mm_read_mtx_crd_size(fid,&num_rows,&num_cols,&num_nonzeros) !=0)
-    exit(1);
-  
   (A->storage_type) = Magma_CSR;
   (A->memory_location) = Magma_CPU;
-  (A->num_rows) = (magma_index_t) num_rows;
-  (A->num_cols) = (magma_index_t) num_cols;
-  (A->nnz)   = (magma_index_t) num_nonzeros;
-
-  magma_index_t *coo_col, *coo_row;
-  float *coo_val;
-  
-  coo_col = (magma_index_t *) malloc(A->nnz*sizeof(magma_index_t));
-  assert(coo_col != NULL);
-
-  coo_row = (magma_index_t *) malloc(A->nnz*sizeof(magma_index_t)); 
-  assert( coo_row != NULL);
-
-  coo_val = (float *) malloc(A->nnz*sizeof(float));
-  assert( coo_val != NULL);
-
-
-  printf("# Reading sparse matrix from file (%s):",filename);
-  fflush(stdout);
+  s_read_mtx( filename, 0, &A->num_rows, &A->num_cols, &A->nnz,
+              &A->val, &A->row, &A->col, &symmetric, &csr_compressor );
 
+  A->sym = Magma_GENERAL;
 
-  if (mm_is_real(matcode) || mm_is_integer(matcode)){
-    for(magma_int_t i = 0; i < A->nnz; ++i){
-      magma_index_t ROW ,COL;
-      float VAL;  // always read in a float and convert later if necessary
-      
-      fscanf(fid, " %d %d %f \n", &ROW, &COL, &VAL);   
-      if( VAL == 0 ) 
-        csr_compressor=1;
-      coo_row[i] = (magma_index_t) ROW - 1; 
-      coo_col[i] = (magma_index_t) COL - 1;
-      coo_val[i] = MAGMA_S_MAKE( VAL, 0.);
-    }
-  } else {
-    printf("Unrecognized data type\n");
-    exit(1);
-  }
-  
-  fclose(fid);
-  printf(" done\n");
-  
-  
-   A->sym = Magma_GENERAL;
-
-  if(mm_is_symmetric(matcode)) { //do not duplicate off diagonal entries!
+  if( symmetric ) { //do not duplicate off diagonal entries!
     A->sym = Magma_SYMMETRIC;
   } //end symmetric case
-  
-  float tv;
-  magma_index_t ti;
-  
-  
-  //If matrix is not in standard format, sorting is necessary
-  /*
-  
-    std::cout << "Sorting the cols...." << std::endl;
-  // bubble sort (by cols)
-  for (int i=0; i<A->nnz-1; ++i)
-    for (int j=0; j<A->nnz-i-1; ++j)
-      if (coo_col[j] > coo_col[j+1] ){
-
-        ti = coo_col[j];
-        coo_col[j] = coo_col[j+1];
-        coo_col[j+1] = ti;
-
-        ti = coo_row[j];
-        coo_row[j] = coo_row[j+1];
-        coo_row[j+1] = ti;
-
-        tv = coo_val[j];
-        coo_val[j] = coo_val[j+1];
-        coo_val[j+1] = tv;
 
-      }
-
-  std::cout << "Sorting the rows...." << std::endl;
-  // bubble sort (by rows)
-  for (int i=0; i<A->nnz-1; ++i)
-    for (int j=0; j<A->nnz-i-1; ++j)
-      if ( coo_row[j] > coo_row[j+1] ){
-
-        ti = coo_col[j];
-        coo_col[j] = coo_col[j+1];
-        coo_col[j+1] = ti;
-
-        ti = coo_row[j];
-        coo_row[j] = coo_row[j+1];
-        coo_row[j+1] = ti;
-
-        tv = coo_val[j];
-        coo_val[j] = coo_val[j+1];
-        coo_val[j+1] = tv;
-
-      }
-  std::cout << "Sorting: done" << std::endl;
-  
-  */
-  
-  
-  magma_smalloc_cpu( &A->val, A->nnz );
-  assert((A->val) != NULL);
-  
-  magma_index_malloc_cpu( &A->col, A->nnz );
-  assert((A->col) != NULL);
-  
-  magma_index_malloc_cpu( &A->row, A->num_rows+1 );
-  assert((A->row) != NULL);
-  
-
-  
-  
-  // original code from  Nathan Bell and Michael Garland
-  // the output CSR structure is NOT sorted!
-
-  for (magma_index_t i = 0; i < num_rows; i++)
-    (A->row)[i] = 0;
-  
-  for (magma_index_t i = 0; i < A->nnz; i++)
-    (A->row)[coo_row[i]]++;
-  
-  
-  //cumsum the nnz per row to get Bp[]
-  for(magma_int_t i = 0, cumsum = 0; i < num_rows; i++){     
-    magma_index_t temp = (A->row)[i];
-    (A->row)[i] = cumsum;
-    cumsum += temp;
-  }
-  (A->row)[num_rows] = A->nnz;
-  
-  //write Aj,Ax into Bj,Bx
-  for(magma_int_t i = 0; i < A->nnz; i++){
-    magma_index_t row_  = coo_row[i];
-    magma_index_t dest = (A->row)[row_];
-    
-    (A->col)[dest] = coo_col[i];
-    
-    (A->val)[dest] = coo_val[i];
-    
-    (A->row)[row_]++;
-  }
-  free (coo_row);
-  free (coo_col);
-  free (coo_val);
-  
-  for(int i = 0, last = 0; i <= num_rows; i++){
-    int temp = (A->row)[i];
-    (A->row)[i]  = last;
-    last   = temp;
-  }
-  
-  (A->row)[A->num_rows]=A->nnz;
-     
-
-  for (magma_index_t k=0; k<A->num_rows; ++k)
-    for (magma_index_t i=(A->row)[k]; i<(A->row)[k+1]-1; ++i) 
-      for (magma_index_t j=(A->row)[k]; j<(A->row)[k+1]-1; ++j) 
-
-      if ( (A->col)[j] > (A->col)[j+1] ){
-
-        ti = (A->col)[j];
-        (A->col)[j] = (A->col)[j+1];
-        (A->col)[j+1] = ti;
-
-        tv = (A->val)[j];
-        (A->val)[j] = (A->val)[j+1];
-        (A->val)[j+1] = tv;
-
-      }
   if( csr_compressor > 0){ // run the CSR compressor to remove zeros
       //printf("removing zeros: ");
       magma_s_sparse_matrix B;
@@ -1331,7 +1501,7 @@ magma_int_t magma_s_csr_mtxsymm( magma_s_sparse_matrix *A,
                         &(A->row),
                          &(A->col), 
                        &B.val, &B.row, &B.col, &B.num_rows ); 
-      B.nnz = B.row[num_rows];
+      B.nnz = B.row[A->num_rows];
      // printf(" remaining nonzeros:%d ", B.nnz); 
       magma_free_cpu( A->val ); 
       magma_free_cpu( A->row ); 
@@ -77,6 +77,17 @@ read_c_csr_from_binary( magma_int_t* n_row,
                         magma_index_t **col,
                         const char * filename);
 
+magma_int_t 
+magma_c_csr_binary(     magma_c_sparse_matrix *A, 
+                        const char *filename );
+
+magma_int_t 
+magma_c_csr_unmapbinary( magma_c_sparse_matrix *A );
+
+magma_int_t 
+write_c_csrtobinary(    magma_c_sparse_matrix A,
+                        const char *filename );
+
 magma_int_t 
 read_c_csr_from_mtx(    magma_storage_t *type, 
                         magma_location_t *location,
@@ -113,6 +124,17 @@ magma_int_t
 magma_c_cucsrtranspose( magma_c_sparse_matrix A, 
                         magma_c_sparse_matrix *B );
 
+magma_int_t 
+magma_c_coo2csr(        magma_c_sparse_matrix A, 
+                        magma_c_sparse_matrix *B );
+
+magma_int_t 
+magma_c_csrsortmerge(   magma_int_t num_rows, 
+                        magma_index_t *row, 
+                        magma_index_t **col, 
+                        magmaFloatComplex **val, 
+                        magma_int_t *nnz );
+
 magma_int_t 
 c_transpose_csr(        magma_int_t n_rows, 
                         magma_int_t n_cols, 
@@ -137,6 +159,56 @@ magma_int_t
 magma_cmscale(          magma_c_sparse_matrix *A, 
                         magma_scale_t scaling );
 
+magma_int_t
+magma_c_rcm(            magma_c_sparse_matrix A, 
+                        magma_index_t *perm );
+
+magma_int_t
+magma_c_nd(             magma_c_sparse_matrix A, 
+                        magma_index_t *perm );
+
+magma_int_t
+magma_c_mpermute(       magma_c_sparse_matrix A, 
+                        magma_c_sparse_matrix *B, 
+                        const magma_index_t *perm );
+
+magma_int_t
+magma_c_vpermute(       magma_trans_t trans, 
+                        const magma_index_t *perm, 
+                        magma_c_vector x, 
+                        magma_c_vector y );
+
+magma_int_t
+magma_c_mbandwidth(     magma_c_sparse_matrix A, 
+                        magma_int_t *bandwidth, 
+                        magma_int_t *profile );
+
+magma_int_t
+magma_c_mreorder(       magma_c_sparse_matrix A, 
+                        magma_c_sparse_matrix *B, 
+                        magma_reorder_t reordering, 
+                        magma_index_t **perm );
+
+magma_int_t
+magma_c_sellp_padding(  magma_c_sparse_matrix A, 
+                        magma_int_t C, 
+                        magma_int_t sigma, 
+                        magma_int_t alignment, 
+                        magma_int_t *stored );
+
+magma_int_t
+magma_c_sellcsigma(     magma_c_sparse_matrix A, 
+                        magma_c_sparse_matrix *B, 
+                        magma_int_t sigma, 
+                        magma_index_t **perm );
+
+magma_int_t
+magma_c_sellcsigma_tune( magma_c_sparse_matrix A, 
+                        magma_c_sparse_matrix *B, 
+                        magma_int_t *sigma, 
+                        magma_index_t **perm, 
+                        magma_int_t verbose );
+
 magma_int_t 
 magma_cmdiff(           magma_c_sparse_matrix A, 
                         magma_c_sparse_matrix B, 
@@ -263,6 +335,22 @@ magma_int_t
 magma_cm_5stencil(  magma_int_t n,
                      magma_c_sparse_matrix *A );
 
+magma_int_t
+magma_cm_stencil(   magma_int_t points,
+                    magma_int_t nx,
+                    magma_int_t ny,
+                    magma_int_t nz,
+                    float ax,
+                    float ay,
+                    float az,
+                    magma_storage_t storage,
+                    magma_c_sparse_matrix *A );
+
+magma_int_t
+magma_cm_stencil_expand( magma_c_sparse_matrix A,
+                         magma_storage_t storage,
+                         magma_c_sparse_matrix *B );
+
 magma_int_t
 magma_csolverinfo(  magma_c_solver_par *solver_par, 
                     magma_c_preconditioner *precond_par );
@@ -280,6 +368,38 @@ magma_csolverinfo_free( magma_c_solver_par *solver_par,
    -- MAGMA_SPARSE function definitions / Data on CPU
 */
 
+magma_int_t
+magma_cpcg_cpu(        magma_c_sparse_matrix A, magma_c_vector b, 
+                       magma_c_vector *x, magma_c_solver_par *solver_par, 
+                       magma_c_preconditioner *precond_par );
+
+magma_int_t
+magma_cpbicgstab_cpu(  magma_c_sparse_matrix A, magma_c_vector b, 
+                       magma_c_vector *x, magma_c_solver_par *solver_par, 
+                       magma_c_preconditioner *precond_par );
+
+magma_int_t
+magma_cpgmres_cpu(     magma_c_sparse_matrix A, magma_c_vector b, 
+                       magma_c_vector *x, magma_c_solver_par *solver_par, 
+                       magma_c_preconditioner *precond_par );
+
+magma_int_t
+magma_ccg_merge_cpu(   magma_c_sparse_matrix A, magma_c_vector b, 
+                       magma_c_vector *x, magma_c_solver_par *solver_par );
+
+magma_int_t
+magma_cbicgstab_merge_cpu( magma_c_sparse_matrix A, magma_c_vector b, 
+                       magma_c_vector *x, magma_c_solver_par *solver_par );
+
+magma_int_t
+magma_cilusetup_cpu( magma_c_sparse_matrix A, magma_c_preconditioner *precond );
+
+magma_int_t
+magma_capplyilu_l_cpu( magma_c_vector b, magma_c_vector *x, 
+                       magma_c_preconditioner *precond );
+magma_int_t
+magma_capplyilu_r_cpu( magma_c_vector b, magma_c_vector *x, 
+                       magma_c_preconditioner *precond );
 
 
 
@@ -736,6 +856,147 @@ magma_cmgesellpmv_blocked( magma_trans_t transA,
                     magmaFloatComplex *d_y );
 
 
+magma_int_t
+magma_cgecsrmv_cpu( magma_trans_t transA,
+                    magma_int_t m, magma_int_t n,
+                    magma_int_t num_vecs,
+                    magmaFloatComplex alpha,
+                    const magmaFloatComplex *val,
+                    const magma_index_t *rowptr,
+                    const magma_index_t *colind,
+                    const magmaFloatComplex *x,
+                    magmaFloatComplex beta,
+                    magmaFloatComplex *y );
+
+magma_int_t
+magma_cgeellmv_cpu( magma_trans_t transA,
+                    magma_int_t m, magma_int_t n,
+                    magma_int_t num_vecs,
+                    magma_int_t nnz_per_row,
+                    magmaFloatComplex alpha,
+                    const magmaFloatComplex *val,
+                    const magma_index_t *colind,
+                    const magmaFloatComplex *x,
+                    magmaFloatComplex beta,
+                    magmaFloatComplex *y );
+
+magma_int_t
+magma_cgeelltmv_cpu( magma_trans_t transA,
+                     magma_int_t m, magma_int_t n,
+                     magma_int_t num_vecs,
+                     magma_int_t nnz_per_row,
+                     magmaFloatComplex alpha,
+                     const magmaFloatComplex *val,
+                     const magma_index_t *colind,
+                     const magmaFloatComplex *x,
+                     magmaFloatComplex beta,
+                     magmaFloatComplex *y );
+
+magma_int_t
+magma_cgesellpmv_cpu( magma_trans_t transA,
+                      magma_int_t m, magma_int_t n,
+                      magma_int_t num_vecs,
+                      magma_int_t blocksize,
+                      magma_int_t slices,
+                      magma_int_t alignment,
+                      magmaFloatComplex alpha,
+                      const magmaFloatComplex *val,
+                      const magma_index_t *colind,
+                      const magma_index_t *rowptr,
+                      const magmaFloatComplex *x,
+                      magmaFloatComplex beta,
+                      magmaFloatComplex *y );
+
+magma_int_t
+magma_cgestencilmv_cpu( magma_trans_t transA,
+                        magma_int_t nx, magma_int_t ny, magma_int_t nz,
+                        magma_int_t num_vecs,
+                        magma_int_t npoints,
+                        magmaFloatComplex alpha,
+                        const magmaFloatComplex *val,
+                        const magma_index_t *offset,
+                        const magmaFloatComplex *x,
+                        magmaFloatComplex beta,
+                        magmaFloatComplex *y );
+
+magmaFloatComplex
+magma_cdotc_cpu(        magma_int_t n,
+                        const magmaFloatComplex *x,
+                        const magmaFloatComplex *y );
+
+magma_int_t
+magma_cdotc2_cpu(       magma_int_t n,
+                        const magmaFloatComplex *x,
+                        const magmaFloatComplex *y,
+                        magmaFloatComplex *dots );
+
+float
+magma_scnrm2_cpu(       magma_int_t n,
+                        const magmaFloatComplex *x );
+
+magma_int_t
+magma_caxpby_cpu(       magma_int_t n,
+                        magmaFloatComplex alpha,
+                        const magmaFloatComplex *x,
+                        magmaFloatComplex beta,
+                        magmaFloatComplex *y );
+
+magma_int_t
+magma_caxpbypcz_cpu(    magma_int_t n,
+                        magmaFloatComplex alpha,
+                        const magmaFloatComplex *x,
+                        magmaFloatComplex beta,
+                        const magmaFloatComplex *y,
+                        magmaFloatComplex gamma,
+                        magmaFloatComplex *z );
+
+float
+magma_ccgupdate_cpu(    magma_int_t n,
+                        magmaFloatComplex alpha,
+                        const magmaFloatComplex *p,
+                        const magmaFloatComplex *q,
+                        magmaFloatComplex *x,
+                        magmaFloatComplex *r );
+
+float
+magma_cbicgupdate_cpu(  magma_int_t n,
+                        magmaFloatComplex alpha,
+                        magmaFloatComplex omega,
+                        const magmaFloatComplex *y,
+                        const magmaFloatComplex *z,
+                        const magmaFloatComplex *s,
+                        const magmaFloatComplex *t,
+                        const magmaFloatComplex *rr,
+                        magmaFloatComplex *x,
+                        magmaFloatComplex *r,
+                        magmaFloatComplex *rho );
+
+magma_int_t
+magma_cjacobi_diagscal_cpu( magma_int_t n,
+                        const magmaFloatComplex *d,
+                        const magmaFloatComplex *b,
+                        magmaFloatComplex *x );
+
+magma_int_t
+magma_ccgmerge_cpu(     magma_c_sparse_matrix A,
+                        magmaFloatComplex *x,
+                        magmaFloatComplex *r,
+                        magmaFloatComplex *d,
+                        magmaFloatComplex *z,
+                        float *nom,
+                        float *den );
+
+magma_int_t
+magma_cbicgmerge_cpu(   magma_c_sparse_matrix A,
+                        magmaFloatComplex *skp,
+                        const magmaFloatComplex *rr,
+                        magmaFloatComplex *r,
+                        magmaFloatComplex *p,
+                        magmaFloatComplex *v,
+                        magmaFloatComplex *s,
+                        magmaFloatComplex *t,
+                        magmaFloatComplex *x );
+
 magma_int_t
 magma_cmergedgs(        magma_int_t n, 
                         magma_int_t ldh,
@@ -77,6 +77,17 @@ read_d_csr_from_binary( magma_int_t* n_row,
                         magma_index_t **col,
                         const char * filename);
 
+magma_int_t 
+magma_d_csr_binary(     magma_d_sparse_matrix *A, 
+                        const char *filename );
+
+magma_int_t 
+magma_d_csr_unmapbinary( magma_d_sparse_matrix *A );
+
+magma_int_t 
+write_d_csrtobinary(    magma_d_sparse_matrix A,
+                        const char *filename );
+
 magma_int_t 
 read_d_csr_from_mtx(    magma_storage_t *type, 
                         magma_location_t *location,
@@ -113,6 +124,17 @@ magma_int_t
 magma_d_cucsrtranspose( magma_d_sparse_matrix A, 
                         magma_d_sparse_matrix *B );
 
+magma_int_t 
+magma_d_coo2csr(        magma_d_sparse_matrix A, 
+                        magma_d_sparse_matrix *B );
+
+magma_int_t 
+magma_d_csrsortmerge(   magma_int_t num_rows, 
+                        magma_index_t *row, 
+                        magma_index_t **col, 
+                        double **val, 
+                        magma_int_t *nnz );
+
 magma_int_t 
 d_transpose_csr(        magma_int_t n_rows, 
                         magma_int_t n_cols, 
@@ -137,6 +159,56 @@ magma_int_t
 magma_dmscale(          magma_d_sparse_matrix *A, 
                         magma_scale_t scaling );
 
+magma_int_t
+magma_d_rcm(            magma_d_sparse_matrix A, 
+                        magma_index_t *perm );
+
+magma_int_t
+magma_d_nd(             magma_d_sparse_matrix A, 
+                        magma_index_t *perm );
+
+magma_int_t
+magma_d_mpermute(       magma_d_sparse_matrix A, 
+                        magma_d_sparse_matrix *B, 
+                        const magma_index_t *perm );
+
+magma_int_t
+magma_d_vpermute(       magma_trans_t trans, 
+                        const magma_index_t *perm, 
+                        magma_d_vector x, 
+                        magma_d_vector y );
+
+magma_int_t
+magma_d_mbandwidth(     magma_d_sparse_matrix A, 
+                        magma_int_t *bandwidth, 
+                        magma_int_t *profile );
+
+magma_int_t
+magma_d_mreorder(       magma_d_sparse_matrix A, 
+                        magma_d_sparse_matrix *B, 
+                        magma_reorder_t reordering, 
+                        magma_index_t **perm );
+
+magma_int_t
+magma_d_sellp_padding(  magma_d_sparse_matrix A, 
+                        magma_int_t C, 
+                        magma_int_t sigma, 
+                        magma_int_t alignment, 
+                        magma_int_t *stored );
+
+magma_int_t
+magma_d_sellcsigma(     magma_d_sparse_matrix A, 
+                        magma_d_sparse_matrix *B, 
+                        magma_int_t sigma, 
+                        magma_index_t **perm );
+
+magma_int_t
+magma_d_sellcsigma_tune( magma_d_sparse_matrix A, 
+                        magma_d_sparse_matrix *B, 
+                        magma_int_t *sigma, 
+                        magma_index_t **perm, 
+                        magma_int_t verbose );
+
 magma_int_t 
 magma_dmdiff(           magma_d_sparse_matrix A, 
                         magma_d_sparse_matrix B, 
@@ -263,6 +335,22 @@ magma_int_t
 magma_dm_5stencil(  magma_int_t n,
                      magma_d_sparse_matrix *A );
 
+magma_int_t
+magma_dm_stencil(   magma_int_t points,
+                    magma_int_t nx,
+                    magma_int_t ny,
+                    magma_int_t nz,
+                    double ax,
+                    double ay,
+                    double az,
+                    magma_storage_t storage,
+                    magma_d_sparse_matrix *A );
+
+magma_int_t
+magma_dm_stencil_expand( magma_d_sparse_matrix A,
+                         magma_storage_t storage,
+                         magma_d_sparse_matrix *B );
+
 magma_int_t
 magma_dsolverinfo(  magma_d_solver_par *solver_par, 
                     magma_d_preconditioner *precond_par );
@@ -280,6 +368,38 @@ magma_dsolverinfo_free( magma_d_solver_par *solver_par,
    -- MAGMA_SPARSE function definitions / Data on CPU
 */
 
+magma_int_t
+magma_dpcg_cpu(        magma_d_sparse_matrix A, magma_d_vector b, 
+                       magma_d_vector *x, magma_d_solver_par *solver_par, 
+                       magma_d_preconditioner *precond_par );
+
+magma_int_t
+magma_dpbicgstab_cpu(  magma_d_sparse_matrix A, magma_d_vector b, 
+                       magma_d_vector *x, magma_d_solver_par *solver_par, 
+                       magma_d_preconditioner *precond_par );
+
+magma_int_t
+magma_dpgmres_cpu(     magma_d_sparse_matrix A, magma_d_vector b, 
+                       magma_d_vector *x, magma_d_solver_par *solver_par, 
+                       magma_d_preconditioner *precond_par );
+
+magma_int_t
+magma_dcg_merge_cpu(   magma_d_sparse_matrix A, magma_d_vector b, 
+                       magma_d_vector *x, magma_d_solver_par *solver_par );
+
+magma_int_t
+magma_dbicgstab_merge_cpu( magma_d_sparse_matrix A, magma_d_vector b, 
+                       magma_d_vector *x, magma_d_solver_par *solver_par );
+
+magma_int_t
+magma_dilusetup_cpu( magma_d_sparse_matrix A, magma_d_preconditioner *precond );
+
+magma_int_t
+magma_dapplyilu_l_cpu( magma_d_vector b, magma_d_vector *x, 
+                       magma_d_preconditioner *precond );
+magma_int_t
+magma_dapplyilu_r_cpu( magma_d_vector b, magma_d_vector *x, 
+                       magma_d_preconditioner *precond );
 
 
 
@@ -736,6 +856,147 @@ magma_dmgesellpmv_blocked( magma_trans_t transA,
                     double *d_y );
 
 
+magma_int_t
+magma_dgecsrmv_cpu( magma_trans_t transA,
+                    magma_int_t m, magma_int_t n,
+                    magma_int_t num_vecs,
+                    double alpha,
+                    const double *val,
+                    const magma_index_t *rowptr,
+                    const magma_index_t *colind,
+                    const double *x,
+                    double beta,
+                    double *y );
+
+magma_int_t
+magma_dgeellmv_cpu( magma_trans_t transA,
+                    magma_int_t m, magma_int_t n,
+                    magma_int_t num_vecs,
+                    magma_int_t nnz_per_row,
+                    double alpha,
+                    const double *val,
+                    const magma_index_t *colind,
+                    const double *x,
+                    double beta,
+                    double *y );
+
+magma_int_t
+magma_dgeelltmv_cpu( magma_trans_t transA,
+                     magma_int_t m, magma_int_t n,
+                     magma_int_t num_vecs,
+                     magma_int_t nnz_per_row,
+                     double alpha,
+                     const double *val,
+                     const magma_index_t *colind,
+                     const double *x,
+                     double beta,
+                     double *y );
+
+magma_int_t
+magma_dgesellpmv_cpu( magma_trans_t transA,
+                      magma_int_t m, magma_int_t n,
+                      magma_int_t num_vecs,
+                      magma_int_t blocksize,
+                      magma_int_t slices,
+                      magma_int_t alignment,
+                      double alpha,
+                      const double *val,
+                      const magma_index_t *colind,
+                      const magma_index_t *rowptr,
+                      const double *x,
+                      double beta,
+                      double *y );
+
+magma_int_t
+magma_dgestencilmv_cpu( magma_trans_t transA,
+                        magma_int_t nx, magma_int_t ny, magma_int_t nz,
+                        magma_int_t num_vecs,
+                        magma_int_t npoints,
+                        double alpha,
+                        const double *val,
+                        const magma_index_t *offset,
+                        const double *x,
+                        double beta,
+                        double *y );
+
+double
+magma_ddotc_cpu(        magma_int_t n,
+                        const double *x,
+                        const double *y );
+
+magma_int_t
+magma_ddotc2_cpu(       magma_int_t n,
+                        const double *x,
+                        const double *y,
+                        double *dots );
+
+double
+magma_dnrm2_cpu(       magma_int_t n,
+                        const double *x );
+
+magma_int_t
+magma_daxpby_cpu(       magma_int_t n,
+                        double alpha,
+                        const double *x,
+                        double beta,
+                        double *y );
+
+magma_int_t
+magma_daxpbypcz_cpu(    magma_int_t n,
+                        double alpha,
+                        const double *x,
+                        double beta,
+                        const double *y,
+                        double gamma,
+                        double *z );
+
+double
+magma_dcgupdate_cpu(    magma_int_t n,
+                        double alpha,
+                        const double *p,
+                        const double *q,
+                        double *x,
+                        double *r );
+
+double
+magma_dbicgupdate_cpu(  magma_int_t n,
+                        double alpha,
+                        double omega,
+                        const double *y,
+                        const double *z,
+                        const double *s,
+                        const double *t,
+                        const double *rr,
+                        double *x,
+                        double *r,
+                        double *rho );
+
+magma_int_t
+magma_djacobi_diagscal_cpu( magma_int_t n,
+                        const double *d,
+                        const double *b,
+                        double *x );
+
+magma_int_t
+magma_dcgmerge_cpu(     magma_d_sparse_matrix A,
+                        double *x,
+                        double *r,
+                        double *d,
+                        double *z,
+                        double *nom,
+                        double *den );
+
+magma_int_t
+magma_dbicgmerge_cpu(   magma_d_sparse_matrix A,
+                        double *skp,
+                        const double *rr,
+                        double *r,
+                        double *p,
+                        double *v,
+                        double *s,
+                        double *t,
+                        double *x );
+
 magma_int_t
 magma_dmergedgs(        magma_int_t n, 
                         magma_int_t ldh,
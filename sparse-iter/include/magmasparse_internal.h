@@ -0,0 +1,106 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+*/
+
+#ifndef MAGMASPARSE_INTERNAL_H
+#define MAGMASPARSE_INTERNAL_H
+
+// Helpers shared by the host (Magma_CPU) kernels and conversions.
+// These are not part of the MAGMA-sparse interface.
+
+
+// Problems with fewer nonzeros, rows, or entries than this are done by a
+// single thread, as starting the threads would cost more than they save.
+#define MAGMA_SPARSE_OMP_THRESHOLD 10000
+
+
+// ---------------------------------------------
+// Returns the first r in [0, n] with row[r] >= k.
+static inline magma_int_t
+magma_sparse_lower_bound( const magma_index_t *row, magma_int_t n, magma_int_t k )
+{
+    magma_int_t lo = 0, hi = n;
+    while( lo < hi ){
+        magma_int_t mid = lo + (hi - lo)/2;
+        if( row[mid] < k )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+
+// ---------------------------------------------
+// Sets [*rb, *re) to the rows of thread id of tot, for a CSR matrix with
+// n rows and row pointer row, so that each thread gets a contiguous range
+// of rows with about row[n]/tot nonzeros.
+static inline void
+magma_sparse_row_partition( const magma_index_t *row, magma_int_t n,
+                            magma_int_t id, magma_int_t tot,
+                            magma_int_t *rb, magma_int_t *re )
+{
+    size_t nnz = row[n];
+    *rb = magma_sparse_lower_bound( row, n, (magma_int_t) ((nnz * id) / tot) );
+    *re = ( id == tot-1 ? n :
+            magma_sparse_lower_bound( row, n, (magma_int_t) ((nnz * (id+1)) / tot) ));
+}
+
+
+// ---------------------------------------------
+// Offsets for a counting sort into n buckets by tot threads.
+// Called by every thread id of a parallel region, after cnt[ t*n + i ]
+// holds the number of thread t's entries in bucket i.
+// On return, cnt[ t*n + i ] is the offset of thread t's first entry within
+// bucket i, so entries of lower threads come first, and ptr[0..n] is the
+// start of each bucket. part holds tot+1 entries of workspace.
+// Thread id does buckets [ n*id/tot, n*(id+1)/tot ). Ends with a barrier.
+static inline void
+magma_sparse_bucket_offsets( magma_index_t *cnt, magma_int_t n,
+                             magma_index_t *ptr, magma_index_t *part,
+                             magma_int_t id, magma_int_t tot )
+{
+    magma_int_t ib = (n * id) / tot;
+    magma_int_t ie = (n * (id+1)) / tot;
+    magma_int_t i, t;
+
+    // offsets of each thread within each of my buckets, and their lengths
+    magma_index_t sum = 0;
+    for( i=ib; i < ie; i++ ){
+        magma_index_t len = 0;
+        for( t=0; t < tot; t++ ){
+            magma_index_t tmp = cnt[ t*n + i ];
+            cnt[ t*n + i ] = len;
+            len += tmp;
+        }
+        ptr[i+1] = len;
+        sum += len;
+    }
+    part[id+1] = sum;
+#ifdef _OPENMP
+    #pragma omp barrier
+    #pragma omp single
+#endif
+    {
+        part[0] = 0;
+        ptr[0] = 0;
+        for( t=0; t < tot; t++ )
+            part[t+1] += part[t];
+    }
+
+    // prefix sum of the bucket lengths, starting from my part
+    sum = part[id];
+    for( i=ib; i < ie; i++ ){
+        sum += ptr[i+1];
+        ptr[i+1] = sum;
+    }
+#ifdef _OPENMP
+    #pragma omp barrier
+#endif
+}
+
+#endif  // MAGMASPARSE_INTERNAL_H
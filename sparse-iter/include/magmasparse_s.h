@@ -77,6 +77,17 @@ read_s_csr_from_binary( magma_int_t* n_row,
                         magma_index_t **col,
                         const char * filename);
 
+magma_int_t 
+magma_s_csr_binary(     magma_s_sparse_matrix *A, 
+                        const char *filename );
+
+magma_int_t 
+magma_s_csr_unmapbinary( magma_s_sparse_matrix *A );
+
+magma_int_t 
+write_s_csrtobinary(    magma_s_sparse_matrix A,
+                        const char *filename );
+
 magma_int_t 
 read_s_csr_from_mtx(    magma_storage_t *type, 
                         magma_location_t *location,
@@ -113,6 +124,17 @@ magma_int_t
 magma_s_cucsrtranspose( magma_s_sparse_matrix A, 
                         magma_s_sparse_matrix *B );
 
+magma_int_t 
+magma_s_coo2csr(        magma_s_sparse_matrix A, 
+                        magma_s_sparse_matrix *B );
+
+magma_int_t 
+magma_s_csrsortmerge(   magma_int_t num_rows, 
+                        magma_index_t *row, 
+                        magma_index_t **col, 
+                        float **val, 
+                        magma_int_t *nnz );
+
 magma_int_t 
 s_transpose_csr(        magma_int_t n_rows, 
                         magma_int_t n_cols, 
@@ -137,6 +159,56 @@ magma_int_t
 magma_smscale(          magma_s_sparse_matrix *A, 
                         magma_scale_t scaling );
 
+magma_int_t
+magma_s_rcm(            magma_s_sparse_matrix A, 
+                        magma_index_t *perm );
+
+magma_int_t
+magma_s_nd(             magma_s_sparse_matrix A, 
+                        magma_index_t *perm );
+
+magma_int_t
+magma_s_mpermute(       magma_s_sparse_matrix A, 
+                        magma_s_sparse_matrix *B, 
+                        const magma_index_t *perm );
+
+magma_int_t
+magma_s_vpermute(       magma_trans_t trans, 
+                        const magma_index_t *perm, 
+                        magma_s_vector x, 
+                        magma_s_vector y );
+
+magma_int_t
+magma_s_mbandwidth(     magma_s_sparse_matrix A, 
+                        magma_int_t *bandwidth, 
+                        magma_int_t *profile );
+
+magma_int_t
+magma_s_mreorder(       magma_s_sparse_matrix A, 
+                        magma_s_sparse_matrix *B, 
+                        magma_reorder_t reordering, 
+                        magma_index_t **perm );
+
+magma_int_t
+magma_s_sellp_padding(  magma_s_sparse_matrix A, 
+                        magma_int_t C, 
+                        magma_int_t sigma, 
+                        magma_int_t alignment, 
+                        magma_int_t *stored );
+
+magma_int_t
+magma_s_sellcsigma(     magma_s_sparse_matrix A, 
+                        magma_s_sparse_matrix *B, 
+                        magma_int_t sigma, 
+                        magma_index_t **perm );
+
+magma_int_t
+magma_s_sellcsigma_tune( magma_s_sparse_matrix A, 
+                        magma_s_sparse_matrix *B, 
+                        magma_int_t *sigma, 
+                        magma_index_t **perm, 
+                        magma_int_t verbose );
+
 magma_int_t 
 magma_smdiff(           magma_s_sparse_matrix A, 
                         magma_s_sparse_matrix B, 
@@ -263,6 +335,22 @@ magma_int_t
 magma_sm_5stencil(  magma_int_t n,
                      magma_s_sparse_matrix *A );
 
+magma_int_t
+magma_sm_stencil(   magma_int_t points,
+                    magma_int_t nx,
+                    magma_int_t ny,
+                    magma_int_t nz,
+                    float ax,
+                    float ay,
+                    float az,
+                    magma_storage_t storage,
+                    magma_s_sparse_matrix *A );
+
+magma_int_t
+magma_sm_stencil_expand( magma_s_sparse_matrix A,
+                         magma_storage_t storage,
+                         magma_s_sparse_matrix *B );
+
 magma_int_t
 magma_ssolverinfo(  magma_s_solver_par *solver_par, 
                     magma_s_preconditioner *precond_par );
@@ -280,6 +368,38 @@ magma_ssolverinfo_free( magma_s_solver_par *solver_par,
    -- MAGMA_SPARSE function definitions / Data on CPU
 */
 
+magma_int_t
+magma_spcg_cpu(        magma_s_sparse_matrix A, magma_s_vector b, 
+                       magma_s_vector *x, magma_s_solver_par *solver_par, 
+                       magma_s_preconditioner *precond_par );
+
+magma_int_t
+magma_spbicgstab_cpu(  magma_s_sparse_matrix A, magma_s_vector b, 
+                       magma_s_vector *x, magma_s_solver_par *solver_par, 
+                       magma_s_preconditioner *precond_par );
+
+magma_int_t
+magma_spgmres_cpu(     magma_s_sparse_matrix A, magma_s_vector b, 
+                       magma_s_vector *x, magma_s_solver_par *solver_par, 
+                       magma_s_preconditioner *precond_par );
+
+magma_int_t
+magma_scg_merge_cpu(   magma_s_sparse_matrix A, magma_s_vector b, 
+                       magma_s_vector *x, magma_s_solver_par *solver_par );
+
+magma_int_t
+magma_sbicgstab_merge_cpu( magma_s_sparse_matrix A, magma_s_vector b, 
+                       magma_s_vector *x, magma_s_solver_par *solver_par );
+
+magma_int_t
+magma_silusetup_cpu( magma_s_sparse_matrix A, magma_s_preconditioner *precond );
+
+magma_int_t
+magma_sapplyilu_l_cpu( magma_s_vector b, magma_s_vector *x, 
+                       magma_s_preconditioner *precond );
+magma_int_t
+magma_sapplyilu_r_cpu( magma_s_vector b, magma_s_vector *x, 
+                       magma_s_preconditioner *precond );
 
 
 
@@ -736,6 +856,147 @@ magma_smgesellpmv_blocked( magma_trans_t transA,
                     float *d_y );
 
 
+magma_int_t
+magma_sgecsrmv_cpu( magma_trans_t transA,
+                    magma_int_t m, magma_int_t n,
+                    magma_int_t num_vecs,
+                    float alpha,
+                    const float *val,
+                    const magma_index_t *rowptr,
+                    const magma_index_t *colind,
+                    const float *x,
+                    float beta,
+                    float *y );
+
+magma_int_t
+magma_sgeellmv_cpu( magma_trans_t transA,
+                    magma_int_t m, magma_int_t n,
+                    magma_int_t num_vecs,
+                    magma_int_t nnz_per_row,
+                    float alpha,
+                    const float *val,
+                    const magma_index_t *colind,
+                    const float *x,
+                    float beta,
+                    float *y );
+
+magma_int_t
+magma_sgeelltmv_cpu( magma_trans_t transA,
+                     magma_int_t m, magma_int_t n,
+                     magma_int_t num_vecs,
+                     magma_int_t nnz_per_row,
+                     float alpha,
+                     const float *val,
+                     const magma_index_t *colind,
+                     const float *x,
+                     float beta,
+                     float *y );
+
+magma_int_t
+magma_sgesellpmv_cpu( magma_trans_t transA,
+                      magma_int_t m, magma_int_t n,
+                      magma_int_t num_vecs,
+                      magma_int_t blocksize,
+                      magma_int_t slices,
+                      magma_int_t alignment,
+                      float alpha,
+                      const float *val,
+                      const magma_index_t *colind,
+                      const magma_index_t *rowptr,
+                      const float *x,
+                      float beta,
+                      float *y );
+
+magma_int_t
+magma_sgestencilmv_cpu( magma_trans_t transA,
+                        magma_int_t nx, magma_int_t ny, magma_int_t nz,
+                        magma_int_t num_vecs,
+                        magma_int_t npoints,
+                        float alpha,
+                        const float *val,
+                        const magma_index_t *offset,
+                        const float *x,
+                        float beta,
+                        float *y );
+
+float
+magma_sdotc_cpu(        magma_int_t n,
+                        const float *x,
+                        const float *y );
+
+magma_int_t
+magma_sdotc2_cpu(       magma_int_t n,
+                        const float *x,
+                        const float *y,
+                        float *dots );
+
+float
+magma_snrm2_cpu(       magma_int_t n,
+                        const float *x );
+
+magma_int_t
+magma_saxpby_cpu(       magma_int_t n,
+                        float alpha,
+                        const float *x,
+                        float beta,
+                        float *y );
+
+magma_int_t
+magma_saxpbypcz_cpu(    magma_int_t n,
+                        float alpha,
+                        const float *x,
+                        float beta,
+                        const float *y,
+                        float gamma,
+                        float *z );
+
+float
+magma_scgupdate_cpu(    magma_int_t n,
+                        float alpha,
+                        const float *p,
+                        const float *q,
+                        float *x,
+                        float *r );
+
+float
+magma_sbicgupdate_cpu(  magma_int_t n,
+                        float alpha,
+                        float omega,
+                        const float *y,
+                        const float *z,
+                        const float *s,
+                        const float *t,
+                        const float *rr,
+                        float *x,
+                        float *r,
+                        float *rho );
+
+magma_int_t
+magma_sjacobi_diagscal_cpu( magma_int_t n,
+                        const float *d,
+                        const float *b,
+                        float *x );
+
+magma_int_t
+magma_scgmerge_cpu(     magma_s_sparse_matrix A,
+                        float *x,
+                        float *r,
+                        float *d,
+                        float *z,
+                        float *nom,
+                        float *den );
+
+magma_int_t
+magma_sbicgmerge_cpu(   magma_s_sparse_matrix A,
+                        float *skp,
+                        const float *rr,
+                        float *r,
+                        float *p,
+                        float *v,
+                        float *s,
+                        float *t,
+                        float *x );
+
 magma_int_t
 magma_smergedgs(        magma_int_t n, 
                         magma_int_t ldh,
@@ -474,6 +474,7 @@ typedef struct magma_zopts{
     magma_location_t        input_location;
     magma_location_t        output_location;
     magma_scale_t           scaling;
+    magma_reorder_t         reordering;
 
 }magma_zopts;
 
@@ -488,6 +489,7 @@ typedef struct magma_copts{
     magma_location_t        input_location;
     magma_location_t        output_location;
     magma_scale_t           scaling;
+    magma_reorder_t         reordering;
 
 }magma_copts;
 
@@ -502,6 +504,7 @@ typedef struct magma_dopts{
     magma_location_t        input_location;
     magma_location_t        output_location;
     magma_scale_t           scaling;
+    magma_reorder_t         reordering;
 
 }magma_dopts;
 
@@ -516,6 +519,7 @@ typedef struct magma_sopts{
     magma_location_t        input_location;
     magma_location_t        output_location;
     magma_scale_t           scaling;
+    magma_reorder_t         reordering;
 
 }magma_sopts;
 
@@ -77,6 +77,17 @@ read_z_csr_from_binary( magma_int_t* n_row,
                         magma_index_t **col,
                         const char * filename);
 
+magma_int_t 
+magma_z_csr_binary(     magma_z_sparse_matrix *A, 
+                        const char *filename );
+
+magma_int_t 
+magma_z_csr_unmapbinary( magma_z_sparse_matrix *A );
+
+magma_int_t 
+write_z_csrtobinary(    magma_z_sparse_matrix A,
+                        const char *filename );
+
 magma_int_t 
 read_z_csr_from_mtx(    magma_storage_t *type, 
                         magma_location_t *location,
@@ -113,6 +124,17 @@ magma_int_t
 magma_z_cucsrtranspose( magma_z_sparse_matrix A, 
                         magma_z_sparse_matrix *B );
 
+magma_int_t 
+magma_z_coo2csr(        magma_z_sparse_matrix A, 
+                        magma_z_sparse_matrix *B );
+
+magma_int_t 
+magma_z_csrsortmerge(   magma_int_t num_rows, 
+                        magma_index_t *row, 
+                        magma_index_t **col, 
+                        magmaDoubleComplex **val, 
+                        magma_int_t *nnz );
+
 magma_int_t 
 z_transpose_csr(        magma_int_t n_rows, 
                         magma_int_t n_cols, 
@@ -137,6 +159,56 @@ magma_int_t
 magma_zmscale(          magma_z_sparse_matrix *A, 
                         magma_scale_t scaling );
 
+magma_int_t
+magma_z_rcm(            magma_z_sparse_matrix A, 
+                        magma_index_t *perm );
+
+magma_int_t
+magma_z_nd(             magma_z_sparse_matrix A, 
+                        magma_index_t *perm );
+
+magma_int_t
+magma_z_mpermute(       magma_z_sparse_matrix A, 
+                        magma_z_sparse_matrix *B, 
+                        const magma_index_t *perm );
+
+magma_int_t
+magma_z_vpermute(       magma_trans_t trans, 
+                        const magma_index_t *perm, 
+                        magma_z_vector x, 
+                        magma_z_vector y );
+
+magma_int_t
+magma_z_mbandwidth(     magma_z_sparse_matrix A, 
+                        magma_int_t *bandwidth, 
+                        magma_int_t *profile );
+
+magma_int_t
+magma_z_mreorder(       magma_z_sparse_matrix A, 
+                        magma_z_sparse_matrix *B, 
+                        magma_reorder_t reordering, 
+                        magma_index_t **perm );
+
+magma_int_t
+magma_z_sellp_padding(  magma_z_sparse_matrix A, 
+                        magma_int_t C, 
+                        magma_int_t sigma, 
+                        magma_int_t alignment, 
+                        magma_int_t *stored );
+
+magma_int_t
+magma_z_sellcsigma(     magma_z_sparse_matrix A, 
+                        magma_z_sparse_matrix *B, 
+                        magma_int_t sigma, 
+                        magma_index_t **perm );
+
+magma_int_t
+magma_z_sellcsigma_tune( magma_z_sparse_matrix A, 
+                        magma_z_sparse_matrix *B, 
+                        magma_int_t *sigma, 
+                        magma_index_t **perm, 
+                        magma_int_t verbose );
+
 magma_int_t 
 magma_zmdiff(           magma_z_sparse_matrix A, 
                         magma_z_sparse_matrix B, 
@@ -263,6 +335,22 @@ magma_int_t
 magma_zm_5stencil(  magma_int_t n,
                      magma_z_sparse_matrix *A );
 
+magma_int_t
+magma_zm_stencil(   magma_int_t points,
+                    magma_int_t nx,
+                    magma_int_t ny,
+                    magma_int_t nz,
+                    double ax,
+                    double ay,
+                    double az,
+                    magma_storage_t storage,
+                    magma_z_sparse_matrix *A );
+
+magma_int_t
+magma_zm_stencil_expand( magma_z_sparse_matrix A,
+                         magma_storage_t storage,
+                         magma_z_sparse_matrix *B );
+
 magma_int_t
 magma_zsolverinfo(  magma_z_solver_par *solver_par, 
                     magma_z_preconditioner *precond_par );
@@ -280,6 +368,38 @@ magma_zsolverinfo_free( magma_z_solver_par *solver_par,
    -- MAGMA_SPARSE function definitions / Data on CPU
 */
 
+magma_int_t
+magma_zpcg_cpu(        magma_z_sparse_matrix A, magma_z_vector b, 
+                       magma_z_vector *x, magma_z_solver_par *solver_par, 
+                       magma_z_preconditioner *precond_par );
+
+magma_int_t
+magma_zpbicgstab_cpu(  magma_z_sparse_matrix A, magma_z_vector b, 
+                       magma_z_vector *x, magma_z_solver_par *solver_par, 
+                       magma_z_preconditioner *precond_par );
+
+magma_int_t
+magma_zpgmres_cpu(     magma_z_sparse_matrix A, magma_z_vector b, 
+                       magma_z_vector *x, magma_z_solver_par *solver_par, 
+                       magma_z_preconditioner *precond_par );
+
+magma_int_t
+magma_zcg_merge_cpu(   magma_z_sparse_matrix A, magma_z_vector b, 
+                       magma_z_vector *x, magma_z_solver_par *solver_par );
+
+magma_int_t
+magma_zbicgstab_merge_cpu( magma_z_sparse_matrix A, magma_z_vector b, 
+                       magma_z_vector *x, magma_z_solver_par *solver_par );
+
+magma_int_t
+magma_zilusetup_cpu( magma_z_sparse_matrix A, magma_z_preconditioner *precond );
+
+magma_int_t
+magma_zapplyilu_l_cpu( magma_z_vector b, magma_z_vector *x, 
+                       magma_z_preconditioner *precond );
+magma_int_t
+magma_zapplyilu_r_cpu( magma_z_vector b, magma_z_vector *x, 
+                       magma_z_preconditioner *precond );
 
 
 
@@ -736,6 +856,147 @@ magma_zmgesellpmv_blocked( magma_trans_t transA,
                     magmaDoubleComplex *d_y );
 
 
+magma_int_t
+magma_zgecsrmv_cpu( magma_trans_t transA,
+                    magma_int_t m, magma_int_t n,
+                    magma_int_t num_vecs,
+                    magmaDoubleComplex alpha,
+                    const magmaDoubleComplex *val,
+                    const magma_index_t *rowptr,
+                    const magma_index_t *colind,
+                    const magmaDoubleComplex *x,
+                    magmaDoubleComplex beta,
+                    magmaDoubleComplex *y );
+
+magma_int_t
+magma_zgeellmv_cpu( magma_trans_t transA,
+                    magma_int_t m, magma_int_t n,
+                    magma_int_t num_vecs,
+                    magma_int_t nnz_per_row,
+                    magmaDoubleComplex alpha,
+                    const magmaDoubleComplex *val,
+                    const magma_index_t *colind,
+                    const magmaDoubleComplex *x,
+                    magmaDoubleComplex beta,
+                    magmaDoubleComplex *y );
+
+magma_int_t
+magma_zgeelltmv_cpu( magma_trans_t transA,
+                     magma_int_t m, magma_int_t n,
+                     magma_int_t num_vecs,
+                     magma_int_t nnz_per_row,
+                     magmaDoubleComplex alpha,
+                     const magmaDoubleComplex *val,
+                     const magma_index_t *colind,
+                     const magmaDoubleComplex *x,
+                     magmaDoubleComplex beta,
+                     magmaDoubleComplex *y );
+
+magma_int_t
+magma_zgesellpmv_cpu( magma_trans_t transA,
+                      magma_int_t m, magma_int_t n,
+                      magma_int_t num_vecs,
+                      magma_int_t blocksize,
+                      magma_int_t slices,
+                      magma_int_t alignment,
+                      magmaDoubleComplex alpha,
+                      const magmaDoubleComplex *val,
+                      const magma_index_t *colind,
+                      const magma_index_t *rowptr,
+                      const magmaDoubleComplex *x,
+                      magmaDoubleComplex beta,
+                      magmaDoubleComplex *y );
+
+magma_int_t
+magma_zgestencilmv_cpu( magma_trans_t transA,
+                        magma_int_t nx, magma_int_t ny, magma_int_t nz,
+                        magma_int_t num_vecs,
+                        magma_int_t npoints,
+                        magmaDoubleComplex alpha,
+                        const magmaDoubleComplex *val,
+                        const magma_index_t *offset,
+                        const magmaDoubleComplex *x,
+                        magmaDoubleComplex beta,
+                        magmaDoubleComplex *y );
+
+magmaDoubleComplex
+magma_zdotc_cpu(        magma_int_t n,
+                        const magmaDoubleComplex *x,
+                        const magmaDoubleComplex *y );
+
+magma_int_t
+magma_zdotc2_cpu(       magma_int_t n,
+                        const magmaDoubleComplex *x,
+                        const magmaDoubleComplex *y,
+                        magmaDoubleComplex *dots );
+
+double
+magma_dznrm2_cpu(       magma_int_t n,
+                        const magmaDoubleComplex *x );
+
+magma_int_t
+magma_zaxpby_cpu(       magma_int_t n,
+                        magmaDoubleComplex alpha,
+                        const magmaDoubleComplex *x,
+                        magmaDoubleComplex beta,
+                        magmaDoubleComplex *y );
+
+magma_int_t
+magma_zaxpbypcz_cpu(    magma_int_t n,
+                        magmaDoubleComplex alpha,
+                        const magmaDoubleComplex *x,
+                        magmaDoubleComplex beta,
+                        const magmaDoubleComplex *y,
+                        magmaDoubleComplex gamma,
+                        magmaDoubleComplex *z );
+
+double
+magma_zcgupdate_cpu(    magma_int_t n,
+                        magmaDoubleComplex alpha,
+                        const magmaDoubleComplex *p,
+                        const magmaDoubleComplex *q,
+                        magmaDoubleComplex *x,
+                        magmaDoubleComplex *r );
+
+double
+magma_zbicgupdate_cpu(  magma_int_t n,
+                        magmaDoubleComplex alpha,
+                        magmaDoubleComplex omega,
+                        const magmaDoubleComplex *y,
+                        const magmaDoubleComplex *z,
+                        const magmaDoubleComplex *s,
+                        const magmaDoubleComplex *t,
+                        const magmaDoubleComplex *rr,
+                        magmaDoubleComplex *x,
+                        magmaDoubleComplex *r,
+                        magmaDoubleComplex *rho );
+
+magma_int_t
+magma_zjacobi_diagscal_cpu( magma_int_t n,
+                        const magmaDoubleComplex *d,
+                        const magmaDoubleComplex *b,
+                        magmaDoubleComplex *x );
+
+magma_int_t
+magma_zcgmerge_cpu(     magma_z_sparse_matrix A,
+                        magmaDoubleComplex *x,
+                        magmaDoubleComplex *r,
+                        magmaDoubleComplex *d,
+                        magmaDoubleComplex *z,
+                        double *nom,
+                        double *den );
+
+magma_int_t
+magma_zbicgmerge_cpu(   magma_z_sparse_matrix A,
+                        magmaDoubleComplex *skp,
+                        const magmaDoubleComplex *rr,
+                        magmaDoubleComplex *r,
+                        magmaDoubleComplex *p,
+                        magmaDoubleComplex *v,
+                        magmaDoubleComplex *s,
+                        magmaDoubleComplex *t,
+                        magmaDoubleComplex *x );
+
 magma_int_t
 magma_zmergedgs(        magma_int_t n, 
                         magma_int_t ldh,
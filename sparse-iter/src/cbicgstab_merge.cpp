@@ -57,6 +57,11 @@ magma_cbicgstab_merge( magma_c_sparse_matrix A, magma_c_vector b,
 
     // prepare solver feedback
     solver_par->solver = Magma_BICGSTABMERGE;
+
+    // CPU implementation
+    if( A.memory_location == Magma_CPU )
+        return magma_cbicgstab_merge_cpu( A, b, x, solver_par );
+
     solver_par->numiter = 0;
     solver_par->info = 0;
 
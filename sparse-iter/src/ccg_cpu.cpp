@@ -0,0 +1,216 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from zcg_cpu.cpp normal z -> c, Tue Sep  2 12:38:36 2014
+*/
+
+#include "common_magma.h"
+#include "magmasparse.h"
+
+#include <assert.h>
+
+#define RTOLERANCE     lapackf77_slamch( "E" )
+#define ATOLERANCE     lapackf77_slamch( "E" )
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex Hermitian N-by-N positive definite matrix A.
+    This is a CPU implementation of the (preconditioned) Conjugate
+    Gradient method, used by magma_ccg, magma_ccg_res and magma_cpcg
+    if A is located on the CPU. A, b and x are on the CPU.
+
+    The solution and residual updates are fused with the residual norm
+    in magma_ccgupdate_cpu, so each iteration reads the vectors once
+    for the SpMV, once for the direction update and dot product, and
+    once for the updates of x and r.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_c_sparse_matrix
+                input matrix A
+
+    @param
+    b           magma_c_vector
+                RHS b
+
+    @param
+    x           magma_c_vector*
+                solution approximation
+
+    @param
+    solver_par  magma_c_solver_par*
+                solver parameters
+
+    @param
+    precond_par magma_c_preconditioner*
+                preconditioner, or NULL for the unpreconditioned method
+
+    @ingroup magmasparse_chesv
+    ********************************************************************/
+
+magma_int_t
+magma_cpcg_cpu( magma_c_sparse_matrix A, magma_c_vector b, magma_c_vector *x,
+                magma_c_solver_par *solver_par,
+                magma_c_preconditioner *precond_par ){
+
+    // prepare solver feedback
+    solver_par->numiter = 0;
+    solver_par->info = 0;
+
+    // local variables
+    magmaFloatComplex c_zero = MAGMA_C_ZERO, c_one = MAGMA_C_ONE;
+
+    magma_int_t dofs = A.num_rows;
+    magma_int_t precond = ( precond_par != NULL
+                            && precond_par->solver != Magma_NONE );
+
+    // CPU workspace
+    magma_c_vector r, rt, p, q, h;
+    magma_c_vinit( &r, Magma_CPU, dofs, c_zero );
+    magma_c_vinit( &p, Magma_CPU, dofs, c_zero );
+    magma_c_vinit( &q, Magma_CPU, dofs, c_zero );
+    if( precond ){
+        magma_c_vinit( &rt, Magma_CPU, dofs, c_zero );
+        magma_c_vinit( &h, Magma_CPU, dofs, c_zero );
+    }
+
+    // solver variables
+    magmaFloatComplex alpha, beta;
+    float nom, nom0, r0, gammaold, gammanew, den, res;
+
+    // solver setup
+    magma_caxpby_cpu( dofs, c_zero, b.val, c_zero, x->val );   // x = 0
+    magma_caxpby_cpu( dofs, c_one, b.val, c_zero, r.val );     // r = b
+    nom0 = magma_scnrm2_cpu( dofs, r.val );
+    nom = gammaold = nom0 * nom0;                              // nom = r' * r
+    solver_par->init_res = nom0;
+
+    if ( (r0 = nom * solver_par->epsilon) < ATOLERANCE )
+        r0 = ATOLERANCE;
+    if ( nom < r0 ){
+        solver_par->iter_res = nom0;
+        solver_par->final_res = nom0;
+        magma_c_vfree(&r);
+        magma_c_vfree(&p);
+        magma_c_vfree(&q);
+        if( precond ){
+            magma_c_vfree(&rt);
+            magma_c_vfree(&h);
+        }
+        return MAGMA_SUCCESS;
+    }
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+    tempo1=magma_wtime();
+    if( solver_par->verbose > 0 ){
+        solver_par->res_vec[0] = (real_Double_t)nom0;
+        solver_par->timing[0] = 0.0;
+    }
+
+    // start iteration
+    for( solver_par->numiter= 1; solver_par->numiter<solver_par->maxiter;
+                                                    solver_par->numiter++ ){
+        if( precond ){
+            magma_c_applyprecond_left( A, r, &rt, precond_par );
+            magma_c_applyprecond_right( A, rt, &h, precond_par );
+            gammanew = MAGMA_C_REAL( magma_cdotc_cpu( dofs, r.val, h.val ));
+                                                            // gn = < r,h>
+        }
+        else{
+            h = r;
+            gammanew = nom;
+        }
+
+        if( solver_par->numiter==1 ){
+            magma_caxpby_cpu( dofs, c_one, h.val, c_zero, p.val );  // p = h
+        }else{
+            beta = MAGMA_C_MAKE(gammanew/gammaold, 0.);       // beta = gn/go
+            magma_caxpby_cpu( dofs, c_one, h.val, beta, p.val ); // p = h + beta*p
+        }
+
+        magma_c_spmv( c_one, A, p, c_zero, q );           // q = A p
+        den = MAGMA_C_REAL( magma_cdotc_cpu( dofs, p.val, q.val ));
+                // den = p dot q
+        // check positive definite
+        if ( solver_par->numiter == 1 && den <= 0.0 ) {
+            printf("Operator A is not postive definite. (Ar,r) = %f\n", den);
+            solver_par->info = -100;
+            res = nom0;
+            break;
+        }
+
+        alpha = MAGMA_C_MAKE(gammanew/den, 0.);
+        nom = magma_ccgupdate_cpu( dofs, alpha, p.val, q.val, x->val, r.val );
+                // x = x + alpha p, r = r - alpha q, nom = r' * r
+        gammaold = gammanew;
+
+        res = sqrt( nom );
+        if( solver_par->verbose > 0 ){
+            tempo2=magma_wtime();
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if (  res/nom0  < solver_par->epsilon ) {
+            break;
+        }
+    }
+    tempo2=magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    float residual;
+    magma_cresidual( A, b, *x, &residual );
+    solver_par->iter_res = res;
+    solver_par->final_res = residual;
+
+    if( solver_par->info == -100 ){
+        // A is not positive definite, keep the error
+    }else if( solver_par->numiter < solver_par->maxiter){
+        solver_par->info = 0;
+    }else if( solver_par->init_res > solver_par->final_res ){
+        if( solver_par->verbose > 0 ){
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        solver_par->info = -2;
+    }
+    else{
+        if( solver_par->verbose > 0 ){
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        solver_par->info = -1;
+    }
+    magma_c_vfree(&r);
+    magma_c_vfree(&p);
+    magma_c_vfree(&q);
+    if( precond ){
+        magma_c_vfree(&rt);
+        magma_c_vfree(&h);
+    }
+
+    return MAGMA_SUCCESS;
+}   /* magma_cpcg_cpu */
@@ -0,0 +1,362 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from zilu_cpu.cpp normal z -> c, Tue Sep  2 12:38:36 2014
+*/
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "common_magma.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+
+
+// The factorization and the triangular solves go through the rows level by
+// level. Row i is in level 1 + the maximum level of the rows it depends on,
+// i.e., of the columns j < i (for L) or j > i (for U) of row i, so the rows
+// of one level are independent and are done in parallel.
+// The schedule is stored as
+//     sched[0]                 number of levels nlev,
+//     sched[1 .. nlev+1]       start of each level in rows,
+//     sched[nlev+2 .. ]        rows, level by level and ascending in each,
+// in precond->int_array_1 for L and precond->int_array_2 for U.
+// If a matrix has fewer than MAGMA_SPARSE_OMP_THRESHOLD rows, or fewer than
+// LEVEL_MIN_ROWS rows per level on average, the sweep is done serially in
+// the natural order instead.
+#define LEVEL_MIN_ROWS 64
+
+#define LEVEL_NUM(s)      ( (s)[0] )
+#define LEVEL_PTR(s)      ( (s) + 1 )
+#define LEVEL_ROWS(s)     ( (s) + LEVEL_NUM(s) + 2 )
+
+
+// ---------------------------------------------
+// Returns the level schedule of the lower (lower = 1) or upper (lower = 0)
+// triangular part of the n-by-n CSR pattern row, col in *sched.
+static magma_int_t
+ilu_levels( magma_int_t n, const magma_index_t *row, const magma_index_t *col,
+            magma_int_t lower, magma_int_t **sched )
+{
+    magma_int_t i, j, nlev = 0;
+    magma_int_t *level, *count;
+    magma_imalloc_cpu( &level, n );
+    for( magma_int_t ii=0; ii < n; ii++ ){
+        i = ( lower ? ii : n-1-ii );
+        magma_int_t lev = 0;
+        for( j=row[i]; j < row[i+1]; j++ ){
+            if( lower ? col[j] < i : col[j] > i )
+                lev = max( lev, level[ col[j] ] + 1 );
+        }
+        level[i] = lev;
+        nlev = max( nlev, lev+1 );
+    }
+
+    // counting sort of the rows by level
+    magma_imalloc_cpu( sched, n + nlev + 2 );
+    LEVEL_NUM( *sched ) = nlev;
+    count = LEVEL_PTR( *sched );
+    for( i=0; i <= nlev; i++ )
+        count[i] = 0;
+    for( i=0; i < n; i++ )
+        count[ level[i]+1 ]++;
+    for( i=0; i < nlev; i++ )
+        count[i+1] += count[i];
+    magma_int_t *rows = LEVEL_ROWS( *sched );
+    for( i=0; i < n; i++ )
+        rows[ count[ level[i] ]++ ]  = i;
+    // count[l] is now the end of level l, shift it back to the start
+    for( i=nlev; i > 0; i-- )
+        count[i] = count[i-1];
+    count[0] = 0;
+
+    magma_free_cpu( level );
+    return MAGMA_SUCCESS;
+}
+
+
+// ---------------------------------------------
+// Returns the number of threads for a sweep over n rows with schedule sched.
+static magma_int_t
+ilu_nthread( magma_int_t n, const magma_int_t *sched )
+{
+#ifdef _OPENMP
+    if ( n >= MAGMA_SPARSE_OMP_THRESHOLD && n >= LEVEL_MIN_ROWS * LEVEL_NUM( sched ) )
+        return omp_get_max_threads();
+#endif
+    return 1;
+}
+
+
+// ---------------------------------------------
+// Row i of the ILU(0) factorization of M in place, for sorted rows:
+// for each k < i in the pattern of row i, in order, l_ik = a_ik / u_kk,
+// then a_ij -= l_ik * u_kj for j > k in both patterns.
+static void
+ilu_row( magma_c_sparse_matrix M, const magma_int_t *diag, magma_int_t i )
+{
+    for( magma_int_t j=M.row[i]; j < M.row[i+1] && M.col[j] < i; j++ ){
+        magma_int_t k = M.col[j];
+        magmaFloatComplex lik = M.val[j] / M.val[ diag[k] ];
+        M.val[j] = lik;
+        // both rows are sorted, so merge the patterns
+        magma_int_t p = j+1, q = diag[k]+1;
+        while( p < M.row[i+1] && q < M.row[k+1] ){
+            if( M.col[p] == M.col[q] ){
+                M.val[p] -= lik * M.val[q];
+                p++;
+                q++;
+            }
+            else if( M.col[p] < M.col[q] )
+                p++;
+            else
+                q++;
+        }
+    }
+}
+
+
+// ---------------------------------------------
+// Row i of the solve L x = b, with the diagonal entry of each row last.
+static inline void
+ilu_lower_row( magma_c_sparse_matrix L, const magmaFloatComplex *b,
+               magmaFloatComplex *x, magma_int_t i )
+{
+    magmaFloatComplex sum = b[i];
+    magma_int_t last = L.row[i+1]-1;
+    for( magma_int_t j=L.row[i]; j<last; j++ )
+        sum -= L.val[j] * x[ L.col[j] ];
+    x[i] = sum / L.val[ last ];
+}
+
+
+// ---------------------------------------------
+// Row i of the solve U x = b, with the diagonal entry of each row first.
+static inline void
+ilu_upper_row( magma_c_sparse_matrix U, const magmaFloatComplex *b,
+               magmaFloatComplex *x, magma_int_t i )
+{
+    magmaFloatComplex sum = b[i];
+    magma_int_t first = U.row[i];
+    for( magma_int_t j=first+1; j<U.row[i+1]; j++ )
+        sum -= U.val[j] * x[ U.col[j] ];
+    x[i] = sum / U.val[ first ];
+}
+
+
+/**
+    Purpose
+    -------
+
+    Prepares the ILU(0) preconditioner on the CPU.
+    Computes the incomplete LU factorization with the sparsity pattern of A
+    and stores its unit lower triangular factor in precond->L and its upper
+    triangular factor in precond->U, both in CSR on the CPU.
+    The factorization needs a nonzero diagonal entry in every row. It
+    merges the patterns of rows in column order, so the columns in each
+    row of the copy of A it works on are sorted first, and duplicate
+    entries summed, with magma_c_csrsortmerge; A itself is not changed.
+
+    For a Hermitian matrix, U = D L^H, so L and U also give the IC(0)
+    preconditioner.
+
+    The level schedules of L and U are computed from the pattern of A and
+    stored in precond->int_array_1 and precond->int_array_2. The
+    factorization and magma_capplyilu_l_cpu and magma_capplyilu_r_cpu do
+    the rows of each level in parallel.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_c_sparse_matrix
+                input matrix A, on the CPU
+
+    @param
+    precond     magma_c_preconditioner*
+                preconditioner parameters
+
+    @ingroup magmasparse_cgepr
+    ********************************************************************/
+
+magma_int_t
+magma_cilusetup_cpu( magma_c_sparse_matrix A, magma_c_preconditioner *precond ){
+
+    magma_c_sparse_matrix hA, M;
+    magma_int_t i, j, n;
+
+    // the factorization overwrites a CSR copy of A, with sorted rows
+    if( A.storage_type != Magma_CSR ){
+        magma_c_mconvert( A, &hA, A.storage_type, Magma_CSR );
+        magma_c_mtransfer( hA, &M, Magma_CPU, Magma_CPU );
+        magma_c_mfree( &hA );
+    }
+    else
+        magma_c_mtransfer( A, &M, Magma_CPU, Magma_CPU );
+    n = M.num_rows;
+    magma_c_csrsortmerge( n, M.row, &M.col, &M.val, &M.nnz );
+
+    // diag[i] is the position of the diagonal entry of row i
+    magma_int_t *diag;
+    magma_imalloc_cpu( &diag, n );
+    for( i=0; i<n; i++ ){
+        diag[i] = -1;
+        for( j=M.row[i]; j<M.row[i+1]; j++ ){
+            if( M.col[j] == i )
+                diag[i] = j;
+        }
+        if( diag[i] == -1 ){
+            printf("error: zero diagonal element in row %d!\n", (int) i);
+            magma_free_cpu( diag );
+            magma_c_mfree( &M );
+            return MAGMA_ERR_NOT_SUPPORTED;
+        }
+    }
+
+    // the rows row i depends on in the factorization are those of the
+    // L solve, so the L schedule is also used for the factorization
+    ilu_levels( n, M.row, M.col, 1, &(precond->int_array_1) );
+    ilu_levels( n, M.row, M.col, 0, &(precond->int_array_2) );
+
+    const magma_int_t *sched = precond->int_array_1;
+    if( ilu_nthread( n, sched ) == 1 ){
+        for( i=0; i<n; i++ )
+            ilu_row( M, diag, i );
+    }
+    else{
+        const magma_int_t *ptr  = LEVEL_PTR( sched );
+        const magma_int_t *rows = LEVEL_ROWS( sched );
+#ifdef _OPENMP
+        #pragma omp parallel num_threads( ilu_nthread( n, sched ) )
+#endif
+        for( magma_int_t lev=0; lev < LEVEL_NUM( sched ); lev++ ){
+#ifdef _OPENMP
+            #pragma omp for schedule( dynamic, 16 )
+#endif
+            for( magma_int_t ii=ptr[lev]; ii < ptr[lev+1]; ii++ )
+                ilu_row( M, diag, rows[ii] );
+        }
+    }
+    magma_free_cpu( diag );
+
+    precond->L.diagorder_type = Magma_UNITY;
+    magma_c_mconvert( M, &(precond->L), Magma_CSR, Magma_CSRL );
+    precond->U.diagorder_type = Magma_VALUE;
+    magma_c_mconvert( M, &(precond->U), Magma_CSR, Magma_CSRU );
+    magma_c_mfree( &M );
+
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Solves L x = b on the CPU for the lower triangular factor L of the
+    ILU preconditioner, in CSR with the diagonal entry of each row last.
+    The rows of each level of precond->int_array_1 are done in parallel.
+
+    Arguments
+    ---------
+
+    @param
+    b           magma_c_vector
+                RHS
+
+    @param
+    x           magma_c_vector*
+                vector to precondition
+
+    @param
+    precond     magma_c_preconditioner*
+                preconditioner parameters
+
+    @ingroup magmasparse_cgepr
+    ********************************************************************/
+
+magma_int_t
+magma_capplyilu_l_cpu( magma_c_vector b, magma_c_vector *x,
+                       magma_c_preconditioner *precond ){
+
+    magma_c_sparse_matrix L = precond->L;
+    const magma_int_t *sched = precond->int_array_1;
+    if( ilu_nthread( L.num_rows, sched ) == 1 ){
+        for( magma_int_t i=0; i<L.num_rows; i++ )
+            ilu_lower_row( L, b.val, x->val, i );
+    }
+    else{
+        const magma_int_t *ptr  = LEVEL_PTR( sched );
+        const magma_int_t *rows = LEVEL_ROWS( sched );
+#ifdef _OPENMP
+        #pragma omp parallel num_threads( ilu_nthread( L.num_rows, sched ) )
+#endif
+        for( magma_int_t lev=0; lev < LEVEL_NUM( sched ); lev++ ){
+#ifdef _OPENMP
+            #pragma omp for schedule( static )
+#endif
+            for( magma_int_t ii=ptr[lev]; ii < ptr[lev+1]; ii++ )
+                ilu_lower_row( L, b.val, x->val, rows[ii] );
+        }
+    }
+    return MAGMA_SUCCESS;
+}
+
+
+/**
+    Purpose
+    -------
+
+    Solves U x = b on the CPU for the upper triangular factor U of the
+    ILU preconditioner, in CSR with the diagonal entry of each row first.
+    The rows of each level of precond->int_array_2 are done in parallel.
+
+    Arguments
+    ---------
+
+    @param
+    b           magma_c_vector
+                RHS
+
+    @param
+    x           magma_c_vector*
+                vector to precondition
+
+    @param
+    precond     magma_c_preconditioner*
+                preconditioner parameters
+
+    @ingroup magmasparse_cgepr
+    ********************************************************************/
+
+magma_int_t
+magma_capplyilu_r_cpu( magma_c_vector b, magma_c_vector *x,
+                       magma_c_preconditioner *precond ){
+
+    magma_c_sparse_matrix U = precond->U;
+    const magma_int_t *sched = precond->int_array_2;
+    if( ilu_nthread( U.num_rows, sched ) == 1 ){
+        for( magma_int_t i=U.num_rows-1; i>=0; i-- )
+            ilu_upper_row( U, b.val, x->val, i );
+    }
+    else{
+        const magma_int_t *ptr  = LEVEL_PTR( sched );
+        const magma_int_t *rows = LEVEL_ROWS( sched );
+#ifdef _OPENMP
+        #pragma omp parallel num_threads( ilu_nthread( U.num_rows, sched ) )
+#endif
+        for( magma_int_t lev=0; lev < LEVEL_NUM( sched ); lev++ ){
+#ifdef _OPENMP
+            #pragma omp for schedule( static )
+#endif
+            for( magma_int_t ii=ptr[lev]; ii < ptr[lev+1]; ii++ )
+                ilu_upper_row( U, b.val, x->val, rows[ii] );
+        }
+    }
+    return MAGMA_SUCCESS;
+}
@@ -237,6 +237,22 @@ magma_cjacobisetup_diagscal( magma_c_sparse_matrix A, magma_c_vector *d ){
     magma_c_vector diag;
     magma_c_vinit( &diag, Magma_CPU, A.num_rows, MAGMA_C_ZERO );
 
+    // the diagonal of a stencil is the value of its center point
+    if( A.storage_type == Magma_STENCIL ){
+        magmaFloatComplex center = MAGMA_C_ZERO;
+        for( i=0; i<A.max_nnz_row; i++ ){
+            if( A.col[3*i] == 0 && A.col[3*i+1] == 0 && A.col[3*i+2] == 0 )
+                center = A.val[i];
+        }
+        if( MAGMA_C_REAL( center ) == 0 )
+            printf(" error: zero diagonal element in the stencil!\n");
+        for( magma_int_t rowindex=0; rowindex<A.num_rows; rowindex++ )
+            diag.val[rowindex] = 1.0/center;
+        magma_c_vtransfer( diag, d, Magma_CPU, A.memory_location);
+        magma_c_vfree( &diag);
+        return MAGMA_SUCCESS;
+    }
+
     if( A.storage_type != Magma_CSR){
         magma_c_mtransfer( A, &A_h1, A.memory_location, Magma_CPU);
         magma_c_mconvert( A_h1, &B, A_h1.storage_type, Magma_CSR);
@@ -76,6 +76,10 @@ magma_cpgmres( magma_c_sparse_matrix A, magma_c_vector b, magma_c_vector *x,
     solver_par->numiter = 0;
     solver_par->info = 0;
 
+    // CPU implementation
+    if( A.memory_location == Magma_CPU )
+        return magma_cpgmres_cpu( A, b, x, solver_par, precond_par );
+
     // local variables
     magmaFloatComplex c_zero = MAGMA_C_ZERO, c_one = MAGMA_C_ONE, 
                                                 c_mone = MAGMA_C_NEG_ONE;
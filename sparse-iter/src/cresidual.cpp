@@ -54,6 +54,16 @@ magma_cresidual( magma_c_sparse_matrix A, magma_c_vector b, magma_c_vector x,
     
     
     magma_c_vector r;
+    if( A.memory_location == Magma_CPU ){
+        magma_c_vinit( &r, Magma_CPU, A.num_rows, zero );
+
+        magma_c_spmv( one, A, x, zero, r );                   // r = A x
+        magma_caxpby_cpu( dofs, mone, b.val, one, r.val );    // r = r - b
+        *res =  magma_scnrm2_cpu( dofs, r.val );              // res = ||r||
+
+        magma_c_vfree(&r);
+        return MAGMA_SUCCESS;
+    }
     magma_c_vinit( &r, Magma_DEV, A.num_rows, zero );
 
     magma_c_spmv( one, A, x, zero, r );                   // r = A x
@@ -59,6 +59,10 @@ magma_dbicgstab( magma_d_sparse_matrix A, magma_d_vector b, magma_d_vector *x,
     solver_par->numiter = 0;
     solver_par->info = 0;
 
+    // CPU implementation
+    if( A.memory_location == Magma_CPU )
+        return magma_dpbicgstab_cpu( A, b, x, solver_par, NULL );
+
     // some useful variables
     double c_zero = MAGMA_D_ZERO, c_one = MAGMA_D_ONE, 
                                             c_mone = MAGMA_D_NEG_ONE;
@@ -0,0 +1,245 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from zbicgstab_cpu.cpp normal z -> d, Tue Sep  2 12:38:36 2014
+
+*/
+#include "common_magma.h"
+#include "magmasparse.h"
+
+#include <assert.h>
+
+
+#define RTOLERANCE     lapackf77_dlamch( "E" )
+#define ATOLERANCE     lapackf77_dlamch( "E" )
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a general complex N-by-N matrix A.
+    This is a CPU implementation of the (preconditioned)
+    Biconjugate Gradient Stabelized method, used by magma_dbicgstab and
+    magma_dpbicgstab if A is located on the CPU. A, b and x are on the CPU.
+
+    The updates of x and r at the end of an iteration are fused with the
+    residual norm and the next <rr,r> in magma_dbicgupdate_cpu.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_d_sparse_matrix
+                input matrix A
+
+    @param
+    b           magma_d_vector
+                RHS b
+
+    @param
+    x           magma_d_vector*
+                solution approximation
+
+    @param
+    solver_par  magma_d_solver_par*
+                solver parameters
+
+    @param
+    precond_par magma_d_preconditioner*
+                preconditioner parameters, or NULL for the
+                unpreconditioned method
+
+    @ingroup magmasparse_dgesv
+    ********************************************************************/
+
+magma_int_t
+magma_dpbicgstab_cpu( magma_d_sparse_matrix A, magma_d_vector b, magma_d_vector *x,
+                      magma_d_solver_par *solver_par,
+                      magma_d_preconditioner *precond_par ){
+
+    // prepare solver feedback
+    solver_par->numiter = 0;
+    solver_par->info = 0;
+
+    // some useful variables
+    double c_zero = MAGMA_D_ZERO, c_one = MAGMA_D_ONE,
+                                            c_mone = MAGMA_D_NEG_ONE;
+
+    magma_int_t dofs = A.num_rows;
+    magma_int_t precond = ( precond_par != NULL
+                            && precond_par->solver != Magma_NONE );
+
+    // workspace
+    magma_d_vector r,rr,p,v,s,t,ms,mt,y,z;
+    magma_d_vinit( &r, Magma_CPU, dofs, c_zero );
+    magma_d_vinit( &rr, Magma_CPU, dofs, c_zero );
+    magma_d_vinit( &p, Magma_CPU, dofs, c_zero );
+    magma_d_vinit( &v, Magma_CPU, dofs, c_zero );
+    magma_d_vinit( &s, Magma_CPU, dofs, c_zero );
+    magma_d_vinit( &t, Magma_CPU, dofs, c_zero );
+    if( precond ){
+        magma_d_vinit( &ms, Magma_CPU, dofs, c_zero );
+        magma_d_vinit( &mt, Magma_CPU, dofs, c_zero );
+        magma_d_vinit( &y, Magma_CPU, dofs, c_zero );
+        magma_d_vinit( &z, Magma_CPU, dofs, c_zero );
+    }
+    else{
+        y = p;
+        z = ms = s;
+        mt = t;
+    }
+
+    // solver variables
+    double alpha, beta, omega, rho_old, rho_new, rho_next;
+    double dots[2];
+    double nom, betanom, nom0, r0, res;
+
+    // solver setup
+    magma_daxpby_cpu( dofs, c_zero, b.val, c_zero, x->val );   // x = 0
+    magma_daxpby_cpu( dofs, c_one, b.val, c_zero, r.val );     // r = b
+    magma_daxpby_cpu( dofs, c_one, b.val, c_zero, rr.val );    // rr = b
+    nom0 = betanom = magma_dnrm2_cpu( dofs, r.val );          // nom = || r ||
+    nom = nom0*nom0;
+    rho_new = omega = alpha = MAGMA_D_MAKE( 1.0, 0. );
+    rho_next = MAGMA_D_MAKE( nom, 0. );                        // <rr,r>
+    solver_par->init_res = nom0;
+
+    if ( (r0 = nom * solver_par->epsilon) < ATOLERANCE )
+        r0 = ATOLERANCE;
+    if ( nom < r0 ){
+        solver_par->iter_res = nom0;
+        solver_par->final_res = nom0;
+        magma_d_vfree(&r);
+        magma_d_vfree(&rr);
+        magma_d_vfree(&p);
+        magma_d_vfree(&v);
+        magma_d_vfree(&s);
+        magma_d_vfree(&t);
+        if( precond ){
+            magma_d_vfree(&ms);
+            magma_d_vfree(&mt);
+            magma_d_vfree(&y);
+            magma_d_vfree(&z);
+        }
+        return MAGMA_SUCCESS;
+    }
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+    tempo1=magma_wtime();
+    if( solver_par->verbose > 0 ){
+        solver_par->res_vec[0] = nom0;
+        solver_par->timing[0] = 0.0;
+    }
+
+    // start iteration
+    for( solver_par->numiter= 1; solver_par->numiter<solver_par->maxiter;
+                                                    solver_par->numiter++ ){
+        rho_old = rho_new;                                   // rho_old=rho
+        rho_new = rho_next;                                  // rho=<rr,r>
+        beta = rho_new/rho_old * alpha/omega;   // beta=rho/rho_old *alpha/omega
+        magma_daxpbypcz_cpu( dofs, c_one, r.val, c_mone * omega * beta, v.val,
+                             beta, p.val );         // p = r + beta*(p-omega*v)
+
+        // preconditioner
+        if( precond ){
+            magma_d_applyprecond_left( A, p, &mt, precond_par );
+            magma_d_applyprecond_right( A, mt, &y, precond_par );
+        }
+
+        magma_d_spmv( c_one, A, y, c_zero, v );              // v = Ap
+
+        alpha = rho_new / magma_ddotc_cpu( dofs, rr.val, v.val );
+        magma_daxpbypcz_cpu( dofs, c_one, r.val, c_mone * alpha, v.val,
+                             c_zero, s.val );                // s=r-alpha*v
+
+        // preconditioner
+        if( precond ){
+            magma_d_applyprecond_left( A, s, &ms, precond_par );
+            magma_d_applyprecond_right( A, ms, &z, precond_par );
+        }
+
+        magma_d_spmv( c_one, A, z, c_zero, t );               // t=As
+
+        // preconditioner
+        if( precond ){
+            magma_d_applyprecond_left( A, s, &ms, precond_par );
+            magma_d_applyprecond_left( A, t, &mt, precond_par );
+        }
+
+        // omega = <mt,ms>/<mt,mt>
+        magma_ddotc2_cpu( dofs, mt.val, ms.val, dots );
+        omega = dots[0] / dots[1];
+
+        // x=x+alpha*p+omega*s, r=s-omega*t, rho_next=<rr,r>
+        nom = magma_dbicgupdate_cpu( dofs, alpha, omega, y.val, z.val, s.val,
+                                     t.val, rr.val, x->val, r.val, &rho_next );
+        res = betanom = sqrt( nom );
+
+        if( solver_par->verbose > 0 ){
+            tempo2=magma_wtime();
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if ( res/nom0  < solver_par->epsilon ) {
+            break;
+        }
+    }
+    tempo2=magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    double residual;
+    magma_dresidual( A, b, *x, &residual );
+    solver_par->final_res = residual;
+    solver_par->iter_res = res;
+
+    if( solver_par->numiter < solver_par->maxiter){
+        solver_par->info = 0;
+    }else if( solver_par->init_res > solver_par->final_res ){
+        if( solver_par->verbose > 0 ){
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        solver_par->info = -2;
+    }
+    else{
+        if( solver_par->verbose > 0 ){
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        solver_par->info = -1;
+    }
+    magma_d_vfree(&r);
+    magma_d_vfree(&rr);
+    magma_d_vfree(&p);
+    magma_d_vfree(&v);
+    magma_d_vfree(&s);
+    magma_d_vfree(&t);
+    if( precond ){
+        magma_d_vfree(&ms);
+        magma_d_vfree(&mt);
+        magma_d_vfree(&y);
+        magma_d_vfree(&z);
+    }
+
+    return MAGMA_SUCCESS;
+}   /* magma_dpbicgstab_cpu */
@@ -59,6 +59,10 @@ magma_dcg( magma_d_sparse_matrix A, magma_d_vector b, magma_d_vector *x,
     solver_par->numiter = 0;
     solver_par->info = 0; 
 
+    // CPU implementation
+    if( A.memory_location == Magma_CPU )
+        return magma_dpcg_cpu( A, b, x, solver_par, NULL );
+
     // local variables
     double c_zero = MAGMA_D_ZERO, c_one = MAGMA_D_ONE;
     
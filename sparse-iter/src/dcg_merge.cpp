@@ -57,6 +57,11 @@ magma_dcg_merge( magma_d_sparse_matrix A, magma_d_vector b, magma_d_vector *x,
 
     // prepare solver feedback
     solver_par->solver = Magma_CGMERGE;
+
+    // CPU implementation
+    if( A.memory_location == Magma_CPU )
+        return magma_dcg_merge_cpu( A, b, x, solver_par );
+
     solver_par->numiter = 0;
     solver_par->info = 0; 
 
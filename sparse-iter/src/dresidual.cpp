@@ -54,6 +54,16 @@ magma_dresidual( magma_d_sparse_matrix A, magma_d_vector b, magma_d_vector x,
     
     
     magma_d_vector r;
+    if( A.memory_location == Magma_CPU ){
+        magma_d_vinit( &r, Magma_CPU, A.num_rows, zero );
+
+        magma_d_spmv( one, A, x, zero, r );                   // r = A x
+        magma_daxpby_cpu( dofs, mone, b.val, one, r.val );    // r = r - b
+        *res =  magma_dnrm2_cpu( dofs, r.val );              // res = ||r||
+
+        magma_d_vfree(&r);
+        return MAGMA_SUCCESS;
+    }
     magma_d_vinit( &r, Magma_DEV, A.num_rows, zero );
 
     magma_d_spmv( one, A, x, zero, r );                   // r = A x
@@ -135,20 +135,22 @@ magma_c_precondsetup( magma_c_sparse_matrix A, magma_c_vector b,
                       magma_c_preconditioner *precond )
 {
     if( precond->solver == Magma_JACOBI ){
-        magma_cjacobisetup_diagscal( A, &(precond->d) );
-        return MAGMA_SUCCESS;
+        return magma_cjacobisetup_diagscal( A, &(precond->d) );
     }
     else if( precond->solver == Magma_PASTIX ){
-        magma_cpastixsetup( A, b, precond );
-        return MAGMA_SUCCESS;
+        return magma_cpastixsetup( A, b, precond );
     }
     else if( precond->solver == Magma_ILU ){
-        magma_ccuilusetup( A, precond );
-        return MAGMA_SUCCESS;
+        if( A.memory_location == Magma_CPU )
+            return magma_cilusetup_cpu( A, precond );
+        else
+            return magma_ccuilusetup( A, precond );
     }
     else if( precond->solver == Magma_ICC ){
-        magma_ccuiccsetup( A, precond );
-        return MAGMA_SUCCESS;
+        if( A.memory_location == Magma_CPU )
+            return magma_cilusetup_cpu( A, precond );
+        else
+            return magma_ccuiccsetup( A, precond );
     }
     else if( precond->solver == Magma_NONE ){
         return MAGMA_SUCCESS;
@@ -268,6 +270,23 @@ magma_int_t
 magma_c_applyprecond_left( magma_c_sparse_matrix A, magma_c_vector b, 
                       magma_c_vector *x, magma_c_preconditioner *precond )
 {
+    if( b.memory_location == Magma_CPU ){
+        if( precond->solver == Magma_JACOBI ){
+            magma_cjacobi_diagscal_cpu( A.num_rows, precond->d.val, b.val, 
+                                                                x->val );
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_ILU || 
+                 precond->solver == Magma_ICC ){
+            magma_capplyilu_l_cpu( b, x, precond );
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_NONE ){
+            magma_caxpby_cpu( b.num_rows, MAGMA_C_ONE, b.val, 
+                              MAGMA_C_ZERO, x->val );           //  x = b
+            return MAGMA_SUCCESS;
+        }
+    }
     if( precond->solver == Magma_JACOBI ){
         magma_cjacobi_diagscal( A.num_rows, precond->d.val, b.val, x->val );
         return MAGMA_SUCCESS;
@@ -327,6 +346,19 @@ magma_int_t
 magma_c_applyprecond_right( magma_c_sparse_matrix A, magma_c_vector b, 
                       magma_c_vector *x, magma_c_preconditioner *precond )
 {
+    if( b.memory_location == Magma_CPU ){
+        if( precond->solver == Magma_JACOBI || 
+            precond->solver == Magma_NONE ){
+            magma_caxpby_cpu( b.num_rows, MAGMA_C_ONE, b.val, 
+                              MAGMA_C_ZERO, x->val );           //  x = b
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_ILU || 
+                 precond->solver == Magma_ICC ){
+            magma_capplyilu_r_cpu( b, x, precond );
+            return MAGMA_SUCCESS;
+        }
+    }
     if( precond->solver == Magma_JACOBI ){
         //magma_cjacobi_diagscal( A.num_rows, precond->d.val, b.val, x->val );
         magma_ccopy( b.num_rows, b.val, 1, x->val, 1 );    // x = b
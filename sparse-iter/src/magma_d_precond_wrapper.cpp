@@ -135,20 +135,22 @@ magma_d_precondsetup( magma_d_sparse_matrix A, magma_d_vector b,
                       magma_d_preconditioner *precond )
 {
     if( precond->solver == Magma_JACOBI ){
-        magma_djacobisetup_diagscal( A, &(precond->d) );
-        return MAGMA_SUCCESS;
+        return magma_djacobisetup_diagscal( A, &(precond->d) );
     }
     else if( precond->solver == Magma_PASTIX ){
-        magma_dpastixsetup( A, b, precond );
-        return MAGMA_SUCCESS;
+        return magma_dpastixsetup( A, b, precond );
     }
     else if( precond->solver == Magma_ILU ){
-        magma_dcuilusetup( A, precond );
-        return MAGMA_SUCCESS;
+        if( A.memory_location == Magma_CPU )
+            return magma_dilusetup_cpu( A, precond );
+        else
+            return magma_dcuilusetup( A, precond );
     }
     else if( precond->solver == Magma_ICC ){
-        magma_dcuiccsetup( A, precond );
-        return MAGMA_SUCCESS;
+        if( A.memory_location == Magma_CPU )
+            return magma_dilusetup_cpu( A, precond );
+        else
+            return magma_dcuiccsetup( A, precond );
     }
     else if( precond->solver == Magma_NONE ){
         return MAGMA_SUCCESS;
@@ -268,6 +270,23 @@ magma_int_t
 magma_d_applyprecond_left( magma_d_sparse_matrix A, magma_d_vector b, 
                       magma_d_vector *x, magma_d_preconditioner *precond )
 {
+    if( b.memory_location == Magma_CPU ){
+        if( precond->solver == Magma_JACOBI ){
+            magma_djacobi_diagscal_cpu( A.num_rows, precond->d.val, b.val, 
+                                                                x->val );
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_ILU || 
+                 precond->solver == Magma_ICC ){
+            magma_dapplyilu_l_cpu( b, x, precond );
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_NONE ){
+            magma_daxpby_cpu( b.num_rows, MAGMA_D_ONE, b.val, 
+                              MAGMA_D_ZERO, x->val );           //  x = b
+            return MAGMA_SUCCESS;
+        }
+    }
     if( precond->solver == Magma_JACOBI ){
         magma_djacobi_diagscal( A.num_rows, precond->d.val, b.val, x->val );
         return MAGMA_SUCCESS;
@@ -327,6 +346,19 @@ magma_int_t
 magma_d_applyprecond_right( magma_d_sparse_matrix A, magma_d_vector b, 
                       magma_d_vector *x, magma_d_preconditioner *precond )
 {
+    if( b.memory_location == Magma_CPU ){
+        if( precond->solver == Magma_JACOBI || 
+            precond->solver == Magma_NONE ){
+            magma_daxpby_cpu( b.num_rows, MAGMA_D_ONE, b.val, 
+                              MAGMA_D_ZERO, x->val );           //  x = b
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_ILU || 
+                 precond->solver == Magma_ICC ){
+            magma_dapplyilu_r_cpu( b, x, precond );
+            return MAGMA_SUCCESS;
+        }
+    }
     if( precond->solver == Magma_JACOBI ){
         //magma_djacobi_diagscal( A.num_rows, precond->d.val, b.val, x->val );
         magma_dcopy( b.num_rows, b.val, 1, x->val, 1 );    // x = b
@@ -48,6 +48,21 @@ magma_d_solver( magma_d_sparse_matrix A, magma_d_vector b,
                  magma_d_vector *x, magma_dopts *zopts ){
 
 
+        // the CPU implementations cover the Krylov solvers
+        if( A.memory_location == Magma_CPU &&
+            zopts->solver_par.solver != Magma_CG &&
+            zopts->solver_par.solver != Magma_CGMERGE &&
+            zopts->solver_par.solver != Magma_PCG &&
+            zopts->solver_par.solver != Magma_BICGSTAB &&
+            zopts->solver_par.solver != Magma_BICGSTABMERGE &&
+            zopts->solver_par.solver != Magma_BICGSTABMERGE2 &&
+            zopts->solver_par.solver != Magma_PBICGSTAB &&
+            zopts->solver_par.solver != Magma_GMRES &&
+            zopts->solver_par.solver != Magma_PGMRES ){
+            printf( "error: solver not supported on the CPU.\n" );
+            return MAGMA_ERR_NOT_SUPPORTED;
+        }
+
         // preconditioner
         if( zopts->solver_par.solver != Magma_ITERREF )
             magma_d_precondsetup( A, b, &zopts->precond_par );
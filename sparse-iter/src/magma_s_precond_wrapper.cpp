@@ -135,20 +135,22 @@ magma_s_precondsetup( magma_s_sparse_matrix A, magma_s_vector b,
                       magma_s_preconditioner *precond )
 {
     if( precond->solver == Magma_JACOBI ){
-        magma_sjacobisetup_diagscal( A, &(precond->d) );
-        return MAGMA_SUCCESS;
+        return magma_sjacobisetup_diagscal( A, &(precond->d) );
     }
     else if( precond->solver == Magma_PASTIX ){
-        magma_spastixsetup( A, b, precond );
-        return MAGMA_SUCCESS;
+        return magma_spastixsetup( A, b, precond );
     }
     else if( precond->solver == Magma_ILU ){
-        magma_scuilusetup( A, precond );
-        return MAGMA_SUCCESS;
+        if( A.memory_location == Magma_CPU )
+            return magma_silusetup_cpu( A, precond );
+        else
+            return magma_scuilusetup( A, precond );
     }
     else if( precond->solver == Magma_ICC ){
-        magma_scuiccsetup( A, precond );
-        return MAGMA_SUCCESS;
+        if( A.memory_location == Magma_CPU )
+            return magma_silusetup_cpu( A, precond );
+        else
+            return magma_scuiccsetup( A, precond );
     }
     else if( precond->solver == Magma_NONE ){
         return MAGMA_SUCCESS;
@@ -268,6 +270,23 @@ magma_int_t
 magma_s_applyprecond_left( magma_s_sparse_matrix A, magma_s_vector b, 
                       magma_s_vector *x, magma_s_preconditioner *precond )
 {
+    if( b.memory_location == Magma_CPU ){
+        if( precond->solver == Magma_JACOBI ){
+            magma_sjacobi_diagscal_cpu( A.num_rows, precond->d.val, b.val, 
+                                                                x->val );
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_ILU || 
+                 precond->solver == Magma_ICC ){
+            magma_sapplyilu_l_cpu( b, x, precond );
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_NONE ){
+            magma_saxpby_cpu( b.num_rows, MAGMA_S_ONE, b.val, 
+                              MAGMA_S_ZERO, x->val );           //  x = b
+            return MAGMA_SUCCESS;
+        }
+    }
     if( precond->solver == Magma_JACOBI ){
         magma_sjacobi_diagscal( A.num_rows, precond->d.val, b.val, x->val );
         return MAGMA_SUCCESS;
@@ -327,6 +346,19 @@ magma_int_t
 magma_s_applyprecond_right( magma_s_sparse_matrix A, magma_s_vector b, 
                       magma_s_vector *x, magma_s_preconditioner *precond )
 {
+    if( b.memory_location == Magma_CPU ){
+        if( precond->solver == Magma_JACOBI || 
+            precond->solver == Magma_NONE ){
+            magma_saxpby_cpu( b.num_rows, MAGMA_S_ONE, b.val, 
+                              MAGMA_S_ZERO, x->val );           //  x = b
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_ILU || 
+                 precond->solver == Magma_ICC ){
+            magma_sapplyilu_r_cpu( b, x, precond );
+            return MAGMA_SUCCESS;
+        }
+    }
     if( precond->solver == Magma_JACOBI ){
         //magma_sjacobi_diagscal( A.num_rows, precond->d.val, b.val, x->val );
         magma_scopy( b.num_rows, b.val, 1, x->val, 1 );    // x = b
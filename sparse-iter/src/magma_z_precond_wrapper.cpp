@@ -135,20 +135,22 @@ magma_z_precondsetup( magma_z_sparse_matrix A, magma_z_vector b,
                       magma_z_preconditioner *precond )
 {
     if( precond->solver == Magma_JACOBI ){
-        magma_zjacobisetup_diagscal( A, &(precond->d) );
-        return MAGMA_SUCCESS;
+        return magma_zjacobisetup_diagscal( A, &(precond->d) );
     }
     else if( precond->solver == Magma_PASTIX ){
-        magma_zpastixsetup( A, b, precond );
-        return MAGMA_SUCCESS;
+        return magma_zpastixsetup( A, b, precond );
     }
     else if( precond->solver == Magma_ILU ){
-        magma_zcuilusetup( A, precond );
-        return MAGMA_SUCCESS;
+        if( A.memory_location == Magma_CPU )
+            return magma_zilusetup_cpu( A, precond );
+        else
+            return magma_zcuilusetup( A, precond );
     }
     else if( precond->solver == Magma_ICC ){
-        magma_zcuiccsetup( A, precond );
-        return MAGMA_SUCCESS;
+        if( A.memory_location == Magma_CPU )
+            return magma_zilusetup_cpu( A, precond );
+        else
+            return magma_zcuiccsetup( A, precond );
     }
     else if( precond->solver == Magma_NONE ){
         return MAGMA_SUCCESS;
@@ -268,6 +270,23 @@ magma_int_t
 magma_z_applyprecond_left( magma_z_sparse_matrix A, magma_z_vector b, 
                       magma_z_vector *x, magma_z_preconditioner *precond )
 {
+    if( b.memory_location == Magma_CPU ){
+        if( precond->solver == Magma_JACOBI ){
+            magma_zjacobi_diagscal_cpu( A.num_rows, precond->d.val, b.val, 
+                                                                x->val );
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_ILU || 
+                 precond->solver == Magma_ICC ){
+            magma_zapplyilu_l_cpu( b, x, precond );
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_NONE ){
+            magma_zaxpby_cpu( b.num_rows, MAGMA_Z_ONE, b.val, 
+                              MAGMA_Z_ZERO, x->val );           //  x = b
+            return MAGMA_SUCCESS;
+        }
+    }
     if( precond->solver == Magma_JACOBI ){
         magma_zjacobi_diagscal( A.num_rows, precond->d.val, b.val, x->val );
         return MAGMA_SUCCESS;
@@ -327,6 +346,19 @@ magma_int_t
 magma_z_applyprecond_right( magma_z_sparse_matrix A, magma_z_vector b, 
                       magma_z_vector *x, magma_z_preconditioner *precond )
 {
+    if( b.memory_location == Magma_CPU ){
+        if( precond->solver == Magma_JACOBI || 
+            precond->solver == Magma_NONE ){
+            magma_zaxpby_cpu( b.num_rows, MAGMA_Z_ONE, b.val, 
+                              MAGMA_Z_ZERO, x->val );           //  x = b
+            return MAGMA_SUCCESS;
+        }
+        else if( precond->solver == Magma_ILU || 
+                 precond->solver == Magma_ICC ){
+            magma_zapplyilu_r_cpu( b, x, precond );
+            return MAGMA_SUCCESS;
+        }
+    }
     if( precond->solver == Magma_JACOBI ){
         //magma_zjacobi_diagscal( A.num_rows, precond->d.val, b.val, x->val );
         magma_zcopy( b.num_rows, b.val, 1, x->val, 1 );    // x = b
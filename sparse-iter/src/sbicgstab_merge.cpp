@@ -57,6 +57,11 @@ magma_sbicgstab_merge( magma_s_sparse_matrix A, magma_s_vector b,
 
     // prepare solver feedback
     solver_par->solver = Magma_BICGSTABMERGE;
+
+    // CPU implementation
+    if( A.memory_location == Magma_CPU )
+        return magma_sbicgstab_merge_cpu( A, b, x, solver_par );
+
     solver_par->numiter = 0;
     solver_par->info = 0;
 
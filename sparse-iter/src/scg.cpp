@@ -59,6 +59,10 @@ magma_scg( magma_s_sparse_matrix A, magma_s_vector b, magma_s_vector *x,
     solver_par->numiter = 0;
     solver_par->info = 0; 
 
+    // CPU implementation
+    if( A.memory_location == Magma_CPU )
+        return magma_spcg_cpu( A, b, x, solver_par, NULL );
+
     // local variables
     float c_zero = MAGMA_S_ZERO, c_one = MAGMA_S_ONE;
     
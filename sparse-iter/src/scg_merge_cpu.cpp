@@ -0,0 +1,185 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from zcg_merge_cpu.cpp normal z -> s, Tue Sep  2 12:38:36 2014
+*/
+
+#include "common_magma.h"
+#include "magmasparse.h"
+
+#include <assert.h>
+
+#define RTOLERANCE     lapackf77_slamch( "E" )
+#define ATOLERANCE     lapackf77_slamch( "E" )
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex Hermitian N-by-N positive definite matrix A.
+    This is a CPU implementation of the Conjugate Gradient method in the
+    variant of magma_scg_merge, used by magma_scg_merge if A is located
+    on the CPU. A, b and x are on the CPU.
+
+    Each iteration is one call of magma_scgmerge_cpu, which reads and
+    writes the vectors in three passes and reduces the dot products from
+    per-thread partial sums. A is converted to CSR if it is stored in
+    another format.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_s_sparse_matrix
+                input matrix A
+
+    @param
+    b           magma_s_vector
+                RHS b
+
+    @param
+    x           magma_s_vector*
+                solution approximation
+
+    @param
+    solver_par  magma_s_solver_par*
+                solver parameters
+
+    @ingroup magmasparse_shesv
+    ********************************************************************/
+
+magma_int_t
+magma_scg_merge_cpu( magma_s_sparse_matrix A, magma_s_vector b, magma_s_vector *x,
+                     magma_s_solver_par *solver_par ){
+
+    // prepare solver feedback
+    solver_par->numiter = 0;
+    solver_par->info = 0;
+
+    // local variables
+    float c_zero = MAGMA_S_ZERO, c_one = MAGMA_S_ONE;
+    magma_int_t dofs = A.num_rows;
+
+    // the fused kernel needs A in CSR
+    magma_s_sparse_matrix hA;
+    if( A.storage_type != Magma_CSR )
+        magma_s_mconvert( A, &hA, A.storage_type, Magma_CSR );
+    else
+        hA = A;
+
+    // CPU workspace
+    magma_s_vector r, d, z;
+    magma_s_vinit( &r, Magma_CPU, dofs, c_zero );
+    magma_s_vinit( &d, Magma_CPU, dofs, c_zero );
+    magma_s_vinit( &z, Magma_CPU, dofs, c_zero );
+
+    // solver variables
+    float nom, nom0, r0, den, res;
+
+    // solver setup
+    magma_saxpby_cpu( dofs, c_zero, b.val, c_zero, x->val );   // x = 0
+    magma_saxpby_cpu( dofs, c_one, b.val, c_zero, r.val );     // r = b
+    magma_saxpby_cpu( dofs, c_one, b.val, c_zero, d.val );     // d = b
+    nom0 = res = magma_snrm2_cpu( dofs, r.val );
+    nom = nom0 * nom0;                                         // nom = r' * r
+    solver_par->init_res = nom0;
+
+    if ( (r0 = nom * solver_par->epsilon) < ATOLERANCE )
+        r0 = ATOLERANCE;
+    if ( nom < r0 ){
+        solver_par->iter_res = nom0;
+        solver_par->final_res = nom0;
+        if( A.storage_type != Magma_CSR )
+            magma_s_mfree( &hA );
+        magma_s_vfree(&r);
+        magma_s_vfree(&d);
+        magma_s_vfree(&z);
+        return MAGMA_SUCCESS;
+    }
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+    tempo1=magma_wtime();
+    if( solver_par->verbose > 0 ){
+        solver_par->res_vec[0] = (real_Double_t) nom0;
+        solver_par->timing[0] = 0.0;
+    }
+
+    // start iteration
+    for( solver_par->numiter= 1; solver_par->numiter<solver_par->maxiter;
+                                                    solver_par->numiter++ ){
+
+        // z = A d, den = d' z, updates x, r, and d, nom = r' * r
+        magma_scgmerge_cpu( hA, x->val, r.val, d.val, z.val, &nom, &den );
+
+        // check positive definite; the kernel does not update x, r, and d
+        // then, so the iteration cannot go on
+        if ( den <= 0.0 ) {
+            printf("Operator A is not postive definite. (Ar,r) = %f\n", den);
+            solver_par->info = -100;
+            break;
+        }
+
+        res = sqrt( nom );
+        if( solver_par->verbose > 0 ){
+            tempo2=magma_wtime();
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if (  res/nom0  < solver_par->epsilon ) {
+            break;
+        }
+    }
+    tempo2=magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    float residual;
+    magma_sresidual( A, b, *x, &residual );
+    solver_par->iter_res = res;
+    solver_par->final_res = residual;
+
+    if( solver_par->info == -100 ){
+        // A is not positive definite, keep the error
+    }else if( solver_par->numiter < solver_par->maxiter){
+        solver_par->info = 0;
+    }else if( solver_par->init_res > solver_par->final_res ){
+        if( solver_par->verbose > 0 ){
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        solver_par->info = -2;
+    }
+    else{
+        if( solver_par->verbose > 0 ){
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) res;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        solver_par->info = -1;
+    }
+    if( A.storage_type != Magma_CSR )
+        magma_s_mfree( &hA );
+    magma_s_vfree(&r);
+    magma_s_vfree(&d);
+    magma_s_vfree(&z);
+
+    return MAGMA_SUCCESS;
+}   /* magma_scg_merge_cpu */
@@ -237,6 +237,22 @@ magma_sjacobisetup_diagscal( magma_s_sparse_matrix A, magma_s_vector *d ){
     magma_s_vector diag;
     magma_s_vinit( &diag, Magma_CPU, A.num_rows, MAGMA_S_ZERO );
 
+    // the diagonal of a stencil is the value of its center point
+    if( A.storage_type == Magma_STENCIL ){
+        float center = MAGMA_S_ZERO;
+        for( i=0; i<A.max_nnz_row; i++ ){
+            if( A.col[3*i] == 0 && A.col[3*i+1] == 0 && A.col[3*i+2] == 0 )
+                center = A.val[i];
+        }
+        if( MAGMA_S_REAL( center ) == 0 )
+            printf(" error: zero diagonal element in the stencil!\n");
+        for( magma_int_t rowindex=0; rowindex<A.num_rows; rowindex++ )
+            diag.val[rowindex] = 1.0/center;
+        magma_s_vtransfer( diag, d, Magma_CPU, A.memory_location);
+        magma_s_vfree( &diag);
+        return MAGMA_SUCCESS;
+    }
+
     if( A.storage_type != Magma_CSR){
         magma_s_mtransfer( A, &A_h1, A.memory_location, Magma_CPU);
         magma_s_mconvert( A_h1, &B, A_h1.storage_type, Magma_CSR);
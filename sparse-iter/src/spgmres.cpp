@@ -76,6 +76,10 @@ magma_spgmres( magma_s_sparse_matrix A, magma_s_vector b, magma_s_vector *x,
     solver_par->numiter = 0;
     solver_par->info = 0;
 
+    // CPU implementation
+    if( A.memory_location == Magma_CPU )
+        return magma_spgmres_cpu( A, b, x, solver_par, precond_par );
+
     // local variables
     float c_zero = MAGMA_S_ZERO, c_one = MAGMA_S_ONE, 
                                                 c_mone = MAGMA_S_NEG_ONE;
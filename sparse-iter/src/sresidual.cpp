@@ -54,6 +54,16 @@ magma_sresidual( magma_s_sparse_matrix A, magma_s_vector b, magma_s_vector x,
     
     
     magma_s_vector r;
+    if( A.memory_location == Magma_CPU ){
+        magma_s_vinit( &r, Magma_CPU, A.num_rows, zero );
+
+        magma_s_spmv( one, A, x, zero, r );                   // r = A x
+        magma_saxpby_cpu( dofs, mone, b.val, one, r.val );    // r = r - b
+        *res =  magma_snrm2_cpu( dofs, r.val );              // res = ||r||
+
+        magma_s_vfree(&r);
+        return MAGMA_SUCCESS;
+    }
     magma_s_vinit( &r, Magma_DEV, A.num_rows, zero );
 
     magma_s_spmv( one, A, x, zero, r );                   // r = A x
@@ -59,6 +59,10 @@ magma_zcg_res( magma_z_sparse_matrix A, magma_z_vector b, magma_z_vector *x,
     solver_par->numiter = 0;
     solver_par->info = 0; 
 
+    // CPU implementation
+    if( A.memory_location == Magma_CPU )
+        return magma_zpcg_cpu( A, b, x, solver_par, NULL );
+
     // local variables
     magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE;
     
@@ -0,0 +1,275 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @precisions normal z -> s d c
+*/
+
+#include "common_magma.h"
+#include "magmasparse.h"
+
+
+#define PRECISION_z
+
+#define  q(i)     (q.val + (i)*dofs)
+#define  z(i)     (z.val + (i)*dofs)
+#define  H(i,j)  H[(i)   + (j)*(1+ldh)]
+
+
+#define RTOLERANCE     lapackf77_dlamch( "E" )
+#define ATOLERANCE     lapackf77_dlamch( "E" )
+
+
+/**
+    Purpose
+    -------
+
+    Solves a system of linear equations
+       A * X = B
+    where A is a complex sparse matrix stored in the CPU memory.
+    X and B are complex vectors stored in the CPU memory.
+    This is a CPU implementation of the (preconditioned) GMRES method
+    with modified Gram-Schmidt, used by magma_zgmres and magma_zpgmres
+    if A is located on the CPU.
+    The least squares problem in H_k is solved with Givens rotations,
+    which also give the residual norm in every step, so a restart cycle
+    stops as soon as the residual is small enough.
+
+    Arguments
+    ---------
+
+    @param
+    A           magma_z_sparse_matrix
+                descriptor for matrix A
+
+    @param
+    b           magma_z_vector
+                RHS b vector
+
+    @param
+    x           magma_z_vector*
+                solution approximation
+
+    @param
+    solver_par  magma_z_solver_par*
+                solver parameters
+
+    @param
+    precond_par magma_z_preconditioner*
+                preconditioner, or NULL for the unpreconditioned method
+
+    @ingroup magmasparse_zgesv
+    ********************************************************************/
+
+magma_int_t
+magma_zpgmres_cpu( magma_z_sparse_matrix A, magma_z_vector b, magma_z_vector *x,
+                   magma_z_solver_par *solver_par,
+                   magma_z_preconditioner *precond_par ){
+
+    // prepare solver feedback
+    solver_par->numiter = 0;
+    solver_par->info = 0;
+
+    // local variables
+    magmaDoubleComplex c_zero = MAGMA_Z_ZERO, c_one = MAGMA_Z_ONE,
+                                                c_mone = MAGMA_Z_NEG_ONE;
+    magma_int_t dofs = A.num_rows;
+    magma_int_t i, j, k, m = 0, ione = 1;
+    magma_int_t restart = min( dofs-1, solver_par->restart );
+    magma_int_t ldh = restart+1;
+    magma_int_t precond = ( precond_par != NULL
+                            && precond_par->solver != Magma_NONE );
+    double nom, rNorm, hnorm, nom0, betanom, r0 = 0.;
+
+    // CPU workspace
+    magmaDoubleComplex *H, *y, *cs, *sn, *g, temp;
+    magma_zmalloc_cpu( &H, (ldh+1)*ldh );
+    magma_zmalloc_cpu( &y, ldh );
+    magma_zmalloc_cpu( &cs, ldh );
+    magma_zmalloc_cpu( &sn, ldh );
+    magma_zmalloc_cpu( &g, ldh+1 );
+
+    // Krylov basis q and, if preconditioned, z[k] = M^(-1) q[k]
+    magma_z_vector r, q, q_t, z, z_t, t;
+    magma_z_vinit( &r, Magma_CPU, dofs, c_zero );
+    magma_z_vinit( &q, Magma_CPU, dofs*(ldh+1), c_zero );
+    q_t.memory_location = Magma_CPU;
+    q_t.val = NULL;
+    q_t.num_rows = q_t.nnz = dofs;
+    z_t = q_t;
+    if( precond ){
+        magma_z_vinit( &t, Magma_CPU, dofs, c_zero );
+        magma_z_vinit( &z, Magma_CPU, dofs*(ldh+1), c_zero );
+    }
+    else
+        z = q;
+
+    magma_zaxpby_cpu( dofs, c_zero, b.val, c_zero, x->val );   //  x = 0
+    magma_zaxpby_cpu( dofs, c_one, b.val, c_zero, r.val );     //  r = b
+    nom0 = betanom = magma_dznrm2_cpu( dofs, r.val );          //  nom0= || r||
+    nom = nom0  * nom0;
+    solver_par->init_res = nom0;
+    if ( (r0 = nom0 * RTOLERANCE ) < ATOLERANCE )
+        r0 = solver_par->epsilon;
+    if ( nom < r0 ){
+        solver_par->iter_res = nom0;
+        solver_par->final_res = nom0;
+        magma_free_cpu( H );
+        magma_free_cpu( y );
+        magma_free_cpu( cs );
+        magma_free_cpu( sn );
+        magma_free_cpu( g );
+        magma_z_vfree(&r);
+        magma_z_vfree(&q);
+        if( precond ){
+            magma_z_vfree(&t);
+            magma_z_vfree(&z);
+        }
+        return MAGMA_SUCCESS;
+    }
+
+    //Chronometry
+    real_Double_t tempo1, tempo2;
+    tempo1=magma_wtime();
+    if( solver_par->verbose > 0 ){
+        solver_par->res_vec[0] = nom0;
+        solver_par->timing[0] = 0.0;
+    }
+    // start iteration
+    for( solver_par->numiter= 1; solver_par->numiter<solver_par->maxiter;
+                                                    solver_par->numiter++ ){
+
+        g[1] = MAGMA_Z_MAKE( betanom, 0. );
+        hnorm = betanom;
+        for(k=1; k<=restart; k++) {
+
+            magma_zaxpby_cpu( dofs, MAGMA_Z_MAKE( 1./hnorm, 0. ), r.val,
+                              c_zero, q(k-1) );     //  q[k-1] = 1.0/||r|| r
+            q_t.val = q(k-1);
+            z_t.val = z(k-1);
+            if( precond ){
+                //  z[k] = M^(-1) q(k)
+                magma_z_applyprecond_left( A, q_t, &t, precond_par );
+                magma_z_applyprecond_right( A, t, &z_t, precond_par );
+            }
+
+            // r = A z[k]
+            magma_z_spmv( c_one, A, z_t, c_zero, r );
+
+            // modified Gram-Schmidt
+            for (i=1; i<=k; i++) {
+                H(i,k) = magma_zdotc_cpu( dofs, q(i-1), r.val );
+                    //  H(i,k) = q[i] . r
+                magma_zaxpby_cpu( dofs, -H(i,k), q(i-1), c_one, r.val );
+                    //  r = r - H(i,k) q[i]
+            }
+            hnorm = magma_dznrm2_cpu( dofs, r.val );
+            H(k+1,k) = MAGMA_Z_MAKE( hnorm, 0. );
+                    //  H(k+1,k) = ||r||
+
+            /*     Minimization of  || b-Ax ||  in H_k       */
+            // apply the previous rotations to the new column of H
+            for (i=1; i<k; i++) {
+                temp       =  cs[i] * H(i,k) + sn[i] * H(i+1,k);
+                H(i+1,k)   = -MAGMA_Z_CNJG( sn[i] ) * H(i,k) + cs[i] * H(i+1,k);
+                H(i,k)     =  temp;
+            }
+            // rotation that eliminates H(k+1,k)
+            rNorm = MAGMA_Z_ABS( H(k,k) );
+            temp = MAGMA_Z_MAKE( sqrt( rNorm*rNorm + hnorm*hnorm ), 0. );
+            if ( rNorm == 0. ) {
+                cs[k] = c_zero;
+                sn[k] = c_one;
+                H(k,k) = temp;
+            } else {
+                cs[k] = MAGMA_Z_MAKE( rNorm, 0. ) / temp;
+                sn[k] = H(k,k) / rNorm * MAGMA_Z_CNJG( H(k+1,k) ) / temp;
+                H(k,k) = H(k,k) / rNorm * temp;
+            }
+            H(k+1,k) = c_zero;
+            g[k+1] = -MAGMA_Z_CNJG( sn[k] ) * g[k];
+            g[k] = cs[k] * g[k];
+            m = k;
+            rNorm = MAGMA_Z_ABS( g[k+1] );        // || b-Ax || for x+Z y
+            if ( rNorm < r0 )
+                break;
+        }/*     Minimization done       */
+        // y = H(1:m,1:m) \ g(1:m)
+        for (i=m; i>=1; i--) {
+            y[i] = g[i];
+            for (j=i+1; j<=m; j++)
+                y[i] -= H(i,j) * y[j];
+            y[i] = y[i] / H(i,i);
+        }
+        // compute solution approximation
+        blasf77_zgemv( MagmaNoTransStr, &dofs, &m, &c_one, z(0), &dofs, y+1,
+                       &ione, &c_one, x->val, &ione );
+
+        // compute residual
+        magma_z_spmv( c_mone, A, *x, c_zero, r );                 //  r = - A * x
+        magma_zaxpby_cpu( dofs, c_one, b.val, c_one, r.val );    //  r = r + b
+        betanom = magma_dznrm2_cpu( dofs, r.val );                //  || r ||
+
+        if( solver_par->verbose > 0 ){
+            tempo2=magma_wtime();
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+
+        if (  betanom  < r0 ) {
+            break;
+        }
+    }
+
+    tempo2=magma_wtime();
+    solver_par->runtime = (real_Double_t) tempo2-tempo1;
+    double residual;
+    magma_zresidual( A, b, *x, &residual );
+    solver_par->iter_res = betanom;
+    solver_par->final_res = residual;
+
+    if( solver_par->numiter < solver_par->maxiter){
+        solver_par->info = 0;
+    }else if( solver_par->init_res > solver_par->final_res ){
+        if( solver_par->verbose > 0 ){
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        solver_par->info = -2;
+    }
+    else{
+        if( solver_par->verbose > 0 ){
+            if( (solver_par->numiter)%solver_par->verbose==0 ) {
+                solver_par->res_vec[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) betanom;
+                solver_par->timing[(solver_par->numiter)/solver_par->verbose]
+                        = (real_Double_t) tempo2-tempo1;
+            }
+        }
+        solver_par->info = -1;
+    }
+    magma_free_cpu( H );
+    magma_free_cpu( y );
+    magma_free_cpu( cs );
+    magma_free_cpu( sn );
+    magma_free_cpu( g );
+    magma_z_vfree(&r);
+    magma_z_vfree(&q);
+    if( precond ){
+        magma_z_vfree(&t);
+        magma_z_vfree(&z);
+    }
+
+    return MAGMA_SUCCESS;
+}   /* magma_zpgmres_cpu */
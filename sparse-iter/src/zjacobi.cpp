@@ -237,6 +237,22 @@ magma_zjacobisetup_diagscal( magma_z_sparse_matrix A, magma_z_vector *d ){
     magma_z_vector diag;
     magma_z_vinit( &diag, Magma_CPU, A.num_rows, MAGMA_Z_ZERO );
 
+    // the diagonal of a stencil is the value of its center point
+    if( A.storage_type == Magma_STENCIL ){
+        magmaDoubleComplex center = MAGMA_Z_ZERO;
+        for( i=0; i<A.max_nnz_row; i++ ){
+            if( A.col[3*i] == 0 && A.col[3*i+1] == 0 && A.col[3*i+2] == 0 )
+                center = A.val[i];
+        }
+        if( MAGMA_Z_REAL( center ) == 0 )
+            printf(" error: zero diagonal element in the stencil!\n");
+        for( magma_int_t rowindex=0; rowindex<A.num_rows; rowindex++ )
+            diag.val[rowindex] = 1.0/center;
+        magma_z_vtransfer( diag, d, Magma_CPU, A.memory_location);
+        magma_z_vfree( &diag);
+        return MAGMA_SUCCESS;
+    }
+
     if( A.storage_type != Magma_CSR){
         magma_z_mtransfer( A, &A_h1, A.memory_location, Magma_CPU);
         magma_z_mconvert( A_h1, &B, A_h1.storage_type, Magma_CSR);
@@ -54,6 +54,16 @@ magma_zresidual( magma_z_sparse_matrix A, magma_z_vector b, magma_z_vector x,
     
     
     magma_z_vector r;
+    if( A.memory_location == Magma_CPU ){
+        magma_z_vinit( &r, Magma_CPU, A.num_rows, zero );
+
+        magma_z_spmv( one, A, x, zero, r );                   // r = A x
+        magma_zaxpby_cpu( dofs, mone, b.val, one, r.val );    // r = r - b
+        *res =  magma_dznrm2_cpu( dofs, r.val );              // res = ||r||
+
+        magma_z_vfree(&r);
+        return MAGMA_SUCCESS;
+    }
     magma_z_vinit( &r, Magma_DEV, A.num_rows, zero );
 
     magma_z_spmv( one, A, x, zero, r );                   // r = A x
@@ -37,18 +37,63 @@
 #endif
 
 
+// ---------------------------------------------
+// Times nrep products y = A * x on the CPU, and returns the time of one.
+static real_Double_t
+cpu_spmv_time( magma_c_sparse_matrix A, magma_c_vector x, magma_c_vector y,
+               magma_int_t nrep )
+{
+    magmaFloatComplex one  = MAGMA_C_MAKE(1.0, 0.0);
+    magmaFloatComplex zero = MAGMA_C_MAKE(0.0, 0.0);
+    magma_c_spmv( one, A, x, zero, y );     // warm up
+    real_Double_t start = magma_wtime();
+    for( magma_int_t j=0; j < nrep; j++ )
+        magma_c_spmv( one, A, x, zero, y );
+    return ( magma_wtime() - start ) / nrep;
+}
+
+
+// ---------------------------------------------
+// Returns the largest over the nv vectors of length n in y and r
+// of max_i |y_i - r_i| / max_i |r_i|.
+static real_Double_t
+vector_error( magma_c_vector y, magma_c_vector r, magma_int_t n, magma_int_t nv )
+{
+    real_Double_t error = 0;
+    for( magma_int_t k=0; k < nv; k++ ){
+        real_Double_t diff = 0, norm = 0;
+        for( magma_int_t i=k*n; i < (k+1)*n; i++ ){
+            diff = max( diff, (real_Double_t) MAGMA_C_ABS( MAGMA_C_SUB( y.val[i], r.val[i] )));
+            norm = max( norm, (real_Double_t) MAGMA_C_ABS( r.val[i] ));
+        }
+        error = max( error, ( norm > 0 ? diff / norm : diff ));
+    }
+    return error;
+}
+
+
 /* ////////////////////////////////////////////////////////////////////////////
    -- testing sparse matrix vector product
+   On the CPU, times CSR, ELLPACK, ELL, and SELLP for one vector and for
+   --num_vecs vectors (default 4), reporting GFLOP/s and the GB/s of
+   matrix and vectors read and written, and checks each of the result
+   vectors against the single-vector CSR SpMV applied to that column of x
+   alone. Checks that an x whose length is not a multiple of the number of
+   columns is rejected. Then times CSR, ELL, and SELLP on the GPU.
 */
 int main( int argc, char** argv)
 {
     TESTING_INIT();
 
-    magma_c_sparse_matrix hA, hA_SELLP, hA_ELL, dA, dA_SELLP, dA_ELL;
+    magma_c_sparse_matrix hA, hA_SELLP, hA_ELL, dA, dA_SELLP, dA_ELL, hB;
     hA_SELLP.blocksize = 8;
     hA_SELLP.alignment = 8;
     float start, end;
+    magma_int_t num_vecs = 4;
+    magma_int_t nrep = 10;
     magma_int_t *pntre;
+    magma_int_t status = 0;
+    real_Double_t tol = 100 * lapackf77_slamch("E");
 
     magmaFloatComplex one  = MAGMA_C_MAKE(1.0, 0.0);
     magmaFloatComplex zero = MAGMA_C_MAKE(0.0, 0.0);
@@ -59,12 +104,18 @@ int main( int argc, char** argv)
             hA_SELLP.blocksize = atoi( argv[++i] );
         }else if ( strcmp("--alignment", argv[i]) == 0 ) {
             hA_SELLP.alignment = atoi( argv[++i] );
+        }else if ( strcmp("--num_vecs", argv[i]) == 0 ) {
+            num_vecs = max( 1, atoi( argv[++i] ));
+        }else if ( strcmp("--nrep", argv[i]) == 0 ) {
+            nrep = max( 1, atoi( argv[++i] ));
         }else
             break;
     }
     printf( "\n#    usage: ./run_cspmv"
-        " [ --blocksize %d --alignment %d (for SELLP) ]"
-        " matrices \n\n", hA_SELLP.blocksize, hA_SELLP.alignment );
+        " [ --blocksize %d --alignment %d (for SELLP)"
+        " --num_vecs %d --nrep %d ]"
+        " matrices \n\n", hA_SELLP.blocksize, hA_SELLP.alignment,
+        (int) num_vecs, (int) nrep );
 
     while(  i < argc ){
 
@@ -85,6 +136,88 @@ int main( int argc, char** argv)
         magma_c_vinit( &dx, Magma_DEV, hA.num_rows, one );
         magma_c_vinit( &dy, Magma_DEV, hA.num_rows, zero );
 
+        // SpMV on CPU
+        // x has random entries, so that wrong column indices show up
+        magma_c_vector hX, hY, hr;
+        magma_int_t ione = 1, ISEED[4] = {0,0,0,1};
+        magma_int_t nx = num_vecs*hA.num_cols;
+        magma_c_vinit( &hX, Magma_CPU, nx, zero );
+        magma_c_vinit( &hY, Magma_CPU, num_vecs*hA.num_rows, zero );
+        magma_c_vinit( &hr, Magma_CPU, num_vecs*hA.num_rows, zero );
+        lapackf77_clarnv( &ione, ISEED, &nx, hX.val );
+
+        // reference: single-vector CSR SpMV, applied column by column
+        for( j=0; j < num_vecs; j++ ){
+            magma_c_vector xj = hX, rj = hr;
+            xj.val += j*hA.num_cols;
+            xj.num_rows = hA.num_cols;
+            rj.val += j*hA.num_rows;
+            rj.num_rows = hA.num_rows;
+            if ( magma_c_spmv( one, hA, xj, zero, rj ) != MAGMA_SUCCESS ){
+                printf( "error: reference SpMV failed.\n" );
+                status++;
+            }
+        }
+
+        printf( "   format      vectors   time (sec)   GFLOP/s     GB/s      error   check\n" );
+        printf( "   ========================================================================\n" );
+        for( int iformat = 0; iformat < 4; iformat++ ){
+            const char *name;
+            magma_int_t stored, ptrs;
+            if ( iformat == 0 ){
+                name = "CSR";
+                magma_c_mtransfer( hA, &hB, Magma_CPU, Magma_CPU );
+                stored = hB.nnz;
+                ptrs = hB.num_rows + 1;
+            }
+            else if ( iformat == 1 || iformat == 2 ){
+                name = ( iformat == 1 ? "ELLPACK" : "ELL" );
+                magma_c_mconvert( hA, &hB, Magma_CSR,
+                                  ( iformat == 1 ? Magma_ELLPACK : Magma_ELL ));
+                stored = hB.num_rows * hB.max_nnz_row;
+                ptrs = 0;
+            }
+            else {
+                name = "SELLP";
+                hB.blocksize = hA_SELLP.blocksize;
+                hB.alignment = hA_SELLP.alignment;
+                magma_c_mconvert( hA, &hB, Magma_CSR, Magma_SELLP );
+                stored = hB.nnz;
+                ptrs = hB.numblocks + 1;
+            }
+            for( int ivec = 0; ivec < ( num_vecs > 1 ? 2 : 1 ); ivec++ ){
+                magma_int_t nv = ( ivec == 0 ? 1 : num_vecs );
+                hX.num_rows = nv*hA.num_cols;
+                hY.num_rows = nv*hA.num_rows;
+                real_Double_t time = cpu_spmv_time( hB, hX, hY, nrep );
+                // matrix read once, x read and y written once per vector
+                real_Double_t gbytes = ( stored*( sizeof(magmaFloatComplex) + sizeof(magma_index_t) )
+                        + ptrs*sizeof(magma_index_t)
+                        + nv*( hA.num_cols + hA.num_rows )*sizeof(magmaFloatComplex) ) / 1e9;
+                real_Double_t error = vector_error( hY, hr, hA.num_rows, nv );
+                status += ! ( error < tol );
+                printf( "   %-8s   %7d   %10.2e   %7.2f   %7.2f   %8.2e   %s\n",
+                        name, (int) nv, time, FLOPS*nv/time, gbytes/time, error,
+                        ( error < tol ? "ok" : "failed" ));
+            }
+            magma_c_mfree( &hB );
+        }
+        // x of length num_cols + 1 is not a multiple of num_cols
+        if ( num_vecs > 1 && hA.num_cols > 1 ){
+            hX.num_rows = hA.num_cols + 1;
+            hY.num_rows = hA.num_rows;
+            magma_int_t info = magma_c_spmv( one, hA, hX, zero, hY );
+            status += ( info != MAGMA_ERR_ILLEGAL_VALUE );
+            printf( "   length %d rejected: %s\n", (int) hX.num_rows,
+                    ( info == MAGMA_ERR_ILLEGAL_VALUE ? "ok" : "failed" ));
+        }
+        printf( "\n" );
+        hX.num_rows = nx;
+        hY.num_rows = num_vecs*hA.num_rows;
+        magma_c_vfree( &hX );
+        magma_c_vfree( &hY );
+        magma_c_vfree( &hr );
+
 /*
         // calling MKL with CSR
         pntre = (magma_int_t*)malloc( (hA.num_rows+1)*sizeof(magma_int_t) );
@@ -215,5 +348,5 @@ int main( int argc, char** argv)
     }
 
     TESTING_FINALIZE();
-    return 0;
+    return status;
 }
@@ -0,0 +1,150 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from testing_zstencil.cpp normal z -> c, Tue Sep  2 12:38:36 2014
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing the stencil matrix generators
+   For the 2D 5-point and 9-point stencils on a --n2^2 grid (default 1000)
+   and the 3D 7-point, 19-point and 27-point stencils on a --n3^3 grid
+   (default 100), reports the time to generate the matrix in CSR, in
+   SELL-P directly, and in CSR followed by the conversion to SELL-P, with
+   slices of --blocksize rows (default 8) padded to --alignment (default 4).
+   The z-coupling is scaled by --az (default 1) for anisotropic problems.
+   Then reports the time of the CPU SpMV in CSR, SELL-P, and with the
+   matrix-free stencil (Magma_STENCIL), the fastest of --nrep runs
+   (default 10), and checks that SELL-P and the stencil give the same
+   result as CSR.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_INIT();
+
+    magmaFloatComplex one  = MAGMA_C_MAKE(1.0, 0.0);
+    magmaFloatComplex zero = MAGMA_C_MAKE(0.0, 0.0);
+    magma_c_sparse_matrix A, B, C, D, S;
+    magma_c_vector x, y, z;
+    real_Double_t t_csr, t_sellp, t_conv, diff, nrm, start;
+    real_Double_t t_spmv[3];
+    real_Double_t eps = lapackf77_slamch( "E" );
+    magma_int_t status = 0;
+    magma_int_t nrep = 10, irep;
+    magma_int_t n2 = 1000, n3 = 100;
+    magma_int_t blocksize = 8, alignment = 4;
+    float az = 1.;
+    magma_int_t points[] = { 5, 9, 7, 19, 27 };
+    magma_int_t j, k;
+    bool failed[5];
+
+    int i;
+    for( i = 1; i < argc; ++i ) {
+        if ( strcmp("--n2", argv[i]) == 0 ) {
+            n2 = atoi( argv[++i] );
+        }else if ( strcmp("--n3", argv[i]) == 0 ) {
+            n3 = atoi( argv[++i] );
+        }else if ( strcmp("--blocksize", argv[i]) == 0 ) {
+            blocksize = max( 1, atoi( argv[++i] ));
+        }else if ( strcmp("--alignment", argv[i]) == 0 ) {
+            alignment = max( 1, atoi( argv[++i] ));
+        }else if ( strcmp("--az", argv[i]) == 0 ) {
+            az = atof( argv[++i] );
+        }else if ( strcmp("--nrep", argv[i]) == 0 ) {
+            nrep = max( 1, atoi( argv[++i] ));
+        }else
+            break;
+    }
+    printf( "\n#    usage: ./testing_zstencil"
+        " [ --n2 %d --n3 %d --blocksize %d --alignment %d --az %.2f --nrep %d ]\n\n",
+        (int) n2, (int) n3, (int) blocksize, (int) alignment, az, (int) nrep );
+
+    printf( "   stencil        rows          nnz   CSR (sec)   SELL-P (sec)   CSR+convert (sec)   padding\n" );
+    printf( "   ==========================================================================================\n" );
+    for( int ip = 0; ip < 5; ++ip ) {
+        magma_int_t n = ( points[ip] <= 9 ? n2 : n3 );
+        magma_int_t nz = ( points[ip] <= 9 ? 1 : n3 );
+        failed[ip] = false;
+
+        t_csr = magma_wtime();
+        magma_cm_stencil( points[ip], n, n, nz, 1., 1., az, Magma_CSR, &A );
+        t_csr = magma_wtime() - t_csr;
+
+        B.blocksize = blocksize;
+        B.alignment = alignment;
+        t_sellp = magma_wtime();
+        magma_cm_stencil( points[ip], n, n, nz, 1., 1., az, Magma_SELLP, &B );
+        t_sellp = magma_wtime() - t_sellp;
+
+        D.blocksize = blocksize;
+        D.alignment = alignment;
+        t_conv = magma_wtime();
+        magma_cm_stencil( points[ip], n, n, nz, 1., 1., az, Magma_CSR, &C );
+        magma_c_mconvert( C, &D, Magma_CSR, Magma_SELLP );
+        t_conv = magma_wtime() - t_conv;
+        magma_c_mfree( &C );
+        magma_c_mfree( &D );
+
+        magma_cm_stencil( points[ip], n, n, nz, 1., 1., az, Magma_STENCIL, &S );
+
+        // y = A x, and z = B x and z = S x for x with distinct entries
+        magma_c_vinit( &x, Magma_CPU, A.num_rows, zero );
+        magma_c_vinit( &y, Magma_CPU, A.num_rows, zero );
+        magma_c_vinit( &z, Magma_CPU, A.num_rows, zero );
+        for( j=0; j < A.num_rows; j++ )
+            x.val[j] = MAGMA_C_MAKE( 1. + (j % 17) / 17., 0. );
+        for( k=0; k < 3; k++ ) {
+            for( irep = 0; irep < nrep; ++irep ) {
+                start = magma_wtime();
+                magma_c_spmv( one, ( k == 0 ? A : k == 1 ? B : S ), x, zero,
+                              ( k == 0 ? y : z ));
+                start = magma_wtime() - start;
+                t_spmv[k] = ( irep == 0 ? start : min( t_spmv[k], start ));
+            }
+            if ( k == 0 ) {
+                nrm = magma_scnrm2_cpu( A.num_rows, y.val );
+            }
+            else {
+                magma_caxpby_cpu( A.num_rows, MAGMA_C_NEG_ONE, y.val, one, z.val );
+                diff = magma_scnrm2_cpu( A.num_rows, z.val ) / nrm;
+                failed[ip] = failed[ip] || !( diff <= 10*eps );
+            }
+        }
+        status += failed[ip];
+
+        printf( "   %2d-point  %10d   %10d   %9.3f   %12.3f   %17.3f   %6.1f%%\n"
+                "                                   SpMV (ms): CSR %.3f, SELL-P %.3f, stencil %.3f   %s\n",
+                (int) points[ip], (int) A.num_rows, (int) A.nnz,
+                t_csr, t_sellp, t_conv, 100. * (B.nnz - A.nnz) / A.nnz,
+                t_spmv[0]*1e3, t_spmv[1]*1e3, t_spmv[2]*1e3,
+                ( failed[ip] ? "failed" : "ok" ));
+        fflush( stdout );
+
+        magma_c_vfree( &x );
+        magma_c_vfree( &y );
+        magma_c_vfree( &z );
+        magma_c_mfree( &A );
+        magma_c_mfree( &B );
+        magma_c_mfree( &S );
+    }
+
+    TESTING_FINALIZE();
+    return status;
+}
@@ -63,15 +63,25 @@ int main( int argc, char** argv)
         // scale matrix
         magma_dmscale( &A, zopts.scaling );
 
+        // reorder rows and columns
+        if ( zopts.reordering != Magma_NOREORDER ) {
+            magma_d_sparse_matrix C;
+            magma_index_t *perm;
+            magma_d_mreorder( A, &C, zopts.reordering, &perm );
+            magma_d_mfree(&A);
+            A = C;
+            magma_free_cpu( perm );
+        }
+
         magma_d_mconvert( A, &B, Magma_CSR, zopts.output_format );
-        magma_d_mtransfer( B, &B_d, Magma_CPU, Magma_DEV );
+        magma_d_mtransfer( B, &B_d, Magma_CPU, zopts.output_location );
 
         // vectors and initial guess
-        magma_d_vinit( &b, Magma_DEV, A.num_cols, one );
-        magma_d_vinit( &x, Magma_DEV, A.num_cols, one );
+        magma_d_vinit( &b, zopts.output_location, A.num_cols, one );
+        magma_d_vinit( &x, zopts.output_location, A.num_cols, one );
         magma_d_spmv( one, B_d, x, zero, b );                 //  b = A x
         magma_d_vfree(&x);
-        magma_d_vinit( &x, Magma_DEV, A.num_cols, zero );
+        magma_d_vinit( &x, zopts.output_location, A.num_cols, zero );
 
         magma_d_solver( B_d, b, &x, &zopts ); 
 
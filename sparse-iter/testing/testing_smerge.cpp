@@ -0,0 +1,127 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from testing_zmerge.cpp normal z -> s, Tue Sep  2 12:38:36 2014
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// includes, project
+#include "flops.h"
+#include "magma.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing the merged CG and BiCGSTAB on the CPU
+   Runs CG and BiCGSTAB, each with the separate vector kernels and in the
+   merged variant, for --maxiter iterations (default 100) on the CPU, and
+   reports the time per iteration and the speedup of the merged variant.
+   Both variants do the same arithmetic, so their final residuals agree
+   up to the different order of the sums in the dot products; BiCGSTAB
+   may amplify that difference.
+   Without files, uses the 3D 27-point stencil matrix on a --n^3 grid
+   (default 64).
+   --nrep sets the number of runs, of which the fastest is reported.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_INIT();
+
+    float one  = MAGMA_S_MAKE(1.0, 0.0);
+    float zero = MAGMA_S_MAKE(0.0, 0.0);
+    magma_s_sparse_matrix A;
+    magma_s_vector x, b;
+    magma_s_solver_par solver_par;
+    real_Double_t time[2], res[2], diff;
+    magma_int_t nthread = 1;
+    magma_int_t maxiter = 100;
+    magma_int_t nrep = 3;
+    magma_int_t n = 64;
+
+    int i;
+    for( i = 1; i < argc; ++i ) {
+        if ( strcmp("--maxiter", argv[i]) == 0 ) {
+            maxiter = max( 2, atoi( argv[++i] ));
+        }else if ( strcmp("--nrep", argv[i]) == 0 ) {
+            nrep = max( 1, atoi( argv[++i] ));
+        }else if ( strcmp("--n", argv[i]) == 0 ) {
+            n = atoi( argv[++i] );
+        }else
+            break;
+    }
+    printf( "\n#    usage: ./testing_zmerge"
+        " [ --maxiter %d --nrep %d --n %d ] matrices\n\n",
+        (int) maxiter, (int) nrep, (int) n );
+
+#ifdef _OPENMP
+    nthread = omp_get_max_threads();
+#endif
+
+    do {
+        if ( i < argc )
+            magma_s_csr_mtx( &A, argv[i] );
+        else
+            magma_sm_27stencil( n, &A );
+
+        printf( "\n# matrix info: %d-by-%d with %d nonzeros, %d threads\n\n",
+                (int) A.num_rows, (int) A.num_cols, (int) A.nnz, (int) nthread );
+
+        // b = A * 1
+        magma_s_vinit( &x, Magma_CPU, A.num_cols, one );
+        magma_s_vinit( &b, Magma_CPU, A.num_rows, zero );
+        magma_s_spmv( one, A, x, zero, b );
+
+        printf( "   solver      iter   separate (ms/iter)   merged (ms/iter)   speedup   residual diff\n" );
+        printf( "   ====================================================================================\n" );
+        for( int isolver = 0; isolver < 2; isolver++ ){
+            for( int imerge = 0; imerge < 2; imerge++ ){
+                for( magma_int_t irep = 0; irep < nrep; irep++ ){
+                    // epsilon = 0, so that all variants do maxiter-1 iterations
+                    solver_par.epsilon = 0.;
+                    solver_par.maxiter = maxiter;
+                    solver_par.verbose = 0;
+                    if ( isolver == 0 && imerge == 0 )
+                        magma_scg( A, b, &x, &solver_par );
+                    else if ( isolver == 0 )
+                        magma_scg_merge( A, b, &x, &solver_par );
+                    else if ( imerge == 0 )
+                        magma_sbicgstab( A, b, &x, &solver_par );
+                    else
+                        magma_sbicgstab_merge( A, b, &x, &solver_par );
+                    diff = solver_par.runtime / solver_par.numiter;
+                    time[imerge] = ( irep == 0 ? diff : min( time[imerge], diff ));
+                }
+                res[imerge] = solver_par.final_res;
+            }
+            // difference of the final residuals, relative to the initial one
+            diff = fabs( res[1] - res[0] ) / solver_par.init_res;
+            printf( "   %-8s  %6d   %18.3f   %16.3f   %7.2f   %13.2e\n",
+                    ( isolver == 0 ? "CG" : "BiCGSTAB" ),
+                    (int) solver_par.numiter, time[0]*1e3, time[1]*1e3,
+                    time[0] / time[1], diff );
+        }
+
+        magma_s_vfree( &x );
+        magma_s_vfree( &b );
+        magma_s_mfree( &A );
+        i++;
+    } while( i < argc );
+
+    TESTING_FINALIZE();
+    return 0;
+}
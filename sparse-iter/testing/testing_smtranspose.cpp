@@ -0,0 +1,280 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from testing_zmtranspose.cpp normal z -> s, Tue Sep  2 12:38:36 2014
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// includes, project
+#include "flops.h"
+#include "magma.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+// ---------------------------------------------
+// Reference: the previous magma_s_csrtranspose, which searches all
+// nonzeros of A for each row of the transpose, O(num_rows * nnz).
+static void reference_csrtranspose( magma_s_sparse_matrix A, magma_s_sparse_matrix *B )
+{
+    magma_int_t i, j, new_nnz=0, lrow;
+
+    B->storage_type = Magma_CSR;
+    B->memory_location = A.memory_location;
+    B->num_rows = A.num_cols;
+    B->num_cols = A.num_rows;
+    B->nnz = A.nnz;
+    B->max_nnz_row = A.max_nnz_row;
+    B->diameter = A.diameter;
+
+    magma_smalloc_cpu( &B->val, A.nnz );
+    magma_index_malloc_cpu( &B->row, A.num_cols+1 );
+    magma_index_malloc_cpu( &B->col, A.nnz );
+
+    for( lrow = 0; lrow < A.num_cols; lrow++ ){
+        B->row[lrow] = new_nnz;
+        for( i=0; i<A.num_rows; i++ ){
+            for( j=A.row[i]; j<A.row[i+1]; j++ ){
+                if( A.col[j] == lrow ){
+                    B->val[ new_nnz ] = A.val[ j ];
+                    B->col[ new_nnz ] = i;
+                    new_nnz++;
+                }
+            }
+        }
+    }
+    B->row[ B->num_rows ] = new_nnz;
+}
+
+
+// ---------------------------------------------
+// Serial counting sort transpose, used to check every run.
+static void serial_csrtranspose( magma_s_sparse_matrix A, magma_s_sparse_matrix *B )
+{
+    magma_int_t i, j;
+
+    B->storage_type = Magma_CSR;
+    B->memory_location = A.memory_location;
+    B->num_rows = A.num_cols;
+    B->num_cols = A.num_rows;
+    B->nnz = A.nnz;
+    B->max_nnz_row = A.max_nnz_row;
+    B->diameter = A.diameter;
+
+    magma_smalloc_cpu( &B->val, A.nnz );
+    magma_index_malloc_cpu( &B->row, A.num_cols+1 );
+    magma_index_malloc_cpu( &B->col, A.nnz );
+
+    for( i=0; i < A.num_cols+1; i++ )
+        B->row[i] = 0;
+    for( j=0; j < A.nnz; j++ )
+        B->row[ A.col[j]+1 ]++;
+    for( i=0; i < A.num_cols; i++ )
+        B->row[i+1] += B->row[i];
+    for( i=0; i < A.num_rows; i++ ){
+        for( j=A.row[i]; j < A.row[i+1]; j++ ){
+            magma_index_t k = B->row[ A.col[j] ]++;
+            B->val[k] = A.val[j];
+            B->col[k] = i;
+        }
+    }
+    for( i=A.num_cols; i > 0; i-- )
+        B->row[i] = B->row[i-1];
+    B->row[0] = 0;
+}
+
+
+// ---------------------------------------------
+// Makes the nonsymmetric, rectangular matrix B from the square matrix A
+// with an n-point grid line: drops the last n columns and the first
+// superdiagonal, and gives every entry a value that depends on its position.
+static void rectangular_matrix( magma_s_sparse_matrix A, magma_int_t n,
+                                magma_s_sparse_matrix *B )
+{
+    magma_int_t i, j, nnz = 0;
+
+    *B = A;
+    B->num_cols = A.num_cols - n;
+    magma_smalloc_cpu( &B->val, A.nnz );
+    magma_index_malloc_cpu( &B->row, A.num_rows+1 );
+    magma_index_malloc_cpu( &B->col, A.nnz );
+
+    B->max_nnz_row = 0;
+    B->row[0] = 0;
+    for( i=0; i < A.num_rows; i++ ){
+        for( j=A.row[i]; j < A.row[i+1]; j++ ){
+            if( A.col[j] < B->num_cols && A.col[j] != i+1 ){
+                B->col[nnz] = A.col[j];
+                B->val[nnz] = MAGMA_S_MAKE( i + 0.5*A.col[j], 1. );
+                nnz++;
+            }
+        }
+        B->row[i+1] = nnz;
+        B->max_nnz_row = max( B->max_nnz_row, (magma_int_t) (B->row[i+1] - B->row[i]) );
+    }
+    B->nnz = nnz;
+}
+
+
+// ---------------------------------------------
+// Returns the number of entries in which the CSR matrices A and B differ.
+static magma_int_t csr_compare( magma_s_sparse_matrix A, magma_s_sparse_matrix B )
+{
+    if( A.num_rows != B.num_rows || A.num_cols != B.num_cols || A.nnz != B.nnz )
+        return 1;
+    magma_int_t i, ndiff = 0;
+    for( i=0; i < A.num_rows+1; i++ )
+        ndiff += ( A.row[i] != B.row[i] );
+    for( i=0; i < A.nnz; i++ )
+        ndiff += ( A.col[i] != B.col[i] ||
+                   ! MAGMA_S_EQUAL( A.val[i], B.val[i] ));
+    return ndiff;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing magma_s_mtranspose on the CPU
+   For each grid size n, generates the 2D 5-point stencil matrix with n^2 rows,
+   the 3D 27-point stencil matrix with about as many rows, and a nonsymmetric
+   n^2 x (n^2-n) matrix made from the 5-point stencil, and times the
+   CSR transpose with 1, 2, 4, ..., up to the OpenMP threads.
+   Checks the transpose against a serial transpose, and that transposing
+   twice gives back A.
+   --ref also times the previous quadratic transpose, for matrices with at
+   most 40000 rows, and checks against it too.
+   --nrep sets the number of runs, of which the fastest is reported.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_INIT();
+
+    magma_s_sparse_matrix A, B, AT, ATT, R, S;
+    real_Double_t start, time, ref_time;
+    magma_int_t n, n3, nthread, max_nthread, ndiff, irep;
+    magma_int_t status = 0;
+    magma_int_t nrep = 3;
+    int ref = 0;
+
+    int i;
+    for( i = 1; i < argc; ++i ) {
+        if ( strcmp("--nrep", argv[i]) == 0 ) {
+            nrep = max( 1, atoi( argv[++i] ));
+        }else if ( strcmp("--ref", argv[i]) == 0 ) {
+            ref = 1;
+        }else
+            break;
+    }
+    printf( "\n#    usage: ./testing_zmtranspose"
+        " [ --nrep %d --ref ] n ... (default 100 300 1000)\n\n", (int) nrep );
+
+    const char* default_sizes[] = { "100", "300", "1000" };
+    char** sizes = argv + i;
+    int nsizes = argc - i;
+    if ( nsizes == 0 ) {
+        sizes  = (char**) default_sizes;
+        nsizes = 3;
+    }
+
+#ifdef _OPENMP
+    max_nthread = omp_get_max_threads();
+#else
+    max_nthread = 1;
+#endif
+
+    const char* names[] = { "5-pt", "27-pt", "5pt-rect" };
+    printf( "  stencil         rows          nnz  threads   reference (sec)   transpose (sec)   GB/s      check\n" );
+    printf( "==========================================================================================================\n" );
+    for( int isize = 0; isize < nsizes; ++isize ) {
+        n  = atoi( sizes[isize] );
+        n3 = (magma_int_t) ( pow( (float) n*n, 1./3 ) + 0.5 );
+        for( int istencil = 0; istencil < 3; ++istencil ) {
+            if ( istencil == 0 )
+                magma_sm_5stencil( n, &A );
+            else if ( istencil == 1 )
+                magma_sm_27stencil( n3, &A );
+            else {
+                magma_sm_5stencil( n, &B );
+                rectangular_matrix( B, n, &A );
+                magma_s_mfree( &B );
+            }
+
+            serial_csrtranspose( A, &S );
+            ref_time = 0;
+            if ( ref && A.num_rows <= 40000 ) {
+                ref_time = magma_wtime();
+                reference_csrtranspose( A, &R );
+                ref_time = magma_wtime() - ref_time;
+            }
+
+            for( nthread = 1; true; nthread = min( 2*nthread, max_nthread )) {
+#ifdef _OPENMP
+                omp_set_num_threads( nthread );
+#endif
+                time = 0;
+                for( irep = 0; irep < nrep; ++irep ) {
+                    start = magma_wtime();
+                    magma_s_mtranspose( A, &AT );
+                    start = magma_wtime() - start;
+                    time = ( irep == 0 ? start : min( time, start ));
+                    if ( irep < nrep-1 )
+                        magma_s_mfree( &AT );
+                }
+
+                magma_s_mtranspose( AT, &ATT );
+                ndiff = csr_compare( S, AT ) + csr_compare( A, ATT );
+                if ( ref_time > 0 )
+                    ndiff += csr_compare( R, AT );
+                status += ( ndiff != 0 );
+                magma_s_mfree( &AT );
+                magma_s_mfree( &ATT );
+
+                // bytes read and written: val, col, row of A and of A^T
+                real_Double_t gbytes = 2.*( A.nnz*( sizeof(float) + sizeof(magma_index_t) )
+                                          + (A.num_rows + 1)*sizeof(magma_index_t) ) / 1e9;
+                if ( ref_time > 0 ) {
+                    printf( "  %-8s %12d %12d  %7d   %15.4f   %15.4f   %6.2f     %s\n",
+                            names[istencil],
+                            (int) A.num_rows, (int) A.nnz, (int) nthread,
+                            ref_time, time, gbytes / time,
+                            (ndiff == 0 ? "ok" : "failed") );
+                }
+                else {
+                    printf( "  %-8s %12d %12d  %7d   %15s   %15.4f   %6.2f     %s\n",
+                            names[istencil],
+                            (int) A.num_rows, (int) A.nnz, (int) nthread,
+                            "---", time, gbytes / time,
+                            (ndiff == 0 ? "ok" : "failed") );
+                }
+                fflush( stdout );
+                if ( nthread == max_nthread ) {
+                    break;
+                }
+            }
+            if ( ref_time > 0 )
+                magma_s_mfree( &R );
+            magma_s_mfree( &S );
+            magma_s_mfree( &A );
+        }
+    }
+
+#ifdef _OPENMP
+    omp_set_num_threads( max_nthread );
+#endif
+
+    TESTING_FINALIZE();
+    return status;
+}
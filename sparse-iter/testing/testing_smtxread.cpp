@@ -0,0 +1,285 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from testing_zmtxread.cpp normal z -> s, Tue Sep  2 12:38:36 2014
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// includes, project
+#include "flops.h"
+#include "magma.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+#include "mmio.h"
+
+
+// ---------------------------------------------
+// Reference: the previous magma_s_csr_mtx, which reads each entry with
+// fscanf into COO arrays, copies them to duplicate the off-diagonal entries
+// of symmetric matrices, converts to CSR, bubble sorts each row, and
+// removes explicit zeros.
+static void reference_csr_mtx( magma_s_sparse_matrix *A, const char *filename )
+{
+    FILE *fid;
+    MM_typecode matcode;
+    magma_index_t num_rows, num_cols, num_nonzeros, i, j, k;
+    int csr_compressor = 0;
+
+    fid = fopen( filename, "r" );
+    mm_read_banner( fid, &matcode );
+    mm_read_mtx_crd_size( fid, &num_rows, &num_cols, &num_nonzeros );
+
+    magma_index_t *coo_row, *coo_col;
+    float *coo_val;
+    magma_index_malloc_cpu( &coo_row, num_nonzeros );
+    magma_index_malloc_cpu( &coo_col, num_nonzeros );
+    magma_smalloc_cpu( &coo_val, num_nonzeros );
+    for( i=0; i < num_nonzeros; ++i ){
+        magma_index_t ROW, COL;
+        real_Double_t VAL = 1.;
+        if( mm_is_pattern( matcode ))
+            fscanf( fid, " %d %d \n", &ROW, &COL );
+        else
+            fscanf( fid, " %d %d %lf \n", &ROW, &COL, &VAL );
+        if( VAL == 0 )
+            csr_compressor = 1;
+        coo_row[i] = ROW - 1;
+        coo_col[i] = COL - 1;
+        coo_val[i] = MAGMA_S_MAKE( VAL, 0. );
+    }
+    fclose( fid );
+
+    magma_index_t nnz = num_nonzeros;
+    if( mm_is_symmetric( matcode )){
+        magma_index_t off_diagonals = 0;
+        for( i=0; i < num_nonzeros; ++i )
+            off_diagonals += ( coo_row[i] != coo_col[i] );
+        nnz = num_nonzeros + off_diagonals;
+
+        magma_index_t *new_row, *new_col;
+        float *new_val;
+        magma_index_malloc_cpu( &new_row, nnz );
+        magma_index_malloc_cpu( &new_col, nnz );
+        magma_smalloc_cpu( &new_val, nnz );
+        for( i=0, k=0; i < num_nonzeros; ++i ){
+            new_row[k] = coo_row[i];
+            new_col[k] = coo_col[i];
+            new_val[k] = coo_val[i];
+            k++;
+            if( coo_row[i] != coo_col[i] ){
+                new_row[k] = coo_col[i];
+                new_col[k] = coo_row[i];
+                new_val[k] = coo_val[i];
+                k++;
+            }
+        }
+        magma_free_cpu( coo_row );
+        magma_free_cpu( coo_col );
+        magma_free_cpu( coo_val );
+        coo_row = new_row;
+        coo_col = new_col;
+        coo_val = new_val;
+    }
+
+    A->storage_type = Magma_CSR;
+    A->memory_location = Magma_CPU;
+    A->num_rows = num_rows;
+    A->num_cols = num_cols;
+    A->nnz = nnz;
+    magma_smalloc_cpu( &A->val, nnz );
+    magma_index_malloc_cpu( &A->col, nnz );
+    magma_index_malloc_cpu( &A->row, num_rows+1 );
+
+    for( i=0; i <= num_rows; i++ )
+        A->row[i] = 0;
+    for( i=0; i < nnz; i++ )
+        A->row[ coo_row[i]+1 ]++;
+    for( i=0; i < num_rows; i++ )
+        A->row[i+1] += A->row[i];
+    for( i=0; i < nnz; i++ ){
+        k = A->row[ coo_row[i] ]++;
+        A->col[k] = coo_col[i];
+        A->val[k] = coo_val[i];
+    }
+    for( i=num_rows; i > 0; i-- )
+        A->row[i] = A->row[i-1];
+    A->row[0] = 0;
+    magma_free_cpu( coo_row );
+    magma_free_cpu( coo_col );
+    magma_free_cpu( coo_val );
+
+    for( k=0; k < num_rows; ++k )
+        for( i=A->row[k]; i < A->row[k+1]-1; ++i )
+            for( j=A->row[k]; j < A->row[k+1]-1; ++j )
+                if( A->col[j] > A->col[j+1] ){
+                    magma_index_t ti = A->col[j];
+                    A->col[j] = A->col[j+1];
+                    A->col[j+1] = ti;
+                    float tv = A->val[j];
+                    A->val[j] = A->val[j+1];
+                    A->val[j+1] = tv;
+                }
+
+    if( csr_compressor ){
+        magma_s_sparse_matrix B;
+        magma_s_mtransfer( *A, &B, Magma_CPU, Magma_CPU );
+        magma_s_csr_compressor( &A->val, &A->row, &A->col,
+                                &B.val, &B.row, &B.col, &B.num_rows );
+        B.nnz = B.row[ num_rows ];
+        magma_free_cpu( A->val );
+        magma_free_cpu( A->row );
+        magma_free_cpu( A->col );
+        magma_s_mtransfer( B, A, Magma_CPU, Magma_CPU );
+        magma_s_mfree( &B );
+    }
+}
+
+
+// ---------------------------------------------
+// Returns the number of entries in which the CSR matrices A and B differ.
+static magma_int_t csr_compare( magma_s_sparse_matrix A, magma_s_sparse_matrix B )
+{
+    if( A.num_rows != B.num_rows || A.num_cols != B.num_cols || A.nnz != B.nnz )
+        return 1;
+    magma_int_t i, ndiff = 0;
+    for( i=0; i < A.num_rows+1; i++ )
+        ndiff += ( A.row[i] != B.row[i] );
+    for( i=0; i < A.nnz; i++ )
+        ndiff += ( A.col[i] != B.col[i] ||
+                   ! MAGMA_S_EQUAL( A.val[i], B.val[i] ));
+    return ndiff;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing magma_s_csr_mtx
+   Times reading each Matrix Market file with 1, 2, 4, ..., up to the OpenMP
+   threads, reporting MB/s of file and millions of nonzeros per second.
+   Without files, writes the 3D 27-point stencil matrix on a --n^3 grid
+   (default 50) to testing_zmtxread.mtx and reads that.
+   --ref also times the previous fscanf based reader and checks that both
+   give the same matrix.
+   --nrep sets the number of runs, of which the fastest is reported.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_INIT();
+
+    magma_s_sparse_matrix A, R;
+    real_Double_t start, time, ref_time, mbytes;
+    magma_int_t nthread, max_nthread, ndiff, irep;
+    magma_int_t status = 0;
+    magma_int_t nrep = 3;
+    magma_int_t n = 50;
+    int ref = 0;
+
+    int i;
+    for( i = 1; i < argc; ++i ) {
+        if ( strcmp("--nrep", argv[i]) == 0 ) {
+            nrep = max( 1, atoi( argv[++i] ));
+        }else if ( strcmp("--n", argv[i]) == 0 ) {
+            n = atoi( argv[++i] );
+        }else if ( strcmp("--ref", argv[i]) == 0 ) {
+            ref = 1;
+        }else
+            break;
+    }
+    printf( "\n#    usage: ./testing_zmtxread"
+        " [ --nrep %d --ref --n %d ] matrices\n\n", (int) nrep, (int) n );
+
+    const char* generated[] = { "testing_zmtxread.mtx" };
+    char** files = argv + i;
+    int nfiles = argc - i;
+    if ( nfiles == 0 ) {
+        magma_sm_27stencil( n, &A );
+        write_s_csrtomtx( A, generated[0] );
+        magma_s_mfree( &A );
+        files  = (char**) generated;
+        nfiles = 1;
+    }
+
+#ifdef _OPENMP
+    max_nthread = omp_get_max_threads();
+#else
+    max_nthread = 1;
+#endif
+
+    printf( "  file size (MB)        rows          nnz  threads   reference (sec)   read (sec)     MB/s   Mnnz/s   check\n" );
+    printf( "================================================================================================================\n" );
+    for( int ifile = 0; ifile < nfiles; ++ifile ) {
+        FILE *fid = fopen( files[ifile], "r" );
+        if ( fid == NULL ) {
+            printf( "#Unable to open file %s\n", files[ifile] );
+            status += 1;
+            continue;
+        }
+        fseek( fid, 0, SEEK_END );
+        mbytes = ftell( fid ) / 1e6;
+        fclose( fid );
+
+        ref_time = 0;
+        if ( ref ) {
+            ref_time = magma_wtime();
+            reference_csr_mtx( &R, files[ifile] );
+            ref_time = magma_wtime() - ref_time;
+        }
+
+        for( nthread = 1; true; nthread = min( 2*nthread, max_nthread )) {
+#ifdef _OPENMP
+            omp_set_num_threads( nthread );
+#endif
+            time = 0;
+            for( irep = 0; irep < nrep; ++irep ) {
+                start = magma_wtime();
+                magma_s_csr_mtx( &A, files[ifile] );
+                start = magma_wtime() - start;
+                time = ( irep == 0 ? start : min( time, start ));
+                if ( irep < nrep-1 )
+                    magma_s_mfree( &A );
+            }
+
+            if ( ref ) {
+                ndiff = csr_compare( A, R );
+                status += ( ndiff != 0 );
+                printf( "  %14.1f %12d %12d  %7d   %15.4f   %10.4f   %6.1f   %6.1f   %s\n",
+                        mbytes, (int) A.num_rows, (int) A.nnz, (int) nthread,
+                        ref_time, time, mbytes / time, A.nnz / time / 1e6,
+                        (ndiff == 0 ? "ok" : "failed") );
+            }
+            else {
+                printf( "  %14.1f %12d %12d  %7d   %15s   %10.4f   %6.1f   %6.1f   %s\n",
+                        mbytes, (int) A.num_rows, (int) A.nnz, (int) nthread,
+                        "---", time, mbytes / time, A.nnz / time / 1e6, "---" );
+            }
+            fflush( stdout );
+            magma_s_mfree( &A );
+            if ( nthread == max_nthread ) {
+                break;
+            }
+        }
+        if ( ref ) {
+            magma_s_mfree( &R );
+        }
+    }
+
+#ifdef _OPENMP
+    omp_set_num_threads( max_nthread );
+#endif
+
+    TESTING_FINALIZE();
+    return status;
+}
@@ -0,0 +1,168 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from testing_zreorder.cpp normal z -> s, Tue Sep  2 12:38:36 2014
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing the Reverse Cuthill-McKee and nested dissection reorderings
+   For each matrix, reports bandwidth, profile, and the time of a CPU SpMV
+   in the original order, after a random symmetric permutation, and after
+   reordering the permuted matrix with RCM and with nested dissection,
+   with the time of the reordering. Checks that P^T (B (P x)) = A x for
+   each reordered matrix B = P A P^T.
+   Without files, uses the 2D 5-point stencil matrix on a --n5^2 grid
+   (default 200) and the 3D 27-point stencil matrix on a --n27^3 grid
+   (default 30).
+   --nrep sets the number of SpMVs, of which the fastest is reported.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_INIT();
+
+    float one  = MAGMA_S_MAKE(1.0, 0.0);
+    float zero = MAGMA_S_MAKE(0.0, 0.0);
+    magma_s_sparse_matrix A, S, B;
+    magma_s_vector x, y, px, py, z;
+    magma_index_t *shuffle, *perm;
+    real_Double_t start, reorder_time, spmv_time, diff, nrm;
+    real_Double_t eps = lapackf77_slamch( "E" );
+    magma_int_t bandwidth, profile, irep, j;
+    magma_int_t status = 0;
+    magma_int_t nrep = 10;
+    magma_int_t n5 = 200, n27 = 30;
+    const char *names[] = { "original", "random", "RCM", "ND" };
+
+    int i;
+    for( i = 1; i < argc; ++i ) {
+        if ( strcmp("--nrep", argv[i]) == 0 ) {
+            nrep = max( 1, atoi( argv[++i] ));
+        }else if ( strcmp("--n5", argv[i]) == 0 ) {
+            n5 = atoi( argv[++i] );
+        }else if ( strcmp("--n27", argv[i]) == 0 ) {
+            n27 = atoi( argv[++i] );
+        }else
+            break;
+    }
+    printf( "\n#    usage: ./testing_zreorder"
+        " [ --nrep %d --n5 %d --n27 %d ] matrices\n\n",
+        (int) nrep, (int) n5, (int) n27 );
+
+    int nmat = ( i < argc ? argc - i : 2 );
+    for( int imat = 0; imat < nmat; ++imat ) {
+        if ( i < argc )
+            magma_s_csr_mtx( &A, argv[i+imat] );
+        else if ( imat == 0 )
+            magma_sm_5stencil( n5, &A );
+        else
+            magma_sm_27stencil( n27, &A );
+
+        printf( "\n# matrix info: %d-by-%d with %d nonzeros\n\n",
+                (int) A.num_rows, (int) A.num_cols, (int) A.nnz );
+        printf( "   ordering     bandwidth        profile   reorder (sec)   spmv (ms)   check\n" );
+        printf( "   ==========================================================================\n" );
+
+        // x has distinct entries, so that permutation errors show
+        magma_s_vinit( &x, Magma_CPU, A.num_rows, zero );
+        magma_s_vinit( &y, Magma_CPU, A.num_rows, zero );
+        magma_s_vinit( &px, Magma_CPU, A.num_rows, zero );
+        magma_s_vinit( &py, Magma_CPU, A.num_rows, zero );
+        magma_s_vinit( &z, Magma_CPU, A.num_rows, zero );
+        for( j=0; j < A.num_rows; j++ )
+            x.val[j] = MAGMA_S_MAKE( 1. + (j % 17) / 17., 0. );
+        magma_s_spmv( one, A, x, zero, y );
+        nrm = magma_snrm2_cpu( A.num_rows, y.val );
+
+        // random symmetric permutation of A
+        magma_index_malloc_cpu( &shuffle, A.num_rows );
+        for( j=0; j < A.num_rows; j++ )
+            shuffle[j] = j;
+        srand( 1 );
+        for( j=A.num_rows-1; j > 0; j-- ) {
+            magma_int_t k = rand() % (j+1);
+            magma_index_t t = shuffle[j];
+            shuffle[j] = shuffle[k];
+            shuffle[k] = t;
+        }
+        magma_s_mpermute( A, &S, shuffle );
+
+        for( int iord = 0; iord < 4; ++iord ) {
+            // B = P A P^T for the combined permutation P
+            reorder_time = 0;
+            if ( iord == 0 ) {
+                magma_index_malloc_cpu( &perm, A.num_rows );
+                for( j=0; j < A.num_rows; j++ )
+                    perm[j] = j;
+                magma_s_mpermute( A, &B, perm );
+            }
+            else if ( iord == 1 ) {
+                magma_index_malloc_cpu( &perm, A.num_rows );
+                for( j=0; j < A.num_rows; j++ )
+                    perm[j] = shuffle[j];
+                magma_s_mpermute( A, &B, perm );
+            }
+            else {
+                magma_index_t *p;
+                reorder_time = magma_wtime();
+                magma_s_mreorder( S, &B, ( iord == 2 ? Magma_RCM : Magma_ND ), &p );
+                reorder_time = magma_wtime() - reorder_time;
+                magma_index_malloc_cpu( &perm, A.num_rows );
+                for( j=0; j < A.num_rows; j++ )
+                    perm[j] = shuffle[ p[j] ];
+                magma_free_cpu( p );
+            }
+            magma_s_mbandwidth( B, &bandwidth, &profile );
+
+            magma_s_vpermute( MagmaNoTrans, perm, x, px );
+            for( irep = 0; irep < nrep; ++irep ) {
+                start = magma_wtime();
+                magma_s_spmv( one, B, px, zero, py );
+                start = magma_wtime() - start;
+                spmv_time = ( irep == 0 ? start : min( spmv_time, start ));
+            }
+
+            // z = P^T B P x - A x
+            magma_s_vpermute( MagmaTrans, perm, py, z );
+            magma_saxpby_cpu( A.num_rows, MAGMA_S_NEG_ONE, y.val, one, z.val );
+            diff = magma_snrm2_cpu( A.num_rows, z.val ) / nrm;
+            status += ( diff > 100*eps );
+
+            printf( "   %-8s  %12d   %12d   %13.4f   %9.3f   %s\n",
+                    names[iord], (int) bandwidth, (int) profile, reorder_time,
+                    spmv_time*1e3, ( diff > 100*eps ? "failed" : "ok" ));
+            fflush( stdout );
+            magma_free_cpu( perm );
+            magma_s_mfree( &B );
+        }
+
+        magma_free_cpu( shuffle );
+        magma_s_mfree( &S );
+        magma_s_vfree( &x );
+        magma_s_vfree( &y );
+        magma_s_vfree( &px );
+        magma_s_vfree( &py );
+        magma_s_vfree( &z );
+        magma_s_mfree( &A );
+    }
+
+    TESTING_FINALIZE();
+    return status;
+}
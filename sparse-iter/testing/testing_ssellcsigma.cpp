@@ -0,0 +1,157 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from testing_zsellcsigma.cpp normal z -> s, Tue Sep  2 12:38:36 2014
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing the SELL-C-sigma conversion and its autotuner
+   For each matrix, reports the padding and the time of the CPU SpMV in
+   CSR and in SELL-C-sigma for C = 8, 32 and sigma = 1, 16 C, 256 C, and checks
+   that P^T (B (P x)) = A x. Then runs magma_s_sellcsigma_tune and reports
+   the chosen C and sigma and the speedup over CSR.
+   Without files, uses the 3D 27-point stencil matrix on a --n^3 grid
+   (default 64). The rows are padded to a multiple of --alignment
+   (default 1). --nrep sets the number of SpMVs, of which the fastest
+   is reported.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_INIT();
+
+    float one  = MAGMA_S_MAKE(1.0, 0.0);
+    float zero = MAGMA_S_MAKE(0.0, 0.0);
+    magma_s_sparse_matrix A, B;
+    magma_s_vector x, y, px, py, z;
+    magma_index_t *perm;
+    real_Double_t start, t_csr, t_sell, diff, nrm;
+    real_Double_t eps = lapackf77_slamch( "E" );
+    magma_int_t stored, sigma, irep, j, info;
+    magma_int_t status = 0;
+    magma_int_t nrep = 10;
+    magma_int_t n = 64;
+    magma_int_t alignment = 1;
+    magma_int_t Cs[] = { 8, 32 };
+    magma_int_t windows[] = { 0, 16, 256 };
+
+    int i;
+    for( i = 1; i < argc; ++i ) {
+        if ( strcmp("--nrep", argv[i]) == 0 ) {
+            nrep = max( 1, atoi( argv[++i] ));
+        }else if ( strcmp("--n", argv[i]) == 0 ) {
+            n = atoi( argv[++i] );
+        }else if ( strcmp("--alignment", argv[i]) == 0 ) {
+            alignment = max( 1, atoi( argv[++i] ));
+        }else
+            break;
+    }
+    printf( "\n#    usage: ./testing_zsellcsigma"
+        " [ --nrep %d --n %d --alignment %d ] matrices\n\n",
+        (int) nrep, (int) n, (int) alignment );
+
+    do {
+        if ( i < argc )
+            magma_s_csr_mtx( &A, argv[i] );
+        else
+            magma_sm_27stencil( n, &A );
+
+        printf( "\n# matrix info: %d-by-%d with %d nonzeros\n\n",
+                (int) A.num_rows, (int) A.num_cols, (int) A.nnz );
+
+        // x has distinct entries, so that permutation errors show
+        magma_s_vinit( &x, Magma_CPU, A.num_rows, zero );
+        magma_s_vinit( &y, Magma_CPU, A.num_rows, zero );
+        magma_s_vinit( &px, Magma_CPU, A.num_rows, zero );
+        magma_s_vinit( &py, Magma_CPU, A.num_rows, zero );
+        magma_s_vinit( &z, Magma_CPU, A.num_rows, zero );
+        for( j=0; j < A.num_rows; j++ )
+            x.val[j] = MAGMA_S_MAKE( 1. + (j % 17) / 17., 0. );
+        for( irep = 0; irep < nrep; ++irep ) {
+            start = magma_wtime();
+            magma_s_spmv( one, A, x, zero, y );
+            start = magma_wtime() - start;
+            t_csr = ( irep == 0 ? start : min( t_csr, start ));
+        }
+        nrm = magma_snrm2_cpu( A.num_rows, y.val );
+
+        printf( "       C      sigma   padding   SpMV (ms)   speedup   check\n" );
+        printf( "   ==========================================================\n" );
+        printf( "     CSR                1.000   %9.3f\n", t_csr*1e3 );
+        for( int tune = 0; tune < 2; ++tune ) {
+        for( int ic = 0; ic < 2; ++ic ) {
+        for( int is = 0; is < 3; ++is ) {
+            if ( tune ) {
+                // B = the matrix chosen by the tuner
+                if ( ic > 0 || is > 0 )
+                    continue;
+                B.alignment = alignment;
+                info = magma_s_sellcsigma_tune( A, &B, &sigma, &perm, 0 );
+            }
+            else {
+                B.blocksize = Cs[ic];
+                B.alignment = alignment;
+                sigma = max( windows[is]*Cs[ic], 1 );
+                info = magma_s_sellcsigma( A, &B, sigma, &perm );
+            }
+            if ( info != MAGMA_SUCCESS ) {
+                printf( "   conversion failed with error %d\n", (int) info );
+                status += 1;
+                continue;
+            }
+            magma_s_sellp_padding( A, B.blocksize, sigma, alignment, &stored );
+
+            magma_s_vpermute( MagmaNoTrans, perm, x, px );
+            for( irep = 0; irep < nrep; ++irep ) {
+                start = magma_wtime();
+                magma_s_spmv( one, B, px, zero, py );
+                start = magma_wtime() - start;
+                t_sell = ( irep == 0 ? start : min( t_sell, start ));
+            }
+
+            // z = P^T B P x - A x
+            magma_s_vpermute( MagmaTrans, perm, py, z );
+            magma_saxpby_cpu( A.num_rows, MAGMA_S_NEG_ONE, y.val, one, z.val );
+            diff = magma_snrm2_cpu( A.num_rows, z.val ) / nrm;
+            status += !( diff <= 100*eps );
+
+            printf( "   %s%4d   %8d   %7.3f   %9.3f   %7.2f   %s\n",
+                    ( tune ? "tuned" : "     " ), (int) B.blocksize, (int) sigma,
+                    (float) stored / A.nnz, t_sell*1e3, t_csr / t_sell,
+                    ( diff <= 100*eps ? "ok" : "failed" ));
+            fflush( stdout );
+            magma_free_cpu( perm );
+            magma_s_mfree( &B );
+        }
+        }
+        }
+
+        magma_s_vfree( &x );
+        magma_s_vfree( &y );
+        magma_s_vfree( &px );
+        magma_s_vfree( &py );
+        magma_s_vfree( &z );
+        magma_s_mfree( &A );
+        i++;
+    } while( i < argc );
+
+    TESTING_FINALIZE();
+    return status;
+}
@@ -63,15 +63,25 @@ int main( int argc, char** argv)
         // scale matrix
         magma_smscale( &A, zopts.scaling );
 
+        // reorder rows and columns
+        if ( zopts.reordering != Magma_NOREORDER ) {
+            magma_s_sparse_matrix C;
+            magma_index_t *perm;
+            magma_s_mreorder( A, &C, zopts.reordering, &perm );
+            magma_s_mfree(&A);
+            A = C;
+            magma_free_cpu( perm );
+        }
+
         magma_s_mconvert( A, &B, Magma_CSR, zopts.output_format );
-        magma_s_mtransfer( B, &B_d, Magma_CPU, Magma_DEV );
+        magma_s_mtransfer( B, &B_d, Magma_CPU, zopts.output_location );
 
         // vectors and initial guess
-        magma_s_vinit( &b, Magma_DEV, A.num_cols, one );
-        magma_s_vinit( &x, Magma_DEV, A.num_cols, one );
+        magma_s_vinit( &b, zopts.output_location, A.num_cols, one );
+        magma_s_vinit( &x, zopts.output_location, A.num_cols, one );
         magma_s_spmv( one, B_d, x, zero, b );                 //  b = A x
         magma_s_vfree(&x);
-        magma_s_vinit( &x, Magma_DEV, A.num_cols, zero );
+        magma_s_vinit( &x, zopts.output_location, A.num_cols, zero );
 
         magma_s_solver( B_d, b, &x, &zopts ); 
 
@@ -0,0 +1,93 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from testing_zvector_cpu.cpp normal z -> s, Tue Sep  2 12:38:36 2014
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing magma_snrm2_cpu
+   Compares the norm of a random vector of length --n (default 100000, at
+   least 4 times the OpenMP threshold, so each thread gets a part) with
+   magma_cblas_snrm2, for entries of order 1, entries whose squares
+   overflow, and entries whose squares underflow. Then puts a NaN at the
+   start, the middle, and the end, so that it is in the first, a middle,
+   and the last thread's part; the norm must be NaN.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_INIT();
+
+    float *x;
+    float nrm, ref, err, alpha;
+    float eps = lapackf77_slamch("E");
+    float tol = 100*eps;
+    magma_int_t ione = 1, ISEED[4] = {0,0,0,1};
+    magma_int_t status = 0;
+    magma_int_t n = 100000;
+
+    int i;
+    for( i = 1; i < argc; ++i ) {
+        if ( strcmp("--n", argv[i]) == 0 ) {
+            n = atoi( argv[++i] );
+        }else
+            break;
+    }
+    n = max( n, 4*MAGMA_SPARSE_OMP_THRESHOLD );
+    printf( "\n#    usage: ./testing_svector_cpu [ --n %d ]\n\n", (int) n );
+
+    TESTING_MALLOC_CPU( x, float, n );
+
+    const char *names[3] = { "order 1", "overflow", "underflow" };
+    float scales[3];
+    scales[0] = 1.;
+    scales[1] = sqrt( lapackf77_slamch("O") );  // squares overflow
+    scales[2] = sqrt( lapackf77_slamch("S") ) * eps;  // squares underflow
+
+    printf( "   entries            n    rel. error   check\n" );
+    printf( "   ===========================================\n" );
+    for( int iscale = 0; iscale < 3; iscale++ ){
+        lapackf77_slarnv( &ione, ISEED, &n, x );
+        ref = magma_cblas_snrm2( n, x, 1 );
+        alpha = scales[iscale];
+        blasf77_sscal( &n, &alpha, x, &ione );
+        nrm = magma_snrm2_cpu( n, x ) / alpha;
+        err = fabs( nrm - ref ) / ref;
+        status += ! (err <= tol);
+        printf( "   %-10s  %9d   %11.2e   %s\n",
+                names[iscale], (int) n, err, (err <= tol ? "ok" : "failed") );
+    }
+
+    magma_int_t pos[3] = { 0, n/2, n-1 };
+    for( int ipos = 0; ipos < 3; ipos++ ){
+        lapackf77_slarnv( &ione, ISEED, &n, x );
+        x[ pos[ipos] ] = MAGMA_S_NAN;
+        nrm = magma_snrm2_cpu( n, x );
+        status += ( nrm == nrm );
+        printf( "   NaN at %-9d  %9d   %11.2e   %s\n",
+                (int) pos[ipos], (int) n, nrm, (nrm != nrm ? "ok" : "failed") );
+    }
+
+    TESTING_FREE_CPU( x );
+
+    TESTING_FINALIZE();
+    return status;
+}
@@ -0,0 +1,182 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma.h"
+#include "magmasparse.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+// ---------------------------------------------
+// Returns the number of entries in which the CSR matrices A and B differ.
+static magma_int_t csr_compare( magma_z_sparse_matrix A, magma_z_sparse_matrix B )
+{
+    if( A.num_rows != B.num_rows || A.num_cols != B.num_cols || A.nnz != B.nnz )
+        return 1;
+    magma_int_t i, ndiff = 0;
+    for( i=0; i < A.num_rows+1; i++ )
+        ndiff += ( A.row[i] != B.row[i] );
+    for( i=0; i < A.nnz; i++ )
+        ndiff += ( A.col[i] != B.col[i] ||
+                   ! MAGMA_Z_EQUAL( A.val[i], B.val[i] ));
+    return ndiff;
+}
+
+
+// ---------------------------------------------
+// Inverts the bits of the byte at offset in the file; doing it twice
+// restores the file.
+static void flip_byte( const char *filename, long offset )
+{
+    FILE *fid = fopen( filename, "r+b" );
+    fseek( fid, offset, SEEK_SET );
+    int c = fgetc( fid );
+    fseek( fid, offset, SEEK_SET );
+    fputc( c ^ 0xff, fid );
+    fclose( fid );
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing write_z_csrtobinary, read_z_csr_from_binary, and magma_z_csr_binary
+   Reads each Matrix Market file, writes it to testing_zbinary.bin, and times
+   reading that back with the copying reader and with the mapping reader.
+   For the mapping reader, also times the first SpMV, which reads the pages
+   of the file. Both readers must give the matrix that was written.
+   Then flips a byte of the row pointer, which the copying reader must
+   reject, and a byte of the header, which both readers must reject.
+   Without files, uses the 3D 27-point stencil matrix on a --n^3 grid
+   (default 50).
+   --nrep sets the number of runs, of which the fastest is reported.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_INIT();
+
+    magmaDoubleComplex one  = MAGMA_Z_MAKE(1.0, 0.0);
+    magmaDoubleComplex zero = MAGMA_Z_MAKE(0.0, 0.0);
+    magma_z_sparse_matrix A, B, C;
+    magma_z_vector x, y;
+    real_Double_t start, mtx_time, write_time, copy_time, map_time, spmv_time, mbytes;
+    magma_int_t ndiff, irep;
+    magma_int_t status = 0;
+    magma_int_t nrep = 3;
+    magma_int_t n = 50;
+    const char *binary = "testing_zbinary.bin";
+
+    int i;
+    for( i = 1; i < argc; ++i ) {
+        if ( strcmp("--nrep", argv[i]) == 0 ) {
+            nrep = max( 1, atoi( argv[++i] ));
+        }else if ( strcmp("--n", argv[i]) == 0 ) {
+            n = atoi( argv[++i] );
+        }else
+            break;
+    }
+    printf( "\n#    usage: ./testing_zbinary"
+        " [ --nrep %d --n %d ] matrices\n\n", (int) nrep, (int) n );
+
+    printf( "  file size (MB)        rows          nnz   mtx (sec)   write (sec)   copy (sec)   map (sec)   1st spmv (sec)   check\n" );
+    printf( "=====================================================================================================================\n" );
+    do {
+        mtx_time = magma_wtime();
+        if ( i < argc )
+            magma_z_csr_mtx( &A, argv[i] );
+        else
+            magma_zm_27stencil( n, &A );
+        mtx_time = magma_wtime() - mtx_time;
+
+        write_time = magma_wtime();
+        write_z_csrtobinary( A, binary );
+        write_time = magma_wtime() - write_time;
+
+        FILE *fid = fopen( binary, "rb" );
+        fseek( fid, 0, SEEK_END );
+        mbytes = ftell( fid ) / 1e6;
+        fclose( fid );
+
+        ndiff = 0;
+        copy_time = map_time = 0;
+        for( irep = 0; irep < nrep; ++irep ) {
+            B.storage_type = Magma_CSR;
+            B.memory_location = Magma_CPU;
+            start = magma_wtime();
+            read_z_csr_from_binary( &B.num_rows, &B.num_cols, &B.nnz,
+                                    &B.val, &B.row, &B.col, binary );
+            start = magma_wtime() - start;
+            copy_time = ( irep == 0 ? start : min( copy_time, start ));
+            ndiff += csr_compare( A, B );
+            magma_z_mfree( &B );
+
+            start = magma_wtime();
+            magma_z_csr_binary( &C, binary );
+            start = magma_wtime() - start;
+            map_time = ( irep == 0 ? start : min( map_time, start ));
+
+            // the first SpMV reads the mapped pages
+            magma_z_vinit( &x, Magma_CPU, C.num_cols, one );
+            magma_z_vinit( &y, Magma_CPU, C.num_rows, zero );
+            start = magma_wtime();
+            magma_z_spmv( one, C, x, zero, y );
+            start = magma_wtime() - start;
+            spmv_time = ( irep == 0 ? start : min( spmv_time, start ));
+            ndiff += csr_compare( A, C );
+            magma_z_vfree( &x );
+            magma_z_vfree( &y );
+            magma_z_mfree( &C );
+        }
+
+        // corrupted data: row[0], which follows the 128 byte header
+        flip_byte( binary, 128 );
+        if ( read_z_csr_from_binary( &B.num_rows, &B.num_cols, &B.nnz,
+                                     &B.val, &B.row, &B.col, binary ) == MAGMA_SUCCESS ) {
+            ndiff += 1;
+            B.storage_type = Magma_CSR;
+            B.memory_location = Magma_CPU;
+            magma_z_mfree( &B );
+        }
+        flip_byte( binary, 128 );
+
+        // corrupted header: the low byte of num_rows
+        flip_byte( binary, 32 );
+        if ( read_z_csr_from_binary( &B.num_rows, &B.num_cols, &B.nnz,
+                                     &B.val, &B.row, &B.col, binary ) == MAGMA_SUCCESS ) {
+            ndiff += 1;
+            B.storage_type = Magma_CSR;
+            B.memory_location = Magma_CPU;
+            magma_z_mfree( &B );
+        }
+        if ( magma_z_csr_binary( &C, binary ) == MAGMA_SUCCESS ) {
+            ndiff += 1;
+            magma_z_mfree( &C );
+        }
+        status += ( ndiff != 0 );
+
+        printf( "  %14.1f %12d %12d   %9.4f   %11.4f   %10.4f   %9.6f   %14.4f   %s\n",
+                mbytes, (int) A.num_rows, (int) A.nnz, mtx_time, write_time,
+                copy_time, map_time, spmv_time, (ndiff == 0 ? "ok" : "failed") );
+        fflush( stdout );
+
+        magma_z_mfree( &A );
+        i++;
+    } while( i < argc );
+    remove( binary );
+
+    TESTING_FINALIZE();
+    return status;
+}
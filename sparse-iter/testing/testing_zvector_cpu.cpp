@@ -0,0 +1,93 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @precisions normal z -> c d s
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// includes, project
+#include "flops.h"
+#include "magma.h"
+#include "magmasparse.h"
+#include "magmasparse_internal.h"
+#include "magma_lapack.h"
+#include "testings.h"
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing magma_dznrm2_cpu
+   Compares the norm of a random vector of length --n (default 100000, at
+   least 4 times the OpenMP threshold, so each thread gets a part) with
+   magma_cblas_dznrm2, for entries of order 1, entries whose squares
+   overflow, and entries whose squares underflow. Then puts a NaN at the
+   start, the middle, and the end, so that it is in the first, a middle,
+   and the last thread's part; the norm must be NaN.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_INIT();
+
+    magmaDoubleComplex *x;
+    double nrm, ref, err, alpha;
+    double eps = lapackf77_dlamch("E");
+    double tol = 100*eps;
+    magma_int_t ione = 1, ISEED[4] = {0,0,0,1};
+    magma_int_t status = 0;
+    magma_int_t n = 100000;
+
+    int i;
+    for( i = 1; i < argc; ++i ) {
+        if ( strcmp("--n", argv[i]) == 0 ) {
+            n = atoi( argv[++i] );
+        }else
+            break;
+    }
+    n = max( n, 4*MAGMA_SPARSE_OMP_THRESHOLD );
+    printf( "\n#    usage: ./testing_zvector_cpu [ --n %d ]\n\n", (int) n );
+
+    TESTING_MALLOC_CPU( x, magmaDoubleComplex, n );
+
+    const char *names[3] = { "order 1", "overflow", "underflow" };
+    double scales[3];
+    scales[0] = 1.;
+    scales[1] = sqrt( lapackf77_dlamch("O") );  // squares overflow
+    scales[2] = sqrt( lapackf77_dlamch("S") ) * eps;  // squares underflow
+
+    printf( "   entries            n    rel. error   check\n" );
+    printf( "   ===========================================\n" );
+    for( int iscale = 0; iscale < 3; iscale++ ){
+        lapackf77_zlarnv( &ione, ISEED, &n, x );
+        ref = magma_cblas_dznrm2( n, x, 1 );
+        alpha = scales[iscale];
+        blasf77_zdscal( &n, &alpha, x, &ione );
+        nrm = magma_dznrm2_cpu( n, x ) / alpha;
+        err = fabs( nrm - ref ) / ref;
+        status += ! (err <= tol);
+        printf( "   %-10s  %9d   %11.2e   %s\n",
+                names[iscale], (int) n, err, (err <= tol ? "ok" : "failed") );
+    }
+
+    magma_int_t pos[3] = { 0, n/2, n-1 };
+    for( int ipos = 0; ipos < 3; ipos++ ){
+        lapackf77_zlarnv( &ione, ISEED, &n, x );
+        x[ pos[ipos] ] = MAGMA_Z_NAN;
+        nrm = magma_dznrm2_cpu( n, x );
+        status += ( nrm == nrm );
+        printf( "   NaN at %-9d  %9d   %11.2e   %s\n",
+                (int) pos[ipos], (int) n, nrm, (nrm != nrm ? "ok" : "failed") );
+    }
+
+    TESTING_FREE_CPU( x );
+
+    TESTING_FINALIZE();
+    return status;
+}
@@ -15,10 +15,7 @@
 #include "common_magma.h"
 #include "magma_bulge.h"
 #include "magma_cbulge.h"
-
-#ifdef MAGMA_SETAFFINITY
-#include "affinity.h"
-#endif
+#include "magma_thread_team.h"
 
 
 #define PRECISION_c
@@ -167,34 +164,15 @@ magma_cbulge_back_m(magma_int_t nrgpu, magma_uplo_t uplo,
         magma_capplyQ_m_id_data* arg;
         magma_malloc_cpu((void**) &arg, threads*sizeof(magma_capplyQ_m_id_data));
 
-        pthread_t* thread_id;
-        magma_malloc_cpu((void**) &thread_id, threads*sizeof(pthread_t));
-
-        pthread_attr_t thread_attr;
-
         // ===============================
         // relaunch thread to apply Q
         // ===============================
-        // Set one thread per core
-        pthread_attr_init(&thread_attr);
-        pthread_attr_setscope(&thread_attr, PTHREAD_SCOPE_SYSTEM);
-        pthread_setconcurrency(threads);
-
-        // Launch threads
-        for (magma_int_t thread = 1; thread < threads; thread++) {
+        // Run on the pinned thread team, this thread as thread 0, and wait for completion
+        for (magma_int_t thread = 0; thread < threads; thread++) {
             arg[thread] = magma_capplyQ_m_id_data(thread, &data_applyQ);
-            pthread_create(&thread_id[thread], &thread_attr, magma_capplyQ_m_parallel_section, &arg[thread]);
-        }
-        arg[0] = magma_capplyQ_m_id_data(0, &data_applyQ);
-        magma_capplyQ_m_parallel_section(&arg[0]);
-
-        // Wait for completion
-        for (magma_int_t thread = 1; thread < threads; thread++) {
-            void *exitcodep;
-            pthread_join(thread_id[thread], &exitcodep);
         }
+        *info = magma_thread_team_run(threads, magma_capplyQ_m_parallel_section, arg, sizeof(magma_capplyQ_m_id_data));
 
-        magma_free_cpu(thread_id);
         magma_free_cpu(arg);
 
         /*============================
@@ -245,31 +223,6 @@ static void *magma_capplyQ_m_parallel_section(void *arg)
     // it need that all threads setting it to 1.
     magma_set_lapack_numthreads(1);
 
-#ifdef MAGMA_SETAFFINITY
-    //#define PRINTAFFINITY
-#ifdef PRINTAFFINITY
-    affinity_set print_set;
-    print_set.print_affinity(my_core_id, "starting affinity");
-#endif
-    affinity_set original_set;
-    affinity_set new_set(my_core_id);
-    int check  = 0;
-    int check2 = 0;
-    // bind threads
-    check = original_set.get_affinity();
-    if (check == 0) {
-        check2 = new_set.set_affinity();
-        if (check2 != 0)
-            printf("Error in sched_setaffinity (single cpu)\n");
-    }
-    else {
-        printf("Error in sched_getaffinity\n");
-    }
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "set affinity");
-#endif
-#endif
-
     if (my_core_id == 0) {
         //=============================================
         //   on GPU on thread 0:
@@ -311,18 +264,6 @@ static void *magma_capplyQ_m_parallel_section(void *arg)
         #endif
     } // END if my_core_id
 
-#ifdef MAGMA_SETAFFINITY
-    // unbind threads
-    if (check == 0) {
-        check2 = original_set.set_affinity();
-        if (check2 != 0)
-            printf("Error in sched_setaffinity (restore cpu list)\n");
-    }
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "restored_affinity");
-#endif
-#endif
-
     return 0;
 }
 
@@ -129,6 +129,101 @@ private:
 };
 
 
+// ---------------------------------------------
+// forms right-hand side for eigenvector ki in x (on CPU):
+// for trans = MagmaNoTrans,   x = [ -T(0:ki-1,ki); 1; 0 ],
+// for trans = MagmaConjTrans, x = [ 0; 1; -T(ki,ki+1:n-1)**H ].
+class ctrevc3_rhs_task: public magma_task
+{
+public:
+    ctrevc3_rhs_task(
+        magma_trans_t in_trans, magma_int_t in_n, magma_int_t in_ki,
+        const magmaFloatComplex* in_T, magma_int_t in_ldt,
+        magmaFloatComplex* in_x
+    ):
+        trans( in_trans ),
+        n    ( in_n     ),
+        ki   ( in_ki    ),
+        T    ( in_T     ),
+        ldt  ( in_ldt   ),
+        x    ( in_x     )
+    {}
+
+    virtual void run()
+    {
+        x[ki] = MAGMA_C_ONE;
+        if ( trans == MagmaNoTrans ) {
+            for( magma_int_t k=0; k < ki; ++k ) {
+                x[k] = -T[ k + ki*ldt ];
+            }
+            for( magma_int_t k=ki+1; k < n; ++k ) {
+                x[k] = MAGMA_C_ZERO;
+            }
+        }
+        else {
+            for( magma_int_t k=0; k < ki; ++k ) {
+                x[k] = MAGMA_C_ZERO;
+            }
+            for( magma_int_t k=ki+1; k < n; ++k ) {
+                x[k] = -MAGMA_C_CNJG( T[ ki + k*ldt ] );
+            }
+        }
+    }
+
+private:
+    magma_trans_t trans;
+    magma_int_t   n;
+    magma_int_t   ki;
+    const magmaFloatComplex* T;
+    magma_int_t   ldt;
+    magmaFloatComplex* x;
+};
+
+
+// ---------------------------------------------
+// normalizes block of back-transformed eigenvectors Q*x, stored in columns
+// 1:nv of W, then copies them to V (on CPU).
+class ctrevc3_normalize_task: public magma_task
+{
+public:
+    ctrevc3_normalize_task(
+        magma_int_t in_n, magma_int_t in_nv,
+        magmaFloatComplex* in_W, magma_int_t in_ldw,
+        magmaFloatComplex* in_V, magma_int_t in_ldv
+    ):
+        n  ( in_n   ),
+        nv ( in_nv  ),
+        W  ( in_W   ),
+        ldw( in_ldw ),
+        V  ( in_V   ),
+        ldv( in_ldv )
+    {}
+
+    virtual void run()
+    {
+        const magma_int_t ione = 1;
+        magma_int_t ii;
+        float remax;
+
+        // W is 1-based
+        for( magma_int_t k=1; k <= nv; ++k ) {
+            ii = blasf77_icamax( &n, W + k*ldw, &ione ) - 1;
+            remax = 1. / MAGMA_C_ABS1( W[ ii + k*ldw ] );
+            blasf77_csscal( &n, &remax, W + k*ldw, &ione );
+        }
+        lapackf77_clacpy( "F", &n, &nv, W + ldw, &ldw, V, &ldv );
+    }
+
+private:
+    magma_int_t  n;
+    magma_int_t  nv;
+    magmaFloatComplex* W;
+    magma_int_t  ldw;
+    magmaFloatComplex* V;
+    magma_int_t  ldv;
+};
+
+
 /**
     Purpose
     -------
@@ -283,7 +378,7 @@ magma_int_t magma_ctrevc3_mt(
     #define  T(i,j)  ( T + (i) + (j)*ldt )
     #define VL(i,j)  (VL + (i) + (j)*ldvl)
     #define VR(i,j)  (VR + (i) + (j)*ldvr)
-    #define work(i,j) (work + (i) + (j)*n)
+    #define work(i,j) (W + (i) + (j)*n)
 
     // .. Parameters ..
     const magmaFloatComplex c_zero = MAGMA_C_ZERO;
@@ -295,6 +390,8 @@ magma_int_t magma_ctrevc3_mt(
     magma_int_t            allv, bothv, leftv, over, rightv, somev;
     magma_int_t            i, ii, is, j, k, ki, iv, n2, nb, nb2, version;
     float                 ovfl, remax, smin, smlnum, ulp, unfl;
+    magmaFloatComplex     *W, *work2;
+    const void            *last_block;  // columns of VR or VL written by the last normalize task
     
     // Decode and test the input parameters
     bothv  = (side == MagmaBothSides);
@@ -352,12 +449,22 @@ magma_int_t magma_ctrevc3_mt(
     // (Compared to dtrevc3, rwork stores 1-norms.)
     // Zero-out the workspace to avoid potential NaN propagation.
     nb = 2;
+    W = work;
+    work2 = NULL;
     if ( lwork >= n + 2*n*nbmin ) {
         version = 2;
         nb = (lwork - n) / (2*n);
         nb = min( nb, nbmax );
         nb2 = 1 + 2*nb;
         lapackf77_claset( "F", &n, &nb2, &c_zero, &c_zero, work, &n );
+        
+        // To overlap solves for the next block with GEMM for the current
+        // block, alternate between work and a second internal workspace.
+        // If it can't be allocated, tasks are serialized by their data
+        // dependencies on the single workspace instead.
+        if ( over && magma_cmalloc_cpu( &work2, n*nb2 ) == MAGMA_SUCCESS ) {
+            lapackf77_claset( "F", &n, &nb2, &c_zero, &c_zero, work2, &n );
+        }
     }
     else {
         version = 1;
@@ -374,6 +481,9 @@ magma_int_t magma_ctrevc3_mt(
     for( i=0; i < n; ++i ) {
         *work(i,0) = *T(i,i);
     }
+    if ( work2 != NULL ) {
+        blasf77_ccopy( &n, work, &ione, work2, &ione );
+    }
 
     // Compute 1-norm of each column of strictly upper triangular
     // part of T to control overflow in triangular solver.
@@ -414,6 +524,7 @@ magma_int_t magma_ctrevc3_mt(
         
         timer_start( time_trsv );
         is = *mout - 1;
+        last_block = NULL;
         for( ki=n-1; ki >= 0; --ki ) {
             if ( somev ) {
                 if ( ! select[ki] ) {
@@ -424,20 +535,31 @@ magma_int_t magma_ctrevc3_mt(
 
             // --------------------------------------------------------
             // Complex right eigenvector
-            *work(ki,iv) = c_one;
-
             // Form right-hand side.
-            for( k=0; k < ki; ++k ) {
-                *work(k,iv) = -(*T(k,ki));
+            // For the blocked back-transform, the GEMM of an earlier block
+            // may still be reading this column, so this is also a task.
+            if ( over && version == 2 ) {
+                magma_task* rhs = new ctrevc3_rhs_task(
+                    MagmaNoTrans, n, ki, T, ldt, work(0,iv) );
+                rhs->writes( work(0,iv) );
+                queue.push_task( rhs );
+            }
+            else {
+                *work(ki,iv) = c_one;
+                for( k=0; k < ki; ++k ) {
+                    *work(k,iv) = -(*T(k,ki));
+                }
             }
 
             // Solve upper triangular system:
             // [ T(1:ki-1,1:ki-1) - T(ki,ki) ]*X = scale*work.
             if ( ki > 0 ) {
-                queue.push_task( new magma_clatrsd_task(
+                magma_task* trsv = new magma_clatrsd_task(
                     MagmaUpper, MagmaNoTrans, MagmaNonUnit, MagmaTrue,
                     ki, T, ldt, *T(ki,ki),
-                    work(0,iv), work(ki,iv), rwork ));
+                    work(0,iv), work(ki,iv), rwork );
+                trsv->writes( work(0,iv) );
+                queue.push_task( trsv );
             }
 
             // Copy the vector x or Q*x to VR and normalize.
@@ -477,41 +599,66 @@ magma_int_t magma_ctrevc3_mt(
             else if ( version == 2 ) {
                 // ------------------------------
                 // version 2: back-transform block of vectors with GEMM
-                // zero out below vector
-                for( k=ki+1; k < n; ++k ) {
-                    *work(k,iv) = c_zero;
-                }
+                // (the RHS task zeroed out below vector)
 
                 // Columns iv:nb of work are valid vectors.
                 // When the number of vectors stored reaches nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv == 1) || (ki == 0) ) {
+                    #ifdef ENABLE_TIMER
+                    // so the timers measure the tasks, not just pushing them;
+                    // this gives up the overlap of solves and GEMMs
                     queue.sync();
+                    #endif
                     time_trsv_sum += timer_stop( time_trsv );
                     timer_start( time_gemm );
                     nb2 = nb-iv+1;
                     n2  = ki+nb-iv+1;
                     
+                    // No sync here: each GEMM task waits only for the solves
+                    // in this block, and the normalize task for all GEMMs.
+                    // Meanwhile, solves for the next block proceed in the
+                    // other workspace.
                     // split gemm into multiple tasks, each doing one block row
+                    magma_task* normalize = new ctrevc3_normalize_task(
+                        n, nb2, work(0,nb+iv-1), n, VR(0,ki), ldvr );
                     for( i=0; i < n; i += NB ) {
                         magma_int_t ib = min( NB, n-i );
-                        queue.push_task( new cgemm_task(
+                        magma_task* gemm = new cgemm_task(
                             MagmaNoTrans, MagmaNoTrans, ib, nb2, n2, c_one,
                             VR(i,0), ldvr,
                             work(0,iv   ), n, c_zero,
-                            work(i,nb+iv), n ));
+                            work(i,nb+iv), n );
+                        for( k=iv; k <= nb; ++k ) {
+                            gemm->reads( work(0,k) );
+                        }
+                        gemm->writes( work(i,nb+1) );
+                        normalize->reads( work(i,nb+1) );
+                        queue.push_task( gemm );
                     }
-                    queue.sync();
-                    time_gemm_sum += timer_stop( time_gemm );
                     
                     // normalize vectors
                     // TODO if somev, should copy vectors individually to correct location.
-                    for( k = iv; k <= nb; ++k ) {
-                        ii = blasf77_icamax( &n, work(0,nb+k), &ione ) - 1;
-                        remax = 1. / MAGMA_C_ABS1( *work(ii,nb+k) );
-                        blasf77_csscal( &n, &remax, work(0,nb+k), &ione );
+                    // The GEMMs of earlier blocks read these columns of VR, so
+                    // copying to them must wait for those GEMMs; the GEMMs of
+                    // later blocks read only columns left of ki and need not
+                    // wait. This task waits for its own GEMMs, through work,
+                    // and for the previous normalize task, which by induction
+                    // waited for all earlier GEMMs.
+                    normalize->writes( VR(0,ki) );
+                    if ( last_block != NULL ) {
+                        normalize->reads( last_block );
+                    }
+                    last_block = VR(0,ki);
+                    queue.push_task( normalize );
+                    #ifdef ENABLE_TIMER
+                    queue.sync();
+                    #endif
+                    time_gemm_sum += timer_stop( time_gemm );
+                    
+                    if ( work2 != NULL ) {
+                        W = (W == work ? work2 : work);
                     }
-                    lapackf77_clacpy( "F", &n, &nb2, work(0,nb+iv), &n, VR(0,ki), &ldvr );
                     iv = nb;
                     timer_start( time_trsv );
                 }
@@ -522,6 +669,7 @@ magma_int_t magma_ctrevc3_mt(
 
             is -= 1;
         }
+        queue.sync();
     }
     timer_stop( time_trsv );
     
@@ -538,6 +686,7 @@ magma_int_t magma_ctrevc3_mt(
         // (Note the "0-th" column is used to store the original diagonal.)
         iv = 1;
         is = 0;
+        last_block = NULL;
         for( ki=0; ki < n; ++ki ) {
             if ( somev ) {
                 if ( ! select[ki] ) {
@@ -548,11 +697,19 @@ magma_int_t magma_ctrevc3_mt(
         
             // --------------------------------------------------------
             // Complex left eigenvector
-            *work(ki,iv) = c_one;
-        
             // Form right-hand side.
-            for( k = ki + 1; k < n; ++k ) {
-                *work(k,iv) = -MAGMA_C_CNJG( *T(ki,k) );
+            // As for right eigenvectors, this is a task in the blocked version.
+            if ( over && version == 2 ) {
+                magma_task* rhs = new ctrevc3_rhs_task(
+                    MagmaConjTrans, n, ki, T, ldt, work(0,iv) );
+                rhs->writes( work(0,iv) );
+                queue.push_task( rhs );
+            }
+            else {
+                *work(ki,iv) = c_one;
+                for( k = ki + 1; k < n; ++k ) {
+                    *work(k,iv) = -MAGMA_C_CNJG( *T(ki,k) );
+                }
             }
             
             // Solve conjugate-transposed triangular system:
@@ -560,10 +717,12 @@ magma_int_t magma_ctrevc3_mt(
             // TODO what happens with T(k,k) - lambda is small? Used to have < smin test.
             if ( ki < n-1 ) {
                 n2 = n-ki-1;
-                queue.push_task( new magma_clatrsd_task(
+                magma_task* trsv = new magma_clatrsd_task(
                     MagmaUpper, MagmaConjTrans, MagmaNonUnit, MagmaTrue,
                     n2, T(ki+1,ki+1), ldt, *T(ki,ki),
-                    work(ki+1,iv), work(ki,iv), rwork ));
+                    work(ki+1,iv), work(ki,iv), rwork );
+                trsv->writes( work(0,iv) );
+                queue.push_task( trsv );
             }
             
             // Copy the vector x or Q*x to VL and normalize.
@@ -600,36 +759,49 @@ magma_int_t magma_ctrevc3_mt(
             else if ( version == 2 ) {
                 // ------------------------------
                 // version 2: back-transform block of vectors with GEMM
-                // zero out above vector
-                // could go from (ki+1)-NV+1 to ki
-                for( k=0; k < ki; ++k ) {
-                    *work(k,iv) = c_zero;
-                }
+                // (the RHS task zeroed out above vector)
         
                 // Columns 1:iv of work are valid vectors.
                 // When the number of vectors stored reaches nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv == nb) || (ki == n-1) ) {
-                    queue.sync();
                     n2 = n-(ki+1)+iv;
                     
+                    // As for right eigenvectors, no sync here; solves for the
+                    // next block overlap with this GEMM.
                     // split gemm into multiple tasks, each doing one block row
+                    magma_task* normalize = new ctrevc3_normalize_task(
+                        n, iv, work(0,nb), n, VL(0,ki-iv+1), ldvl );
                     for( i=0; i < n; i += NB ) {
                         magma_int_t ib = min( NB, n-i );
-                        queue.push_task( new cgemm_task(
+                        magma_task* gemm = new cgemm_task(
                             MagmaNoTrans, MagmaNoTrans, ib, iv, n2, c_one,
                             VL(i,ki-iv+1), ldvl,
                             work(ki-iv+1,1), n, c_zero,
-                            work(i,nb+1), n ));
+                            work(i,nb+1), n );
+                        for( k=1; k <= iv; ++k ) {
+                            gemm->reads( work(0,k) );
+                        }
+                        gemm->writes( work(i,nb+1) );
+                        normalize->reads( work(i,nb+1) );
+                        queue.push_task( gemm );
                     }
-                    queue.sync();
+                    
                     // normalize vectors
-                    for( k=1; k <= iv; ++k ) {
-                        ii = blasf77_icamax( &n, work(0,nb+k), &ione ) - 1;
-                        remax = 1. / MAGMA_C_ABS1( *work(ii,nb+k) );
-                        blasf77_csscal( &n, &remax, work(0,nb+k), &ione );
+                    // As for VR, copying to these columns of VL waits for the
+                    // GEMMs of earlier blocks through the previous normalize
+                    // task; the GEMMs of later blocks read only columns right
+                    // of ki and need not wait.
+                    normalize->writes( VL(0,ki-iv+1) );
+                    if ( last_block != NULL ) {
+                        normalize->reads( last_block );
+                    }
+                    last_block = VL(0,ki-iv+1);
+                    queue.push_task( normalize );
+                    
+                    if ( work2 != NULL ) {
+                        W = (W == work ? work2 : work);
                     }
-                    lapackf77_clacpy( "F", &n, &iv, work(0,nb+1), &n, VL(0,ki-iv+1), &ldvl );
                     iv = 1;
                 }
                 else {
@@ -645,5 +817,7 @@ magma_int_t magma_ctrevc3_mt(
     queue.quit();
     magma_set_lapack_numthreads( lapack_nthread );
     
+    magma_free_cpu( work2 );
+    
     return *info;
 }  // End of CTREVC
@@ -15,6 +15,7 @@
 #include "common_magma.h"
 #include "magma_bulge.h"
 #include "magma_dbulge.h"
+#include "magma_thread_team.h"
 
 #define PRECISION_d
 
@@ -155,34 +156,15 @@ magma_dbulge_back(magma_uplo_t uplo,
         magma_dapplyQ_id_data* arg;
         magma_malloc_cpu((void**) &arg, threads*sizeof(magma_dapplyQ_id_data));
 
-        pthread_t* thread_id;
-        magma_malloc_cpu((void**) &thread_id, threads*sizeof(pthread_t));
-
-        pthread_attr_t thread_attr;
-
         // ===============================
         // relaunch thread to apply Q
         // ===============================
-        // Set one thread per core
-        pthread_attr_init(&thread_attr);
-        pthread_attr_setscope(&thread_attr, PTHREAD_SCOPE_SYSTEM);
-        pthread_setconcurrency(threads);
-
-        // Launch threads
-        for (magma_int_t thread = 1; thread < threads; thread++) {
+        // Run on the pinned thread team, this thread as thread 0, and wait for completion
+        for (magma_int_t thread = 0; thread < threads; thread++) {
             magma_dapplyQ_id_data_init(&(arg[thread]), thread, &data_applyQ);
-            pthread_create(&thread_id[thread], &thread_attr, magma_dapplyQ_parallel_section, &arg[thread]);
         }
-        magma_dapplyQ_id_data_init(&(arg[0]), 0, &data_applyQ);
-        magma_dapplyQ_parallel_section(&arg[0]);
+        *info = magma_thread_team_run(threads, magma_dapplyQ_parallel_section, arg, sizeof(magma_dapplyQ_id_data));
 
-        // Wait for completion
-        for (magma_int_t thread = 1; thread < threads; thread++) {
-            void *exitcodep;
-            pthread_join(thread_id[thread], &exitcodep);
-        }
-
-        magma_free_cpu(thread_id);
         magma_free_cpu(arg);
         magma_dapplyQ_data_destroy(&data_applyQ);
 
@@ -239,27 +221,6 @@ static void *magma_dapplyQ_parallel_section(void *arg)
     // it need that all threads setting it to 1.
     magma_set_lapack_numthreads(1);
 
-#ifdef MAGMA_SETAFFINITY
-    //#define PRINTAFFINITY
-#ifdef PRINTAFFINITY
-    affinity_set print_set;
-    print_set.print_affinity(my_core_id, "starting affinity");
-#endif
-    cpu_set_t old_set, new_set;
-
-    //store current affinity
-    CPU_ZERO(&old_set);
-    sched_getaffinity( 0, sizeof(old_set), &old_set);
-    //set new affinity
-    // bind threads
-    CPU_ZERO(&new_set);
-    CPU_SET(my_core_id, &new_set);
-    sched_setaffinity( 0, sizeof(new_set), &new_set) ;       
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "set affinity");
-#endif
-#endif
-
     if (my_core_id == 0) {
         //=============================================
         //   on GPU on thread 0:
@@ -302,14 +263,6 @@ static void *magma_dapplyQ_parallel_section(void *arg)
         #endif
     } // END if my_core_id
 
-#ifdef MAGMA_SETAFFINITY
-    //restore old affinity
-    sched_setaffinity(0, sizeof(old_set), &old_set);
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "restored_affinity");
-#endif
-#endif
-
     return 0;
 }
 
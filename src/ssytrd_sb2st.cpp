@@ -15,20 +15,20 @@
 #include "common_magma.h"
 #include "magma_bulge.h"
 #include "magma_sbulge.h"
-
-#ifdef MAGMA_SETAFFINITY
-#include "affinity.h"
-#endif
+#include "magma_progress.h"
+#include "magma_thread_team.h"
 
 #define PRECISION_s
 
 static void *magma_ssytrd_sb2st_parallel_section(void *arg);
 static void magma_stile_bulge_parallel(magma_int_t my_core_id, magma_int_t cores_num, float *A, magma_int_t lda,
                                        float *V, magma_int_t ldv, float *TAU, magma_int_t n, magma_int_t nb, magma_int_t nbtiles,
-                                       magma_int_t grsiz, magma_int_t Vblksiz, volatile magma_int_t *prog);
+                                       magma_int_t grsiz, magma_int_t Vblksiz, magma_progress_t *prog,
+                                       magma_progress_t *sweeps, magma_bulge_sched_t sched, volatile long *next_group);
 
 static void magma_stile_bulge_computeT_parallel(magma_int_t my_core_id, magma_int_t cores_num, float *V, magma_int_t ldv, float *TAU,
-                                                float *T, magma_int_t ldt, magma_int_t n, magma_int_t nb, magma_int_t Vblksiz);
+                                                float *T, magma_int_t ldt, magma_int_t n, magma_int_t nb, magma_int_t Vblksiz,
+                                                magma_progress_t *sweeps, volatile long *next_T);
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -47,7 +47,13 @@ typedef struct magma_sbulge_data_s {
     float* TAU;
     float* T;
     magma_int_t ldt;
-    volatile magma_int_t *prog;
+    magma_progress_t *prog;
+    magma_progress_t *sweeps;
+    magma_bulge_sched_t sched;
+    magma_bulge_numa_t numa;
+    float* Aorig;
+    volatile long next_group;
+    volatile long next_T;
     pthread_barrier_t barrier;
 } magma_sbulge_data;
 
@@ -56,7 +62,8 @@ void magma_sbulge_data_init(magma_sbulge_data *sbulge_data_S,
         magma_int_t grsiz, magma_int_t Vblksiz, magma_int_t compT,
         float *A, magma_int_t lda, float *V,
         magma_int_t ldv, float *TAU, float *T,
-        magma_int_t ldt, volatile magma_int_t* prog)
+        magma_int_t ldt, magma_progress_t* prog, magma_progress_t* sweeps, magma_bulge_sched_t sched,
+        magma_bulge_numa_t numa, float *Aorig)
 {
     sbulge_data_S->threads_num = threads_num;
     sbulge_data_S->n = n;
@@ -73,6 +80,12 @@ void magma_sbulge_data_init(magma_sbulge_data *sbulge_data_S,
     sbulge_data_S->T = T;
     sbulge_data_S->ldt = ldt;
     sbulge_data_S->prog = prog;
+    sbulge_data_S->sweeps = sweeps;
+    sbulge_data_S->sched = sched;
+    sbulge_data_S->numa = numa;
+    sbulge_data_S->Aorig = Aorig;
+    sbulge_data_S->next_group = 0;
+    sbulge_data_S->next_T = 0;
 
     pthread_barrier_init(&(sbulge_data_S->barrier), NULL, sbulge_data_S->threads_num);
 }
@@ -96,7 +109,17 @@ void magma_sbulge_id_data_init(magma_sbulge_id_data *id_data, magma_int_t id, ma
 /**
     Purpose
     -------
+    Reduces a band matrix to tridiagonal form by bulge chasing.
+
+    By default, the bulge chasing tasks are assigned statically to threads
+    by tile column. Setting $MAGMA_BULGE_SCHED=dynamic instead hands groups
+    of consecutive tasks to idle threads as they become free; see
+    magma_bulge_get_grsiz for the group size.
 
+    On NUMA machines, V, TAU, and T are zeroed by the threads that update
+    them, so pages are allocated on the socket that uses them; see
+    magma_bulge_get_numa. This helps when V, TAU, and T are freshly
+    allocated. The memory policy of the caller's buffers is not changed.
 
     Arguments
     ---------
@@ -182,52 +205,68 @@ magma_ssytrd_sb2st(
     magma_set_lapack_numthreads(1);
 
     //const char* uplo_ = lapack_uplo_const( uplo );
+    magma_bulge_sched_t sched = magma_bulge_get_sched();
     magma_int_t INgrsiz=1;
+    if (sched == MagmaBulgeDynamic)
+        INgrsiz = magma_bulge_get_grsiz(n, nb, threads, sizeof(float));
     magma_int_t blkcnt = magma_bulge_get_blkcnt(n, nb, Vblksiz);
     magma_int_t nbtiles = magma_ceildiv(n, nb);
 
-    memset(T,   0, blkcnt*ldt*Vblksiz*sizeof(float));
-    memset(TAU, 0, blkcnt*Vblksiz*sizeof(float));
-    memset(V,   0, blkcnt*ldv*Vblksiz*sizeof(float));
+    // with NUMA placement, the threads zero V, TAU, T; with interleave, they
+    // also copy A into Aloc, which is interleaved. Only Aloc, which we
+    // allocate, gets a memory policy.
+    magma_bulge_numa_t numa = magma_bulge_get_numa();
+    float *Aloc = A;
+    if (numa == MagmaBulgeNumaInterleave) {
+        if (magma_smalloc_cpu(&Aloc, lda*n) == MAGMA_SUCCESS) {
+            magma_bulge_numa_interleave(Aloc, lda*n*sizeof(float));
+        }
+        else {
+            Aloc = A;
+            numa = MagmaBulgeNumaFirstTouch;
+        }
+    }
+    if (numa == MagmaBulgeNumaNone) {
+        memset(T,   0, blkcnt*ldt*Vblksiz*sizeof(float));
+        memset(TAU, 0, blkcnt*Vblksiz*sizeof(float));
+        memset(V,   0, blkcnt*ldv*Vblksiz*sizeof(float));
+    }
 
-    volatile magma_int_t* prog;
-    magma_malloc_cpu((void**) &prog, (2*nbtiles+threads+10)*sizeof(magma_int_t));
-    memset((void *) prog, 0, (2*nbtiles+threads+10)*sizeof(magma_int_t));
+    magma_progress_t prog;
+    magma_int_t info_prog = magma_progress_init(&prog, 2*nbtiles+threads+10);
+    // sweeps counter 0 = number of sweeps completed, used to start the T's early
+    magma_progress_t sweeps;
+    magma_int_t info_sweeps = magma_progress_init(&sweeps, 1);
 
-    magma_sbulge_id_data* arg;
+    magma_sbulge_id_data* arg = NULL;
     magma_malloc_cpu((void**) &arg, threads*sizeof(magma_sbulge_id_data));
 
-    pthread_t* thread_id;
-    magma_malloc_cpu((void**) &thread_id, threads*sizeof(pthread_t));
-    pthread_attr_t thread_attr;
+    if (info_prog != MAGMA_SUCCESS || info_sweeps != MAGMA_SUCCESS || arg == NULL) {
+        if (info_prog == MAGMA_SUCCESS)
+            magma_progress_destroy(&prog);
+        if (info_sweeps == MAGMA_SUCCESS)
+            magma_progress_destroy(&sweeps);
+        magma_free_cpu(arg);
+        if (Aloc != A)
+            magma_free_cpu(Aloc);
+        magma_set_lapack_numthreads(mklth);
+        return MAGMA_ERR_HOST_ALLOC;
+    }
 
     magma_sbulge_data data_bulge;
     magma_sbulge_data_init(&data_bulge, threads, n, nb, nbtiles, INgrsiz, Vblksiz, compT,
-                                 A, lda, V, ldv, TAU, T, ldt, prog);
-
-    // Set one thread per core
-    pthread_attr_init(&thread_attr);
-    pthread_attr_setscope(&thread_attr, PTHREAD_SCOPE_SYSTEM);
-    pthread_setconcurrency(threads);
+                                 Aloc, lda, V, ldv, TAU, T, ldt, &prog, &sweeps, sched, numa, A);
 
     //timing
     #ifdef ENABLE_TIMER
     timeblg = magma_wtime();
     #endif
 
-    // Launch threads
-    for (magma_int_t thread = 1; thread < threads; thread++) {
+    // Run on the pinned thread team, this thread as thread 0, and wait for completion
+    for (magma_int_t thread = 0; thread < threads; thread++) {
         magma_sbulge_id_data_init(&(arg[thread]), thread, &data_bulge);
-        pthread_create(&thread_id[thread], &thread_attr, magma_ssytrd_sb2st_parallel_section, &arg[thread]);
-    }
-    magma_sbulge_id_data_init(&(arg[0]), 0, &data_bulge);
-    magma_ssytrd_sb2st_parallel_section(&arg[0]);
-
-    // Wait for completion
-    for (magma_int_t thread = 1; thread < threads; thread++) {
-        void *exitcodep;
-        pthread_join(thread_id[thread], &exitcodep);
     }
+    magma_int_t info = magma_thread_team_run(threads, magma_ssytrd_sb2st_parallel_section, arg, sizeof(magma_sbulge_id_data));
 
     // timing
     #ifdef ENABLE_TIMER
@@ -235,9 +274,11 @@ magma_ssytrd_sb2st(
     printf("  time BULGE+T = %f\n", timeblg);
     #endif
 
-    magma_free_cpu(thread_id);
     magma_free_cpu(arg);
-    magma_free_cpu((void *) prog);
+    if (Aloc != A)
+        magma_free_cpu(Aloc);
+    magma_progress_destroy(&prog);
+    magma_progress_destroy(&sweeps);
     magma_sbulge_data_destroy(&data_bulge);
 
     magma_set_lapack_numthreads(mklth);
@@ -288,7 +329,7 @@ magma_ssytrd_sb2st(
         d[n-1] = A[(n-1)*lda+nb];
     }
 #endif
-    return MAGMA_SUCCESS;
+    return info;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -312,7 +353,13 @@ static void *magma_ssytrd_sb2st_parallel_section(void *arg)
     float *TAU    = data -> TAU;
     float *T      = data -> T;
     magma_int_t ldt            = data -> ldt;
-    volatile magma_int_t* prog = data -> prog;
+    magma_progress_t* prog     = data -> prog;
+    magma_progress_t* sweeps   = data -> sweeps;
+    magma_bulge_sched_t sched  = data -> sched;
+    magma_bulge_numa_t numa    = data -> numa;
+    float *Aorig  = data -> Aorig;
+    volatile long* next_group  = &(data -> next_group);
+    volatile long* next_T      = &(data -> next_T);
 
     pthread_barrier_t* barrier = &(data -> barrier);
 
@@ -326,30 +373,13 @@ static void *magma_ssytrd_sb2st_parallel_section(void *arg)
     // it need that all threads setting it to 1.
     magma_set_lapack_numthreads(1);
 
-#ifdef MAGMA_SETAFFINITY
-//#define PRINTAFFINITY
-#ifdef PRINTAFFINITY
-    affinity_set print_set;
-    print_set.print_affinity(my_core_id, "starting affinity");
-#endif
-    affinity_set original_set;
-    affinity_set new_set(my_core_id);
-    int check  = 0;
-    int check2 = 0;
-    // bind threads
-    check = original_set.get_affinity();
-    if (check == 0) {
-        check2 = new_set.set_affinity();
-        if (check2 != 0)
-            printf("Error in sched_setaffinity (single cpu)\n");
-    }
-    else {
-        printf("Error in sched_getaffinity\n");
+    if (numa != MagmaBulgeNumaNone) {
+        // first touch of V, TAU, T, and the band workspace if any, by the threads that update them
+        if (A != Aorig)
+            magma_bulge_numa_copy_band(my_core_id, allcores_num, n, nb, grsiz, sizeof(float), Aorig, A, lda);
+        magma_bulge_numa_zero_VT(my_core_id, allcores_num, n, nb, grsiz, Vblksiz, sizeof(float), V, ldv, TAU, T, ldt);
+        pthread_barrier_wait(barrier);
     }
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "set affinity");
-#endif
-#endif
 
     if (compT == 1) {
         /* compute the Q1 overlapped with the bulge chasing+T.
@@ -366,7 +396,7 @@ static void *magma_ssytrd_sb2st_parallel_section(void *arg)
             timeB = magma_wtime();
             #endif
             
-            magma_stile_bulge_parallel(0, 1, A, lda, V, ldv, TAU, n, nb, nbtiles, grsiz, Vblksiz, prog);
+            magma_stile_bulge_parallel(0, 1, A, lda, V, ldv, TAU, n, nb, nbtiles, grsiz, Vblksiz, prog, sweeps, sched, next_group);
 
             #ifdef ENABLE_TIMER
             timeB = magma_wtime()-timeB;
@@ -379,7 +409,7 @@ static void *magma_ssytrd_sb2st_parallel_section(void *arg)
             timeT = magma_wtime();
             #endif
 
-            magma_stile_bulge_computeT_parallel(0, 1, V, ldv, TAU, T, ldt, n, nb, Vblksiz);
+            magma_stile_bulge_computeT_parallel(0, 1, V, ldv, TAU, T, ldt, n, nb, Vblksiz, sweeps, next_T);
 
             #ifdef ENABLE_TIMER
             timeT = magma_wtime()-timeT;
@@ -389,40 +419,31 @@ static void *magma_ssytrd_sb2st_parallel_section(void *arg)
             magma_int_t id  = my_core_id;
             magma_int_t tot = allcores_num;
 
-
                 //=========================
-                //    bulge chasing
+                //    bulge chasing, then T's
                 //=========================
+                /* No barrier between the two: once a thread runs out of
+                 * bulge chasing tasks, it starts computing the T's of
+                 * blocks whose sweeps are already done, overlapping the
+                 * tail of the bulge chasing. */
                 #ifdef ENABLE_TIMER
                 if (id == 0)
                     timeB = magma_wtime();
                 #endif
 
-                magma_stile_bulge_parallel(id, tot, A, lda, V, ldv, TAU, n, nb, nbtiles, grsiz, Vblksiz, prog);
-                pthread_barrier_wait(barrier);
+                magma_stile_bulge_parallel(id, tot, A, lda, V, ldv, TAU, n, nb, nbtiles, grsiz, Vblksiz, prog, sweeps, sched, next_group);
 
                 #ifdef ENABLE_TIMER
-                if (id == 0) {
-                    timeB = magma_wtime()-timeB;
-                    printf("  Finish BULGE   timing= %f\n", timeB);
-                }
+                timeT = magma_wtime();
                 #endif
 
-                //=========================
-                // compute the T's to be used when applying Q2
-                //=========================
-                #ifdef ENABLE_TIMER
-                if (id == 0)
-                    timeT = magma_wtime();
-                #endif
-
-                magma_stile_bulge_computeT_parallel(id, tot, V, ldv, TAU, T, ldt, n, nb, Vblksiz);
+                magma_stile_bulge_computeT_parallel(id, tot, V, ldv, TAU, T, ldt, n, nb, Vblksiz, sweeps, next_T);
                 pthread_barrier_wait(barrier);
 
                 #ifdef ENABLE_TIMER
                 if (id == 0) {
-                    timeT = magma_wtime()-timeT;
-                    printf("  Finish T's     timing= %f\n", timeT);
+                    printf("  Finish BULGE+T timing= %f  (thread 0 started T's at %f)\n",
+                           magma_wtime()-timeB, timeT-timeB);
                 }
                 #endif
         } // allcore == 1
@@ -435,7 +456,7 @@ static void *magma_ssytrd_sb2st_parallel_section(void *arg)
             timeB = magma_wtime();
         #endif
 
-        magma_stile_bulge_parallel(my_core_id, allcores_num, A, lda, V, ldv, TAU, n, nb, nbtiles, grsiz, Vblksiz, prog);
+        magma_stile_bulge_parallel(my_core_id, allcores_num, A, lda, V, ldv, TAU, n, nb, nbtiles, grsiz, Vblksiz, prog, sweeps, sched, next_group);
         pthread_barrier_wait(barrier);
 
         #ifdef ENABLE_TIMER
@@ -446,17 +467,10 @@ static void *magma_ssytrd_sb2st_parallel_section(void *arg)
         #endif
     } // WANTZ > 0
 
-#ifdef MAGMA_SETAFFINITY
-    // unbind threads
-    if (check == 0) {
-        check2 = original_set.set_affinity();
-        if (check2 != 0)
-            printf("Error in sched_setaffinity (restore cpu list)\n");
+    if (A != Aorig) {
+        // copy the band back, after the barrier above
+        magma_bulge_numa_copy_band(my_core_id, allcores_num, n, nb, grsiz, sizeof(float), A, Aorig, lda);
     }
-#ifdef PRINTAFFINITY
-    print_set.print_affinity(my_core_id, "restored_affinity");
-#endif
-#endif
 
     return 0;
 }
@@ -465,16 +479,16 @@ static void *magma_ssytrd_sb2st_parallel_section(void *arg)
 
 static void magma_stile_bulge_parallel(magma_int_t my_core_id, magma_int_t cores_num, float *A, magma_int_t lda,
                                        float *V, magma_int_t ldv, float *TAU, magma_int_t n, magma_int_t nb, magma_int_t nbtiles,
-                                       magma_int_t grsiz, magma_int_t Vblksiz, volatile magma_int_t *prog)
+                                       magma_int_t grsiz, magma_int_t Vblksiz, magma_progress_t *prog,
+                                       magma_progress_t *sweeps, magma_bulge_sched_t sched, volatile long *next_group)
 {
     magma_int_t sweepid, myid, shift, stt, st, ed, stind, edind;
     magma_int_t blklastind, colpt;
     magma_int_t stepercol;
     magma_int_t i, j, m, k;
     magma_int_t thgrsiz, thgrnb, thgrid, thed;
-    magma_int_t coreid;
+    magma_int_t coreid, mine, groupid, mygroup;
     magma_int_t colblktile, maxrequiredcores, colpercore, mycoresnb;
-    magma_int_t fin;
     float *work;
 
     if (n <= 0)
@@ -519,10 +533,25 @@ static void magma_stile_bulge_parallel(magma_int_t my_core_id, magma_int_t cores
            printf("  WARNING only %3d threads are required to run this test optimizing cache reuse\n", maxrequiredcores);
            printf("==================================================================================\n");
         }
-        printf("  Static bulgechasing version v9_9col threads  %4d      N %5d      NB %5d    grs %4d thgrsiz %4d \n", cores_num, n, nb, grsiz, thgrsiz);
+        if (sched == MagmaBulgeDynamic)
+            printf("  Dynamic bulgechasing version         threads  %4d      N %5d      NB %5d    grs %4d thgrsiz %4d \n", cores_num, n, nb, grsiz, thgrsiz);
+        else
+            printf("  Static bulgechasing version v9_9col threads  %4d      N %5d      NB %5d    grs %4d thgrsiz %4d \n", cores_num, n, nb, grsiz, thgrsiz);
     }
     #endif
 
+    /* In the dynamic schedule, all threads walk the same task order as the
+     * static one. Each (sweep, step) iteration below is a group of up to
+     * grsiz consecutive tasks of one sweep, sharing most of their data.
+     * A thread runs the group it claimed from next_group, then claims the
+     * next one. Groups are claimed in order, so the oldest unfinished
+     * group always has its dependencies done and the waits can't deadlock.
+     * */
+    groupid = 0;
+    mygroup = -1;
+    if (sched == MagmaBulgeDynamic)
+        mygroup = magma_atomic_fetch_add(next_group, 1);
+
     for (thgrid = 1; thgrid <= thgrnb; thgrid++) {
         stt  = (thgrid-1)*thgrsiz+1;
         thed = min( (stt + thgrsiz -1), (n-1));
@@ -557,45 +586,55 @@ static void magma_stile_bulge_parallel(magma_int_t my_core_id, magma_int_t cores
                             }
                         }
 
-                        coreid = (stind/colpercore)%mycoresnb;
-
-                        if (my_core_id == coreid) {
-                            fin=0;
-                            while(fin == 0) {
-                                if (myid == 1) {
-                                    if ( prog[myid+shift-1] == (sweepid-1) ) {
-                                        magma_strdtype1cbHLsym_withQ_v2(n, nb, A, lda, V, ldv, TAU, stind, edind, sweepid, Vblksiz, work);
-
-                                        fin=1;
-                                        prog[myid]= sweepid;
-                                        if (blklastind >= (n-1)) {
-                                            for (j = 1; j <= shift; j++)
-                                                prog[myid+j]=sweepid;
-                                        }
-                                    } // END progress condition
-                                } else {
-                                    if ( (prog[myid-1] == sweepid) && (prog[myid+shift-1] == (sweepid-1)) ) {
-                                        if (myid%2 == 0)
-                                            magma_strdtype2cbHLsym_withQ_v2(n, nb, A, lda, V, ldv, TAU, stind, edind, sweepid, Vblksiz, work);
-                                        else
-                                            magma_strdtype3cbHLsym_withQ_v2(n, nb, A, lda, V, ldv, TAU, stind, edind, sweepid, Vblksiz, work);
-
-                                        fin=1;
-                                        prog[myid]= sweepid;
-                                        if (blklastind >= (n-1)) {
-                                            for (j = 1; j <= shift+mycoresnb; j++)
-                                                prog[myid+j]=sweepid;
-                                        }
-                                    } // END progress condition
-                                } // END if myid == 1
-                            } // END while loop
-                        } // END if my_core_id == coreid
+                        if (sched == MagmaBulgeDynamic) {
+                            mine = (groupid == mygroup);
+                        } else {
+                            coreid = (stind/colpercore)%mycoresnb;
+                            mine = (my_core_id == coreid);
+                        }
+
+                        if (mine) {
+                            /* Progress counters only increase, so waiting for
+                             * prog[myid-1] >= sweepid is the same as the
+                             * original test prog[myid-1] == sweepid. */
+                            if (myid == 1) {
+                                magma_progress_wait(prog, myid+shift-1, sweepid-1);
+                                magma_strdtype1cbHLsym_withQ_v2(n, nb, A, lda, V, ldv, TAU, stind, edind, sweepid, Vblksiz, work);
+
+                                magma_progress_set(prog, myid, sweepid);
+                                if (blklastind >= (n-1)) {
+                                    // last task of the sweep; set before releasing the
+                                    // next sweep, so sweeps are counted in order
+                                    magma_progress_set(sweeps, 0, sweepid);
+                                    for (j = 1; j <= shift; j++)
+                                        magma_progress_set(prog, myid+j, sweepid);
+                                }
+                            } else {
+                                magma_progress_wait(prog, myid-1,       sweepid);
+                                magma_progress_wait(prog, myid+shift-1, sweepid-1);
+                                if (myid%2 == 0)
+                                    magma_strdtype2cbHLsym_withQ_v2(n, nb, A, lda, V, ldv, TAU, stind, edind, sweepid, Vblksiz, work);
+                                else
+                                    magma_strdtype3cbHLsym_withQ_v2(n, nb, A, lda, V, ldv, TAU, stind, edind, sweepid, Vblksiz, work);
+
+                                magma_progress_set(prog, myid, sweepid);
+                                if (blklastind >= (n-1)) {
+                                    magma_progress_set(sweeps, 0, sweepid);
+                                    for (j = 1; j <= shift+mycoresnb; j++)
+                                        magma_progress_set(prog, myid+j, sweepid);
+                                }
+                            } // END if myid == 1
+                        } // END if mine
 
                         if (blklastind >= (n-1)) {
                             stt=stt+1;
                             break;
                         }
                     }   // END for k=1:grsiz
+
+                    if (groupid == mygroup)
+                        mygroup = magma_atomic_fetch_add(next_group, 1);
+                    groupid++;
                 } // END for sweepid=st:ed
             } // END for m=1:stepercol
         } // END for i=1:n-1
@@ -609,7 +648,8 @@ static void magma_stile_bulge_parallel(magma_int_t my_core_id, magma_int_t cores
 #define TAU(m)   &(TAU[(m)])
 #define T(m)   &(T[(m)])
 static void magma_stile_bulge_computeT_parallel(magma_int_t my_core_id, magma_int_t cores_num, float *V, magma_int_t ldv, float *TAU,
-                                                float *T, magma_int_t ldt, magma_int_t n, magma_int_t nb, magma_int_t Vblksiz)
+                                                float *T, magma_int_t ldt, magma_int_t n, magma_int_t nb, magma_int_t Vblksiz,
+                                                magma_progress_t *sweeps, volatile long *next_T)
 {
     //%===========================
     //%   local variables
@@ -617,16 +657,11 @@ static void magma_stile_bulge_computeT_parallel(magma_int_t my_core_id, magma_in
     magma_int_t Vm, Vn, mt, nt;
     magma_int_t myrow, mycol, blkj, blki, firstrow;
     magma_int_t blkid, vpos, taupos, tpos;
-    magma_int_t blkpercore, myid;
+    magma_int_t lastsweep, taskid, mytask;
 
     if (n <= 0)
         return;
 
-    magma_int_t blkcnt = magma_bulge_get_blkcnt(n, nb, Vblksiz);
-    blkpercore = blkcnt/cores_num;
-    blkpercore = (blkpercore == 0 ? 1 : blkpercore);
-    //magma_int_t nbGblk  = magma_ceildiv(n-1, Vblksiz);
-
     #ifdef ENABLE_DEBUG
     if (my_core_id == 0)
         printf("  COMPUTE T parallel threads %d with  N %d   NB %d   Vblksiz %d \n", cores_num, n, nb, Vblksiz);
@@ -640,11 +675,17 @@ static void magma_stile_bulge_computeT_parallel(magma_int_t my_core_id, magma_in
      * a T and compute it. The loop is based on
      * the version 113 of the applyQ
      * which go over the losange block_column
-     * by block column. but it is not important
-     * here the order because Ts are independent.
+     * by block column.
+     * The T's of block column blkj only need the V's of its
+     * Vblksiz sweeps, so block columns are taken in the order the
+     * sweeps finish, each T waiting until its sweeps are done.
+     * Threads pick the next T from next_T as they become free,
+     * so this can start while other threads are still chasing bulges.
      * ======================================== */
+    taskid = 0;
+    mytask = magma_atomic_fetch_add(next_T, 1);
     nt  = magma_ceildiv((n-1), Vblksiz);
-    for (blkj=nt-1; blkj >= 0; blkj--) {
+    for (blkj=0; blkj < nt; blkj++) {
         /* the index of the first row on the top of block (blkj) */
         firstrow = blkj * Vblksiz + 1;
         /*find the number of tile for this block */
@@ -652,8 +693,13 @@ static void magma_stile_bulge_computeT_parallel(magma_int_t my_core_id, magma_in
             mt = magma_ceildiv( n -  firstrow,    nb);
         else
             mt = magma_ceildiv( n - (firstrow+1), nb);
+        /* last sweep (1-based) that stores V's in this block */
+        lastsweep = min( (blkj+1)*Vblksiz, n-1 );
         /*loop over the tiles find the size of the Vs and apply it */
         for (blki=mt; blki > 0; blki--) {
+            if (taskid++ != mytask)
+                continue;
+
             /*calculate the size of each losange of Vs= (Vm,Vn)*/
             myrow     = firstrow + (mt-blki)*nb;
             mycol     = blkj*Vblksiz;
@@ -667,12 +713,11 @@ static void magma_stile_bulge_computeT_parallel(magma_int_t my_core_id, magma_in
              * Note that Vs and Ts have special storage done
              * by the bulgechasing function*/
             magma_bulge_findVTAUTpos(n, nb, Vblksiz, mycol, myrow, ldv, ldt, &vpos, &taupos, &tpos, &blkid);
-            myid = blkid/blkpercore;
-            if ( my_core_id == (myid%cores_num) ) {
-                if ( ( Vm > 0 ) && ( Vn > 0 ) ) {
-                    lapackf77_slarft( "F", "C", &Vm, &Vn, V(vpos), &ldv, TAU(taupos), T(tpos), &ldt);
-                }
+            if ( ( Vm > 0 ) && ( Vn > 0 ) ) {
+                magma_progress_wait(sweeps, 0, lastsweep);
+                lapackf77_slarft( "F", "C", &Vm, &Vn, V(vpos), &ldv, TAU(taupos), T(tpos), &ldt);
             }
+            mytask = magma_atomic_fetch_add(next_T, 1);
         }
     }
 }
@@ -110,6 +110,113 @@ private:
 };
 
 
+// ---------------------------------------------
+// stores arguments and executes call to slaset (on CPU)
+class slaset_task: public magma_task
+{
+public:
+    slaset_task(
+        magma_int_t in_m, magma_int_t in_n,
+        float  in_offdiag, float in_diag,
+        float* in_A, magma_int_t in_lda
+    ):
+        m      ( in_m       ),
+        n      ( in_n       ),
+        offdiag( in_offdiag ),
+        diag   ( in_diag    ),
+        A      ( in_A       ),
+        lda    ( in_lda     )
+    {}
+
+    virtual void run()
+    {
+        lapackf77_slaset( "F", &m, &n, &offdiag, &diag, A, &lda );
+    }
+
+private:
+    magma_int_t m;
+    magma_int_t n;
+    float      offdiag;
+    float      diag;
+    float*     A;
+    magma_int_t lda;
+};
+
+
+// ---------------------------------------------
+// normalizes block of back-transformed eigenvectors Q*x, stored in columns
+// 1:nv of W, then copies them to V (on CPU).
+// iscomplex is copied, since the caller reuses it for the next block.
+class strevc3_normalize_task: public magma_task
+{
+public:
+    strevc3_normalize_task(
+        magma_int_t in_n, magma_int_t in_nv,
+        const magma_int_t* in_iscomplex,
+        float* in_W, magma_int_t in_ldw,
+        float* in_V, magma_int_t in_ldv
+    ):
+        n  ( in_n   ),
+        nv ( in_nv  ),
+        W  ( in_W   ),
+        ldw( in_ldw ),
+        V  ( in_V   ),
+        ldv( in_ldv )
+    {
+        iscomplex = new magma_int_t[ nv+1 ];
+        for( magma_int_t k=1; k <= nv; ++k ) {
+            iscomplex[k] = in_iscomplex[k];
+        }
+    }
+
+    virtual ~strevc3_normalize_task()
+    {
+        delete[] iscomplex;
+    }
+
+    virtual void run()
+    {
+        const magma_int_t ione = 1;
+        const float c_zero = 0;
+        const float c_one  = 1;
+        magma_int_t ii;
+        float emax, remax=0;
+
+        // W is 1-based, to match iscomplex
+        for( magma_int_t k=1; k <= nv; ++k ) {
+            if ( iscomplex[k] == 0 ) {
+                // real eigenvector
+                ii = blasf77_isamax( &n, W + k*ldw, &ione ) - 1;  // subtract 1; ii is 0-based
+                remax = c_one / fabsf( W[ ii + k*ldw ] );
+            }
+            else if ( iscomplex[k] == 1 ) {
+                // first eigenvector of conjugate pair
+                emax = c_zero;
+                for( ii=0; ii < n; ++ii ) {
+                    emax = max( emax, fabsf( W[ ii + k*ldw     ] )
+                                    + fabsf( W[ ii + (k+1)*ldw ] ) );
+                }
+                remax = c_one / emax;
+            // else if iscomplex[k] == -1
+            //     second eigenvector of conjugate pair
+            //     reuse same remax as previous k
+            }
+            blasf77_sscal( &n, &remax, W + k*ldw, &ione );
+        }
+        lapackf77_slacpy( "F", &n, &nv, W + ldw, &ldw, V, &ldv );
+    }
+
+private:
+    magma_int_t  n;
+    magma_int_t  nv;
+    magma_int_t* iscomplex;
+    float*      W;
+    magma_int_t  ldw;
+    float*      V;
+    magma_int_t  ldv;
+};
+
+
 /**
     Purpose
     -------
@@ -275,7 +382,7 @@ magma_int_t magma_strevc3_mt(
 #define VL(i,j) (VL + (i) + (j)*ldvl)
 #define VR(i,j) (VR + (i) + (j)*ldvr)
 #define X(i,j)  (X  + (i)-1 + ((j)-1)*2)  // still as 1-based indices
-#define work(i,j) (work + (i) + (j)*n)
+#define work(i,j) (W + (i) + (j)*n)
 
     // constants
     const magma_int_t ione = 1;
@@ -288,6 +395,8 @@ magma_int_t magma_strevc3_mt(
     magma_int_t i, ii, ip, is, j, k, ki, ki2,
                 iv, n2, nb, nb2, version;
     float emax, remax;
+    float *W, *work2;
+    const void *last_block;  // columns of VR or VL written by the last normalize task
     
     // .. Local Arrays ..
     // since iv is a 1-based index, allocate one extra here
@@ -372,12 +481,22 @@ magma_int_t magma_strevc3_mt(
     // Requires 1 vector for 1-norms, and 2*nb vectors for x and Q*x.
     // Zero-out the workspace to avoid potential NaN propagation.
     nb = 2;
+    W = work;
+    work2 = NULL;
     if ( lwork >= n + 2*n*nbmin ) {
         version = 2;
         nb = (lwork - n) / (2*n);
         nb = min( nb, nbmax );
         nb2 = 1 + 2*nb;
         lapackf77_slaset( "F", &n, &nb2, &c_zero, &c_zero, work, &n );
+        
+        // To overlap solves for the next block with GEMM for the current
+        // block, alternate between work and a second internal workspace.
+        // If it can't be allocated, tasks are serialized by their data
+        // dependencies on the single workspace instead.
+        if ( over && magma_smalloc_cpu( &work2, n*nb2 ) == MAGMA_SUCCESS ) {
+            lapackf77_slaset( "F", &n, &nb2, &c_zero, &c_zero, work2, &n );
+        }
     }
     else {
         version = 1;
@@ -392,6 +511,9 @@ magma_int_t magma_strevc3_mt(
             *work(j,0) += fabsf( *T(i,j) );
         }
     }
+    if ( work2 != NULL ) {
+        blasf77_scopy( &n, work, &ione, work2, &ione );
+    }
         
     // launch threads -- each single-threaded MKL
     magma_int_t nthread = magma_get_parallel_numthreads();
@@ -432,6 +554,7 @@ magma_int_t magma_strevc3_mt(
         timer_start( time_trsv );
         ip = 0;
         is = *mout - 1;
+        last_block = NULL;
         for( ki=n-1; ki >= 0; --ki ) {
             if ( ip == -1 ) {
                 // previous iteration (ki+1) was second of conjugate pair,
@@ -470,8 +593,10 @@ magma_int_t magma_strevc3_mt(
                 // Real right eigenvector
                 // Solve upper quasi-triangular system:
                 // [ T(0:ki-1,0:ki-1) - wr ]*X = -T(0:ki-1,ki)
-                queue.push_task( new magma_slaqtrsd_task(
-                    MagmaNoTrans, ki+1, T(0,0), ldt, work(0,iv), n, work(0,0) ));
+                magma_task* trsv = new magma_slaqtrsd_task(
+                    MagmaNoTrans, ki+1, T(0,0), ldt, work(0,iv), n, work(0,0) );
+                trsv->writes( work(0,iv) );
+                queue.push_task( trsv );
                 
                 // Copy the vector x or Q*x to VR and normalize.
                 if ( ! over ) {
@@ -512,8 +637,11 @@ magma_int_t magma_strevc3_mt(
                     // ------------------------------
                     // version 2: back-transform block of vectors with GEMM
                     // zero out below vector
-                    for( k=ki + 1; k < n; ++k ) {
-                        *work(k,iv) = c_zero;
+                    if ( ki < n-1 ) {
+                        magma_task* zero = new slaset_task(
+                            n-ki-1, 1, c_zero, c_zero, work(ki+1,iv), n );
+                        zero->writes( work(0,iv) );
+                        queue.push_task( zero );
                     }
                     iscomplex[ iv ] = ip;
                     // back-transform and normalization is done below
@@ -524,8 +652,11 @@ magma_int_t magma_strevc3_mt(
                 // Complex right eigenvector
                 // Solve upper quasi-triangular system:
                 // [ T(0:ki-2,0:ki-2) - (wr+i*wi) ]*x = u
-                queue.push_task( new magma_slaqtrsd_task(
-                    MagmaNoTrans, ki+1, T(0,0), ldt, work(0,iv-1), n, work(0,0) ));
+                magma_task* trsv = new magma_slaqtrsd_task(
+                    MagmaNoTrans, ki+1, T(0,0), ldt, work(0,iv-1), n, work(0,0) );
+                trsv->writes( work(0,iv-1) );
+                trsv->writes( work(0,iv  ) );
+                queue.push_task( trsv );
 
                 // Copy the vector x or Q*x to VR and normalize.
                 if ( ! over ) {
@@ -585,9 +716,12 @@ magma_int_t magma_strevc3_mt(
                     // ------------------------------
                     // version 2: back-transform block of vectors with GEMM
                     // zero out below vector
-                    for( k=ki + 1; k < n; ++k ) {
-                        *work(k,iv-1) = c_zero;
-                        *work(k,iv  ) = c_zero;
+                    if ( ki < n-1 ) {
+                        magma_task* zero = new slaset_task(
+                            n-ki-1, 2, c_zero, c_zero, work(ki+1,iv-1), n );
+                        zero->writes( work(0,iv-1) );
+                        zero->writes( work(0,iv  ) );
+                        queue.push_task( zero );
                     }
                     iscomplex[ iv-1 ] = -ip;
                     iscomplex[ iv   ] =  ip;
@@ -611,50 +745,60 @@ magma_int_t magma_strevc3_mt(
                 // When the number of vectors stored reaches nb-1 or nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv <= 2) || (ki2 == 0) ) {
+                    #ifdef ENABLE_TIMER
+                    // so the timers measure the tasks, not just pushing them;
+                    // this gives up the overlap of solves and GEMMs
                     queue.sync();
+                    #endif
                     time_trsv_sum += timer_stop( time_trsv );
                     timer_start( time_gemm );
                     nb2 = nb-iv+1;
                     n2  = ki2+nb-iv+1;
                     
+                    // No sync here: each GEMM task waits only for the solves
+                    // in this block, and the normalize task for all GEMMs.
+                    // Meanwhile, solves for the next block proceed in the
+                    // other workspace.
                     // split gemm into multiple tasks, each doing one block row
+                    magma_task* normalize = new strevc3_normalize_task(
+                        n, nb2, &iscomplex[iv-1], work(0,nb+iv-1), n, VR(0,ki2), ldvr );
                     for( i=0; i < n; i += NB ) {
                         magma_int_t ib = min( NB, n-i );
-                        queue.push_task( new sgemm_task(
+                        magma_task* gemm = new sgemm_task(
                             MagmaNoTrans, MagmaNoTrans, ib, nb2, n2, c_one,
                             VR(i,0), ldvr,
                             work(0,iv), n, c_zero,
-                            work(i,nb+iv), n ));
+                            work(i,nb+iv), n );
+                        for( k=iv; k <= nb; ++k ) {
+                            gemm->reads( work(0,k) );
+                        }
+                        gemm->writes( work(i,nb+1) );
+                        normalize->reads( work(i,nb+1) );
+                        queue.push_task( gemm );
                     }
-                    queue.sync();
-                    time_gemm_sum += timer_stop( time_gemm );
-
+                    
                     // normalize vectors
                     // TODO if somev, should copy vectors individually to correct location.
-                    for( k=iv; k <= nb; ++k ) {
-                        if ( iscomplex[k] == 0 ) {
-                            // real eigenvector
-                            ii = blasf77_isamax( &n, work(0,nb+k), &ione ) - 1;  // subtract 1; ii is 0-based
-                            remax = c_one / fabsf( *work(ii,nb+k) );
-                        }
-                        else if ( iscomplex[k] == 1 ) {
-                            // first eigenvector of conjugate pair
-                            emax = c_zero;
-                            for( ii=0; ii < n; ++ii ) {
-                                emax = max( emax, fabsf( *work(ii,nb+k  ) )
-                                                + fabsf( *work(ii,nb+k+1) ) );
-                            }
-                            remax = c_one / emax;
-                        // else if iscomplex[k] == -1
-                        //     second eigenvector of conjugate pair
-                        //     reuse same remax as previous k
-                        }
-                        blasf77_sscal( &n, &remax, work(0,nb+k), &ione );
+                    // The GEMMs of earlier blocks read these columns of VR, so
+                    // copying to them must wait for those GEMMs; the GEMMs of
+                    // later blocks read only columns left of ki2 and need not
+                    // wait. This task waits for its own GEMMs, through work,
+                    // and for the previous normalize task, which by induction
+                    // waited for all earlier GEMMs.
+                    normalize->writes( VR(0,ki2) );
+                    if ( last_block != NULL ) {
+                        normalize->reads( last_block );
+                    }
+                    last_block = VR(0,ki2);
+                    queue.push_task( normalize );
+                    #ifdef ENABLE_TIMER
+                    queue.sync();
+                    #endif
+                    time_gemm_sum += timer_stop( time_gemm );
+                    
+                    if ( work2 != NULL ) {
+                        W = (W == work ? work2 : work);
                     }
-                    nb2 = nb-iv+1;
-                    lapackf77_slacpy( "F", &n, &nb2,
-                                      work(0,nb+iv), &n,
-                                      VR(0,ki2), &ldvr );
                     iv = nb;
                     timer_start( time_trsv );
                 }
@@ -668,6 +812,7 @@ magma_int_t magma_strevc3_mt(
                 is -= 1;
             }
         }
+        queue.sync();
     }
     timer_stop( time_trsv );
     
@@ -686,6 +831,7 @@ magma_int_t magma_strevc3_mt(
         iv = 1;
         ip = 0;
         is = 0;
+        last_block = NULL;
         for( ki=0; ki < n; ++ki ) {
             if ( ip == 1 ) {
                 // previous iteration (ki-1) was first of conjugate pair,
@@ -717,8 +863,10 @@ magma_int_t magma_strevc3_mt(
                 // Real left eigenvector
                 // Solve transposed quasi-triangular system:
                 // [ T(ki+1:n,ki+1:n) - wr ]**T * X = -T(ki+1:n,ki)
-                queue.push_task( new magma_slaqtrsd_task(
-                    MagmaTrans, n-ki, T(ki,ki), ldt, work(ki,iv), n, work(ki,0) ));
+                magma_task* trsv = new magma_slaqtrsd_task(
+                    MagmaTrans, n-ki, T(ki,ki), ldt, work(ki,iv), n, work(ki,0) );
+                trsv->writes( work(0,iv) );
+                queue.push_task( trsv );
     
                 // Copy the vector x or Q*x to VL and normalize.
                 if ( ! over ) {
@@ -756,8 +904,11 @@ magma_int_t magma_strevc3_mt(
                     // version 2: back-transform block of vectors with GEMM
                     // zero out above vector
                     // could go from (ki+1)-NV+1 to ki
-                    for( k=0; k < ki; ++k ) {
-                        *work(k,iv) = c_zero;
+                    if ( ki > 0 ) {
+                        magma_task* zero = new slaset_task(
+                            ki, 1, c_zero, c_zero, work(0,iv), n );
+                        zero->writes( work(0,iv) );
+                        queue.push_task( zero );
                     }
                     iscomplex[ iv ] = ip;
                     // back-transform and normalization is done below
@@ -768,8 +919,11 @@ magma_int_t magma_strevc3_mt(
                 // Complex left eigenvector
                 // Solve transposed quasi-triangular system:
                 // [ T(ki+2:n,ki+2:n)**T - (wr-i*wi) ]*X = V
-                queue.push_task( new magma_slaqtrsd_task(
-                    MagmaTrans, n-ki, T(ki,ki), ldt, work(ki,iv), n, work(ki,0) ));
+                magma_task* trsv = new magma_slaqtrsd_task(
+                    MagmaTrans, n-ki, T(ki,ki), ldt, work(ki,iv), n, work(ki,0) );
+                trsv->writes( work(0,iv  ) );
+                trsv->writes( work(0,iv+1) );
+                queue.push_task( trsv );
     
                 // Copy the vector x or Q*x to VL and normalize.
                 if ( ! over ) {
@@ -826,9 +980,12 @@ magma_int_t magma_strevc3_mt(
                     // version 2: back-transform block of vectors with GEMM
                     // zero out above vector
                     // could go from (ki+1)-NV+1 to ki
-                    for( k=0; k < ki; ++k ) {
-                        *work(k,iv  ) = c_zero;
-                        *work(k,iv+1) = c_zero;
+                    if ( ki > 0 ) {
+                        magma_task* zero = new slaset_task(
+                            ki, 2, c_zero, c_zero, work(0,iv), n );
+                        zero->writes( work(0,iv  ) );
+                        zero->writes( work(0,iv+1) );
+                        queue.push_task( zero );
                     }
                     iscomplex[ iv   ] =  ip;
                     iscomplex[ iv+1 ] = -ip;
@@ -852,43 +1009,43 @@ magma_int_t magma_strevc3_mt(
                 // When the number of vectors stored reaches nb-1 or nb,
                 // or if this was last vector, do the GEMM
                 if ( (iv >= nb-1) || (ki2 == n-1) ) {
-                    queue.sync();
                     n2 = n-(ki2+1)+iv;
                     
+                    // As for right eigenvectors, no sync here; solves for the
+                    // next block overlap with this GEMM.
                     // split gemm into multiple tasks, each doing one block row
+                    magma_task* normalize = new strevc3_normalize_task(
+                        n, iv, iscomplex, work(0,nb), n, VL(0,ki2-iv+1), ldvl );
                     for( i=0; i < n; i += NB ) {
                         magma_int_t ib = min( NB, n-i );
-                        queue.push_task( new sgemm_task(
+                        magma_task* gemm = new sgemm_task(
                             MagmaNoTrans, MagmaNoTrans, ib, iv, n2, c_one,
                             VL(i,ki2-iv+1), ldvl,
                             work(ki2-iv+1,1), n, c_zero,
-                            work(i,nb+1), n ));
+                            work(i,nb+1), n );
+                        for( k=1; k <= iv; ++k ) {
+                            gemm->reads( work(0,k) );
+                        }
+                        gemm->writes( work(i,nb+1) );
+                        normalize->reads( work(i,nb+1) );
+                        queue.push_task( gemm );
                     }
-                    queue.sync();
+                    
                     // normalize vectors
-                    for( k=1; k <= iv; ++k ) {
-                        if ( iscomplex[k] == 0 ) {
-                            // real eigenvector
-                            ii = blasf77_isamax( &n, work(0,nb+k), &ione ) - 1;  // subtract 1; ii is 0-based
-                            remax = c_one / fabsf( *work(ii,nb+k) );
-                        }
-                        else if ( iscomplex[k] == 1) {
-                            // first eigenvector of conjugate pair
-                            emax = c_zero;
-                            for( ii=0; ii < n; ++ii ) {
-                                emax = max( emax, fabsf( *work(ii,nb+k  ) )
-                                                + fabsf( *work(ii,nb+k+1) ) );
-                            }
-                            remax = c_one / emax;
-                        // else if iscomplex[k] == -1
-                        //     second eigenvector of conjugate pair
-                        //     reuse same remax as previous k
-                        }
-                        blasf77_sscal( &n, &remax, work(0,nb+k), &ione );
+                    // As for VR, copying to these columns of VL waits for the
+                    // GEMMs of earlier blocks through the previous normalize
+                    // task; the GEMMs of later blocks read only columns right
+                    // of ki2 and need not wait.
+                    normalize->writes( VL(0,ki2-iv+1) );
+                    if ( last_block != NULL ) {
+                        normalize->reads( last_block );
+                    }
+                    last_block = VL(0,ki2-iv+1);
+                    queue.push_task( normalize );
+                    
+                    if ( work2 != NULL ) {
+                        W = (W == work ? work2 : work);
                     }
-                    lapackf77_slacpy( "F", &n, &iv,
-                                      work(0,nb+1), &n,
-                                      VL(0,ki2-iv+1), &ldvl );
                     iv = 1;
                 }
                 else {
@@ -907,5 +1064,7 @@ magma_int_t magma_strevc3_mt(
     queue.quit();
     magma_set_lapack_numthreads( lapack_nthread );
     
+    magma_free_cpu( work2 );
+    
     return *info;
 }  // end of STREVC3
@@ -429,6 +429,8 @@ aux = (
 	('testing_constants',              '-c',  '',   ''),
 	('testing_operators',              '-c',  '',   ''),
 	('testing_parse_opts',             '-c',  '',   ''),
+	('testing_thread_queue',           '-l',  n,    ''),
+	('testing_thread_team',            '-l',  n,    ''),
 )
 if ( opts.aux ):
 	tests += aux
@@ -563,6 +565,7 @@ syev = (
 # symmetric eigenvalues, 2-stage
 	#('testing_zhetrd_he2hb',       '-L -c',  n,    'NOT hetrd_he2hb -- calls heevdx_2stage'),
 	#('testing_zhetrd_he2hb',       '-U -c',  n,    'NOT hetrd_he2hb -- calls heevdx_2stage. upper not implemented'),
+	('testing_zhetrd_hb2st',       '-c',  n,    ''),
 	
 	#('testing_zheevdx_2stage', '-L -JN -c',  n,    '-c implies -JV'),
 	#('testing_zheevdx_2stage', '-U -JN -c',  n,    '-c implies -JV'),
@@ -714,6 +717,7 @@ subs = (
 	('ssy',           'dsy',         'che',           'zhe'       ),
 	('sor',           'dor',         'cun',           'zun'       ),
 	('sy2sb',         'sy2sb',       'he2hb',         'he2hb'     ),
+	('sb2st',         'sb2st',       'hb2st',         'hb2st'     ),
 	('',              'testing_ds',  '',              'testing_zc'),
 	('testing_s',     'testing_d',   'testing_c',     'testing_z' ),
 	('lansy',         'lansy',       'lanhe',         'lanhe'     ),
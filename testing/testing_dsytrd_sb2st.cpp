@@ -0,0 +1,279 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+
+       @generated from testing_zhetrd_hb2st.cpp normal z -> d, Tue Sep  2 12:38:25 2014
+
+*/
+
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#if defined(__linux__)
+#include <malloc.h>
+#endif
+
+// includes, project
+#include "magma.h"
+#include "magma_lapack.h"
+#include "magma_bulge.h"
+#include "magma_dbulge.h"
+#include "magma_threadsetting.h"
+#include "testings.h"
+
+#ifdef MAGMA_SETAFFINITY
+#include "affinity.h"
+#endif
+
+#define PRECISION_d
+
+
+// ---------------------------------------------
+// Returns user + system CPU time of this process (all threads), in seconds.
+static real_Double_t cpu_time()
+{
+    struct rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec*1e-6
+         + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec*1e-6;
+}
+
+
+// ---------------------------------------------
+// Starts nload child processes that each spin on one core,
+// to oversubscribe the machine. Their CPU time isn't counted by cpu_time().
+static void start_load( magma_int_t nload, pid_t* pids )
+{
+    for( magma_int_t i=0; i < nload; ++i ) {
+        pids[i] = fork();
+        if ( pids[i] == 0 ) {
+            volatile long x = 0;
+            while( true ) {
+                x += 1;
+            }
+        }
+    }
+}
+
+static void stop_load( magma_int_t nload, pid_t* pids )
+{
+    for( magma_int_t i=0; i < nload; ++i ) {
+        if ( pids[i] > 0 ) {
+            kill( pids[i], SIGKILL );
+            waitpid( pids[i], NULL, 0 );
+        }
+    }
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing dsytrd_sb2st
+   Times the bulge chasing (band to tridiagonal) on its own, reporting wall
+   time and CPU time, first on an idle machine, then oversubscribed with one
+   extra spinning process per thread. CPU time much larger than
+   wall time * threads indicates threads burning cores while waiting.
+   Each case is run with the static (v9_9col) and dynamic schedulers,
+   selected via $MAGMA_BULGE_SCHED, and with V, TAU, T zeroed by the calling
+   thread (none), first touched by their owner threads (firsttouch), or
+   interleaved over NUMA nodes, selected via $MAGMA_BULGE_NUMA.
+   V, TAU, T are allocated for each run, so their pages are placed anew.
+   -N n sets the matrix size, --nb the bandwidth, --nthread the number of threads,
+   -JV also computes the T matrices used to apply Q2.
+   -c checks eigenvalues of the tridiagonal against LAPACK dsyevd on the band matrix.
+*/
+int main( int argc, char** argv)
+{
+    TESTING_INIT();
+
+    real_Double_t wall;
+    real_Double_t cpu;
+    double *h_A, *h_B, *h_R, *V, *TAU, *T, *h_work;
+    double *D, *E, *D2, *rwork;
+    magma_int_t *iwork;
+    magma_int_t N, nb, lda, ldb, ldv, ldt, Vblksiz, blkcnt, threads, nload, compT, isched, inuma;
+    magma_int_t i, j, info, lwork, lrwork, liwork;
+    magma_int_t ione     = 1;
+    magma_int_t ISEED[4] = {0,0,0,1};
+    double error, tol;
+    magma_int_t status = 0;
+
+    magma_opts opts;
+    parse_opts( argc, argv, &opts );
+    tol = opts.tolerance * lapackf77_dlamch("E");
+
+    // hb2st uses magma_get_parallel_numthreads
+    if ( opts.nthread > 1 ) {
+        char buf[32];
+        snprintf( buf, sizeof(buf), "%d", (int) opts.nthread );
+        setenv( "MAGMA_NUM_THREADS", buf, 1 );
+    }
+    threads = magma_get_parallel_numthreads();
+    compT = (opts.jobz == MagmaVec);
+    pid_t* pids = (pid_t*) malloc( threads * sizeof(pid_t) );
+    const char* scheds[] = { "static", "dynamic" };
+    const char* numas[]  = { "none", "firsttouch", "interleave" };
+
+    #if defined(__linux__) && defined(M_MMAP_THRESHOLD)
+    // allocate large arrays with mmap, so each run gets untouched pages
+    mallopt( M_MMAP_THRESHOLD, 1024*1024 );
+    #endif
+
+    #ifdef MAGMA_SETAFFINITY
+    affinity_set topo;
+    if ( topo.get_affinity() == 0 ) {
+        topo.print_topology( "% topology" );
+    }
+    #endif
+
+    printf("    N    nb  threads  load  sched    numa          wall (sec)   CPU (sec)   CPU/wall   |D - D_lapack| / |D|\n");
+    printf("=================================================================================================================\n");
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        for( int iter = 0; iter < opts.niter; ++iter ) {
+            N   = opts.nsize[itest];
+            nb  = (opts.nb > 0 ? opts.nb : 64);
+            nb  = max( 2, min( nb, N-1 ));
+            lda = 2*nb;
+            ldb = N;
+            Vblksiz = magma_dbulge_get_Vblksiz( N, nb, threads );
+            ldt = Vblksiz;
+            ldv = nb + Vblksiz;
+            blkcnt = magma_bulge_get_blkcnt( N, nb, Vblksiz );
+
+            TESTING_MALLOC_CPU( h_A, double, lda*N );
+            TESTING_MALLOC_CPU( h_R, double, lda*N );
+            TESTING_MALLOC_CPU( D,   double, N );
+            TESTING_MALLOC_CPU( E,   double, N );
+
+            /* Initialize the band matrix, lower storage: A(i,j) in h_A[ (i-j) + j*lda ] */
+            magma_int_t n2 = lda*N;
+            lapackf77_dlarnv( &ione, ISEED, &n2, h_A );
+            for( j=0; j < N; ++j ) {
+                h_A[ j*lda ] = MAGMA_D_MAKE( MAGMA_D_REAL( h_A[ j*lda ] ), 0. );
+                for( i=nb+1; i < lda; ++i ) {
+                    h_A[ i + j*lda ] = MAGMA_D_ZERO;
+                }
+                for( i=N-j; i <= nb; ++i ) {
+                    h_A[ i + j*lda ] = MAGMA_D_ZERO;
+                }
+            }
+
+            /* ====================================================================
+               Performs operation using MAGMA, without and with extra load,
+               with static and dynamic scheduling, with each NUMA placement
+               =================================================================== */
+            for( nload = 0; nload <= threads; nload += threads ) {
+            for( isched = 0; isched < 2; ++isched ) {
+            for( inuma = 0; inuma < 3; ++inuma ) {
+                setenv( "MAGMA_BULGE_SCHED", scheds[isched], 1 );
+                setenv( "MAGMA_BULGE_NUMA",  numas[inuma],   1 );
+                TESTING_MALLOC_CPU( V,   double, blkcnt*ldv*Vblksiz );
+                TESTING_MALLOC_CPU( TAU, double, blkcnt*Vblksiz );
+                TESTING_MALLOC_CPU( T,   double, blkcnt*ldt*Vblksiz );
+                lapackf77_dlacpy( MagmaUpperLowerStr, &lda, &N, h_A, &lda, h_R, &lda );
+                start_load( nload, pids );
+
+                cpu  = cpu_time();
+                wall = magma_wtime();
+                magma_dsytrd_sb2st( MagmaLower, N, nb, Vblksiz, h_R, lda, D, E,
+                                    V, ldv, TAU, compT, T, ldt );
+                wall = magma_wtime() - wall;
+                cpu  = cpu_time() - cpu;
+
+                stop_load( nload, pids );
+
+                /* =====================================================================
+                   Check the result: eigenvalues of tridiagonal (D,E) vs. full matrix
+                   =================================================================== */
+                error = 0;
+                if ( opts.check ) {
+                    TESTING_MALLOC_CPU( h_B, double, ldb*N );
+                    TESTING_MALLOC_CPU( D2,  double, N );
+                    lwork  = 2*N + N*N;
+                    lrwork = 1 + 5*N + 2*N*N;
+                    liwork = 3 + 5*N;
+                    TESTING_MALLOC_CPU( h_work, double, lwork  );
+                    TESTING_MALLOC_CPU( rwork,  double,             lrwork );
+                    TESTING_MALLOC_CPU( iwork,  magma_int_t,        liwork );
+
+                    memset( h_B, 0, ldb*N*sizeof(double) );
+                    for( j=0; j < N; ++j ) {
+                        for( i=0; i <= min( nb, N-1-j ); ++i ) {
+                            h_B[ (j+i) + j*ldb ] = h_A[ i + j*lda ];
+                        }
+                    }
+                    lapackf77_dsyevd( "N", "L", &N, h_B, &ldb, D2,
+                                      h_work, &lwork,
+                                      #if defined(PRECISION_z) || defined(PRECISION_c)
+                                      rwork, &lrwork,
+                                      #endif
+                                      iwork, &liwork, &info );
+                    if (info != 0)
+                        printf("lapackf77_dsyevd returned error %d: %s.\n",
+                               (int) info, magma_strerror( info ));
+
+                    // eigenvalues of tridiagonal, in ascending order
+                    lapackf77_dsterf( &N, D, E, &info );
+                    if (info != 0)
+                        printf("lapackf77_dsterf returned error %d: %s.\n",
+                               (int) info, magma_strerror( info ));
+
+                    double maxD = 0;
+                    for( j=0; j < N; ++j ) {
+                        error = max( error, fabs( D[j] - D2[j] ));
+                        maxD  = max( maxD,  fabs( D2[j] ));
+                    }
+                    error /= maxD;
+
+                    TESTING_FREE_CPU( h_B    );
+                    TESTING_FREE_CPU( D2     );
+                    TESTING_FREE_CPU( h_work );
+                    TESTING_FREE_CPU( rwork  );
+                    TESTING_FREE_CPU( iwork  );
+                }
+
+                /* =====================================================================
+                   Print performance and error.
+                   =================================================================== */
+                printf("%5d %5d  %7d  %4d  %-7s  %-10s   %11.4f  %10.4f   %8.2f",
+                       (int) N, (int) nb, (int) threads, (int) nload, scheds[isched], numas[inuma],
+                       wall, cpu, cpu / wall );
+                if ( opts.check ) {
+                    printf("   %8.2e   %s\n", error, (error < tol ? "ok" : "failed"));
+                    status += ! (error < tol);
+                }
+                else {
+                    printf("     ---\n");
+                }
+                TESTING_FREE_CPU( V   );
+                TESTING_FREE_CPU( TAU );
+                TESTING_FREE_CPU( T   );
+            }
+            }
+            }
+
+            TESTING_FREE_CPU( h_A );
+            TESTING_FREE_CPU( h_R );
+            TESTING_FREE_CPU( D   );
+            TESTING_FREE_CPU( E   );
+            fflush( stdout );
+        }
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    free( pids );
+    TESTING_FINALIZE();
+    return status;
+}
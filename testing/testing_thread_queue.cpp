@@ -0,0 +1,263 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <queue>
+#include <exception>
+
+// includes, project
+#include "thread_queue.hpp"
+#include "magma.h"
+#include "testings.h"
+#include "magma_threadsetting.h"
+
+
+// ---------------------------------------------
+// Small task that does ~2*n flops on private data, so throughput is
+// dominated by the cost of pushing, popping, and completing tasks.
+class spin_task: public magma_task
+{
+public:
+    spin_task( magma_int_t in_n, double* in_result ):
+        n     ( in_n      ),
+        result( in_result )
+    {}
+
+    virtual void run()
+    {
+        double sum = 0;
+        for( magma_int_t i=0; i < n; ++i ) {
+            sum = sum*0.5 + i;
+        }
+        *result = sum;
+    }
+
+private:
+    magma_int_t n;
+    double* result;
+};
+
+
+// ---------------------------------------------
+// Reference thread pool: the previous magma_thread_queue implementation,
+// with one mutex and condition variable guarding a single std::queue.
+// Kept here as the baseline for comparison.
+static void check( int err )
+{
+    if ( err != 0 ) {
+        fprintf( stderr, "Error: %s (%d)\n", strerror(err), err );
+        throw std::exception();
+    }
+}
+
+extern "C" void* reference_thread_main( void* arg );
+
+class reference_thread_queue
+{
+public:
+    reference_thread_queue( magma_int_t in_nthread ):
+        quit_flag( false ),
+        ntask    ( 0 ),
+        nthread  ( in_nthread )
+    {
+        check( pthread_mutex_init( &mutex,      NULL ));
+        check( pthread_cond_init(  &cond,       NULL ));
+        check( pthread_cond_init(  &cond_ntask, NULL ));
+        threads = new pthread_t[ nthread ];
+        for( magma_int_t i=0; i < nthread; ++i ) {
+            check( pthread_create( &threads[i], NULL, reference_thread_main, this ));
+        }
+    }
+
+    ~reference_thread_queue()
+    {
+        check( pthread_mutex_lock( &mutex ));
+        quit_flag = true;
+        check( pthread_cond_broadcast( &cond ));
+        check( pthread_mutex_unlock( &mutex ));
+        for( magma_int_t i=0; i < nthread; ++i ) {
+            check( pthread_join( threads[i], NULL ));
+        }
+        delete[] threads;
+        check( pthread_mutex_destroy( &mutex ));
+        check( pthread_cond_destroy( &cond ));
+        check( pthread_cond_destroy( &cond_ntask ));
+    }
+
+    void push_task( magma_task* task )
+    {
+        check( pthread_mutex_lock( &mutex ));
+        q.push( task );
+        ntask += 1;
+        check( pthread_cond_broadcast( &cond ));
+        check( pthread_mutex_unlock( &mutex ));
+    }
+
+    magma_task* pop_task()
+    {
+        magma_task* task = NULL;
+        check( pthread_mutex_lock( &mutex ));
+        while( q.empty() && ! quit_flag ) {
+            check( pthread_cond_wait( &cond, &mutex ));
+        }
+        if ( ! q.empty()) {
+            task = q.front();
+            q.pop();
+        }
+        check( pthread_mutex_unlock( &mutex ));
+        return task;
+    }
+
+    void task_done()
+    {
+        check( pthread_mutex_lock( &mutex ));
+        ntask -= 1;
+        check( pthread_cond_broadcast( &cond_ntask ));
+        check( pthread_mutex_unlock( &mutex ));
+    }
+
+    void sync()
+    {
+        check( pthread_mutex_lock( &mutex ));
+        while( ntask > 0 ) {
+            check( pthread_cond_wait( &cond_ntask, &mutex ));
+        }
+        check( pthread_mutex_unlock( &mutex ));
+    }
+
+private:
+    std::queue< magma_task* > q;
+    bool            quit_flag;
+    magma_int_t     ntask;
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    pthread_cond_t  cond_ntask;
+    pthread_t*      threads;
+    magma_int_t     nthread;
+};
+
+extern "C"
+void* reference_thread_main( void* arg )
+{
+    reference_thread_queue* queue = (reference_thread_queue*) arg;
+    magma_task* task;
+    while( (task = queue->pop_task()) != NULL ) {
+        task->run();
+        queue->task_done();
+        delete task;
+    }
+    return NULL;
+}
+
+
+// ---------------------------------------------
+// Pushes ntask tasks in nbatch batches, with a sync after each batch,
+// as dtrevc3_mt does. Returns time in seconds.
+template< typename queue_t >
+double run_tasks( queue_t& queue, magma_int_t ntask, magma_int_t nbatch,
+                  magma_int_t work, double* results )
+{
+    double time = magma_wtime();
+    magma_int_t per_batch = ceildiv( ntask, nbatch );
+    for( magma_int_t k=0; k < ntask; k += per_batch ) {
+        for( magma_int_t i=k; i < min( k + per_batch, ntask ); ++i ) {
+            queue.push_task( new spin_task( work, &results[i] ));
+        }
+        queue.sync();
+    }
+    return magma_wtime() - time;
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing magma_thread_queue
+   Measures throughput (tasks/sec) of magma_thread_queue versus the previous
+   single-lock implementation, for 1, 2, 4, ..., nthread threads.
+   -N ntask,work sets the number of tasks and the loop length of each task.
+*/
+int main( int argc, char** argv )
+{
+    TESTING_INIT();
+
+    double *results;
+    double ref_time, time, ref_rate, rate;
+    magma_int_t ntask, work, nbatch, nthread;
+    magma_int_t status = 0;
+
+    magma_opts opts;
+    parse_opts( argc, argv, &opts );
+
+    // default to all cores, unless --nthread was given
+    magma_int_t max_nthread = opts.nthread;
+    if ( max_nthread == 1 ) {
+        max_nthread = magma_get_parallel_numthreads();
+    }
+    nbatch = 10;
+
+    printf( "  ntask   work  nthread   reference (tasks/s)   magma_thread_queue (tasks/s)   speedup\n" );
+    printf( "=====================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        ntask = opts.msize[itest];
+        work  = opts.nsize[itest];
+        TESTING_MALLOC_CPU( results, double, ntask );
+
+        for( nthread = 1; true; nthread = min( 2*nthread, max_nthread )) {
+            for( int iter = 0; iter < opts.niter; ++iter ) {
+                ref_time = 0;
+                if ( opts.lapack ) {
+                    reference_thread_queue ref_queue( nthread );
+                    ref_time = run_tasks( ref_queue, ntask, nbatch, work, results );
+                }
+
+                magma_thread_queue queue;
+                queue.launch( nthread );
+                memset( results, 0, ntask*sizeof(double) );
+                time = run_tasks( queue, ntask, nbatch, work, results );
+                queue.quit();
+
+                // check every task ran
+                magma_int_t nmissed = 0;
+                if ( work > 1 ) {
+                    for( magma_int_t i=0; i < ntask; ++i ) {
+                        nmissed += (results[i] == 0);
+                    }
+                }
+                status += (nmissed != 0);
+
+                rate = ntask / time;
+                if ( opts.lapack ) {
+                    ref_rate = ntask / ref_time;
+                    printf( "%7d %6d  %7d   %19.0f   %28.0f   %7.2f   %s\n",
+                            (int) ntask, (int) work, (int) nthread,
+                            ref_rate, rate, rate / ref_rate,
+                            (nmissed == 0 ? "ok" : "failed") );
+                }
+                else {
+                    printf( "%7d %6d  %7d   %19s   %28.0f   %7s   %s\n",
+                            (int) ntask, (int) work, (int) nthread,
+                            "---", rate, "---",
+                            (nmissed == 0 ? "ok" : "failed") );
+                }
+            }
+            if ( nthread == max_nthread ) {
+                break;
+            }
+        }
+        TESTING_FREE_CPU( results );
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    TESTING_FINALIZE();
+    return status;
+}
@@ -0,0 +1,188 @@
+/*
+    -- MAGMA (version 1.5.0) --
+       Univ. of Tennessee, Knoxville
+       Univ. of California, Berkeley
+       Univ. of Colorado, Denver
+       @date September 2014
+*/
+// includes, system
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+// includes, project
+#include "magma.h"
+#include "testings.h"
+#include "magma_threadsetting.h"
+#include "magma_thread_team.h"
+#include "pthread_barrier.h"
+
+#ifdef MAGMA_SETAFFINITY
+#include "affinity.h"
+#endif
+
+
+// ---------------------------------------------
+// Tiny SPMD parallel section, shaped like the hb2st and bulge_back sections:
+// each thread does a little private work, then all meet at a barrier.
+typedef struct section_arg_s {
+    magma_int_t        id;
+    magma_int_t        count;
+    pthread_barrier_t* barrier;
+} section_arg;
+
+extern "C"
+void* section( void* arg )
+{
+    section_arg* a = (section_arg*) arg;
+    a->count += 1;
+    pthread_barrier_wait( a->barrier );
+    return NULL;
+}
+
+
+// ---------------------------------------------
+// Reference: the previous pattern in hb2st and bulge_back, which creates,
+// pins, unpins, and joins nthread-1 threads on every call.
+extern "C"
+void* reference_section( void* arg )
+{
+#ifdef MAGMA_SETAFFINITY
+    section_arg* a = (section_arg*) arg;
+    affinity_set original_set;
+    affinity_set new_set( a->id );
+    int check = original_set.get_affinity();
+    if ( check == 0 ) {
+        new_set.set_affinity();
+    }
+#endif
+
+    section( arg );
+
+#ifdef MAGMA_SETAFFINITY
+    if ( check == 0 ) {
+        original_set.set_affinity();
+    }
+#endif
+    return NULL;
+}
+
+static void reference_run( magma_int_t nthread, section_arg* args )
+{
+    pthread_t* thread_id = (pthread_t*) malloc( nthread * sizeof(pthread_t) );
+    pthread_attr_t thread_attr;
+    pthread_attr_init( &thread_attr );
+    pthread_attr_setscope( &thread_attr, PTHREAD_SCOPE_SYSTEM );
+    pthread_setconcurrency( nthread );
+
+    for( magma_int_t thread=1; thread < nthread; ++thread ) {
+        pthread_create( &thread_id[thread], &thread_attr, reference_section, &args[thread] );
+    }
+    reference_section( &args[0] );
+    for( magma_int_t thread=1; thread < nthread; ++thread ) {
+        pthread_join( thread_id[thread], NULL );
+    }
+    free( thread_id );
+}
+
+
+/* ////////////////////////////////////////////////////////////////////////////
+   -- Testing magma_thread_team
+   Measures the per-call overhead (microseconds) of running a tiny parallel
+   section, with pthread_create / pinning / pthread_join on every call as
+   hb2st and bulge_back used to do (run with -l), versus magma_thread_team_run,
+   for 1, 2, 4, ..., nthread threads.
+   -N ncall sets the number of calls.
+   The first team call, which creates the team, is not timed.
+*/
+int main( int argc, char** argv )
+{
+    TESTING_INIT();
+
+    section_arg *args;
+    pthread_barrier_t barrier;
+    double ref_time, time;
+    magma_int_t ncall, nthread, i, j;
+    magma_int_t status = 0;
+
+    magma_opts opts;
+    parse_opts( argc, argv, &opts );
+
+    // default to all cores, unless --nthread was given
+    magma_int_t max_nthread = opts.nthread;
+    if ( max_nthread == 1 ) {
+        max_nthread = magma_get_parallel_numthreads();
+    }
+
+    printf( "  ncall  nthread   reference (us/call)   magma_thread_team (us/call)   speedup\n" );
+    printf( "=================================================================================\n" );
+    for( int itest = 0; itest < opts.ntest; ++itest ) {
+        ncall = opts.nsize[itest];
+        TESTING_MALLOC_CPU( args, section_arg, max_nthread );
+
+        for( nthread = 1; true; nthread = min( 2*nthread, max_nthread )) {
+            for( int iter = 0; iter < opts.niter; ++iter ) {
+                pthread_barrier_init( &barrier, NULL, nthread );
+                for( j=0; j < nthread; ++j ) {
+                    args[j].id      = j;
+                    args[j].count   = 0;
+                    args[j].barrier = &barrier;
+                }
+
+                ref_time = 0;
+                if ( opts.lapack ) {
+                    ref_time = magma_wtime();
+                    for( i=0; i < ncall; ++i ) {
+                        reference_run( nthread, args );
+                    }
+                    ref_time = magma_wtime() - ref_time;
+                }
+
+                // warm up, creating the team if needed
+                magma_thread_team_run( nthread, section, args, sizeof(section_arg) );
+
+                time = magma_wtime();
+                for( i=0; i < ncall; ++i ) {
+                    magma_thread_team_run( nthread, section, args, sizeof(section_arg) );
+                }
+                time = magma_wtime() - time;
+                pthread_barrier_destroy( &barrier );
+
+                // check every thread ran every call
+                magma_int_t expect = ncall + 1 + (opts.lapack ? ncall : 0);
+                magma_int_t nmissed = 0;
+                for( j=0; j < nthread; ++j ) {
+                    nmissed += (args[j].count != expect);
+                }
+                status += (nmissed != 0);
+
+                time *= 1e6 / ncall;
+                if ( opts.lapack ) {
+                    ref_time *= 1e6 / ncall;
+                    printf( "%7d  %7d   %19.2f   %27.2f   %7.2f   %s\n",
+                            (int) ncall, (int) nthread,
+                            ref_time, time, ref_time / time,
+                            (nmissed == 0 ? "ok" : "failed") );
+                }
+                else {
+                    printf( "%7d  %7d   %19s   %27.2f   %7s   %s\n",
+                            (int) ncall, (int) nthread,
+                            "---", time, "---",
+                            (nmissed == 0 ? "ok" : "failed") );
+                }
+            }
+            if ( nthread == max_nthread ) {
+                break;
+            }
+        }
+        TESTING_FREE_CPU( args );
+        if ( opts.niter > 1 ) {
+            printf( "\n" );
+        }
+    }
+
+    TESTING_FINALIZE();
+    return status;
+}